@@ -49,6 +49,14 @@ cdef extern from "chemkit/moleculegeometryoptimizer.h" namespace "chemkit":
         _Molecule* molecule()
         bool setForceField(char *forceField)
         string forceField()
+        bool setMinimizer(char *minimizer)
+        string minimizer()
+        void setMaximumIterations(size_t iterations)
+        size_t maximumIterations()
+        void setEnergyTolerance(double tolerance)
+        double energyTolerance()
+        void setGradientTolerance(double tolerance)
+        double gradientTolerance()
 
         # energy
         double energy()
@@ -59,6 +67,8 @@ cdef extern from "chemkit/moleculegeometryoptimizer.h" namespace "chemkit":
         bool converged()
         bool optimize()
         void writeCoordinates()
+        size_t iterationCount()
+        size_t evaluationCount()
 
         # error handling
         string errorString()
@@ -76,6 +76,48 @@ cdef class MoleculeGeometryOptimizer:
 
         return name.c_str()
 
+    def setMinimizer(self, char *minimizer):
+        """Sets the minimization algorithm to use for the optimization."""
+
+        return self._optimizer.setMinimizer(minimizer)
+
+    def minimizer(self):
+        """Returns the name of the minimization algorithm."""
+
+        cdef string name = self._optimizer.minimizer()
+
+        return name.c_str()
+
+    def setMaximumIterations(self, int iterations):
+        """Sets the maximum number of iterations for optimize()."""
+
+        self._optimizer.setMaximumIterations(iterations)
+
+    def maximumIterations(self):
+        """Returns the maximum number of iterations."""
+
+        return self._optimizer.maximumIterations()
+
+    def setEnergyTolerance(self, double tolerance):
+        """Sets the energy change below which the optimization is converged."""
+
+        self._optimizer.setEnergyTolerance(tolerance)
+
+    def energyTolerance(self):
+        """Returns the energy tolerance."""
+
+        return self._optimizer.energyTolerance()
+
+    def setGradientTolerance(self, double tolerance):
+        """Sets the RMS gradient below which the optimization is converged."""
+
+        self._optimizer.setGradientTolerance(tolerance)
+
+    def gradientTolerance(self):
+        """Returns the gradient tolerance."""
+
+        return self._optimizer.gradientTolerance()
+
     ### Energy ################################################################
     def energy(self):
         """Returns the current energy of the molecule."""
@@ -108,6 +150,16 @@ cdef class MoleculeGeometryOptimizer:
 
         self._optimizer.writeCoordinates()
 
+    def iterationCount(self):
+        """Returns the number of iterations performed."""
+
+        return self._optimizer.iterationCount()
+
+    def evaluationCount(self):
+        """Returns the number of energy and gradient evaluations performed."""
+
+        return self._optimizer.evaluationCount()
+
 
     ### Error Handling ########################################################
     def errorString(self):
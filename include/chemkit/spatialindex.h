@@ -0,0 +1 @@
+#include "../../src/chemkit/spatialindex.h"
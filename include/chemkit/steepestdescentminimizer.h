@@ -0,0 +1 @@
+#include "../../src/md/steepestdescentminimizer.h"
@@ -81,6 +81,8 @@ int main(int argc, char *argv[])
             "Return only non-matching molecules.")
         ("names-only,n",
             "Output only the names of matching molecules.")
+        ("no-screening",
+            "Match every molecule without screening it first.")
         ("help,h",
             "Shows this help message");
 
@@ -145,6 +147,7 @@ int main(int argc, char *argv[])
     bool exactMatch = variables.find("exact-match") != variables.end();
     bool invertMatch = variables.find("invert-match") != variables.end();
     bool namesOnly = variables.find("names-only") != variables.end();
+    bool noScreening = variables.find("no-screening") != variables.end();
 
     int flags = 0;
     if(compositionOnly){
@@ -153,6 +156,9 @@ int main(int argc, char *argv[])
     if(exactMatch){
         flags |= chemkit::SubstructureQuery::CompareExact;
     }
+    if(!noScreening){
+        flags |= chemkit::SubstructureQuery::UseScreening;
+    }
 
     chemkit::SubstructureQuery query;
     query.setMolecule(patternMolecule);
@@ -117,20 +117,15 @@ void Atom::setIsotope(const Isotope &isotope)
         setElement(isotope.element());
     }
 
-    m_molecule->d->isotopes[this] = isotope;
+    m_molecule->d->massNumbers[m_index] = isotope.massNumber();
+    m_molecule->d->massNumbersSet[m_index] = true;
     m_molecule->notifyWatchers(this, MoleculeWatcher::AtomMassNumberChanged);
 }
 
 /// Returns the isotope for the atom.
 Isotope Atom::isotope() const
 {
-    std::map<const Atom *, Isotope>::iterator iter = m_molecule->d->isotopes.find(this);
-    if(iter == m_molecule->d->isotopes.end()){
-        return Isotope(element(), is(Hydrogen) ? 1 : atomicNumber() * 2);
-    }
-    else{
-        return iter->second;
-    }
+    return Isotope(element(), massNumber());
 }
 
 /// Sets the mass number for the atom. This is the number of protons
@@ -144,32 +139,51 @@ void Atom::setMassNumber(MassNumberType massNumber)
 /// Returns the mass number of the atom.
 Atom::MassNumberType Atom::massNumber() const
 {
-    return isotope().massNumber();
+    const MoleculePrivate *d = m_molecule->d;
+
+    if(!d->massNumbersSet[m_index]){
+        return is(Hydrogen) ? 1 : atomicNumber() * 2;
+    }
+
+    return d->massNumbers[m_index];
 }
 
 /// Sets the symbolic type for the atom to \p type.
 void Atom::setType(const std::string &type)
 {
-    std::vector<std::string> &atomTypes = m_molecule->d->atomTypes;
+    MoleculePrivate *d = m_molecule->d;
+
+    // the names are stored once per molecule and each atom stores the
+    // index of its type's name
+    int id;
+    boost::unordered_map<std::string, int>::const_iterator iter = d->atomTypeIds.find(type);
+    if(iter != d->atomTypeIds.end()){
+        id = iter->second;
+    }
+    else{
+        id = static_cast<int>(d->atomTypeNames.size());
+        d->atomTypeNames.push_back(type);
+        d->atomTypeIds[type] = id;
+    }
 
-    if(m_index >= atomTypes.size()){
-        atomTypes.resize(m_index + 1);
+    if(m_index >= d->atomTypes.size()){
+        d->atomTypes.resize(m_index + 1, -1);
     }
 
-    atomTypes[m_index] = type;
+    d->atomTypes[m_index] = id;
 }
 
 /// Returns the symbolic type for the atom or an empty string if no
 /// atom type has been set.
 std::string Atom::type() const
 {
-    std::vector<std::string> &atomTypes = m_molecule->d->atomTypes;
+    const MoleculePrivate *d = m_molecule->d;
 
-    if(m_index >= atomTypes.size()){
+    if(m_index >= d->atomTypes.size() || d->atomTypes[m_index] == -1){
         return std::string();
     }
 
-    return atomTypes[m_index];
+    return d->atomTypeNames[d->atomTypes[m_index]];
 }
 
 /// Returns the atom's expected valence.
@@ -370,7 +384,13 @@ bool Atom::isBondedTo(const Element &element, int bondOrder) const
 /// fragment).
 bool Atom::isConnectedTo(const Atom *atom) const
 {
-    return fragment()->contains(atom);
+    if(atom->m_molecule != m_molecule){
+        return false;
+    }
+
+    const MoleculePrivate *d = m_molecule->d;
+
+    return d->findFragmentSet(m_index) == d->findFragmentSet(atom->m_index);
 }
 
 /// Returns \c true if this atom is bonded to exactly one atom. (i.e.
@@ -401,56 +421,29 @@ Ring* Atom::ring(size_t index) const
 /// \see Molecule::rings()
 Atom::RingRange Atom::rings() const
 {
-    // range of all rings in the molecule
-    const Molecule::RingRange moleculeRings = m_molecule->rings();
+    const std::vector<Ring *> &rings = ringMembership();
 
-    // predicate function to check if a ring contains this atom
-    boost::function<bool (const Ring *)> ringContainsThisAtom =
-        boost::bind(static_cast<bool (Ring::*)(const Atom *) const>(&Ring::contains), _1, this);
-
-    return boost::make_iterator_range(
-               boost::make_filter_iterator<
-                   boost::function<bool (const Ring *)> >(ringContainsThisAtom,
-                                                          moleculeRings.begin(),
-                                                          moleculeRings.end()),
-               boost::make_filter_iterator<
-                    boost::function<bool (const Ring *)> >(ringContainsThisAtom,
-                                                           moleculeRings.end(),
-                                                           moleculeRings.end()));
+    return boost::make_iterator_range(rings.begin(), rings.end());
 }
 
 /// Returns the number of rings that contain the atom.
 size_t Atom::ringCount() const
 {
-    size_t count = 0;
-
-    foreach(const Ring *ring, m_molecule->rings()){
-        if(ring->contains(this)){
-            count++;
-        }
-    }
-
-    return count;
+    return ringMembership().size();
 }
 
 /// Returns \c true if the atom is a member of at least one ring
 /// (i.e. ringCount() >= 1).
 bool Atom::isInRing() const
 {
-    foreach(const Ring *ring, m_molecule->rings()){
-        if(ring->contains(this)){
-            return true;
-        }
-    }
-
-    return false;
+    return !ringMembership().empty();
 }
 
 /// Returns \c true if the atom is a member of a ring of given size.
 bool Atom::isInRing(size_t size) const
 {
-    foreach(const Ring *ring, m_molecule->rings()){
-        if(ring->size() == size && ring->contains(this)){
+    foreach(const Ring *ring, ringMembership()){
+        if(ring->size() == size){
             return true;
         }
     }
@@ -458,13 +451,13 @@ bool Atom::isInRing(size_t size) const
     return false;
 }
 
-/// Returns the smallest ring the atom is a member of or 0 if the
+/// Returns the smallest ring the atom is a member of or \c 0 if the
 /// atom is not in a ring.
 Ring* Atom::smallestRing() const
 {
     Ring *smallest = 0;
 
-    foreach(Ring *ring, rings()){
+    foreach(Ring *ring, ringMembership()){
         if(!smallest || ring->size() < smallest->size()){
             smallest = ring;
         }
@@ -474,15 +467,15 @@ Ring* Atom::smallestRing() const
 }
 
 /// Returns \c true if the atom is in an aromatic ring.
+///
+/// \see Ring::isAromatic()
 bool Atom::isAromatic() const
 {
-    foreach(const Ring *ring, rings()){
-        if(ring->isAromatic()){
-            return true;
-        }
+    if(!m_molecule->d->aromaticityPerceived){
+        m_molecule->perceiveAromaticity();
     }
 
-    return false;
+    return m_molecule->d->atomAromaticity[m_index];
 }
 
 // --- Geometry ------------------------------------------------------------ //
@@ -536,19 +529,14 @@ Real Atom::distance(const Atom *atom) const
 /// Sets the chirality of the atom.
 void Atom::setChirality(Stereochemistry::Type chirality)
 {
-    m_molecule->stereochemistry()->setStereochemistry(this, chirality);
+    m_molecule->d->atomStereochemistry[m_index] = chirality;
     m_molecule->notifyWatchers(this, MoleculeWatcher::AtomChiralityChanged);
 }
 
 /// Returns the chirality of the atom.
 Stereochemistry::Type Atom::chirality() const
 {
-    if(!m_molecule->m_stereochemistry){
-        return Stereochemistry::None;
-    }
-    else{
-        return m_molecule->stereochemistry()->stereochemistry(this);
-    }
+    return m_molecule->d->atomStereochemistry[m_index];
 }
 
 /// Returns \c true if the atom is chiral (i.e. chirality() !=
@@ -558,4 +546,17 @@ bool Atom::isChiral() const
     return chirality() != Stereochemistry::None;
 }
 
+// --- Internal Methods ---------------------------------------------------- //
+// Returns the rings containing the atom. The ring membership of every
+// atom and bond is found the first time this is called and is cached
+// until the structure of the molecule changes.
+const std::vector<Ring *>& Atom::ringMembership() const
+{
+    if(!m_molecule->d->ringMembershipPerceived){
+        m_molecule->perceiveRingMembership();
+    }
+
+    return m_molecule->d->atomRings[m_index];
+}
+
 } // end chemkit namespace
@@ -43,7 +43,6 @@
 #ifndef Q_MOC_RUN
 #include <boost/function.hpp>
 #include <boost/range/iterator_range.hpp>
-#include <boost/iterator/filter_iterator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #endif
 
@@ -71,11 +70,7 @@ public:
                 boost::transform_iterator<
                     boost::function<Atom* (Bond *)>,
                     std::vector<Bond *>::const_iterator> > NeighborRange;
-    typedef boost::iterator_range<
-                boost::filter_iterator<
-                    boost::function<bool (const Ring *)>,
-                    boost::iterator_range<
-                        std::vector<Ring *>::const_iterator>::const_iterator> > RingRange;
+    typedef boost::iterator_range<std::vector<Ring *>::const_iterator> RingRange;
 
     // properties
     void setElement(const Element &element);
@@ -259,6 +254,9 @@ private:
     Atom(Molecule *molecule, size_t index);
     ~Atom();
 
+    // internal methods
+    const std::vector<Ring *>& ringMembership() const;
+
     CHEMKIT_DISABLE_COPY(Atom)
 
     friend class Molecule;
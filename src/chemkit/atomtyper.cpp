@@ -35,6 +35,10 @@
 
 #include "atomtyper.h"
 
+#include <boost/unordered_map.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
 #include "atom.h"
 #include "bond.h"
 #include "foreach.h"
@@ -47,10 +51,34 @@ namespace chemkit {
 class AtomTyperPrivate
 {
 public:
+    int addType(const std::string &name);
+
     std::string name;
     const Molecule *molecule;
+    std::vector<std::string> typeNames;
+    boost::unordered_map<std::string, int> typeIds;
+    boost::mutex typeMutex;
 };
 
+// Returns the id for the type with name, adding it to the table if
+// it has not been seen before. The type table is locked because the
+// const typeId() method may add types from several threads.
+int AtomTyperPrivate::addType(const std::string &name)
+{
+    boost::lock_guard<boost::mutex> lock(typeMutex);
+
+    boost::unordered_map<std::string, int>::const_iterator iter = typeIds.find(name);
+    if(iter != typeIds.end()){
+        return iter->second;
+    }
+
+    int id = static_cast<int>(typeNames.size());
+    typeNames.push_back(name);
+    typeIds[name] = id;
+
+    return id;
+}
+
 // === AtomTyper =========================================================== //
 /// \class AtomTyper atomtyper.h chemkit/atomtyper.h
 /// \ingroup chemkit
@@ -58,6 +86,12 @@ public:
 ///
 /// To create atom typer objects use the AtomTyper::create() method.
 ///
+/// Each atom typer keeps a table of the types it has assigned. The
+/// typeId() method returns the index of an atom's type in the table
+/// and the typeName() method returns the name for an index. Code
+/// which stores or compares many types (such as a Topology) should
+/// use the integer ids and only look up the names when needed.
+///
 /// A list of supported atom typers is available at:
 /// http://wiki.chemkit.org/Features#Atom_Typers
 
@@ -103,6 +137,56 @@ std::string AtomTyper::type(const Atom *atom) const
     return std::string();
 }
 
+/// Returns the id of the type for \p atom.
+///
+/// The default implementation adds the name returned from type() to
+/// the type table. Atom typers which define a fixed set of types
+/// should add them in their constructor with addType() and override
+/// this method to avoid creating the names.
+///
+/// This method may be called from several threads at once.
+int AtomTyper::typeId(const Atom *atom) const
+{
+    return d->addType(type(atom));
+}
+
+/// Returns the name of the type with \p id. Returns an empty string
+/// if \p id is not in the type table.
+std::string AtomTyper::typeName(int id) const
+{
+    boost::lock_guard<boost::mutex> lock(d->typeMutex);
+
+    if(id < 0 || static_cast<size_t>(id) >= d->typeNames.size()){
+        return std::string();
+    }
+
+    return d->typeNames[id];
+}
+
+/// Returns the number of types in the type table.
+size_t AtomTyper::typeCount() const
+{
+    boost::lock_guard<boost::mutex> lock(d->typeMutex);
+
+    return d->typeNames.size();
+}
+
+/// Returns a list of the names in the type table. The name for the
+/// type with id \c i is at index \c i.
+std::vector<std::string> AtomTyper::typeNames() const
+{
+    boost::lock_guard<boost::mutex> lock(d->typeMutex);
+
+    return d->typeNames;
+}
+
+/// Adds the type with \p name to the type table and returns its id.
+/// If the type is already in the table its existing id is returned.
+int AtomTyper::addType(const std::string &name)
+{
+    return d->addType(name);
+}
+
 // --- Interaction Types --------------------------------------------------- //
 int AtomTyper::bondedInteractionType(const Atom *a, const Atom *b) const
 {
@@ -62,6 +62,10 @@ public:
 
     // types
     virtual std::string type(const Atom *atom) const;
+    virtual int typeId(const Atom *atom) const;
+    std::string typeName(int id) const;
+    size_t typeCount() const;
+    std::vector<std::string> typeNames() const;
 
     // interaction types
     virtual int bondedInteractionType(const Atom *a, const Atom *b) const;
@@ -92,6 +96,7 @@ public:
 
 protected:
     AtomTyper(const std::string &name);
+    int addType(const std::string &name);
 
 private:
     AtomTyperPrivate* const d;
@@ -35,8 +35,6 @@
 
 #include "bond.h"
 
-#include <boost/bind.hpp>
-
 #include "atom.h"
 #include "ring.h"
 #include "foreach.h"
@@ -208,56 +206,29 @@ Ring* Bond::ring(size_t index) const
 /// \see Molecule::rings()
 Bond::RingRange Bond::rings() const
 {
-    // range of all rings in the molecule
-    const Molecule::RingRange moleculeRings = m_molecule->rings();
-
-    // predicate function to check if a ring contains this bond
-    boost::function<bool (const Ring *)> ringContainsThisBond =
-        boost::bind(static_cast<bool (Ring::*)(const Bond *) const>(&Ring::contains), _1, this);
-
-    return boost::make_iterator_range(
-               boost::make_filter_iterator<
-                   boost::function<bool (const Ring *)> >(ringContainsThisBond,
-                                                          moleculeRings.begin(),
-                                                          moleculeRings.end()),
-               boost::make_filter_iterator<
-                    boost::function<bool (const Ring *)> >(ringContainsThisBond,
-                                                           moleculeRings.end(),
-                                                           moleculeRings.end()));
+    const std::vector<Ring *> &rings = ringMembership();
+
+    return boost::make_iterator_range(rings.begin(), rings.end());
 }
 
 /// Returns the number of rings that contain the bond.
 size_t Bond::ringCount() const
 {
-    size_t count = 0;
-
-    foreach(const Ring *ring, m_molecule->rings()){
-        if(ring->contains(this)){
-            count++;
-        }
-    }
-
-    return count;
+    return ringMembership().size();
 }
 
-/// Returns \c true if the bond is a member of at least one ring.
+/// Returns \c true if the bond is a member of at least one ring
 /// (i.e. ringCount() >= 1).
 bool Bond::isInRing() const
 {
-    foreach(const Ring *ring, molecule()->rings()){
-        if(ring->contains(this)){
-            return true;
-        }
-    }
-
-    return false;
+    return !ringMembership().empty();
 }
 
-/// Returns \c true if the bond is in a ring of given size.
+/// Returns \c true if the bond is a member of a ring of given size.
 bool Bond::isInRing(size_t size) const
 {
-    foreach(const Ring *ring, molecule()->rings()){
-        if(ring->size() == size && ring->contains(this)){
+    foreach(const Ring *ring, ringMembership()){
+        if(ring->size() == size){
             return true;
         }
     }
@@ -271,7 +242,7 @@ Ring* Bond::smallestRing() const
 {
     Ring *smallest = 0;
 
-    foreach(Ring *ring, rings()){
+    foreach(Ring *ring, ringMembership()){
         if(!smallest || ring->size() < smallest->size()){
             smallest = ring;
         }
@@ -285,13 +256,11 @@ Ring* Bond::smallestRing() const
 /// \see Ring::isAromatic()
 bool Bond::isAromatic() const
 {
-    foreach(const Ring *ring, rings()){
-        if(ring->isAromatic()){
-            return true;
-        }
+    if(!m_molecule->d->aromaticityPerceived){
+        m_molecule->perceiveAromaticity();
     }
 
-    return false;
+    return m_molecule->d->bondAromaticity[m_index];
 }
 
 // --- Geometry ------------------------------------------------------------ //
@@ -313,18 +282,26 @@ Real Bond::length() const
 /// Sets the stereochemistry for the bond.
 void Bond::setStereochemistry(Stereochemistry::Type stereochemistry)
 {
-    m_molecule->stereochemistry()->setStereochemistry(this, stereochemistry);
+    m_molecule->d->bondStereochemistry[m_index] = stereochemistry;
 }
 
 /// Returns the stereochemistry for the bond.
 Stereochemistry::Type Bond::stereochemistry() const
 {
-    if(!m_molecule->m_stereochemistry){
-        return Stereochemistry::None;
-    }
-    else{
-        return m_molecule->stereochemistry()->stereochemistry(this);
+    return m_molecule->d->bondStereochemistry[m_index];
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+// Returns the rings containing the bond. The ring membership of every
+// atom and bond is found the first time this is called and is cached
+// until the structure of the molecule changes.
+const std::vector<Ring *>& Bond::ringMembership() const
+{
+    if(!m_molecule->d->ringMembershipPerceived){
+        m_molecule->perceiveRingMembership();
     }
+
+    return m_molecule->d->bondRings[m_index];
 }
 
 } // end chemkit namespace
@@ -41,9 +41,7 @@
 #include <vector>
 
 #ifndef Q_MOC_RUN
-#include <boost/function.hpp>
 #include <boost/range/iterator_range.hpp>
-#include <boost/iterator/filter_iterator.hpp>
 #endif
 
 #include "point3.h"
@@ -63,11 +61,7 @@ class CHEMKIT_EXPORT Bond
 public:
     // typedefs
     typedef unsigned char BondOrderType;
-    typedef boost::iterator_range<
-                boost::filter_iterator<
-                    boost::function<bool (const Ring *)>,
-                    boost::iterator_range<
-                        std::vector<Ring *>::const_iterator>::const_iterator> > RingRange;
+    typedef boost::iterator_range<std::vector<Ring *>::const_iterator> RingRange;
 
     // enumerations
     enum BondType{
@@ -119,6 +113,9 @@ private:
     Bond(Molecule *molecule, size_t index);
     ~Bond();
 
+    // internal methods
+    const std::vector<Ring *>& ringMembership() const;
+
     CHEMKIT_DISABLE_COPY(Bond)
 
     friend class Molecule;
@@ -35,12 +35,81 @@
 
 #include "bondpredictor.h"
 
+#include <algorithm>
+
 #include "atom.h"
 #include "foreach.h"
 #include "molecule.h"
+#include "concurrent.h"
+#include "spatialindex.h"
 
 namespace chemkit {
 
+namespace {
+
+// number of atoms checked by each parallel task
+const size_t BlockSize = 2048;
+
+// finds the bonded pairs for a block of atoms
+class BondSearch
+{
+public:
+    typedef void result_type;
+
+    BondSearch(const SpatialIndex &index,
+               const std::vector<Real> &radii,
+               Real searchRadius,
+               Real minimumLength,
+               Real maximumLength,
+               Real tolerance,
+               std::vector<std::vector<SpatialIndex::Pair> > &blocks)
+        : m_index(index),
+          m_radii(radii),
+          m_searchRadius(searchRadius),
+          m_minimumLength(minimumLength),
+          m_maximumLength(maximumLength),
+          m_tolerance(tolerance),
+          m_blocks(blocks)
+    {
+    }
+
+    void operator()(size_t block) const
+    {
+        std::vector<SpatialIndex::Pair> &pairs = m_blocks[block];
+
+        size_t end = std::min(m_index.size(), (block + 1) * BlockSize);
+
+        for(size_t i = block * BlockSize; i < end; i++){
+            const Point3 position = m_index.position(i);
+
+            foreach(size_t j, m_index.within(position, m_searchRadius)){
+                if(j <= i){
+                    continue;
+                }
+
+                Real distance = (m_index.position(j) - position).norm();
+
+                if(distance > m_minimumLength &&
+                   distance < m_maximumLength &&
+                   std::abs((m_radii[i] + m_radii[j]) - distance) < m_tolerance){
+                    pairs.push_back(std::make_pair(i, j));
+                }
+            }
+        }
+    }
+
+private:
+    const SpatialIndex &m_index;
+    const std::vector<Real> &m_radii;
+    Real m_searchRadius;
+    Real m_minimumLength;
+    Real m_maximumLength;
+    Real m_tolerance;
+    std::vector<std::vector<SpatialIndex::Pair> > &m_blocks;
+};
+
+} // end anonymous namespace
+
 // === BondPredictorPrivate ================================================ //
 class BondPredictorPrivate
 {
@@ -68,6 +137,11 @@ public:
 /// \endcode
 ///
 /// This class implements the \blueobeliskalgorithm{rebondFrom3DCoordinates}.
+///
+/// Atoms are bucketed into a grid with cells as large as the longest
+/// possible bond so only nearby atoms are compared and the prediction
+/// runs in linear time. Large molecules are split across the threads
+/// in the global thread pool.
 
 /// \typedef BondPredictor::PredictedBond;
 /// This tuple contains information about each predicted bond.
@@ -154,12 +228,56 @@ std::vector<BondPredictor::PredictedBond> BondPredictor::predictedBonds()
         return bonds;
 
     std::vector<Atom *> atoms(d->molecule->atoms().begin(), d->molecule->atoms().end());
+    if(atoms.empty()){
+        return bonds;
+    }
 
-    for(unsigned int i = 0; i < atoms.size(); i++){
-        for(unsigned int j = i+1; j < atoms.size(); j++){
-            if(couldBeBonded(atoms[i], atoms[j])){
-                bonds.push_back(boost::make_tuple(atoms[i], atoms[j], Bond::Single));
-            }
+    std::vector<Point3> positions;
+    positions.reserve(atoms.size());
+
+    foreach(const Atom *atom, atoms){
+        positions.push_back(atom->position());
+    }
+
+    std::vector<Real> radii = d->molecule->covalentRadii();
+
+    // no pair of atoms further apart than the largest two radii
+    // plus the tolerance can be bonded
+    Real largestRadius = *std::max_element(radii.begin(), radii.end());
+    Real cutoff = std::min(maximumBondLength(), 2 * largestRadius + tolerance());
+    if(cutoff <= 0){
+        return bonds;
+    }
+
+    // pad the search radius so that rounding never drops a pair
+    Real searchRadius = cutoff * (1 + 1e-6);
+
+    SpatialIndex index;
+    index.setCellSize(searchRadius);
+    index.setPositions(positions);
+
+    size_t blockCount = (atoms.size() + BlockSize - 1) / BlockSize;
+    std::vector<std::vector<SpatialIndex::Pair> > blocks(blockCount);
+
+    BondSearch search(index,
+                      radii,
+                      searchRadius,
+                      minimumBondLength(),
+                      maximumBondLength(),
+                      tolerance(),
+                      blocks);
+
+    if(blockCount == 1){
+        search(0);
+    }
+    else{
+        concurrent::parallel_for(0, blockCount, search);
+    }
+
+    // blocks and the pairs within them are ordered by atom index
+    foreach(const std::vector<SpatialIndex::Pair> &block, blocks){
+        foreach(const SpatialIndex::Pair &pair, block){
+            bonds.push_back(boost::make_tuple(atoms[pair.first], atoms[pair.second], Bond::Single));
         }
     }
 
@@ -178,18 +296,4 @@ void BondPredictor::predictBonds(Molecule *molecule)
     }
 }
 
-// --- Internal Methods ---------------------------------------------------- //
-// Returns \c true if the atoms could feasibly be bonded.
-bool BondPredictor::couldBeBonded(Atom *a, Atom *b) const
-{
-    Real distance = a->distance(b);
-
-    if(distance > minimumBondLength() &&
-       distance < maximumBondLength() &&
-       std::abs((a->covalentRadius() + b->covalentRadius()) - distance) < tolerance())
-        return true;
-    else
-        return false;
-}
-
 } // end chemkit namespace
@@ -77,9 +77,6 @@ public:
     // static methods
     static void predictBonds(Molecule *molecule);
 
-private:
-    bool couldBeBonded(Atom *a, Atom *b) const;
-
 private:
     BondPredictorPrivate* const d;
 };
@@ -90,6 +90,20 @@
     #define CHEMKIT_OVERRIDE
 #endif
 
+// Define a macro if the compiler supports C++11 rvalue references.
+#if defined(__clang__)
+    #if __has_feature(cxx_rvalue_references)
+        #define CHEMKIT_HAS_RVALUE_REFERENCES
+    #endif
+#elif defined(__GNUC__)
+    #if(__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 3)) && \
+       (defined(__GXX_EXPERIMENTAL_CXX0X__) || __cplusplus >= 201103L)
+        #define CHEMKIT_HAS_RVALUE_REFERENCES
+    #endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1600
+    #define CHEMKIT_HAS_RVALUE_REFERENCES
+#endif
+
 namespace chemkit {
 
 /// Typedef for a real number.
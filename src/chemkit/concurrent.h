@@ -38,31 +38,413 @@
 
 #include "chemkit.h"
 
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
 #ifndef Q_MOC_RUN
+#include <boost/bind.hpp>
 #include <boost/thread.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/throw_exception.hpp>
 #endif
 
+#include "threadpool.h"
+
 namespace chemkit {
 namespace concurrent {
 
-/// Runs \p function asynchronously in a separate thread. Returns a
-/// future containing the value returned from \p function.
+/// \class CancelledError concurrent.h chemkit/concurrent.h
+/// \ingroup chemkit
+/// \brief The CancelledError exception is thrown when waiting for
+///        the result of a task that was cancelled.
+///
+/// \see CancellationToken
+class CancelledError : public std::runtime_error
+{
+public:
+    CancelledError()
+        : std::runtime_error("operation cancelled")
+    {
+    }
+};
+
+/// \class CancellationToken concurrent.h chemkit/concurrent.h
+/// \ingroup chemkit
+/// \brief The CancellationToken class is used to request the
+///        cancellation of asynchronous tasks.
+///
+/// Copies of a token share their state so a token can be passed to
+/// run() or parallel_for() and later cancelled from another thread.
+/// Cancellation is cooperative: tasks which have not yet started are
+/// skipped, the results of tasks which were cancelled while running
+/// are discarded and long running functions may poll isCancelled()
+/// on their own copy of the token to stop early.
+class CancellationToken
+{
+public:
+    /// Creates a new cancellation token.
+    CancellationToken()
+        : m_state(boost::make_shared<State>())
+    {
+    }
+
+    /// Requests cancellation of the tasks using the token.
+    void cancel()
+    {
+        boost::lock_guard<boost::mutex> lock(m_state->mutex);
+        m_state->cancelled = true;
+    }
+
+    /// Returns \c true if cancel() has been called.
+    bool isCancelled() const
+    {
+        boost::lock_guard<boost::mutex> lock(m_state->mutex);
+        return m_state->cancelled;
+    }
+
+private:
+    struct State
+    {
+        State() : cancelled(false) { }
+
+        boost::mutex mutex;
+        bool cancelled;
+    };
+
+    boost::shared_ptr<State> m_state;
+};
+
+namespace detail {
+
+inline void throwIfCancelled(const CancellationToken &token)
+{
+    if(token.isCancelled()){
+        boost::throw_exception(CancelledError());
+    }
+}
+
+// calls function and throws CancelledError instead of returning its
+// result if token was cancelled while it was running
+template<typename T>
+struct CancellableCall
+{
+    template<typename Function>
+    static T call(Function &function, const CancellationToken &token)
+    {
+        T result = function();
+        throwIfCancelled(token);
+        return result;
+    }
+};
+
+template<>
+struct CancellableCall<void>
+{
+    template<typename Function>
+    static void call(Function &function, const CancellationToken &token)
+    {
+        function();
+        throwIfCancelled(token);
+    }
+};
+
+// wraps a function so that it throws CancelledError instead of
+// running once its token has been cancelled
+template<typename Function>
+class CancellableFunction
+{
+public:
+    typedef typename Function::result_type result_type;
+
+    CancellableFunction(const Function &function, const CancellationToken &token)
+        : m_function(function),
+          m_token(token)
+    {
+    }
+
+    result_type operator()()
+    {
+        throwIfCancelled(m_token);
+
+        return CancellableCall<result_type>::call(m_function, m_token);
+    }
+
+private:
+    Function m_function;
+    CancellationToken m_token;
+};
+
+// runs the task unless it has already been started by a thread
+// waiting for its result (see runWaitedForTask())
+template<typename T>
+inline void runPackagedTask(const boost::shared_ptr<boost::packaged_task<T> > &task)
+{
+    try {
+        (*task)();
+    }
+    catch(boost::task_already_started &){
+    }
+}
+
+// called when a thread waits for the result of a task which has not
+// finished. if the task is still queued it is run in the waiting
+// thread which prevents a deadlock when a pool thread waits for a
+// task queued behind it
+template<typename T>
+inline void runWaitedForTask(boost::packaged_task<T> &task)
+{
+    try {
+        task();
+    }
+    catch(boost::task_already_started &){
+    }
+}
+
+// tracks the completion of a group of tasks started by parallel_for()
+class TaskGroup
+{
+public:
+    TaskGroup(size_t count)
+        : m_remaining(count)
+    {
+    }
+
+    void finish(const boost::exception_ptr &exception = boost::exception_ptr())
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        if(exception && !m_exception){
+            m_exception = exception;
+        }
+        if(--m_remaining == 0){
+            m_condition.notify_all();
+        }
+    }
+
+    // waits for each task in the group to finish while running
+    // other queued tasks to avoid blocking a worker thread
+    void wait(ThreadPool *pool)
+    {
+        for(;;){
+            {
+                boost::unique_lock<boost::mutex> lock(m_mutex);
+                if(m_remaining == 0){
+                    break;
+                }
+            }
+
+            // once no tasks are queued the remaining tasks in the
+            // group are running in other threads and finish() will
+            // signal the condition when the last one is done
+            if(!pool->runPendingTask()){
+                boost::unique_lock<boost::mutex> lock(m_mutex);
+                while(m_remaining != 0){
+                    m_condition.wait(lock);
+                }
+            }
+        }
+
+        if(m_exception){
+            boost::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    boost::mutex m_mutex;
+    boost::condition_variable m_condition;
+    size_t m_remaining;
+    boost::exception_ptr m_exception;
+};
+
+template<typename Function>
+inline void runRange(const Function *function,
+                     size_t begin,
+                     size_t end,
+                     const CancellationToken &token,
+                     TaskGroup *group)
+{
+    try {
+        for(size_t i = begin; i < end && !token.isCancelled(); i++){
+            (*function)(i);
+        }
+    }
+    catch(...){
+        group->finish(boost::current_exception());
+        return;
+    }
+
+    group->finish();
+}
+
+// Storage for the results of parallel_map() while the calls are
+// running.
+template<typename T>
+struct MapResults
+{
+    typedef std::vector<T> storage_type;
+
+    static std::vector<T> take(storage_type &storage)
+    {
+        std::vector<T> results;
+        results.swap(storage);
+        return results;
+    }
+};
+
+// std::vector<bool> packs its values into shared words so concurrent
+// writes to neighboring values would race. bool results are stored as
+// chars and converted once every call has finished.
+template<>
+struct MapResults<bool>
+{
+    typedef std::vector<char> storage_type;
+
+    static std::vector<bool> take(storage_type &storage)
+    {
+        return std::vector<bool>(storage.begin(), storage.end());
+    }
+};
+
+template<typename Input, typename Function>
+class MapFunction
+{
+public:
+    typedef void result_type;
+    typedef typename MapResults<typename Function::result_type>::storage_type storage_type;
+
+    MapFunction(const std::vector<Input> &input,
+                const Function &function,
+                storage_type &output)
+        : m_input(input),
+          m_function(function),
+          m_output(output)
+    {
+    }
+
+    void operator()(size_t index) const
+    {
+        m_output[index] = m_function(m_input[index]);
+    }
+
+private:
+    const std::vector<Input> &m_input;
+    const Function &m_function;
+    storage_type &m_output;
+};
+
+} // end detail namespace
+
+/// Runs \p function asynchronously on the global thread pool.
+/// Returns a future containing the value returned from \p function.
+///
+/// If \p token is cancelled before \p function starts then it is
+/// not run and waiting on the future throws a CancelledError. If it
+/// is cancelled while \p function is running then the result is
+/// discarded and waiting on the future also throws a CancelledError.
+///
+/// Waiting for the future of a task which has not started yet runs
+/// the task in the waiting thread. This allows tasks running on the
+/// pool to wait for the results of other tasks without deadlocking.
+///
+/// \see ThreadPool::globalInstance()
 ///
 /// \internal
 template<typename Function>
-inline boost::shared_future<typename Function::result_type> run(const Function &function)
+inline boost::shared_future<typename Function::result_type>
+run(const Function &function, const CancellationToken &token = CancellationToken())
 {
     typedef typename Function::result_type result_type;
 
-    boost::packaged_task<result_type> task(function);
-    boost::shared_future<result_type> future(task.get_future());
+    boost::shared_ptr<boost::packaged_task<result_type> > task =
+        boost::make_shared<boost::packaged_task<result_type> >(
+            detail::CancellableFunction<Function>(function, token));
+    task->set_wait_callback(&detail::runWaitedForTask<result_type>);
+    boost::shared_future<result_type> future(task->get_future());
 
-    // execute task in detached thread
-    boost::thread(boost::move(task)).detach();
+    ThreadPool::globalInstance()->start(
+        boost::bind(&detail::runPackagedTask<result_type>, task));
 
     return future;
 }
 
+/// Calls \p function for each index in the range [\p begin, \p end)
+/// using the global thread pool and returns once every call has
+/// finished. The calling thread also executes part of the range.
+///
+/// If \p token is cancelled the remaining indices are skipped and a
+/// CancelledError is thrown. If \p function throws an exception the
+/// first one is rethrown after the other calls have finished.
+///
+/// \internal
+template<typename Function>
+inline void parallel_for(size_t begin,
+                         size_t end,
+                         const Function &function,
+                         const CancellationToken &token = CancellationToken())
+{
+    if(end <= begin){
+        return;
+    }
+
+    ThreadPool *pool = ThreadPool::globalInstance();
+
+    // split the range into a few chunks per thread so that idle
+    // threads can steal work from busy ones
+    size_t count = end - begin;
+    size_t chunkCount = std::min(count, 4 * (pool->threadCount() + 1));
+    size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    detail::TaskGroup group(chunkCount);
+
+    for(size_t chunk = 1; chunk < chunkCount; chunk++){
+        size_t chunkBegin = begin + chunk * chunkSize;
+        size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+
+        pool->start(boost::bind(&detail::runRange<Function>,
+                                &function,
+                                chunkBegin,
+                                chunkEnd,
+                                token,
+                                &group));
+    }
+
+    // run the first chunk in the calling thread
+    detail::runRange(&function, begin, std::min(end, begin + chunkSize), token, &group);
+
+    group.wait(pool);
+
+    if(token.isCancelled()){
+        boost::throw_exception(CancelledError());
+    }
+}
+
+/// Calls \p function for each item in \p input using the global
+/// thread pool and returns a vector containing the results in the
+/// same order.
+///
+/// \see parallel_for()
+///
+/// \internal
+template<typename Input, typename Function>
+inline std::vector<typename Function::result_type>
+parallel_map(const std::vector<Input> &input,
+             const Function &function,
+             const CancellationToken &token = CancellationToken())
+{
+    typedef detail::MapResults<typename Function::result_type> MapResults;
+
+    typename MapResults::storage_type output(input.size());
+
+    parallel_for(0,
+                 input.size(),
+                 detail::MapFunction<Input, Function>(input, function, output),
+                 token);
+
+    return MapResults::take(output);
+}
+
 } // end concurrent namespace
 } // end chemkit namespace
 
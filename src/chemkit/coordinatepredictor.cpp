@@ -39,6 +39,7 @@
 #include "foreach.h"
 #include "molecule.h"
 #include "concurrent.h"
+#include "spatialindex.h"
 
 namespace chemkit {
 
@@ -133,26 +134,27 @@ bool CoordinatePredictor::eliminateCloseContacts(Molecule *molecule, Real distan
     bool done = false;
     bool modified = false;
 
+    SpatialIndex index(molecule);
+
     while(!done){
         done = true;
 
-        for(size_t i = 0; i < molecule->size(); i++){
-            Atom *a = molecule->atom(i);
-
-            for(size_t j = i + 1; j < molecule->size(); j++){
-                Atom *b = molecule->atom(j);
+        foreach(const SpatialIndex::Pair &pair, index.pairs(distance)){
+            // skip pairs separated by an earlier move
+            if(index.distance(pair.first, pair.second) >= distance){
+                continue;
+            }
 
-                if(a->distance(b) < distance){
-                    done = false;
+            done = false;
 
-                    // move atom b by a random unit vector
-                    b->setPosition(b->position() +
-                                   distance * Vector3::Random().normalized());
+            // move atom b by a random unit vector
+            Atom *b = molecule->atom(pair.second);
+            b->setPosition(b->position() +
+                           distance * Vector3::Random().normalized());
+            index.setPosition(pair.second, b->position());
 
-                    // set modified flag
-                    modified = true;
-                }
-            }
+            // set modified flag
+            modified = true;
         }
     }
 
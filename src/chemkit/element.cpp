@@ -35,6 +35,9 @@
 
 #include "element.h"
 
+#include <cstring>
+#include <algorithm>
+
 #include "atom.h"
 
 namespace chemkit {
@@ -183,6 +186,166 @@ const struct ElementData ElementData[] = {
 
 const Element::AtomicNumberType ElementDataSize = sizeof(ElementData) / sizeof(*ElementData);
 
+// --- Element Lookup ------------------------------------------------------ //
+// Element symbols have at most three letters so each symbol maps
+// directly to a slot in a table indexed by its letters. Names are
+// found with a small open addressing hash table. Both tables ignore
+// case, the case of the letters is checked after the lookup when it
+// matters.
+
+const size_t SymbolTableSize = 26 * 27 * 27;
+const size_t NameTableSize = 512;
+
+// Returns the position of c in the alphabet starting at one or zero
+// if c is not a letter.
+inline size_t letterIndex(char c)
+{
+    char lower = c | 0x20;
+
+    return lower >= 'a' && lower <= 'z' ? lower - 'a' + 1 : 0;
+}
+
+inline bool isLowerCase(char c)
+{
+    return c >= 'a' && c <= 'z';
+}
+
+inline bool isUpperCase(char c)
+{
+    return c >= 'A' && c <= 'Z';
+}
+
+class ElementLookupTable
+{
+public:
+    ElementLookupTable();
+
+    Element::AtomicNumberType symbol(const char *symbol, size_t length, bool caseSensitive) const;
+    Element::AtomicNumberType name(const char *name, size_t length, bool caseSensitive) const;
+
+    static const ElementLookupTable& instance();
+
+private:
+    static size_t symbolSlot(const char *symbol, size_t length);
+    static size_t nameHash(const char *name, size_t length);
+
+private:
+    Element::AtomicNumberType m_symbols[SymbolTableSize];
+    Element::AtomicNumberType m_names[NameTableSize];
+};
+
+ElementLookupTable::ElementLookupTable()
+{
+    std::fill(m_symbols, m_symbols + SymbolTableSize, 0);
+    std::fill(m_names, m_names + NameTableSize, 0);
+
+    for(Element::AtomicNumberType i = 1; i < ElementDataSize; i++){
+        const char *symbol = ElementData[i].symbol;
+        m_symbols[symbolSlot(symbol, strlen(symbol))] = i;
+
+        const char *name = ElementData[i].name;
+        size_t slot = nameHash(name, strlen(name));
+        while(m_names[slot]){
+            slot = (slot + 1) % NameTableSize;
+        }
+        m_names[slot] = i;
+    }
+}
+
+// Returns the atomic number for the element with symbol or zero if
+// there is no such element.
+Element::AtomicNumberType ElementLookupTable::symbol(const char *symbol, size_t length, bool caseSensitive) const
+{
+    size_t slot = symbolSlot(symbol, length);
+    if(slot == size_t(-1)){
+        return 0;
+    }
+
+    if(caseSensitive){
+        if(!isUpperCase(symbol[0])){
+            return 0;
+        }
+
+        for(size_t i = 1; i < length; i++){
+            if(!isLowerCase(symbol[i])){
+                return 0;
+            }
+        }
+    }
+
+    return m_symbols[slot];
+}
+
+// Returns the atomic number for the element with name or zero if
+// there is no such element.
+Element::AtomicNumberType ElementLookupTable::name(const char *name, size_t length, bool caseSensitive) const
+{
+    for(size_t slot = nameHash(name, length); m_names[slot]; slot = (slot + 1) % NameTableSize){
+        const char *elementName = ElementData[m_names[slot]].name;
+
+        if(caseSensitive){
+            if(strncmp(name, elementName, length) == 0 && elementName[length] == '\0'){
+                return m_names[slot];
+            }
+
+            continue;
+        }
+
+        size_t i = 0;
+        while(i < length && elementName[i] && (name[i] | 0x20) == (elementName[i] | 0x20)){
+            i++;
+        }
+
+        if(i == length && elementName[length] == '\0'){
+            return m_names[slot];
+        }
+    }
+
+    return 0;
+}
+
+// Returns the lookup table. It is created the first time it is used.
+const ElementLookupTable& ElementLookupTable::instance()
+{
+    static const ElementLookupTable table;
+
+    return table;
+}
+
+// Returns the index of the slot in the symbol table for symbol or -1
+// if symbol is not made of one to three letters.
+size_t ElementLookupTable::symbolSlot(const char *symbol, size_t length)
+{
+    if(length < 1 || length > 3){
+        return size_t(-1);
+    }
+
+    size_t letters[3] = { 0, 0, 0 };
+    for(size_t i = 0; i < length; i++){
+        letters[i] = letterIndex(symbol[i]);
+
+        if(!letters[i]){
+            return size_t(-1);
+        }
+    }
+
+    return (letters[0] - 1) * 27 * 27 + letters[1] * 27 + letters[2];
+}
+
+// Returns the FNV-1a hash of the lower case letters in name reduced
+// to the size of the name table.
+size_t ElementLookupTable::nameHash(const char *name, size_t length)
+{
+    unsigned int hash = 2166136261u;
+
+    for(size_t i = 0; i < length; i++){
+        hash ^= static_cast<unsigned char>(name[i] | 0x20);
+        hash *= 16777619u;
+    }
+
+    return hash % NameTableSize;
+}
+
 } // end anonymous namespace
 
 // === Element ============================================================= //
@@ -200,28 +363,14 @@ const Element::AtomicNumberType ElementDataSize = sizeof(ElementData) / sizeof(*
 /// valid the atomic number is set to \c 0.
 Element::Element(const char *symbol)
 {
-    m_atomicNumber = 0;
-
-    for(int i = 1; i < ElementDataSize; i++){
-        if(!strcmp(symbol, ElementData[i].symbol)){
-            m_atomicNumber = i;
-            break;
-        }
-    }
+    m_atomicNumber = ElementLookupTable::instance().symbol(symbol, strlen(symbol), true);
 }
 
 /// Creates a new element with the given symbol. If the symbol is not
 /// valid the atomic number is set to \c 0.
 Element::Element(const std::string &symbol)
 {
-    m_atomicNumber = 0;
-
-    for(int i = 1; i < ElementDataSize; i++){
-        if(!symbol.compare(ElementData[i].symbol)){
-            m_atomicNumber = i;
-            break;
-        }
-    }
+    m_atomicNumber = ElementLookupTable::instance().symbol(symbol.c_str(), symbol.length(), true);
 }
 
 // --- Properties ---------------------------------------------------------- //
@@ -424,19 +573,20 @@ bool Element::isNonmetal() const
 /// Returns the element corresponding to \p name.
 Element Element::fromName(const std::string &name)
 {
-    return fromName(name.c_str());
+    return Element(ElementLookupTable::instance().name(name.c_str(), name.length(), true));
 }
 
 /// Returns the element corresponding to \p name.
 Element Element::fromName(const char *name)
 {
-    for(AtomicNumberType i = 1; i < ElementDataSize; i++){
-        if(!strcmp(name, ElementData[i].name)){
-            return Element(i);
-        }
-    }
+    return Element(ElementLookupTable::instance().name(name, strlen(name), true));
+}
 
-    return Element();
+/// Returns the element corresponding to \p name ignoring the case of
+/// its letters (e.g. "carbon" or "CARBON").
+Element Element::fromNameCaseInsensitive(const std::string &name)
+{
+    return Element(ElementLookupTable::instance().name(name.c_str(), name.length(), false));
 }
 
 /// Returns the element corresponding to \p symbol.
@@ -454,14 +604,22 @@ Element Element::fromSymbol(const char *symbol)
 /// Returns the element corresponding to \p symbol with \p length.
 Element Element::fromSymbol(const char *symbol, size_t length)
 {
-    for(AtomicNumberType i = 1; i < ElementDataSize; i++){
-        if(strlen(ElementData[i].symbol) == length &&
-           strncmp(symbol, ElementData[i].symbol, length) == 0){
-            return Element(i);
-        }
-    }
+    return Element(ElementLookupTable::instance().symbol(symbol, length, true));
+}
 
-    return Element();
+/// Returns the element corresponding to \p symbol ignoring the case
+/// of its letters. This is useful for formats which store symbols in
+/// upper case (e.g. "CL" for chlorine in PDB files).
+Element Element::fromSymbolCaseInsensitive(const std::string &symbol)
+{
+    return fromSymbolCaseInsensitive(symbol.c_str(), symbol.length());
+}
+
+/// Returns the element corresponding to \p symbol with \p length
+/// ignoring the case of its letters.
+Element Element::fromSymbolCaseInsensitive(const char *symbol, size_t length)
+{
+    return Element(ElementLookupTable::instance().symbol(symbol, length, false));
 }
 
 /// Returns the element corresponding to \p symbol.
@@ -80,10 +80,13 @@ public:
     // static methods
     static Element fromName(const std::string &name);
     static Element fromName(const char *name);
+    static Element fromNameCaseInsensitive(const std::string &name);
     static Element fromSymbol(const std::string &symbol);
     static Element fromSymbol(const char *symbol);
     static Element fromSymbol(const char *symbol, size_t length);
     static Element fromSymbol(char symbol);
+    static Element fromSymbolCaseInsensitive(const std::string &symbol);
+    static Element fromSymbolCaseInsensitive(const char *symbol, size_t length);
     static bool isValidAtomicNumber(AtomicNumberType atomicNumber);
     static bool isValidSymbol(const std::string &symbol);
 
@@ -35,6 +35,9 @@
 
 #include "fingerprint.h"
 
+#include <cmath>
+#include <algorithm>
+
 #include "molecule.h"
 #include "pluginmanager.h"
 
@@ -74,7 +77,18 @@ namespace chemkit {
 /// Bitset fingerprint = uracil.fingerprint("fp2");
 /// \endcode
 ///
-/// \see Bitset, Molecule::fingerprint()
+/// Fingerprints can also be calculated as a PackedFingerprint with
+/// the packedValue() method. The similarity of packed fingerprints
+/// is computed directly from their words without any temporary
+/// bitsets:
+/// \code
+/// PackedFingerprint a = fp2->packedValue(&uracil);
+/// PackedFingerprint b = fp2->packedValue(&thymine);
+///
+/// Real similarity = Fingerprint::tanimotoCoefficient(a, b);
+/// \endcode
+///
+/// \see Bitset, PackedFingerprint, Molecule::fingerprint()
 
 // --- Construction and Destruction ---------------------------------------- //
 /// Creates a new fingerprint with \p name.
@@ -115,6 +129,16 @@ Bitset Fingerprint::value(const Molecule *molecule) const
     return Bitset();
 }
 
+/// Returns the fingerprint value as a packed fingerprint.
+///
+/// The default implementation packs the bitset returned from
+/// value(). Fingerprints should reimplement this method to set the
+/// bits in the packed fingerprint directly.
+PackedFingerprint Fingerprint::packedValue(const Molecule *molecule) const
+{
+    return PackedFingerprint(value(molecule));
+}
+
 // --- Similarity ---------------------------------------------------------- //
 /// Returns the tanimoto coefficent between \p a and \p b.
 Real Fingerprint::tanimotoCoefficient(const Bitset &a, const Bitset &b)
@@ -124,6 +148,74 @@ Real Fingerprint::tanimotoCoefficient(const Bitset &a, const Bitset &b)
     return Real(intersection) / Real(a.count() + b.count() - intersection);
 }
 
+/// Returns the tanimoto coefficent between \p a and \p b. Returns
+/// \c 0 if neither fingerprint has any bits set.
+Real Fingerprint::tanimotoCoefficient(const PackedFingerprint &a, const PackedFingerprint &b)
+{
+    size_t wordCount = std::min(a.wordCount(), b.wordCount());
+    size_t intersection = PackedFingerprint::intersectionCount(a.words(), b.words(), wordCount);
+    size_t total = a.count() + b.count() - intersection;
+
+    if(total == 0){
+        return 0;
+    }
+
+    return Real(intersection) / Real(total);
+}
+
+/// Returns the dice coefficient between \p a and \p b. Returns
+/// \c 0 if neither fingerprint has any bits set.
+Real Fingerprint::diceCoefficient(const PackedFingerprint &a, const PackedFingerprint &b)
+{
+    size_t wordCount = std::min(a.wordCount(), b.wordCount());
+    size_t intersection = PackedFingerprint::intersectionCount(a.words(), b.words(), wordCount);
+    size_t total = a.count() + b.count();
+
+    if(total == 0){
+        return 0;
+    }
+
+    return Real(2 * intersection) / Real(total);
+}
+
+/// Returns the cosine coefficient between \p a and \p b. Returns
+/// \c 0 if either fingerprint has no bits set.
+Real Fingerprint::cosineCoefficient(const PackedFingerprint &a, const PackedFingerprint &b)
+{
+    size_t wordCount = std::min(a.wordCount(), b.wordCount());
+    size_t intersection = PackedFingerprint::intersectionCount(a.words(), b.words(), wordCount);
+    size_t countA = a.count();
+    size_t countB = b.count();
+
+    if(countA == 0 || countB == 0){
+        return 0;
+    }
+
+    return Real(intersection) / std::sqrt(Real(countA) * Real(countB));
+}
+
+/// Returns the tversky index of \p a with respect to \p b. The
+/// bits only set in \p a are weighted by \p alpha and the bits only
+/// set in \p b are weighted by \p beta. With both weights set to
+/// \c 1 this is the tanimoto coefficient and with both set to
+/// \c 0.5 this is the dice coefficient. Returns \c 0 if the
+/// denominator is zero.
+Real Fingerprint::tverskyIndex(const PackedFingerprint &a, const PackedFingerprint &b, Real alpha, Real beta)
+{
+    size_t wordCount = std::min(a.wordCount(), b.wordCount());
+    size_t intersection = PackedFingerprint::intersectionCount(a.words(), b.words(), wordCount);
+
+    Real denominator = intersection +
+                       alpha * (a.count() - intersection) +
+                       beta * (b.count() - intersection);
+
+    if(denominator == 0){
+        return 0;
+    }
+
+    return Real(intersection) / denominator;
+}
+
 // --- Static Methods ------------------------------------------------------ //
 /// Creates a new fingerprint object for \p name. Returns \c 0 if
 /// \p name is not supported.
@@ -43,6 +43,7 @@
 
 #include "bitset.h"
 #include "plugin.h"
+#include "packedfingerprint.h"
 
 namespace chemkit {
 
@@ -60,9 +61,14 @@ public:
 
     // fingerprint
     virtual Bitset value(const Molecule *molecule) const;
+    virtual PackedFingerprint packedValue(const Molecule *molecule) const;
 
     // similarity
     static Real tanimotoCoefficient(const Bitset &a, const Bitset &b);
+    static Real tanimotoCoefficient(const PackedFingerprint &a, const PackedFingerprint &b);
+    static Real diceCoefficient(const PackedFingerprint &a, const PackedFingerprint &b);
+    static Real cosineCoefficient(const PackedFingerprint &a, const PackedFingerprint &b);
+    static Real tverskyIndex(const PackedFingerprint &a, const PackedFingerprint &b, Real alpha, Real beta);
 
     // static methods
     static Fingerprint* create(const std::string &name);
@@ -0,0 +1,706 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fingerprintdatabase.h"
+
+#include <cmath>
+#include <queue>
+#include <algorithm>
+
+#include "molecule.h"
+#include "concurrent.h"
+#include "fingerprint.h"
+
+namespace chemkit {
+
+// === FingerprintDatabasePrivate ========================================== //
+class FingerprintDatabasePrivate
+{
+public:
+    // The fingerprints with each popcount are stored contiguously in
+    // a bucket along with their indices in the database.
+    struct Bucket
+    {
+        std::vector<PackedFingerprint::Word> words;
+        std::vector<boost::uint64_t> indices;
+    };
+
+    size_t size() const;
+    size_t bucketSize(size_t count) const;
+    const PackedFingerprint::Word* bucketWords(size_t count) const;
+    const boost::uint64_t* bucketIndices(size_t count) const;
+    const PackedFingerprint::Word* fingerprintWords(size_t index) const;
+    std::string identifier(size_t index) const;
+    void detach();
+
+    Fingerprint *fingerprint;
+    size_t fingerprintSize;
+    size_t wordCount;
+    std::vector<Bucket> buckets;
+    std::vector<std::pair<size_t, size_t> > locations;
+    std::vector<std::string> identifiers;
+    bool external;
+    FingerprintDatabase::ExternalStorage storage;
+};
+
+size_t FingerprintDatabasePrivate::size() const
+{
+    return external ? storage.size : locations.size();
+}
+
+// Returns the number of fingerprints with count bits set.
+size_t FingerprintDatabasePrivate::bucketSize(size_t count) const
+{
+    if(external){
+        return storage.bucketOffsets[count + 1] - storage.bucketOffsets[count];
+    }
+
+    return buckets[count].indices.size();
+}
+
+// Returns the words for the fingerprints with count bits set. The
+// bucket must not be empty.
+const PackedFingerprint::Word* FingerprintDatabasePrivate::bucketWords(size_t count) const
+{
+    if(external){
+        return storage.words + storage.bucketOffsets[count] * wordCount;
+    }
+
+    return &buckets[count].words[0];
+}
+
+// Returns the database indices of the fingerprints with count bits
+// set. The bucket must not be empty.
+const boost::uint64_t* FingerprintDatabasePrivate::bucketIndices(size_t count) const
+{
+    if(external){
+        return storage.indices + storage.bucketOffsets[count];
+    }
+
+    return &buckets[count].indices[0];
+}
+
+// Returns the words for the fingerprint at index.
+const PackedFingerprint::Word* FingerprintDatabasePrivate::fingerprintWords(size_t index) const
+{
+    if(external){
+        return storage.words + storage.positions[index] * wordCount;
+    }
+
+    const std::pair<size_t, size_t> &location = locations[index];
+
+    return &buckets[location.first].words[location.second * wordCount];
+}
+
+std::string FingerprintDatabasePrivate::identifier(size_t index) const
+{
+    if(external){
+        return std::string(storage.identifiers + storage.identifierOffsets[index],
+                           storage.identifiers + storage.identifierOffsets[index + 1]);
+    }
+
+    return identifiers[index];
+}
+
+// Copies the fingerprints from the external storage into the
+// buckets so that they can be modified.
+void FingerprintDatabasePrivate::detach()
+{
+    if(!external){
+        return;
+    }
+
+    buckets.assign(fingerprintSize + 1, Bucket());
+    locations.resize(storage.size);
+    identifiers.resize(storage.size);
+
+    for(size_t count = 0; count <= fingerprintSize; count++){
+        size_t size = bucketSize(count);
+        if(!size){
+            continue;
+        }
+
+        Bucket &bucket = buckets[count];
+        bucket.words.assign(bucketWords(count), bucketWords(count) + size * wordCount);
+        bucket.indices.assign(bucketIndices(count), bucketIndices(count) + size);
+
+        for(size_t i = 0; i < size; i++){
+            locations[bucket.indices[i]] = std::make_pair(count, i);
+        }
+    }
+
+    for(size_t i = 0; i < storage.size; i++){
+        identifiers[i] = identifier(i);
+    }
+
+    external = false;
+    storage = FingerprintDatabase::ExternalStorage();
+}
+
+namespace {
+
+typedef FingerprintDatabase::Hit Hit;
+
+// queries with at least this many fingerprints are searched in parallel
+const size_t ParallelSearchThreshold = 4;
+
+// Returns true if hit a should be ranked before hit b. Hits are
+// ranked by decreasing similarity and then by increasing index.
+inline bool compareHits(const Hit &a, const Hit &b)
+{
+    if(a.second != b.second){
+        return a.second > b.second;
+    }
+
+    return a.first < b.first;
+}
+
+inline Real tanimoto(size_t a, size_t b, size_t intersection)
+{
+    size_t total = a + b - intersection;
+
+    return total ? Real(intersection) / Real(total) : Real(0);
+}
+
+// Returns the largest tanimoto coefficient possible between
+// fingerprints with a and b bits set (Swamidass and Baldi).
+inline Real tanimotoBound(size_t a, size_t b)
+{
+    if(a == 0 || b == 0){
+        return 0;
+    }
+
+    return Real(std::min(a, b)) / Real(std::max(a, b));
+}
+
+// Searches the buckets for fingerprints within the threshold of
+// query. Only the buckets with popcounts between threshold * a and
+// a / threshold can contain matches. Queries with a different size
+// than the fingerprints in the database have no hits.
+void searchThreshold(const FingerprintDatabasePrivate *d,
+                     const PackedFingerprint &query,
+                     Real threshold,
+                     std::vector<Hit> &hits)
+{
+    if(d->wordCount == 0 || query.size() != d->fingerprintSize){
+        return;
+    }
+
+    const size_t wordCount = d->wordCount;
+    const size_t a = query.count();
+    const size_t last = d->fingerprintSize;
+
+    size_t lower = 0;
+    if(threshold * a >= last){
+        lower = last;
+    }
+    else if(threshold > 0){
+        lower = size_t(std::floor(threshold * a));
+    }
+
+    size_t upper = last;
+    if(threshold > 0 && a / threshold < last){
+        upper = size_t(std::ceil(a / threshold));
+    }
+
+    for(size_t b = lower; b <= upper; b++){
+        size_t size = d->bucketSize(b);
+        if(!size){
+            continue;
+        }
+
+        const PackedFingerprint::Word *words = d->bucketWords(b);
+        const boost::uint64_t *indices = d->bucketIndices(b);
+
+        for(size_t i = 0; i < size; i++){
+            size_t intersection =
+                PackedFingerprint::intersectionCount(query.words(), words + i * d->wordCount, wordCount);
+
+            Real similarity = tanimoto(a, b, intersection);
+            if(similarity >= threshold){
+                hits.push_back(Hit(indices[i], similarity));
+            }
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), compareHits);
+}
+
+// Searches the buckets in order of decreasing similarity bound for
+// the k fingerprints most similar to query. The search stops once
+// the bound for the remaining buckets is below the kth best hit.
+// Queries with a different size than the fingerprints in the
+// database have no hits.
+void searchNearest(const FingerprintDatabasePrivate *d,
+                   const PackedFingerprint &query,
+                   size_t k,
+                   std::vector<Hit> &hits)
+{
+    if(k == 0 || d->wordCount == 0 || query.size() != d->fingerprintSize){
+        return;
+    }
+
+    const size_t wordCount = d->wordCount;
+    const size_t a = query.count();
+
+    std::vector<std::pair<Real, size_t> > order;
+    for(size_t b = 0; b <= d->fingerprintSize; b++){
+        if(d->bucketSize(b)){
+            order.push_back(std::make_pair(-tanimotoBound(a, b), b));
+        }
+    }
+    std::sort(order.begin(), order.end());
+
+    // the worst hit found so far is at the top of the heap
+    std::priority_queue<Hit, std::vector<Hit>, bool (*)(const Hit &, const Hit &)> heap(compareHits);
+
+    for(size_t j = 0; j < order.size(); j++){
+        if(heap.size() == k && -order[j].first < heap.top().second){
+            break;
+        }
+
+        size_t b = order[j].second;
+        size_t size = d->bucketSize(b);
+        const PackedFingerprint::Word *words = d->bucketWords(b);
+        const boost::uint64_t *indices = d->bucketIndices(b);
+
+        for(size_t i = 0; i < size; i++){
+            size_t intersection =
+                PackedFingerprint::intersectionCount(query.words(), words + i * d->wordCount, wordCount);
+
+            Hit hit(indices[i], tanimoto(a, b, intersection));
+
+            if(heap.size() < k){
+                heap.push(hit);
+            }
+            else if(compareHits(hit, heap.top())){
+                heap.pop();
+                heap.push(hit);
+            }
+        }
+    }
+
+    hits.resize(heap.size());
+    for(size_t i = hits.size(); i > 0; i--){
+        hits[i - 1] = heap.top();
+        heap.pop();
+    }
+}
+
+// Runs a threshold search for each query. Each call writes to a
+// different result so the queries can be searched concurrently.
+class ThresholdSearch
+{
+public:
+    ThresholdSearch(const FingerprintDatabasePrivate *d,
+                    const std::vector<PackedFingerprint> &queries,
+                    Real threshold,
+                    std::vector<std::vector<Hit> > &results)
+        : m_d(d),
+          m_queries(queries),
+          m_threshold(threshold),
+          m_results(results)
+    {
+    }
+
+    void operator()(size_t index) const
+    {
+        searchThreshold(m_d, m_queries[index], m_threshold, m_results[index]);
+    }
+
+private:
+    const FingerprintDatabasePrivate *m_d;
+    const std::vector<PackedFingerprint> &m_queries;
+    Real m_threshold;
+    std::vector<std::vector<Hit> > &m_results;
+};
+
+// Runs a nearest neighbor search for each query.
+class NearestSearch
+{
+public:
+    NearestSearch(const FingerprintDatabasePrivate *d,
+                  const std::vector<PackedFingerprint> &queries,
+                  size_t k,
+                  std::vector<std::vector<Hit> > &results)
+        : m_d(d),
+          m_queries(queries),
+          m_k(k),
+          m_results(results)
+    {
+    }
+
+    void operator()(size_t index) const
+    {
+        searchNearest(m_d, m_queries[index], m_k, m_results[index]);
+    }
+
+private:
+    const FingerprintDatabasePrivate *m_d;
+    const std::vector<PackedFingerprint> &m_queries;
+    size_t m_k;
+    std::vector<std::vector<Hit> > &m_results;
+};
+
+template<typename Search>
+void searchAll(const Search &search, size_t count)
+{
+    if(count >= ParallelSearchThreshold){
+        concurrent::parallel_for(0, count, search);
+    }
+    else{
+        for(size_t i = 0; i < count; i++){
+            search(i);
+        }
+    }
+}
+
+} // end anonymous namespace
+
+// === FingerprintDatabase ================================================= //
+/// \class FingerprintDatabase fingerprintdatabase.h chemkit/fingerprintdatabase.h
+/// \ingroup chemkit
+/// \brief The FingerprintDatabase class provides similarity search
+///        over a collection of fingerprints.
+///
+/// The fingerprints are stored contiguously in buckets by the number
+/// of bits they have set. The tanimoto coefficient between
+/// fingerprints with \c a and \c b bits set can be at most
+/// min(a, b) / max(a, b) so searches skip the buckets which cannot
+/// contain a match without comparing any of their fingerprints.
+///
+/// The following example shows how to find the ten molecules in a
+/// database most similar to a query molecule:
+/// \code
+/// FingerprintDatabase database("fp2");
+///
+/// foreach(const Molecule *molecule, molecules){
+///     database.addMolecule(molecule);
+/// }
+///
+/// Fingerprint *fp2 = Fingerprint::create("fp2");
+/// std::vector<FingerprintDatabase::Hit> hits =
+///     database.nearestNeighbors(fp2->packedValue(&query), 10);
+/// delete fp2;
+/// \endcode
+///
+/// Fingerprint databases can be written to and read from files
+/// with the FingerprintFile class.
+///
+/// \see Fingerprint, PackedFingerprint
+
+/// \class FingerprintDatabase::ExternalStorage fingerprintdatabase.h chemkit/fingerprintdatabase.h
+/// \brief The ExternalStorage struct describes fingerprints stored
+///        outside of the database.
+///
+/// \see FingerprintDatabase::setExternalStorage()
+
+/// \typedef FingerprintDatabase::Hit
+/// A search result containing the index of the fingerprint in the
+/// database and its tanimoto coefficient to the query.
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty fingerprint database.
+FingerprintDatabase::FingerprintDatabase()
+    : d(new FingerprintDatabasePrivate)
+{
+    d->fingerprint = 0;
+    d->fingerprintSize = 0;
+    d->wordCount = 0;
+    d->external = false;
+}
+
+/// Creates a new, empty fingerprint database for molecules using
+/// the \p fingerprint.
+FingerprintDatabase::FingerprintDatabase(const std::string &fingerprint)
+    : d(new FingerprintDatabasePrivate)
+{
+    d->fingerprint = 0;
+    d->fingerprintSize = 0;
+    d->wordCount = 0;
+    d->external = false;
+
+    setFingerprint(fingerprint);
+}
+
+/// Destroys the fingerprint database.
+FingerprintDatabase::~FingerprintDatabase()
+{
+    delete d->fingerprint;
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of fingerprints in the database.
+size_t FingerprintDatabase::size() const
+{
+    return d->size();
+}
+
+/// Returns \c true if the database contains no fingerprints.
+bool FingerprintDatabase::isEmpty() const
+{
+    return size() == 0;
+}
+
+/// Sets the fingerprint used by addMolecule() to \p name. If the
+/// database is empty its fingerprint size is set to the size of
+/// the fingerprint.
+void FingerprintDatabase::setFingerprint(const std::string &name)
+{
+    delete d->fingerprint;
+    d->fingerprint = Fingerprint::create(name);
+
+    if(d->fingerprint && isEmpty()){
+        setFingerprintSize(d->fingerprint->size());
+    }
+}
+
+/// Returns the name of the fingerprint used by addMolecule().
+std::string FingerprintDatabase::fingerprint() const
+{
+    if(d->fingerprint){
+        return d->fingerprint->name();
+    }
+
+    return std::string();
+}
+
+/// Sets the number of bits in each fingerprint to \p size. Returns
+/// \c false if the database is not empty.
+bool FingerprintDatabase::setFingerprintSize(size_t size)
+{
+    if(!isEmpty()){
+        return false;
+    }
+
+    d->external = false;
+    d->storage = ExternalStorage();
+    d->fingerprintSize = size;
+    d->wordCount = PackedFingerprint::wordCount(size);
+    d->buckets.assign(size + 1, FingerprintDatabasePrivate::Bucket());
+
+    return true;
+}
+
+/// Returns the number of bits in each fingerprint.
+size_t FingerprintDatabase::fingerprintSize() const
+{
+    return d->fingerprintSize;
+}
+
+// --- Fingerprints -------------------------------------------------------- //
+/// Adds \p fingerprint to the database with \p identifier. If the
+/// database is empty and has no fingerprint size set, it is set to
+/// the size of \p fingerprint.
+///
+/// Returns \c false if the size of \p fingerprint is different from
+/// the fingerprint size of the database.
+bool FingerprintDatabase::addFingerprint(const PackedFingerprint &fingerprint,
+                                         const std::string &identifier)
+{
+    d->detach();
+
+    if(d->buckets.empty()){
+        setFingerprintSize(fingerprint.size());
+    }
+
+    if(fingerprint.size() != d->fingerprintSize){
+        return false;
+    }
+
+    size_t count = fingerprint.count();
+    FingerprintDatabasePrivate::Bucket &bucket = d->buckets[count];
+
+    d->locations.push_back(std::make_pair(count, bucket.indices.size()));
+    d->identifiers.push_back(identifier);
+
+    bucket.indices.push_back(d->locations.size() - 1);
+    bucket.words.insert(bucket.words.end(),
+                        fingerprint.words(),
+                        fingerprint.words() + d->wordCount);
+
+    return true;
+}
+
+/// Adds the fingerprint for \p molecule to the database using the
+/// molecule's name as its identifier.
+///
+/// Returns \c false if no fingerprint is set.
+///
+/// \see setFingerprint()
+bool FingerprintDatabase::addMolecule(const Molecule *molecule)
+{
+    if(!d->fingerprint){
+        return false;
+    }
+
+    return addFingerprint(d->fingerprint->packedValue(molecule), molecule->name());
+}
+
+/// Returns the fingerprint at \p index.
+PackedFingerprint FingerprintDatabase::fingerprint(size_t index) const
+{
+    const PackedFingerprint::Word *words = d->fingerprintWords(index);
+
+    PackedFingerprint fingerprint(d->fingerprintSize);
+    std::copy(words, words + d->wordCount, fingerprint.words());
+
+    return fingerprint;
+}
+
+/// Returns the identifier for the fingerprint at \p index.
+std::string FingerprintDatabase::identifier(size_t index) const
+{
+    return d->identifier(index);
+}
+
+/// Reserves space for \p size fingerprints.
+void FingerprintDatabase::reserve(size_t size)
+{
+    d->locations.reserve(size);
+    d->identifiers.reserve(size);
+}
+
+/// Removes all of the fingerprints from the database.
+void FingerprintDatabase::clear()
+{
+    if(d->external){
+        d->external = false;
+        d->storage = ExternalStorage();
+        d->buckets.resize(d->fingerprintSize + 1);
+    }
+
+    d->locations.clear();
+    d->identifiers.clear();
+    d->buckets.assign(d->buckets.size(), FingerprintDatabasePrivate::Bucket());
+}
+
+// --- Storage ------------------------------------------------------------- //
+/// Sets the database to use the fingerprints in \p storage. The
+/// fingerprints are searched in place without being copied. This
+/// allows a database to be used directly from a memory-mapped file.
+///
+/// The storage contains the words for each fingerprint ordered by
+/// their number of set bits. The fingerprints with \c n bits set
+/// are at the positions between \c bucketOffsets[n] and
+/// \c bucketOffsets[n+1]. The \c indices array contains the index
+/// of the fingerprint at each position and the \c positions array
+/// contains the position of the fingerprint with each index. The
+/// identifier for the fingerprint at index \c i is stored in
+/// \c identifiers between \c identifierOffsets[i] and
+/// \c identifierOffsets[i+1].
+///
+/// The \c owner is kept until the database no longer uses the
+/// storage. Adding a fingerprint to the database copies the
+/// fingerprints from the storage.
+void FingerprintDatabase::setExternalStorage(const ExternalStorage &storage)
+{
+    d->buckets.clear();
+    d->locations.clear();
+    d->identifiers.clear();
+
+    d->external = true;
+    d->storage = storage;
+    d->fingerprintSize = storage.fingerprintSize;
+    d->wordCount = PackedFingerprint::wordCount(storage.fingerprintSize);
+}
+
+/// Returns \c true if the database is using external storage.
+///
+/// \see setExternalStorage()
+bool FingerprintDatabase::hasExternalStorage() const
+{
+    return d->external;
+}
+
+// --- Search -------------------------------------------------------------- //
+/// Returns the fingerprints in the database with a tanimoto
+/// coefficient of at least \p threshold to \p query. The hits are
+/// sorted by decreasing similarity.
+///
+/// Returns an empty list if the size of \p query is different from
+/// the fingerprint size of the database.
+std::vector<FingerprintDatabase::Hit> FingerprintDatabase::search(const PackedFingerprint &query,
+                                                                  Real threshold) const
+{
+    std::vector<Hit> hits;
+    searchThreshold(d, query, threshold, hits);
+
+    return hits;
+}
+
+/// Returns the hits for each query in \p queries. The queries are
+/// searched concurrently using the global thread pool. Queries with
+/// a different size than the fingerprint size of the database have
+/// no hits.
+std::vector<std::vector<FingerprintDatabase::Hit> >
+FingerprintDatabase::search(const std::vector<PackedFingerprint> &queries, Real threshold) const
+{
+    std::vector<std::vector<Hit> > results(queries.size());
+    searchAll(ThresholdSearch(d, queries, threshold, results), queries.size());
+
+    return results;
+}
+
+/// Returns the \p k fingerprints in the database with the largest
+/// tanimoto coefficients to \p query. The hits are sorted by
+/// decreasing similarity.
+///
+/// Returns an empty list if the size of \p query is different from
+/// the fingerprint size of the database.
+std::vector<FingerprintDatabase::Hit> FingerprintDatabase::nearestNeighbors(const PackedFingerprint &query,
+                                                                            size_t k) const
+{
+    std::vector<Hit> hits;
+    searchNearest(d, query, k, hits);
+
+    return hits;
+}
+
+/// Returns the \p k nearest neighbors for each query in \p queries.
+/// The queries are searched concurrently using the global thread
+/// pool. Queries with a different size than the fingerprint size of
+/// the database have no hits.
+std::vector<std::vector<FingerprintDatabase::Hit> >
+FingerprintDatabase::nearestNeighbors(const std::vector<PackedFingerprint> &queries, size_t k) const
+{
+    std::vector<std::vector<Hit> > results(queries.size());
+    searchAll(NearestSearch(d, queries, k, results), queries.size());
+
+    return results;
+}
+
+} // end chemkit namespace
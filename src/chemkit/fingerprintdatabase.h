@@ -0,0 +1,116 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_FINGERPRINTDATABASE_H
+#define CHEMKIT_FINGERPRINTDATABASE_H
+
+#include "chemkit.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#endif
+
+#include "packedfingerprint.h"
+
+namespace chemkit {
+
+class Molecule;
+class FingerprintDatabasePrivate;
+
+class CHEMKIT_EXPORT FingerprintDatabase
+{
+public:
+    // typedefs
+    typedef std::pair<size_t, Real> Hit;
+
+    // storage
+    struct ExternalStorage
+    {
+        size_t size;
+        size_t fingerprintSize;
+        const PackedFingerprint::Word *words;
+        const boost::uint64_t *bucketOffsets;
+        const boost::uint64_t *indices;
+        const boost::uint64_t *positions;
+        const boost::uint64_t *identifierOffsets;
+        const char *identifiers;
+        boost::shared_ptr<const void> owner;
+    };
+
+    // construction and destruction
+    FingerprintDatabase();
+    FingerprintDatabase(const std::string &fingerprint);
+    ~FingerprintDatabase();
+
+    // properties
+    size_t size() const;
+    bool isEmpty() const;
+    void setFingerprint(const std::string &name);
+    std::string fingerprint() const;
+    bool setFingerprintSize(size_t size);
+    size_t fingerprintSize() const;
+
+    // fingerprints
+    bool addFingerprint(const PackedFingerprint &fingerprint, const std::string &identifier = std::string());
+    bool addMolecule(const Molecule *molecule);
+    PackedFingerprint fingerprint(size_t index) const;
+    std::string identifier(size_t index) const;
+    void reserve(size_t size);
+    void clear();
+
+    // storage
+    void setExternalStorage(const ExternalStorage &storage);
+    bool hasExternalStorage() const;
+
+    // search
+    std::vector<Hit> search(const PackedFingerprint &query, Real threshold) const;
+    std::vector<std::vector<Hit> > search(const std::vector<PackedFingerprint> &queries, Real threshold) const;
+    std::vector<Hit> nearestNeighbors(const PackedFingerprint &query, size_t k) const;
+    std::vector<std::vector<Hit> > nearestNeighbors(const std::vector<PackedFingerprint> &queries, size_t k) const;
+
+private:
+    CHEMKIT_DISABLE_COPY(FingerprintDatabase)
+
+    FingerprintDatabasePrivate* const d;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_FINGERPRINTDATABASE_H
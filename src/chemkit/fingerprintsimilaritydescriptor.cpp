@@ -116,8 +116,8 @@ Variant FingerprintSimilarityDescriptor::value(const Molecule *molecule) const
         return 0;
     }
 
-    Bitset a = d->fingerprint->value(d->molecule.get());
-    Bitset b = d->fingerprint->value(molecule);
+    PackedFingerprint a = d->fingerprint->packedValue(d->molecule.get());
+    PackedFingerprint b = d->fingerprint->packedValue(molecule);
 
     return Fingerprint::tanimotoCoefficient(a, b);
 }
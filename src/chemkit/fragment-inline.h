@@ -60,43 +60,29 @@ inline Molecule* Fragment::molecule() const
 /// Returns the atom at \p index in the fragment.
 inline Atom* Fragment::atom(size_t index) const
 {
-    size_t position = m_bitset.find_first();
-
-    while(index--){
-        position = m_bitset.find_next(position);
-
-        if(position == Bitset::npos){
-            return 0;
-        }
+    if(index >= m_atoms.size()){
+        return 0;
     }
 
-    return m_molecule->atom(position);
+    return m_atoms[index];
 }
 
 /// Returns a list of all the atoms in the fragment.
 inline std::vector<Atom *> Fragment::atoms() const
 {
-    std::vector<Atom *> atoms;
-
-    for(size_t i = 0; i < m_bitset.size(); i++){
-        if(m_bitset.test(i)){
-            atoms.push_back(m_molecule->atom(i));
-        }
-    }
-
-    return atoms;
+    return m_atoms;
 }
 
 /// Returns the number of atoms in the fragment.
 inline size_t Fragment::atomCount() const
 {
-    return m_bitset.count();
+    return m_atoms.size();
 }
 
 /// Returns \c true if the fragment contains the atom.
 inline bool Fragment::contains(const Atom *atom) const
 {
-    return m_bitset.test(atom->index());
+    return atom->molecule() == m_molecule && atom->fragment() == this;
 }
 
 } // end chemkit namespace
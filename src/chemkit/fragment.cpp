@@ -53,11 +53,10 @@ namespace chemkit {
 /// methods such as Molecule::fragments() and Atom::fragment().
 
 // --- Construction and Destruction ---------------------------------------- //
-/// Creates a new fragment that contains all the atoms attached to
-/// \p root.
-Fragment::Fragment(Molecule *molecule, const Bitset &bitset)
-    : m_molecule(molecule),
-      m_bitset(bitset)
+/// Creates a new, empty fragment. The molecule adds the fragment's
+/// atoms when perceiving its fragments.
+Fragment::Fragment(Molecule *molecule)
+    : m_molecule(molecule)
 {
 }
 
@@ -72,9 +71,10 @@ std::vector<Bond *> Fragment::bonds() const
 {
     std::vector<Bond *> bonds;
 
-    foreach(Atom *atom, atoms()){
+    // each bond is added from the atom with the lower index
+    foreach(Atom *atom, m_atoms){
         foreach(Bond *bond, atom->bonds()){
-            if(std::find(bonds.begin(), bonds.end(), bond) == bonds.end()){
+            if(bond->otherAtom(atom)->index() > atom->index()){
                 bonds.push_back(bond);
             }
         }
@@ -86,7 +86,13 @@ std::vector<Bond *> Fragment::bonds() const
 /// Returns the number of bonds in the fragment.
 size_t Fragment::bondCount() const
 {
-    return bonds().size();
+    size_t count = 0;
+
+    foreach(const Atom *atom, m_atoms){
+        count += atom->neighborCount();
+    }
+
+    return count / 2;
 }
 
 /// Returns \c true if the fragment contains the bond.
@@ -40,8 +40,6 @@
 
 #include <vector>
 
-#include "bitset.h"
-
 namespace chemkit {
 
 class Atom;
@@ -65,16 +63,17 @@ public:
     bool contains(const Bond *bond) const;
 
 private:
-    Fragment(Molecule *molecule, const Bitset &bitset);
+    Fragment(Molecule *molecule);
     ~Fragment();
 
     CHEMKIT_DISABLE_COPY(Fragment)
 
     friend class Molecule;
+    friend class MoleculePrivate;
 
 private:
     Molecule* m_molecule;
-    Bitset m_bitset;
+    std::vector<Atom *> m_atoms;
 };
 
 } // end chemkit namespace
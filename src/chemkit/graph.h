@@ -46,6 +46,9 @@ template<typename T = size_t>
 class CHEMKIT_EXPORT Graph
 {
 public:
+    // typedefs
+    typedef T VertexType;
+
     // construction and destruction
     Graph(T size = 0);
 
@@ -0,0 +1,96 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_GRAPHDISTANCEMATRIX_INLINE_H
+#define CHEMKIT_GRAPHDISTANCEMATRIX_INLINE_H
+
+#include "graphdistancematrix.h"
+
+namespace chemkit {
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of vertices (atoms) in the matrix.
+inline size_t GraphDistanceMatrix::size() const
+{
+    return m_size;
+}
+
+/// Returns \c true if the matrix contains no vertices.
+inline bool GraphDistanceMatrix::isEmpty() const
+{
+    return m_size == 0;
+}
+
+/// Returns the number of bytes used to store each distance. This
+/// is \c 1 if every distance in the graph is less than 255 and
+/// \c 2 otherwise.
+inline size_t GraphDistanceMatrix::elementSize() const
+{
+    return m_wordDistances.empty() ? sizeof(boost::uint8_t) : sizeof(boost::uint16_t);
+}
+
+// --- Distances ----------------------------------------------------------- //
+/// Returns the number of bonds on the shortest path between the
+/// vertices \p a and \p b. Returns \c -1 if there is no path between
+/// them.
+inline int GraphDistanceMatrix::distance(size_t a, size_t b) const
+{
+    if(m_wordDistances.empty()){
+        boost::uint8_t distance = m_byteDistances[a * m_size + b];
+        return distance == boost::uint8_t(-1) ? -1 : distance;
+    }
+    else{
+        boost::uint16_t distance = m_wordDistances[a * m_size + b];
+        return distance == boost::uint16_t(-1) ? -1 : distance;
+    }
+}
+
+/// Returns \c true if there is a path between the vertices \p a
+/// and \p b.
+inline bool GraphDistanceMatrix::isReachable(size_t a, size_t b) const
+{
+    return distance(a, b) != -1;
+}
+
+/// Returns the largest distance between \p vertex and any other
+/// vertex reachable from it.
+inline int GraphDistanceMatrix::eccentricity(size_t vertex) const
+{
+    return m_eccentricities[vertex];
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_GRAPHDISTANCEMATRIX_INLINE_H
@@ -0,0 +1,229 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "graphdistancematrix.h"
+
+#include <algorithm>
+
+#include "foreach.h"
+#include "concurrent.h"
+#include "graphsnapshot.h"
+
+namespace chemkit {
+
+namespace {
+
+// graphs with at least this many vertices are searched in parallel
+const size_t ParallelSearchThreshold = 256;
+
+// Returns an upper bound on the largest distance between any two
+// connected vertices in the graph. For each connected component the
+// distance between any two vertices is at most twice the
+// eccentricity of one of them.
+size_t distanceBound(const GraphSnapshot &graph)
+{
+    std::vector<int> distances(graph.size(), -1);
+    std::vector<size_t> queue;
+    queue.reserve(graph.size());
+
+    size_t bound = 0;
+
+    for(size_t vertex = 0; vertex < graph.size(); vertex++){
+        if(distances[vertex] != -1){
+            continue;
+        }
+
+        distances[vertex] = 0;
+        queue.clear();
+        queue.push_back(vertex);
+
+        for(size_t i = 0; i < queue.size(); i++){
+            size_t current = queue[i];
+
+            foreach(size_t neighbor, graph.neighbors(current)){
+                if(distances[neighbor] == -1){
+                    distances[neighbor] = distances[current] + 1;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+
+        bound = std::max(bound, size_t(2 * distances[queue.back()]));
+    }
+
+    return bound;
+}
+
+// Fills in the row of the distance matrix for a single vertex with
+// a breadth-first search. Each call writes to a different row so
+// the rows can be computed concurrently.
+template<typename T>
+class BreadthFirstSearch
+{
+public:
+    BreadthFirstSearch(const GraphSnapshot &graph, T *distances, int *eccentricities)
+        : m_graph(graph),
+          m_distances(distances),
+          m_eccentricities(eccentricities)
+    {
+    }
+
+    void operator()(size_t vertex) const
+    {
+        const std::vector<size_t> &offsets = m_graph.offsets();
+        const std::vector<size_t> &neighbors = m_graph.neighborIndices();
+
+        T *row = m_distances + vertex * m_graph.size();
+        row[vertex] = 0;
+
+        std::vector<size_t> queue;
+        queue.reserve(m_graph.size());
+        queue.push_back(vertex);
+
+        for(size_t i = 0; i < queue.size(); i++){
+            size_t current = queue[i];
+            T distance = row[current] + 1;
+
+            for(size_t j = offsets[current]; j < offsets[current + 1]; j++){
+                size_t neighbor = neighbors[j];
+
+                if(row[neighbor] == T(-1)){
+                    row[neighbor] = distance;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+
+        // the last vertex visited is one of the farthest from the start
+        m_eccentricities[vertex] = row[queue.back()];
+    }
+
+private:
+    const GraphSnapshot &m_graph;
+    T *m_distances;
+    int *m_eccentricities;
+};
+
+} // end anonymous namespace
+
+// === GraphDistanceMatrix ================================================= //
+/// \class GraphDistanceMatrix graphdistancematrix.h chemkit/graphdistancematrix.h
+/// \ingroup chemkit
+/// \brief The GraphDistanceMatrix class contains the topological
+///        distances between every pair of atoms in a molecule.
+///
+/// The distance between two atoms is the number of bonds on the
+/// shortest path between them. The distances are computed with one
+/// breadth-first search from each vertex of a GraphSnapshot. Larger
+/// graphs are searched in parallel using the global thread pool.
+///
+/// The distances are stored in a square matrix using one byte per
+/// entry when every distance fits and two bytes otherwise. The
+/// memory required grows with the square of the number of atoms.
+///
+/// Graph descriptors should use the matrix returned from
+/// Molecule::graphDistanceMatrix() which is cached and shared until
+/// an atom or bond is added or removed.
+///
+/// \see Molecule::graphDistanceMatrix(), GraphSnapshot
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty distance matrix.
+GraphDistanceMatrix::GraphDistanceMatrix()
+    : m_size(0)
+{
+}
+
+/// Creates a new distance matrix containing the distances between
+/// the vertices in \p graph.
+GraphDistanceMatrix::GraphDistanceMatrix(const GraphSnapshot &graph)
+    : m_size(graph.size()),
+      m_eccentricities(graph.size())
+{
+    if(distanceBound(graph) < 0xff){
+        compute(graph, m_byteDistances);
+    }
+    else{
+        compute(graph, m_wordDistances);
+    }
+}
+
+// --- Distances ----------------------------------------------------------- //
+/// Returns the largest eccentricity of any vertex in the graph.
+/// For a connected graph this is the largest distance between any
+/// two vertices. Returns \c 0 if the graph is empty.
+int GraphDistanceMatrix::diameter() const
+{
+    if(m_eccentricities.empty()){
+        return 0;
+    }
+
+    return *std::max_element(m_eccentricities.begin(), m_eccentricities.end());
+}
+
+/// Returns the smallest eccentricity of any vertex in the graph.
+/// Returns \c 0 if the graph is empty.
+int GraphDistanceMatrix::radius() const
+{
+    if(m_eccentricities.empty()){
+        return 0;
+    }
+
+    return *std::min_element(m_eccentricities.begin(), m_eccentricities.end());
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+template<typename T>
+void GraphDistanceMatrix::compute(const GraphSnapshot &graph, std::vector<T> &distances)
+{
+    if(graph.isEmpty()){
+        return;
+    }
+
+    distances.assign(m_size * m_size, T(-1));
+
+    BreadthFirstSearch<T> search(graph, &distances[0], &m_eccentricities[0]);
+
+    if(m_size >= ParallelSearchThreshold){
+        concurrent::parallel_for(0, m_size, search);
+    }
+    else{
+        for(size_t vertex = 0; vertex < m_size; vertex++){
+            search(vertex);
+        }
+    }
+}
+
+} // end chemkit namespace
@@ -0,0 +1,84 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_GRAPHDISTANCEMATRIX_H
+#define CHEMKIT_GRAPHDISTANCEMATRIX_H
+
+#include "chemkit.h"
+
+#include <vector>
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#endif
+
+namespace chemkit {
+
+class GraphSnapshot;
+
+class CHEMKIT_EXPORT GraphDistanceMatrix
+{
+public:
+    // construction and destruction
+    GraphDistanceMatrix();
+    GraphDistanceMatrix(const GraphSnapshot &graph);
+
+    // properties
+    inline size_t size() const;
+    inline bool isEmpty() const;
+    inline size_t elementSize() const;
+
+    // distances
+    inline int distance(size_t a, size_t b) const;
+    inline bool isReachable(size_t a, size_t b) const;
+    inline int eccentricity(size_t vertex) const;
+    int diameter() const;
+    int radius() const;
+
+private:
+    template<typename T> void compute(const GraphSnapshot &graph, std::vector<T> &distances);
+
+private:
+    size_t m_size;
+    std::vector<boost::uint8_t> m_byteDistances;
+    std::vector<boost::uint16_t> m_wordDistances;
+    std::vector<int> m_eccentricities;
+};
+
+} // end chemkit namespace
+
+#include "graphdistancematrix-inline.h"
+
+#endif // CHEMKIT_GRAPHDISTANCEMATRIX_H
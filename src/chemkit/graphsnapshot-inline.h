@@ -0,0 +1,159 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_GRAPHSNAPSHOT_INLINE_H
+#define CHEMKIT_GRAPHSNAPSHOT_INLINE_H
+
+#include "graphsnapshot.h"
+
+namespace chemkit {
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of vertices (atoms) in the graph.
+inline size_t GraphSnapshot::size() const
+{
+    return vertexCount();
+}
+
+/// Returns \c true if the graph contains no vertices.
+inline bool GraphSnapshot::isEmpty() const
+{
+    return size() == 0;
+}
+
+/// Returns the number of vertices (atoms) in the graph.
+inline size_t GraphSnapshot::vertexCount() const
+{
+    return m_offsets.size() - 1;
+}
+
+/// Returns the number of edges (bonds) in the graph.
+inline size_t GraphSnapshot::edgeCount() const
+{
+    return m_neighbors.size() / 2;
+}
+
+// --- Structure ----------------------------------------------------------- //
+/// Returns the number of neighbors of \p vertex.
+inline size_t GraphSnapshot::degree(size_t vertex) const
+{
+    return m_offsets[vertex + 1] - m_offsets[vertex];
+}
+
+/// Returns a range containing the indices of the neighbors of
+/// \p vertex.
+inline GraphSnapshot::IndexRange GraphSnapshot::neighbors(size_t vertex) const
+{
+    return boost::make_iterator_range(m_neighbors.begin() + m_offsets[vertex],
+                                      m_neighbors.begin() + m_offsets[vertex + 1]);
+}
+
+/// Returns a range containing the indices of the bonds to the
+/// neighbors of \p vertex. The bonds are in the same order as the
+/// neighbors returned from neighbors().
+inline GraphSnapshot::IndexRange GraphSnapshot::bonds(size_t vertex) const
+{
+    return boost::make_iterator_range(m_bonds.begin() + m_offsets[vertex],
+                                      m_bonds.begin() + m_offsets[vertex + 1]);
+}
+
+/// Returns \c true if vertices \p a and \p b are adjacent.
+inline bool GraphSnapshot::isAdjacent(size_t a, size_t b) const
+{
+    return find(a, b) != NullIndex;
+}
+
+/// Returns the index of the bond between vertices \p a and \p b.
+/// Returns \c NullIndex if they are not adjacent.
+inline size_t GraphSnapshot::bondIndex(size_t a, size_t b) const
+{
+    size_t position = find(a, b);
+
+    return position != NullIndex ? m_bonds[position] : NullIndex;
+}
+
+/// Returns the order of the bond between vertices \p a and \p b.
+/// Returns \c 0 if they are not adjacent.
+inline Bond::BondOrderType GraphSnapshot::bondOrder(size_t a, size_t b) const
+{
+    size_t position = find(a, b);
+
+    return position != NullIndex ? m_bondOrders[position] : 0;
+}
+
+// --- Arrays -------------------------------------------------------------- //
+/// Returns the offsets of the first neighbor of each vertex in the
+/// neighbor, bond and bond order arrays. The offsets array contains
+/// one more entry than the number of vertices.
+inline const std::vector<size_t>& GraphSnapshot::offsets() const
+{
+    return m_offsets;
+}
+
+/// Returns the neighbor indices for every vertex.
+inline const std::vector<size_t>& GraphSnapshot::neighborIndices() const
+{
+    return m_neighbors;
+}
+
+/// Returns the bond indices for every neighbor of every vertex.
+inline const std::vector<size_t>& GraphSnapshot::bondIndices() const
+{
+    return m_bonds;
+}
+
+/// Returns the bond orders for every neighbor of every vertex.
+inline const std::vector<Bond::BondOrderType>& GraphSnapshot::bondOrders() const
+{
+    return m_bondOrders;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+/// Returns the position of \p b in the neighbors of \p a or
+/// \c NullIndex if they are not adjacent.
+inline size_t GraphSnapshot::find(size_t a, size_t b) const
+{
+    for(size_t i = m_offsets[a]; i < m_offsets[a + 1]; i++){
+        if(m_neighbors[i] == b){
+            return i;
+        }
+    }
+
+    return NullIndex;
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_GRAPHSNAPSHOT_INLINE_H
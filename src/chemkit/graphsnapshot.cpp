@@ -0,0 +1,124 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "graphsnapshot.h"
+
+#include "atom.h"
+#include "foreach.h"
+#include "molecule.h"
+
+namespace chemkit {
+
+// === GraphSnapshot ======================================================= //
+/// \class GraphSnapshot graphsnapshot.h chemkit/graphsnapshot.h
+/// \ingroup chemkit
+/// \brief The GraphSnapshot class contains a compact, read-only copy
+///        of the bonding graph of a molecule.
+///
+/// The graph is stored in compressed sparse row form. The neighbors
+/// of vertex \c i are stored in neighborIndices() between positions
+/// \c offsets()[i] and \c offsets()[i+1]. The bondIndices() and
+/// bondOrders() arrays contain the index and order of the bond to
+/// each neighbor at the same positions.
+///
+/// Graph algorithms which only read the structure of a molecule
+/// should use the snapshot returned from Molecule::graphSnapshot()
+/// which is cached and shared until the molecule is modified.
+///
+/// \see Molecule::graphSnapshot()
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty graph snapshot.
+GraphSnapshot::GraphSnapshot()
+    : m_offsets(1, 0)
+{
+}
+
+/// Creates a new graph snapshot of the atoms and bonds in
+/// \p molecule. The vertex indices are the same as the atom indices.
+GraphSnapshot::GraphSnapshot(const Molecule *molecule)
+{
+    m_offsets.reserve(molecule->atomCount() + 1);
+    m_neighbors.reserve(2 * molecule->bondCount());
+    m_bonds.reserve(2 * molecule->bondCount());
+    m_bondOrders.reserve(2 * molecule->bondCount());
+
+    m_offsets.push_back(0);
+
+    foreach(const Atom *atom, molecule->atoms()){
+        foreach(const Bond *bond, atom->bonds()){
+            m_neighbors.push_back(bond->otherAtom(atom)->index());
+            m_bonds.push_back(bond->index());
+            m_bondOrders.push_back(bond->order());
+        }
+
+        m_offsets.push_back(m_neighbors.size());
+    }
+}
+
+/// Creates a new graph snapshot of the subgraph containing
+/// \p atoms and the bonds between them. The atoms must all be
+/// from the same molecule. Vertex \c i corresponds to \c atoms[i].
+GraphSnapshot::GraphSnapshot(const std::vector<Atom *> &atoms)
+{
+    m_offsets.reserve(atoms.size() + 1);
+    m_offsets.push_back(0);
+
+    if(atoms.empty()){
+        return;
+    }
+
+    // map from atom index to vertex index
+    std::vector<size_t> vertices(atoms.front()->molecule()->atomCount(), NullIndex);
+    for(size_t i = 0; i < atoms.size(); i++){
+        vertices[atoms[i]->index()] = i;
+    }
+
+    foreach(const Atom *atom, atoms){
+        foreach(const Bond *bond, atom->bonds()){
+            size_t neighbor = vertices[bond->otherAtom(atom)->index()];
+
+            if(neighbor != NullIndex){
+                m_neighbors.push_back(neighbor);
+                m_bonds.push_back(bond->index());
+                m_bondOrders.push_back(bond->order());
+            }
+        }
+
+        m_offsets.push_back(m_neighbors.size());
+    }
+}
+
+} // end chemkit namespace
@@ -0,0 +1,103 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_GRAPHSNAPSHOT_H
+#define CHEMKIT_GRAPHSNAPSHOT_H
+
+#include "chemkit.h"
+
+#include <vector>
+
+#ifndef Q_MOC_RUN
+#include <boost/range/iterator_range.hpp>
+#endif
+
+#include "bond.h"
+
+namespace chemkit {
+
+class Atom;
+class Molecule;
+
+class CHEMKIT_EXPORT GraphSnapshot
+{
+public:
+    // typedefs
+    typedef size_t VertexType;
+    typedef boost::iterator_range<std::vector<size_t>::const_iterator> IndexRange;
+
+    // enumerations
+    enum { NullIndex = size_t(-1) };
+
+    // construction and destruction
+    GraphSnapshot();
+    GraphSnapshot(const Molecule *molecule);
+    GraphSnapshot(const std::vector<Atom *> &atoms);
+
+    // properties
+    inline size_t size() const;
+    inline bool isEmpty() const;
+    inline size_t vertexCount() const;
+    inline size_t edgeCount() const;
+
+    // structure
+    inline size_t degree(size_t vertex) const;
+    inline IndexRange neighbors(size_t vertex) const;
+    inline IndexRange bonds(size_t vertex) const;
+    inline bool isAdjacent(size_t a, size_t b) const;
+    inline size_t bondIndex(size_t a, size_t b) const;
+    inline Bond::BondOrderType bondOrder(size_t a, size_t b) const;
+
+    // arrays
+    inline const std::vector<size_t>& offsets() const;
+    inline const std::vector<size_t>& neighborIndices() const;
+    inline const std::vector<size_t>& bondIndices() const;
+    inline const std::vector<Bond::BondOrderType>& bondOrders() const;
+
+private:
+    inline size_t find(size_t a, size_t b) const;
+
+private:
+    std::vector<size_t> m_offsets;
+    std::vector<size_t> m_neighbors;
+    std::vector<size_t> m_bonds;
+    std::vector<Bond::BondOrderType> m_bondOrders;
+};
+
+} // end chemkit namespace
+
+#include "graphsnapshot-inline.h"
+
+#endif // CHEMKIT_GRAPHSNAPSHOT_H
@@ -126,8 +126,9 @@ MolecularSurface::MolecularSurface(const Molecule *molecule, SurfaceType type)
     if(molecule){
         foreach(const Atom *atom, molecule->atoms()){
             d->points.push_back(atom->position());
-            d->radii.push_back(atom->vanDerWaalsRadius());
         }
+
+        d->radii = molecule->vanDerWaalsRadii();
     }
 
     d->alphaShape = 0;
@@ -151,14 +152,12 @@ void MolecularSurface::setMolecule(const Molecule *molecule)
     // update atom positions and radii
     if(molecule){
         d->points.resize(molecule->size());
-        d->radii.resize(molecule->size());
 
         for(size_t i = 0; i < molecule->size(); i++){
-            const Atom *atom = molecule->atom(i);
-
-            d->points[i] = atom->position();
-            d->radii[i] = atom->vanDerWaalsRadius();
+            d->points[i] = molecule->atom(i)->position();
         }
+
+        d->radii = molecule->vanDerWaalsRadii();
     }
 
     setCalculated(false);
@@ -64,15 +64,15 @@ inline bool Molecule::isEmpty() const
 template<typename Predicate>
 inline void Molecule::removeAtomIf(Predicate predicate)
 {
-    std::vector<Atom *> atomsToRemove;
+    beginEdit();
 
     BOOST_FOREACH(Atom *atom, m_atoms){
         if(predicate(atom)){
-            atomsToRemove.push_back(atom);
+            removeAtom(atom);
         }
     }
 
-    removeAtoms(atomsToRemove);
+    endEdit();
 }
 
 /// Removes each atom in \p range from the molecule.
@@ -105,15 +105,15 @@ inline Atom* Molecule::atom(size_t index) const
 template<typename Predicate>
 inline void Molecule::removeBondIf(Predicate predicate)
 {
-    std::vector<Bond *> bondsToRemove;
+    beginEdit();
 
     BOOST_FOREACH(Bond *bond, bonds()){
         if(predicate(bond)){
-            bondsToRemove.push_back(bond);
+            removeBond(bond);
         }
     }
 
-    removeBonds(bondsToRemove);
+    endEdit();
 }
 
 /// Removes each bond in \p range from the molecule.
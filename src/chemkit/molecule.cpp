@@ -42,6 +42,7 @@
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/thread/locks.hpp>
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
@@ -64,20 +65,385 @@
 #include "quaternion.h"
 #include "variantmap.h"
 #include "fingerprint.h"
+#include "graphsnapshot.h"
+#include "moleculearena.h"
 #include "moleculeprivate.h"
 #include "moleculewatcher.h"
 #include "diagramcoordinates.h"
+#include "graphdistancematrix.h"
 #include "internalcoordinates.h"
 #include "moleculardescriptor.h"
 #include "cartesiancoordinates.h"
 
 namespace chemkit {
 
+namespace {
+
+// size of the arena slots which store both atoms and bonds
+const size_t SlotSize = sizeof(Atom) > sizeof(Bond) ? sizeof(Atom) : sizeof(Bond);
+
+// number of slots in the first and largest slabs taken from the arena
+const size_t MinimumSlabSlots = 8;
+const size_t MaximumSlabSlots = 4096;
+
+bool compareAtomIndices(const Atom *a, const Atom *b)
+{
+    return a->index() < b->index();
+}
+
+// Collects the indices of the unvisited atoms connected to root in
+// component. Returns true as soon as target is reached.
+bool visitFragment(const MoleculePrivate *d,
+                   size_t root,
+                   size_t target,
+                   std::vector<bool> &visited,
+                   std::vector<size_t> &component)
+{
+    component.assign(1, root);
+    visited[root] = true;
+
+    for(size_t i = 0; i < component.size(); i++){
+        foreach(const Bond *bond, d->atomBonds[component[i]]){
+            const std::pair<Atom *, Atom *> &atoms = d->bondAtoms[bond->index()];
+            size_t neighbor = atoms.first->index() == component[i] ? atoms.second->index()
+                                                                 : atoms.first->index();
+
+            if(neighbor == target){
+                return true;
+            }
+            else if(!visited[neighbor]){
+                visited[neighbor] = true;
+                component.push_back(neighbor);
+            }
+        }
+    }
+
+    return false;
+}
+
+} // end anonymous namespace
+
 // === MoleculePrivate ===================================================== //
 MoleculePrivate::MoleculePrivate()
 {
     fragmentsPerceived = false;
     ringsPerceived = false;
+    ringMembershipPerceived = false;
+    aromaticityPerceived = false;
+    coordinatesCreated = false;
+    fragmentSetCount = 0;
+    slab = 0;
+    slabRemaining = 0;
+    slotCount = 0;
+    editDepth = 0;
+    editChanged = false;
+}
+
+// Returns uninitialized storage for a single atom or bond. Storage is
+// taken from slots freed by removed atoms and bonds, then from the
+// current slab and finally from a new slab allocated from the arena.
+// Slabs double in size as the molecule grows.
+void* MoleculePrivate::allocateSlot()
+{
+    if(!freeSlots.empty()){
+        void *slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    if(!slabRemaining){
+        reserveSlots(std::min(std::max(slotCount, MinimumSlabSlots), MaximumSlabSlots));
+    }
+
+    void *slot = slab;
+    slab += SlotSize;
+    slabRemaining--;
+
+    return slot;
+}
+
+// Ensures that at least count slots can be allocated without taking
+// another slab from the arena. If needed, a single slab large enough
+// for all of them is allocated and any space left in the current slab
+// is abandoned.
+void MoleculePrivate::reserveSlots(size_t count)
+{
+    if(slabRemaining + freeSlots.size() >= count){
+        return;
+    }
+
+    if(!arena){
+        arena = MoleculeArena::currentArena();
+
+        if(!arena){
+            // private arenas allocate exactly what is requested
+            arena = boost::make_shared<MoleculeArena>(0);
+        }
+    }
+
+    slab = static_cast<char *>(arena->allocate(count * SlotSize));
+    slabRemaining = count;
+    slotCount += count;
+}
+
+// Returns the storage for a destroyed atom or bond for reuse.
+void MoleculePrivate::releaseSlot(void *slot)
+{
+    freeSlots.push_back(slot);
+}
+
+// Releases all of the storage for the molecule's atoms and bonds. Must
+// only be called once every atom and bond has been destroyed. Shared
+// arenas are kept alive by the other molecules still using them.
+void MoleculePrivate::releaseArena()
+{
+    if(arena && arena.unique()){
+        arena->release();
+    }
+
+    arena.reset();
+    slab = 0;
+    slabRemaining = 0;
+    slotCount = 0;
+    freeSlots.clear();
+}
+
+// The atoms of each fragment are kept as a disjoint set (union-find)
+// indexed by atom index. Adding atoms and bonds only creates and merges
+// sets. Removing a bond recomputes the sets for the fragment that
+// contained it and removing many atoms at once rebuilds them all. Once
+// perceived, the fragment objects are updated along with the sets.
+
+// Adds a new set (and fragment) containing only atom. The atom must
+// be the last atom in the molecule.
+void MoleculePrivate::addFragmentSet(Atom *atom)
+{
+    fragmentParents.push_back(fragmentParents.size());
+    fragmentSizes.push_back(1);
+    fragmentSetCount++;
+
+    if(fragmentsPerceived){
+        Fragment *fragment = new Fragment(atom->molecule());
+        fragment->m_atoms.push_back(atom);
+        fragments.push_back(fragment);
+        atomFragments.push_back(fragment);
+    }
+}
+
+// Removes the set (and fragment) for the atom at index. The atom must
+// not be bonded to any other atom. The sets of the atoms after it are
+// renumbered.
+void MoleculePrivate::removeFragmentSet(size_t atom)
+{
+    assert(fragmentParents[atom] == atom && fragmentSizes[atom] == 1);
+
+    fragmentParents.erase(fragmentParents.begin() + atom);
+    fragmentSizes.erase(fragmentSizes.begin() + atom);
+
+    for(size_t i = 0; i < fragmentParents.size(); i++){
+        if(fragmentParents[i] > atom){
+            fragmentParents[i]--;
+        }
+    }
+
+    fragmentSetCount--;
+
+    if(fragmentsPerceived){
+        Fragment *fragment = atomFragments[atom];
+        fragments.erase(std::find(fragments.begin(), fragments.end(), fragment));
+        atomFragments.erase(atomFragments.begin() + atom);
+        delete fragment;
+    }
+}
+
+// Returns the index of the atom which identifies the set containing
+// the atom at index. The paths are not compressed so that fragments
+// can be looked up concurrently.
+size_t MoleculePrivate::findFragmentSet(size_t atom) const
+{
+    while(fragmentParents[atom] != atom){
+        atom = fragmentParents[atom];
+    }
+
+    return atom;
+}
+
+// Merges the sets containing the atoms at indices a and b. Returns
+// false if they were already in the same set.
+bool MoleculePrivate::unionFragmentSets(size_t a, size_t b)
+{
+    size_t rootA = findFragmentSet(a);
+    size_t rootB = findFragmentSet(b);
+
+    // compress the paths from both atoms
+    while(a != rootA){
+        size_t parent = fragmentParents[a];
+        fragmentParents[a] = rootA;
+        a = parent;
+    }
+    while(b != rootB){
+        size_t parent = fragmentParents[b];
+        fragmentParents[b] = rootB;
+        b = parent;
+    }
+
+    if(rootA == rootB){
+        return false;
+    }
+
+    // attach the smaller set to the larger set
+    if(fragmentSizes[rootA] < fragmentSizes[rootB]){
+        std::swap(rootA, rootB);
+    }
+
+    fragmentParents[rootB] = rootA;
+    fragmentSizes[rootA] += fragmentSizes[rootB];
+    fragmentSetCount--;
+
+    return true;
+}
+
+// Merges the sets (and fragments) after a bond between atoms a and b
+// has been added.
+void MoleculePrivate::mergeFragmentSets(const Atom *a, const Atom *b)
+{
+    if(!unionFragmentSets(a->index(), b->index()) || !fragmentsPerceived){
+        return;
+    }
+
+    // move the atoms from the smaller fragment into the larger one
+    Fragment *fragment = atomFragments[a->index()];
+    Fragment *other = atomFragments[b->index()];
+    if(fragment->m_atoms.size() < other->m_atoms.size()){
+        std::swap(fragment, other);
+    }
+
+    std::vector<Atom *> &atoms = fragment->m_atoms;
+    size_t size = atoms.size();
+    bool sorted = atoms.back()->index() < other->m_atoms.front()->index();
+
+    atoms.insert(atoms.end(), other->m_atoms.begin(), other->m_atoms.end());
+    if(!sorted){
+        std::inplace_merge(atoms.begin(), atoms.begin() + size, atoms.end(), compareAtomIndices);
+    }
+
+    foreach(const Atom *atom, other->m_atoms){
+        atomFragments[atom->index()] = fragment;
+    }
+
+    // fragments are ordered by their first atom so the merged fragment
+    // takes the place of the other fragment if it started first
+    if(atoms.front() == other->m_atoms.front()){
+        fragments.erase(std::find(fragments.begin(), fragments.end(), fragment));
+        *std::find(fragments.begin(), fragments.end(), other) = fragment;
+    }
+    else{
+        fragments.erase(std::find(fragments.begin(), fragments.end(), other));
+    }
+
+    delete other;
+}
+
+// Updates the sets (and fragments) after the bond between atoms a and
+// b has been removed. Only the atoms in the fragment which contained
+// the bond are visited.
+void MoleculePrivate::splitFragmentSet(const Atom *a, const Atom *b)
+{
+    // the visited flags are kept between calls and only the flags of
+    // the atoms visited here are cleared again
+    std::vector<bool> &visited = fragmentVisited;
+    visited.resize(fragmentParents.size(), false);
+
+    std::vector<size_t> component;
+
+    // the fragment is unchanged if a and b are still connected
+    bool connected = visitFragment(this, a->index(), b->index(), visited, component);
+    foreach(size_t atom, component){
+        visited[atom] = false;
+    }
+
+    if(connected){
+        return;
+    }
+
+    // otherwise split it into the atoms connected to a and to b
+    foreach(size_t atom, component){
+        fragmentParents[atom] = a->index();
+    }
+    fragmentSizes[a->index()] = component.size();
+
+    visitFragment(this, b->index(), size_t(-1), visited, component);
+
+    foreach(size_t atom, component){
+        fragmentParents[atom] = b->index();
+        visited[atom] = false;
+    }
+    fragmentSizes[b->index()] = component.size();
+
+    fragmentSetCount++;
+
+    if(!fragmentsPerceived){
+        return;
+    }
+
+    // move the atoms connected to b into a new fragment
+    Fragment *fragment = atomFragments[a->index()];
+    Fragment *other = new Fragment(fragment->m_molecule);
+
+    std::vector<Atom *> atoms;
+    atoms.reserve(fragment->m_atoms.size() - component.size());
+    other->m_atoms.reserve(component.size());
+
+    foreach(Atom *atom, fragment->m_atoms){
+        if(fragmentParents[atom->index()] == b->index()){
+            other->m_atoms.push_back(atom);
+            atomFragments[atom->index()] = other;
+        }
+        else{
+            atoms.push_back(atom);
+        }
+    }
+
+    fragment->m_atoms.swap(atoms);
+
+    // the first atom of the fragment may have moved so both fragments
+    // are inserted in order
+    fragments.erase(std::find(fragments.begin(), fragments.end(), fragment));
+    insertFragment(fragment);
+    insertFragment(other);
+}
+
+// Inserts fragment into the fragments which are ordered by their
+// first atom.
+void MoleculePrivate::insertFragment(Fragment *fragment)
+{
+    std::vector<Fragment *>::iterator position = fragments.begin();
+    while(position != fragments.end() &&
+          (*position)->m_atoms.front()->index() < fragment->m_atoms.front()->index()){
+        ++position;
+    }
+
+    fragments.insert(position, fragment);
+}
+
+// Rebuilds the sets from the bonds between the atoms. The fragments
+// must not be perceived.
+void MoleculePrivate::rebuildFragmentSets()
+{
+    assert(!fragmentsPerceived);
+
+    const size_t atomCount = atomBonds.size();
+
+    fragmentParents.resize(atomCount);
+    for(size_t i = 0; i < atomCount; i++){
+        fragmentParents[i] = i;
+    }
+    fragmentSizes.assign(atomCount, 1);
+    fragmentSetCount = atomCount;
+
+    for(size_t i = 0; i < bondAtoms.size(); i++){
+        unionFragmentSets(bondAtoms[i].first->index(), bondAtoms[i].second->index());
+    }
 }
 
 // === Molecule ============================================================ //
@@ -122,7 +488,6 @@ Molecule::Molecule()
     : d(new MoleculePrivate)
 {
     m_coordinates = 0;
-    m_stereochemistry = 0;
 }
 
 /// Creates a new molecule from its formula.
@@ -141,7 +506,6 @@ Molecule::Molecule(const std::string &formula, const std::string &format)
     : d(new MoleculePrivate)
 {
     m_coordinates = 0;
-    m_stereochemistry = 0;
 
     boost::scoped_ptr<LineFormat> lineFormat(LineFormat::create(format));
     if(!lineFormat){
@@ -153,7 +517,7 @@ Molecule::Molecule(const std::string &formula, const std::string &format)
         return;
     }
 
-    *this = *molecule;
+    moveStructure(*molecule);
 }
 
 /// Creates a new molecule that is a copy of \p molecule.
@@ -161,35 +525,38 @@ Molecule::Molecule(const Molecule &molecule)
     : d(new MoleculePrivate)
 {
     m_coordinates = 0;
-    m_stereochemistry = 0;
 
     d->name = molecule.name();
 
-    std::map<const Atom *, Atom *> oldToNew;
-
-    foreach(const Atom *atom, molecule.atoms()){
-        Atom *newAtom = addAtomCopy(atom);
-        oldToNew[atom] = newAtom;
-    }
+    copyStructure(molecule);
+}
 
-    foreach(const Bond *bond, molecule.bonds()){
-        Bond *newBond = addBond(oldToNew[bond->atom1()], oldToNew[bond->atom2()]);
-        newBond->setOrder(bond->order());
+#ifdef CHEMKIT_HAS_RVALUE_REFERENCES
+/// Creates a new molecule which takes the atoms, bonds and all other
+/// contents of \p molecule. The atom and bond objects themselves are
+/// moved so existing pointers to them remain valid and now refer to
+/// the new molecule. After the move \p molecule is empty.
+///
+/// This constructor is only available when chemkit is built with a
+/// compiler supporting C++11 rvalue references.
+Molecule::Molecule(Molecule &&molecule)
+    : d(new MoleculePrivate)
+{
+    m_coordinates = 0;
 
-        if(bond->stereochemistry() != Stereochemistry::None){
-            newBond->setStereochemistry(bond->stereochemistry());
-        }
-    }
+    moveStructure(molecule);
 }
+#endif
 
 /// Destroys a molecule. This also destroys all of the atoms and
 /// bonds that the molecule contains.
 Molecule::~Molecule()
 {
+    // destroy atoms and bonds, their storage is released with the arena
     foreach(Atom *atom, m_atoms)
-        delete atom;
+        atom->~Atom();
     foreach(Bond *bond, d->bonds)
-        delete bond;
+        bond->~Bond();
     foreach(Ring *ring, d->rings)
         delete ring;
     foreach(Fragment *fragment, d->fragments)
@@ -209,8 +576,6 @@ Molecule::~Molecule()
         delete m_coordinates;
     }
 
-    delete m_stereochemistry;
-
     delete d;
 }
 
@@ -335,12 +700,73 @@ Real Molecule::mass() const
 {
     Real mass = 0;
 
-    foreach(const Atom *atom, m_atoms)
-        mass += atom->mass();
+    foreach(const Element &element, m_elements)
+        mass += element.mass();
 
     return mass;
 }
 
+/// Returns the molar mass of each atom in the molecule. The mass of
+/// the atom at index \c i is at position \c i in the returned
+/// vector. Mass is in g/mol.
+///
+/// \see Atom::mass()
+std::vector<Real> Molecule::masses() const
+{
+    std::vector<Real> masses;
+    masses.reserve(m_elements.size());
+
+    foreach(const Element &element, m_elements){
+        masses.push_back(element.mass());
+    }
+
+    return masses;
+}
+
+/// Returns the partial charge of each atom in the molecule. The
+/// charge of the atom at index \c i is at position \c i in the
+/// returned vector.
+///
+/// \see Atom::partialCharge()
+std::vector<Real> Molecule::partialCharges() const
+{
+    return d->partialCharges;
+}
+
+/// Returns the covalent radius of each atom in the molecule. The
+/// radius of the atom at index \c i is at position \c i in the
+/// returned vector.
+///
+/// \see Atom::covalentRadius()
+std::vector<Real> Molecule::covalentRadii() const
+{
+    std::vector<Real> radii;
+    radii.reserve(m_elements.size());
+
+    foreach(const Element &element, m_elements){
+        radii.push_back(element.covalentRadius());
+    }
+
+    return radii;
+}
+
+/// Returns the Van der Waals radius of each atom in the molecule.
+/// The radius of the atom at index \c i is at position \c i in the
+/// returned vector.
+///
+/// \see Atom::vanDerWaalsRadius()
+std::vector<Real> Molecule::vanDerWaalsRadii() const
+{
+    std::vector<Real> radii;
+    radii.reserve(m_elements.size());
+
+    foreach(const Element &element, m_elements){
+        radii.push_back(element.vanDerWaalsRadius());
+    }
+
+    return radii;
+}
+
 /// Sets the data for the molecule with \p name to \p value.
 void Molecule::setData(const std::string &name, const Variant &value)
 {
@@ -382,20 +808,23 @@ Variant Molecule::data(const std::string &name) const
 /// \endcode
 Atom* Molecule::addAtom(const Element &element)
 {
-    Atom *atom = new Atom(this, m_atoms.size());
+    Atom *atom = new(d->allocateSlot()) Atom(this, m_atoms.size());
     m_atoms.push_back(atom);
 
     // add atom properties
     m_elements.push_back(element);
     d->atomBonds.push_back(std::vector<Bond *>());
+    d->massNumbers.push_back(0);
+    d->massNumbersSet.push_back(false);
     d->partialCharges.push_back(0);
+    d->atomStereochemistry.push_back(Stereochemistry::None);
+    d->addFragmentSet(atom);
 
     // set atom position
     if(m_coordinates){
         m_coordinates->append(0, 0, 0);
     }
 
-    setFragmentsPerceived(false);
     notifyWatchers(atom, MoleculeWatcher::AtomAdded);
 
     return atom;
@@ -420,22 +849,50 @@ Atom* Molecule::addAtomCopy(const Atom *atom)
 
 /// Removes atom from the molecule. This will also remove any bonds
 /// to/from the atom.
+///
+/// If called during an edit the atom is only marked for removal and
+/// is removed when the edit ends.
+///
+/// \see beginEdit()
 void Molecule::removeAtom(Atom *atom)
 {
     if(!contains(atom)){
         return;
     }
 
+    // mark the atom and its bonds for removal during an edit
+    if(d->editDepth){
+        d->removedAtoms.resize(m_atoms.size(), false);
+
+        if(!d->removedAtoms[atom->m_index]){
+            d->removedAtoms[atom->m_index] = true;
+
+            foreach(Bond *bond, atom->bonds()){
+                removeBond(bond);
+            }
+
+            d->editChanged = true;
+        }
+
+        return;
+    }
+
     // remove all bonds to/from the atom first
-    removeBonds(atom->bonds());
+    std::vector<Bond *> bonds(atom->bonds().begin(), atom->bonds().end());
+    BOOST_REVERSE_FOREACH(Bond *bond, bonds){
+        removeBond(bond);
+    }
 
     m_atoms.erase(std::remove(m_atoms.begin(), m_atoms.end(), atom), m_atoms.end());
 
     // remove atom properties
     m_elements.erase(m_elements.begin() + atom->index());
-    d->isotopes.erase(atom);
+    d->massNumbers.erase(d->massNumbers.begin() + atom->index());
+    d->massNumbersSet.erase(d->massNumbersSet.begin() + atom->index());
     d->atomBonds.erase(d->atomBonds.begin() + atom->index());
     d->partialCharges.erase(d->partialCharges.begin() + atom->index());
+    d->atomStereochemistry.erase(d->atomStereochemistry.begin() + atom->index());
+    d->removeFragmentSet(atom->index());
 
     if(atom->index() < d->atomTypes.size()){
         d->atomTypes.erase(d->atomTypes.begin() + atom->index());
@@ -451,18 +908,25 @@ void Molecule::removeAtom(Atom *atom)
     }
 
     atom->m_molecule = 0;
-    setFragmentsPerceived(false);
     notifyWatchers(atom, MoleculeWatcher::AtomRemoved);
 
-    delete atom;
+    atom->~Atom();
+    d->releaseSlot(atom);
 }
 
-/// Removes each atom in \p atoms from the molecule.
+/// Removes each atom in \p atoms from the molecule. The atoms are
+/// removed together in a single edit.
+///
+/// \see beginEdit()
 void Molecule::removeAtoms(const std::vector<Atom *> &atoms)
 {
-    BOOST_REVERSE_FOREACH(Atom *atom, atoms){
+    beginEdit();
+
+    foreach(Atom *atom, atoms){
         removeAtom(atom);
     }
+
+    endEdit();
 }
 
 /// Returns the number of atoms in the molecule of the given
@@ -480,8 +944,11 @@ void Molecule::setAtomCapacity(size_t capacity)
 {
     m_atoms.reserve(capacity);
     m_elements.reserve(capacity);
+    d->massNumbers.reserve(capacity);
+    d->massNumbersSet.reserve(capacity);
     d->atomBonds.reserve(capacity);
     d->partialCharges.reserve(capacity);
+    d->atomStereochemistry.reserve(capacity);
 }
 
 /// Returns the atom capacity for the molecule.
@@ -521,10 +988,17 @@ Bond* Molecule::addBond(Atom *a, Atom *b, int order)
 
     // check to see if they are already bonded
     if(a->isBondedTo(b)){
-        return bond(a, b);
+        Bond *bond = this->bond(a, b);
+
+        // keep a bond that was marked for removal in the current edit
+        if(bond->m_index < d->removedBonds.size()){
+            d->removedBonds[bond->m_index] = false;
+        }
+
+        return bond;
     }
 
-    Bond *bond = new Bond(this, d->bonds.size());
+    Bond *bond = new(d->allocateSlot()) Bond(this, d->bonds.size());
     d->atomBonds[a->index()].push_back(bond);
     d->atomBonds[b->index()].push_back(bond);
     d->bonds.push_back(bond);
@@ -532,9 +1006,11 @@ Bond* Molecule::addBond(Atom *a, Atom *b, int order)
     // add bond properties
     d->bondAtoms.push_back(std::make_pair(a, b));
     d->bondOrders.push_back(order);
+    d->bondStereochemistry.push_back(Stereochemistry::None);
+
+    d->mergeFragmentSets(a, b);
 
     setRingsPerceived(false);
-    setFragmentsPerceived(false);
 
     notifyWatchers(bond, MoleculeWatcher::BondAdded);
 
@@ -548,15 +1024,35 @@ Bond* Molecule::addBond(size_t a, size_t b, int order)
 }
 
 /// Removes \p bond from the molecule.
+///
+/// If called during an edit the bond is only marked for removal and
+/// is removed when the edit ends.
+///
+/// \see beginEdit()
 void Molecule::removeBond(Bond *bond)
 {
     assert(bond->molecule() == this);
 
+    // mark the bond for removal during an edit
+    if(d->editDepth){
+        d->removedBonds.resize(d->bonds.size(), false);
+
+        if(!d->removedBonds[bond->m_index]){
+            d->removedBonds[bond->m_index] = true;
+            d->editChanged = true;
+        }
+
+        return;
+    }
+
+    Atom *a = bond->atom1();
+    Atom *b = bond->atom2();
+
     d->bonds.erase(d->bonds.begin() + bond->index());
 
     // remove bond from atom bond vectors
-    std::vector<Bond *> &bondsA = d->atomBonds[bond->atom1()->index()];
-    std::vector<Bond *> &bondsB = d->atomBonds[bond->atom2()->index()];
+    std::vector<Bond *> &bondsA = d->atomBonds[a->index()];
+    std::vector<Bond *> &bondsB = d->atomBonds[b->index()];
 
     bondsA.erase(std::find(bondsA.begin(), bondsA.end(), bond));
     bondsB.erase(std::find(bondsB.begin(), bondsB.end(), bond));
@@ -564,18 +1060,21 @@ void Molecule::removeBond(Bond *bond)
     // remove bond properties
     d->bondAtoms.erase(d->bondAtoms.begin() + bond->index());
     d->bondOrders.erase(d->bondOrders.begin() + bond->index());
+    d->bondStereochemistry.erase(d->bondStereochemistry.begin() + bond->index());
 
     // subtract one from the index of all bonds after this one
     for(size_t i = bond->index(); i < d->bonds.size(); i++){
         d->bonds[i]->m_index--;
     }
 
+    d->splitFragmentSet(a, b);
+
     setRingsPerceived(false);
-    setFragmentsPerceived(false);
 
     notifyWatchers(bond, MoleculeWatcher::BondRemoved);
 
-    delete bond;
+    bond->~Bond();
+    d->releaseSlot(bond);
 }
 
 /// Removes the bond between atoms \p a and \p b. Does nothing if
@@ -595,12 +1094,19 @@ void Molecule::removeBond(size_t a, size_t b)
     removeBond(bond(a, b));
 }
 
-/// Removes each bond in \p bonds from the molecule.
+/// Removes each bond in \p bonds from the molecule. The bonds are
+/// removed together in a single edit.
+///
+/// \see beginEdit()
 void Molecule::removeBonds(const std::vector<Bond *> &bonds)
 {
-    BOOST_REVERSE_FOREACH(Bond *bond, bonds){
+    beginEdit();
+
+    foreach(Bond *bond, bonds){
         removeBond(bond);
     }
+
+    endEdit();
 }
 
 /// Returns a range containing all of the bonds in the molecule.
@@ -664,8 +1170,123 @@ bool Molecule::contains(const Bond *bond) const
 /// Removes all atoms and bonds from the molecule.
 void Molecule::clear()
 {
-    removeBonds(d->bonds);
     removeAtoms(m_atoms);
+
+    // release the storage for the removed atoms and bonds in bulk
+    if(!d->editDepth && (!d->arena || d->arena.unique())){
+        d->releaseArena();
+    }
+}
+
+/// Begins an edit of the molecule.
+///
+/// Atoms and bonds removed during an edit are only marked for
+/// removal. They remain in the molecule (with their indices
+/// unchanged) until the edit ends at which point they are all
+/// removed in a single pass. This makes removing many atoms or bonds
+/// a linear time operation. Atoms and bonds marked for removal must
+/// not be used in any other way during the edit.
+///
+/// Watchers of the molecule are not notified of the individual
+/// changes made during an edit. Instead, a single
+/// MoleculeWatcher::StructureChanged notification is sent when the
+/// edit ends.
+///
+/// Edits may be nested, the changes are applied when the outermost
+/// edit ends.
+///
+/// For example, to remove every terminal hydrogen atom:
+/// \code
+/// molecule->beginEdit();
+/// foreach(Atom *atom, molecule->atoms()){
+///     if(atom->isTerminalHydrogen()){
+///         molecule->removeAtom(atom);
+///     }
+/// }
+/// molecule->endEdit();
+/// \endcode
+///
+/// \see endEdit()
+void Molecule::beginEdit()
+{
+    d->editDepth++;
+}
+
+/// Ends an edit of the molecule. Removes each atom and bond marked
+/// for removal during the edit and notifies the watchers of the
+/// molecule if anything changed.
+///
+/// \see beginEdit()
+void Molecule::endEdit()
+{
+    assert(d->editDepth > 0);
+
+    if(--d->editDepth){
+        return;
+    }
+
+    removeMarked();
+
+    if(d->editChanged){
+        d->editChanged = false;
+        notifyWatchers(MoleculeWatcher::StructureChanged);
+    }
+}
+
+/// Returns a snapshot of the bonding graph of the molecule.
+///
+/// The snapshot is created when first requested and then shared by
+/// every caller until an atom or bond is added or removed or a bond
+/// order is changed. Existing snapshots are never modified so they
+/// remain valid (though out of date) after the molecule changes.
+///
+/// \see GraphSnapshot
+boost::shared_ptr<const GraphSnapshot> Molecule::graphSnapshot() const
+{
+    boost::lock_guard<boost::recursive_mutex> lock(d->perceptionMutex);
+
+    if(!d->graphSnapshot){
+        d->graphSnapshot = boost::make_shared<GraphSnapshot>(this);
+    }
+
+    return d->graphSnapshot;
+}
+
+/// Returns a matrix containing the topological distances between
+/// every pair of atoms in the molecule.
+///
+/// The matrix is computed from the graph snapshot when first
+/// requested and then shared by every caller until an atom or bond
+/// is added or removed.
+///
+/// \see GraphDistanceMatrix
+boost::shared_ptr<const GraphDistanceMatrix> Molecule::graphDistanceMatrix() const
+{
+    {
+        boost::lock_guard<boost::recursive_mutex> lock(d->perceptionMutex);
+
+        if(d->graphDistanceMatrix){
+            return d->graphDistanceMatrix;
+        }
+    }
+
+    // the distances are computed without holding the perception lock
+    // because the computation may wait on tasks in the thread pool and
+    // a waiting thread runs other queued tasks which may use this
+    // molecule
+    boost::shared_ptr<const GraphSnapshot> snapshot = graphSnapshot();
+    boost::shared_ptr<GraphDistanceMatrix> matrix =
+        boost::make_shared<GraphDistanceMatrix>(*snapshot);
+
+    boost::lock_guard<boost::recursive_mutex> lock(d->perceptionMutex);
+
+    // another thread may have computed the distances while this one
+    // was working
+    if(!d->graphDistanceMatrix){
+        d->graphDistanceMatrix = matrix;
+    }
+
+    return d->graphDistanceMatrix;
 }
 
 // --- Ring Perception ----------------------------------------------------- //
@@ -694,13 +1315,26 @@ Molecule::RingRange Molecule::rings() const
 {
     // only run ring perception if necessary
     if(!ringsPerceived()){
-        // find rings
-        foreach(const std::vector<Atom *> &ring, chemkit::algorithm::rppath(this)){
-            d->rings.push_back(new Ring(ring));
-        }
+        // find rings. this is done without holding the perception lock
+        // because the search may wait on tasks in the thread pool and a
+        // waiting thread runs other queued tasks which may use this
+        // molecule
+        std::vector<std::vector<Atom *> > paths = chemkit::algorithm::rppath(this);
+
+        boost::lock_guard<boost::recursive_mutex> lock(d->perceptionMutex);
+
+        // another thread may have perceived the rings while this one
+        // was searching
+        if(!ringsPerceived()){
+            foreach(const std::vector<Atom *> &path, paths){
+                Ring *ring = new Ring(path);
+                ring->m_index = d->rings.size();
+                d->rings.push_back(ring);
+            }
 
-        // set perceived to true
-        setRingsPerceived(true);
+            // set perceived to true
+            setRingsPerceived(true);
+        }
     }
 
     return boost::make_iterator_range(d->rings.begin(), d->rings.end());
@@ -724,6 +1358,9 @@ void Molecule::setRingsPerceived(bool perceived) const
         }
 
         d->rings.clear();
+
+        d->ringMembershipPerceived = false;
+        d->aromaticityPerceived = false;
     }
 
     d->ringsPerceived = perceived;
@@ -756,9 +1393,13 @@ Fragment* Molecule::fragment(size_t index) const
 Molecule::FragmentRange Molecule::fragments() const
 {
     if(!fragmentsPerceived()){
-        perceiveFragments();
+        boost::lock_guard<boost::recursive_mutex> lock(d->perceptionMutex);
 
-        setFragmentsPerceived(true);
+        if(!fragmentsPerceived()){
+            perceiveFragments();
+
+            setFragmentsPerceived(true);
+        }
     }
 
     return boost::make_iterator_range(d->fragments.begin(),
@@ -768,7 +1409,7 @@ Molecule::FragmentRange Molecule::fragments() const
 /// Returns the number of fragments in the molecule.
 size_t Molecule::fragmentCount() const
 {
-    return fragments().size();
+    return d->fragmentSetCount;
 }
 
 /// Returns \c true if the molecule is fragmented. (i.e. contains
@@ -787,13 +1428,13 @@ void Molecule::removeFragment(Fragment *fragment)
 
 Fragment* Molecule::fragmentForAtom(const Atom *atom) const
 {
-    foreach(Fragment *fragment, fragments()){
-        if(fragment->contains(atom)){
-            return fragment;
-        }
+    if(!contains(atom)){
+        return 0;
     }
 
-    return 0;
+    fragments();
+
+    return d->atomFragments[atom->index()];
 }
 
 void Molecule::setFragmentsPerceived(bool perceived) const
@@ -807,6 +1448,7 @@ void Molecule::setFragmentsPerceived(bool perceived) const
         }
 
         d->fragments.clear();
+        d->atomFragments.clear();
     }
 
     d->fragmentsPerceived = perceived;
@@ -819,52 +1461,22 @@ bool Molecule::fragmentsPerceived() const
 
 void Molecule::perceiveFragments() const
 {
-    if(isEmpty()){
-        // nothing to do
-        return;
-    }
-
-    // position of the next atom to root the depth-first search
-    size_t position = 0;
-
-    // bitset marking each atom not visited yet
-    Bitset unvisited(m_atoms.size());
-    unvisited.set();
-
-    for(;;){
-        // bitset marking the atoms contained in the fragment
-        Bitset bitset(m_atoms.size());
-
-        // perform depth-first search
-        std::vector<const Atom *> row;
-        row.push_back(m_atoms[position]);
-
-        while(!row.empty()){
-            std::vector<const Atom *> nextRow;
+    // fragments are ordered by their first atom
+    std::vector<Fragment *> setFragments(m_atoms.size());
+    d->atomFragments.resize(m_atoms.size());
 
-            foreach(const Atom *atom, row){
-                bitset.set(atom->index());
-                unvisited.set(atom->index(), false);
+    for(size_t i = 0; i < m_atoms.size(); i++){
+        size_t set = d->findFragmentSet(i);
+        Fragment *&fragment = setFragments[set];
 
-                foreach(const Atom *neighbor, atom->neighbors()){
-                    if(unvisited[neighbor->index()]){
-                        nextRow.push_back(neighbor);
-                    }
-                }
-            }
-
-            row = nextRow;
+        if(!fragment){
+            fragment = new Fragment(const_cast<Molecule *>(this));
+            fragment->m_atoms.reserve(d->fragmentSizes[set]);
+            d->fragments.push_back(fragment);
         }
 
-        // create and add fragment
-        Fragment *fragment = new Fragment(const_cast<Molecule *>(this), bitset);
-        d->fragments.push_back(fragment);
-
-        // find next unvisited atom
-        position = unvisited.find_next(position);
-        if(position == Bitset::npos){
-            break;
-        }
+        fragment->m_atoms.push_back(m_atoms[i]);
+        d->atomFragments[i] = fragment;
     }
 }
 
@@ -872,6 +1484,12 @@ void Molecule::perceiveFragments() const
 /// Returns the coordinates for the molecule.
 CartesianCoordinates* Molecule::coordinates() const
 {
+    if(d->coordinatesCreated){
+        return m_coordinates;
+    }
+
+    boost::lock_guard<boost::recursive_mutex> lock(d->perceptionMutex);
+
     if(!m_coordinates){
         if(d->coordinateSets.empty() ||
            d->coordinateSets.front()->type() == CoordinateSet::None){
@@ -898,6 +1516,8 @@ CartesianCoordinates* Molecule::coordinates() const
         }
     }
 
+    d->coordinatesCreated = m_coordinates != 0;
+
     return m_coordinates;
 }
 
@@ -1060,13 +1680,7 @@ Point3 Molecule::centerOfMass() const
         return Point3(0, 0, 0);
     }
 
-    std::vector<Real> weights;
-
-    foreach(const Atom *atom, m_atoms){
-        weights.push_back(atom->mass());
-    }
-
-    return m_coordinates->weightedCenter(weights);
+    return m_coordinates->weightedCenter(masses());
 }
 
 // --- Operators ----------------------------------------------------------- //
@@ -1079,27 +1693,40 @@ Molecule& Molecule::operator=(const Molecule &molecule)
         // set new name
         setName(molecule.name());
 
-        std::map<const Atom *, Atom *> oldToNew;
+        // copy atoms and bonds
+        copyStructure(molecule);
 
-        // add new atoms
-        foreach(const Atom *atom, molecule.atoms()){
-            Atom *newAtom = addAtomCopy(atom);
-            oldToNew[atom] = newAtom;
+        if(!isEmpty()){
+            notifyWatchers(MoleculeWatcher::StructureChanged);
         }
+    }
 
-        // add new bonds
-        foreach(const Bond *bond, molecule.bonds()){
-            Bond *newBond = addBond(oldToNew[bond->atom1()], oldToNew[bond->atom2()]);
-            newBond->setOrder(bond->order());
+    return *this;
+}
 
-            if(bond->stereochemistry() != Stereochemistry::None){
-                newBond->setStereochemistry(bond->stereochemistry());
-            }
+#ifdef CHEMKIT_HAS_RVALUE_REFERENCES
+/// Replaces the contents of the molecule with the contents of
+/// \p molecule. The atom and bond objects are moved rather than
+/// copied and \p molecule is left empty. Watchers of both molecules
+/// are notified with MoleculeWatcher::StructureChanged.
+Molecule& Molecule::operator=(Molecule &&molecule)
+{
+    if(this != &molecule){
+        clear();
+
+        moveStructure(molecule);
+
+        if(!isEmpty()){
+            notifyWatchers(MoleculeWatcher::NameChanged);
+            notifyWatchers(MoleculeWatcher::StructureChanged);
+            molecule.notifyWatchers(MoleculeWatcher::NameChanged);
+            molecule.notifyWatchers(MoleculeWatcher::StructureChanged);
         }
     }
 
     return *this;
 }
+#endif
 
 /// Returns the atom at \p index in the molecule.
 ///
@@ -1113,8 +1740,238 @@ Atom* Molecule::operator[](size_t index) const
 }
 
 // --- Internal Methods ---------------------------------------------------- //
+// Finds the rings containing each atom and bond.
+void Molecule::perceiveRingMembership() const
+{
+    // perceive the rings before taking the lock (see rings())
+    rings();
+
+    boost::lock_guard<boost::recursive_mutex> lock(d->perceptionMutex);
+
+    if(d->ringMembershipPerceived){
+        return;
+    }
+
+    d->atomRings.assign(size(), std::vector<Ring *>());
+    d->bondRings.assign(bondCount(), std::vector<Ring *>());
+
+    foreach(Ring *ring, rings()){
+        foreach(Atom *atom, ring->atoms()){
+            d->atomRings[atom->index()].push_back(ring);
+
+            // a ring contains each bond between two of its atoms
+            foreach(Bond *bond, atom->bonds()){
+                const Atom *neighbor = bond->otherAtom(atom);
+
+                if(neighbor->index() > atom->index() && ring->contains(neighbor)){
+                    d->bondRings[bond->index()].push_back(ring);
+                }
+            }
+        }
+    }
+
+    d->ringMembershipPerceived = true;
+}
+
+// Determines the aromaticity of each ring and marks the atoms and
+// bonds in aromatic rings as aromatic.
+void Molecule::perceiveAromaticity() const
+{
+    // perceive the rings before taking the lock (see rings())
+    rings();
+
+    boost::lock_guard<boost::recursive_mutex> lock(d->perceptionMutex);
+
+    if(d->aromaticityPerceived){
+        return;
+    }
+
+    if(!d->ringMembershipPerceived){
+        perceiveRingMembership();
+    }
+
+    d->ringAromaticity.assign(d->rings.size(), false);
+    d->atomAromaticity.assign(size(), false);
+    d->bondAromaticity.assign(bondCount(), false);
+
+    foreach(const Ring *ring, d->rings){
+        if(!ring->calculateAromaticity()){
+            continue;
+        }
+
+        d->ringAromaticity[ring->m_index] = true;
+
+        foreach(const Atom *atom, ring->atoms()){
+            d->atomAromaticity[atom->index()] = true;
+        }
+    }
+
+    for(size_t i = 0; i < d->bondRings.size(); i++){
+        foreach(const Ring *ring, d->bondRings[i]){
+            if(d->ringAromaticity[ring->m_index]){
+                d->bondAromaticity[i] = true;
+                break;
+            }
+        }
+    }
+
+    d->aromaticityPerceived = true;
+}
+
+// Discards the cached ring membership and aromaticity information
+// that depends on the type of change.
+void Molecule::invalidatePerception(MoleculeWatcher::ChangeType type) const
+{
+    switch(type){
+        case MoleculeWatcher::AtomAdded:
+        case MoleculeWatcher::AtomRemoved:
+        case MoleculeWatcher::BondAdded:
+        case MoleculeWatcher::BondRemoved:
+            d->ringMembershipPerceived = false;
+            d->aromaticityPerceived = false;
+            d->graphSnapshot.reset();
+            d->graphDistanceMatrix.reset();
+            break;
+        case MoleculeWatcher::AtomElementChanged:
+            d->aromaticityPerceived = false;
+            break;
+        case MoleculeWatcher::BondOrderChanged:
+            d->aromaticityPerceived = false;
+            d->graphSnapshot.reset();
+            break;
+        default:
+            break;
+    }
+}
+
+// Removes the atoms and bonds marked for removal during an edit. The
+// atom and bond properties are compacted and the remaining atoms and
+// bonds are renumbered in a single pass over each.
+void Molecule::removeMarked()
+{
+    std::vector<bool> &removedAtoms = d->removedAtoms;
+    std::vector<bool> &removedBonds = d->removedBonds;
+
+    if(std::find(removedAtoms.begin(), removedAtoms.end(), true) == removedAtoms.end() &&
+       std::find(removedBonds.begin(), removedBonds.end(), true) == removedBonds.end()){
+        removedAtoms.clear();
+        removedBonds.clear();
+        return;
+    }
+
+    removedAtoms.resize(m_atoms.size(), false);
+    removedBonds.resize(d->bonds.size(), false);
+
+    // remove every bond to a removed atom (including any bonds
+    // added to the atom after it was marked for removal)
+    for(size_t i = 0; i < d->bonds.size(); i++){
+        if(removedAtoms[d->bondAtoms[i].first->m_index] ||
+           removedAtoms[d->bondAtoms[i].second->m_index]){
+            removedBonds[i] = true;
+        }
+    }
+
+    // remove marked bonds from the bond list of each atom
+    foreach(std::vector<Bond *> &bonds, d->atomBonds){
+        size_t count = 0;
+
+        for(size_t i = 0; i < bonds.size(); i++){
+            if(!removedBonds[bonds[i]->m_index]){
+                bonds[count++] = bonds[i];
+            }
+        }
+
+        bonds.resize(count);
+    }
+
+    // compact bonds and bond properties
+    size_t bondCount = 0;
+
+    for(size_t i = 0; i < d->bonds.size(); i++){
+        Bond *bond = d->bonds[i];
+
+        if(removedBonds[i]){
+            bond->~Bond();
+            d->releaseSlot(bond);
+            continue;
+        }
+
+        bond->m_index = bondCount;
+        d->bonds[bondCount] = bond;
+        d->bondAtoms[bondCount] = d->bondAtoms[i];
+        d->bondOrders[bondCount] = d->bondOrders[i];
+        d->bondStereochemistry[bondCount] = d->bondStereochemistry[i];
+        bondCount++;
+    }
+
+    d->bonds.resize(bondCount);
+    d->bondAtoms.resize(bondCount);
+    d->bondOrders.resize(bondCount);
+    d->bondStereochemistry.resize(bondCount);
+
+    // compact atoms and atom properties
+    size_t atomCount = 0;
+    size_t atomTypeCount = 0;
+
+    for(size_t i = 0; i < m_atoms.size(); i++){
+        Atom *atom = m_atoms[i];
+
+        if(removedAtoms[i]){
+            atom->m_molecule = 0;
+            atom->~Atom();
+            d->releaseSlot(atom);
+            continue;
+        }
+
+        atom->m_index = atomCount;
+        m_atoms[atomCount] = atom;
+        m_elements[atomCount] = m_elements[i];
+        d->massNumbers[atomCount] = d->massNumbers[i];
+        d->massNumbersSet[atomCount] = d->massNumbersSet[i];
+        d->atomBonds[atomCount].swap(d->atomBonds[i]);
+        d->partialCharges[atomCount] = d->partialCharges[i];
+        d->atomStereochemistry[atomCount] = d->atomStereochemistry[i];
+
+        if(i < d->atomTypes.size()){
+            d->atomTypes[atomTypeCount++] = d->atomTypes[i];
+        }
+
+        if(m_coordinates){
+            m_coordinates->setPosition(atomCount, m_coordinates->position(i));
+        }
+
+        atomCount++;
+    }
+
+    m_atoms.resize(atomCount);
+    m_elements.resize(atomCount);
+    d->massNumbers.resize(atomCount);
+    d->massNumbersSet.resize(atomCount);
+    d->atomBonds.resize(atomCount);
+    d->partialCharges.resize(atomCount);
+    d->atomStereochemistry.resize(atomCount);
+    d->atomTypes.resize(atomTypeCount);
+
+    if(m_coordinates){
+        m_coordinates->resize(atomCount);
+    }
+
+    removedAtoms.clear();
+    removedBonds.clear();
+
+    setRingsPerceived(false);
+    setFragmentsPerceived(false);
+    d->rebuildFragmentSets();
+    invalidatePerception(MoleculeWatcher::AtomRemoved);
+}
+
 void Molecule::notifyWatchers(MoleculeWatcher::ChangeType type)
 {
+    if(d->editDepth){
+        d->editChanged = true;
+        return;
+    }
+
     foreach(MoleculeWatcher *watcher, d->watchers){
         watcher->moleculeChanged(this, type);
     }
@@ -1122,6 +1979,13 @@ void Molecule::notifyWatchers(MoleculeWatcher::ChangeType type)
 
 void Molecule::notifyWatchers(const Atom *atom, MoleculeWatcher::ChangeType type)
 {
+    invalidatePerception(type);
+
+    if(d->editDepth){
+        d->editChanged = true;
+        return;
+    }
+
     foreach(MoleculeWatcher *watcher, d->watchers){
         watcher->atomChanged(atom, type);
     }
@@ -1129,6 +1993,13 @@ void Molecule::notifyWatchers(const Atom *atom, MoleculeWatcher::ChangeType type
 
 void Molecule::notifyWatchers(const Bond *bond, MoleculeWatcher::ChangeType type)
 {
+    invalidatePerception(type);
+
+    if(d->editDepth){
+        d->editChanged = true;
+        return;
+    }
+
     foreach(MoleculeWatcher *watcher, d->watchers){
         watcher->bondChanged(bond, type);
     }
@@ -1144,13 +2015,131 @@ void Molecule::removeWatcher(MoleculeWatcher *watcher) const
     d->watchers.erase(std::remove(d->watchers.begin(), d->watchers.end(), watcher));
 }
 
-Stereochemistry* Molecule::stereochemistry()
+// Copies the atoms and bonds from molecule into this molecule which
+// must be empty. The per-atom and per-bond arrays are copied directly
+// and the storage for every atom and bond is reserved in one slab so
+// no watchers are notified and no lookup tables are needed.
+void Molecule::copyStructure(const Molecule &molecule)
 {
-    if(!m_stereochemistry){
-        m_stereochemistry = new Stereochemistry(this);
+    assert(isEmpty() && !bondCount());
+
+    const size_t atomCount = molecule.atomCount();
+    const size_t bondCount = molecule.bondCount();
+    if(!atomCount){
+        return;
+    }
+
+    d->reserveSlots(atomCount + bondCount);
+
+    // atoms
+    m_atoms.reserve(atomCount);
+    for(size_t i = 0; i < atomCount; i++){
+        m_atoms.push_back(new(d->allocateSlot()) Atom(this, i));
+    }
+
+    m_elements = molecule.m_elements;
+    d->massNumbers = molecule.d->massNumbers;
+    d->massNumbersSet = molecule.d->massNumbersSet;
+    d->partialCharges = molecule.d->partialCharges;
+    d->atomStereochemistry = molecule.d->atomStereochemistry;
+
+    // bonds
+    d->bonds.reserve(bondCount);
+    d->bondAtoms.reserve(bondCount);
+    for(size_t i = 0; i < bondCount; i++){
+        d->bonds.push_back(new(d->allocateSlot()) Bond(this, i));
+
+        const std::pair<Atom *, Atom *> &atoms = molecule.d->bondAtoms[i];
+        d->bondAtoms.push_back(std::make_pair(m_atoms[atoms.first->index()],
+                                              m_atoms[atoms.second->index()]));
+    }
+
+    d->bondOrders = molecule.d->bondOrders;
+    d->bondStereochemistry = molecule.d->bondStereochemistry;
+    d->fragmentParents = molecule.d->fragmentParents;
+    d->fragmentSizes = molecule.d->fragmentSizes;
+    d->fragmentSetCount = molecule.d->fragmentSetCount;
+
+    d->atomBonds.resize(atomCount);
+    for(size_t i = 0; i < atomCount; i++){
+        const std::vector<Bond *> &bonds = molecule.d->atomBonds[i];
+        std::vector<Bond *> &newBonds = d->atomBonds[i];
+
+        newBonds.reserve(bonds.size());
+        foreach(const Bond *bond, bonds){
+            newBonds.push_back(d->bonds[bond->index()]);
+        }
+    }
+
+    // coordinates
+    const CartesianCoordinates *coordinates = molecule.coordinates();
+    CartesianCoordinates *newCoordinates = this->coordinates();
+    newCoordinates->resize(atomCount);
+    for(size_t i = 0; i < atomCount; i++){
+        newCoordinates->setPosition(i, coordinates->position(i));
+    }
+
+    setRingsPerceived(false);
+    setFragmentsPerceived(false);
+    invalidatePerception(MoleculeWatcher::AtomAdded);
+}
+
+// Moves the contents of molecule into this molecule which must be
+// empty. The atom and bond objects along with the storage they live
+// in are transferred and are updated to refer to this molecule. The
+// watchers of each molecule are left unchanged and molecule is left
+// empty.
+void Molecule::moveStructure(Molecule &molecule)
+{
+    assert(isEmpty() && !bondCount());
+    assert(!d->editDepth && !molecule.d->editDepth);
+
+    // rings and fragments are perceived again as needed
+    molecule.setRingsPerceived(false);
+    molecule.setFragmentsPerceived(false);
+    setRingsPerceived(false);
+    setFragmentsPerceived(false);
+
+    std::swap(m_coordinates, molecule.m_coordinates);
+    d->coordinatesCreated = m_coordinates != 0;
+    molecule.d->coordinatesCreated = molecule.m_coordinates != 0;
+    m_atoms.swap(molecule.m_atoms);
+    m_elements.swap(molecule.m_elements);
+
+    MoleculePrivate *other = molecule.d;
+    d->name.swap(other->name);
+    d->bonds.swap(other->bonds);
+    d->data.swap(other->data);
+    d->massNumbers.swap(other->massNumbers);
+    d->massNumbersSet.swap(other->massNumbersSet);
+    d->atomTypes.swap(other->atomTypes);
+    d->atomTypeNames.swap(other->atomTypeNames);
+    d->atomTypeIds.swap(other->atomTypeIds);
+    d->partialCharges.swap(other->partialCharges);
+    d->atomStereochemistry.swap(other->atomStereochemistry);
+    d->bondAtoms.swap(other->bondAtoms);
+    d->atomBonds.swap(other->atomBonds);
+    d->bondOrders.swap(other->bondOrders);
+    d->bondStereochemistry.swap(other->bondStereochemistry);
+    d->coordinateSets.swap(other->coordinateSets);
+    d->arena.swap(other->arena);
+    std::swap(d->slab, other->slab);
+    std::swap(d->slabRemaining, other->slabRemaining);
+    std::swap(d->slotCount, other->slotCount);
+    d->freeSlots.swap(other->freeSlots);
+    d->fragmentParents.swap(other->fragmentParents);
+    d->fragmentSizes.swap(other->fragmentSizes);
+    std::swap(d->fragmentSetCount, other->fragmentSetCount);
+
+    foreach(Atom *atom, m_atoms){
+        atom->m_molecule = this;
+    }
+    foreach(Bond *bond, d->bonds){
+        bond->m_molecule = this;
     }
 
-    return m_stereochemistry;
+    invalidatePerception(MoleculeWatcher::AtomAdded);
+    molecule.invalidatePerception(MoleculeWatcher::AtomRemoved);
 }
 
 } // end chemkit namespace
@@ -60,11 +60,12 @@ class Atom;
 class Bond;
 class Ring;
 class Fragment;
+class GraphSnapshot;
 class MoleculePrivate;
 class MoleculeWatcher;
-class Stereochemistry;
 class DiagramCoordinates;
 class InternalCoordinates;
+class GraphDistanceMatrix;
 class CartesianCoordinates;
 
 class CHEMKIT_EXPORT Molecule
@@ -81,6 +82,9 @@ public:
     Molecule();
     Molecule(const std::string &formula, const std::string &format);
     Molecule(const Molecule &molecule);
+#ifdef CHEMKIT_HAS_RVALUE_REFERENCES
+    Molecule(Molecule &&molecule);
+#endif
     virtual ~Molecule();
 
     // properties
@@ -93,6 +97,10 @@ public:
     inline size_t size() const;
     inline bool isEmpty() const;
     Real mass() const;
+    std::vector<Real> masses() const;
+    std::vector<Real> partialCharges() const;
+    std::vector<Real> covalentRadii() const;
+    std::vector<Real> vanDerWaalsRadii() const;
     void setData(const std::string &name, const Variant &value);
     Variant data(const std::string &name) const;
 
@@ -128,6 +136,10 @@ public:
     size_t bondCapacity() const;
     bool contains(const Bond *bond) const;
     void clear();
+    void beginEdit();
+    void endEdit();
+    boost::shared_ptr<const GraphSnapshot> graphSnapshot() const;
+    boost::shared_ptr<const GraphDistanceMatrix> graphDistanceMatrix() const;
 
     // ring perception
     Ring* ring(size_t index) const;
@@ -165,6 +177,9 @@ public:
 
     // operators
     Molecule& operator=(const Molecule &molecule);
+#ifdef CHEMKIT_HAS_RVALUE_REFERENCES
+    Molecule& operator=(Molecule &&molecule);
+#endif
     Atom* operator[](size_t index) const;
 
 private:
@@ -175,23 +190,29 @@ private:
     bool fragmentsPerceived() const;
     void perceiveFragments() const;
     Fragment* fragmentForAtom(const Atom *atom) const;
+    void perceiveRingMembership() const;
+    void perceiveAromaticity() const;
+    void invalidatePerception(MoleculeWatcher::ChangeType type) const;
+    void removeMarked();
+    void copyStructure(const Molecule &molecule);
+    void moveStructure(Molecule &molecule);
     void notifyWatchers(MoleculeWatcher::ChangeType type);
     void notifyWatchers(const Atom *atom, MoleculeWatcher::ChangeType type);
     void notifyWatchers(const Bond *bond, MoleculeWatcher::ChangeType type);
     void addWatcher(MoleculeWatcher *watcher) const;
     void removeWatcher(MoleculeWatcher *watcher) const;
-    Stereochemistry* stereochemistry();
 
     friend class Atom;
     friend class Bond;
+    friend class Ring;
     friend class MoleculeWatcher;
+    friend class Stereochemistry;
 
 private:
     MoleculePrivate* const d;
     std::vector<Atom *> m_atoms;
     std::vector<Element> m_elements;
     mutable CartesianCoordinates *m_coordinates;
-    Stereochemistry *m_stereochemistry;
 };
 
 } // end chemkit namespace
@@ -0,0 +1,228 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculearena.h"
+
+#include <new>
+#include <vector>
+#include <algorithm>
+
+#include <boost/thread.hpp>
+
+#include "foreach.h"
+
+namespace chemkit {
+
+namespace {
+
+// alignment of each allocation (sufficient for every type stored)
+const size_t Alignment = 16;
+
+// the arena used for molecules created in the current thread
+boost::thread_specific_ptr<boost::shared_ptr<MoleculeArena> > currentArenaPointer;
+
+} // end anonymous namespace
+
+// === MoleculeArenaPrivate ================================================ //
+class MoleculeArenaPrivate
+{
+public:
+    size_t blockSize;
+    std::vector<char *> blocks;
+    char *next;
+    size_t remaining;
+    size_t size;
+    size_t capacity;
+    boost::mutex mutex;
+};
+
+// === MoleculeArena ======================================================= //
+/// \class MoleculeArena moleculearena.h chemkit/moleculearena.h
+/// \ingroup chemkit
+/// \brief The MoleculeArena class provides block storage for the
+///        atoms and bonds in molecules.
+///
+/// Molecules allocate their Atom and Bond objects in slabs taken
+/// from an arena instead of allocating each one individually. By
+/// default each molecule creates a private arena which is released
+/// in bulk when the molecule is cleared or destroyed.
+///
+/// A single arena may also be shared between many molecules in
+/// order to store their atoms and bonds contiguously. The memory
+/// for a shared arena is released once the last molecule using it
+/// (and every other reference to it) has been destroyed. Memory for
+/// atoms and bonds removed from a molecule is reused by that
+/// molecule but is not returned to the arena.
+///
+/// The following example reads a file with all of its molecules
+/// packed into a single arena:
+/// \code
+/// boost::shared_ptr<MoleculeArena> arena(new MoleculeArena);
+///
+/// MoleculeFile file("ligands.sdf");
+/// file.setArena(arena);
+/// file.read();
+/// \endcode
+///
+/// \see MoleculeArena::setCurrentArena()
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty arena which allocates memory in blocks of
+/// \p blockSize bytes.
+MoleculeArena::MoleculeArena(size_t blockSize)
+    : d(new MoleculeArenaPrivate)
+{
+    d->blockSize = blockSize;
+    d->next = 0;
+    d->remaining = 0;
+    d->size = 0;
+    d->capacity = 0;
+}
+
+/// Destroys the arena and releases all of its memory.
+MoleculeArena::~MoleculeArena()
+{
+    release();
+
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the size in bytes of the blocks allocated by the arena.
+size_t MoleculeArena::blockSize() const
+{
+    return d->blockSize;
+}
+
+/// Returns the number of blocks allocated by the arena.
+size_t MoleculeArena::blockCount() const
+{
+    boost::lock_guard<boost::mutex> lock(d->mutex);
+
+    return d->blocks.size();
+}
+
+/// Returns the number of bytes that have been allocated from the
+/// arena.
+size_t MoleculeArena::size() const
+{
+    boost::lock_guard<boost::mutex> lock(d->mutex);
+
+    return d->size;
+}
+
+/// Returns the total number of bytes reserved by the arena.
+size_t MoleculeArena::capacity() const
+{
+    boost::lock_guard<boost::mutex> lock(d->mutex);
+
+    return d->capacity;
+}
+
+// --- Allocation ---------------------------------------------------------- //
+/// Allocates \p size bytes from the arena and returns a pointer to
+/// the memory. The memory remains valid until the arena is released
+/// or destroyed.
+///
+/// This method is thread-safe.
+void* MoleculeArena::allocate(size_t size)
+{
+    // round up to keep every allocation aligned
+    size = std::max<size_t>((size + Alignment - 1) & ~(Alignment - 1), Alignment);
+
+    boost::lock_guard<boost::mutex> lock(d->mutex);
+
+    if(size > d->remaining){
+        size_t blockSize = std::max(d->blockSize, size);
+
+        char *block = static_cast<char *>(::operator new(blockSize));
+        d->blocks.push_back(block);
+        d->capacity += blockSize;
+
+        d->next = block;
+        d->remaining = blockSize;
+    }
+
+    void *memory = d->next;
+    d->next += size;
+    d->remaining -= size;
+    d->size += size;
+
+    return memory;
+}
+
+/// Releases all of the memory allocated by the arena.
+///
+/// \warning Any objects still stored in the arena must not be used
+///          after calling this method.
+void MoleculeArena::release()
+{
+    boost::lock_guard<boost::mutex> lock(d->mutex);
+
+    foreach(char *block, d->blocks){
+        ::operator delete(block);
+    }
+
+    d->blocks.clear();
+    d->next = 0;
+    d->remaining = 0;
+    d->size = 0;
+    d->capacity = 0;
+}
+
+// --- Static Methods ------------------------------------------------------ //
+/// Sets the arena used for new molecules created in the current
+/// thread to \p arena. If \p arena is \c 0 each new molecule will
+/// use its own private arena (the default).
+void MoleculeArena::setCurrentArena(const boost::shared_ptr<MoleculeArena> &arena)
+{
+    if(arena){
+        currentArenaPointer.reset(new boost::shared_ptr<MoleculeArena>(arena));
+    }
+    else{
+        currentArenaPointer.reset();
+    }
+}
+
+/// Returns the arena used for new molecules created in the current
+/// thread. Returns \c 0 if molecules use private arenas.
+boost::shared_ptr<MoleculeArena> MoleculeArena::currentArena()
+{
+    boost::shared_ptr<MoleculeArena> *arena = currentArenaPointer.get();
+
+    return arena ? *arena : boost::shared_ptr<MoleculeArena>();
+}
+
+} // end chemkit namespace
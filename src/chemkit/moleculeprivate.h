@@ -42,10 +42,16 @@
 #include <string>
 #include <vector>
 
+#include <boost/atomic.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+
 #include "bond.h"
 #include "point3.h"
 #include "isotope.h"
 #include "variantmap.h"
+#include "moleculearena.h"
+#include "stereochemistry.h"
 
 namespace chemkit {
 
@@ -54,28 +60,73 @@ class Bond;
 class Ring;
 class Fragment;
 class CoordinateSet;
+class GraphSnapshot;
 class MoleculeWatcher;
+class GraphDistanceMatrix;
 
 class MoleculePrivate
 {
 public:
     MoleculePrivate();
 
+    void* allocateSlot();
+    void reserveSlots(size_t count);
+    void releaseSlot(void *slot);
+    void releaseArena();
+    void addFragmentSet(Atom *atom);
+    void removeFragmentSet(size_t atom);
+    size_t findFragmentSet(size_t atom) const;
+    bool unionFragmentSets(size_t a, size_t b);
+    void mergeFragmentSets(const Atom *a, const Atom *b);
+    void splitFragmentSet(const Atom *a, const Atom *b);
+    void insertFragment(Fragment *fragment);
+    void rebuildFragmentSets();
+
     std::string name;
     std::vector<Bond *> bonds;
-    bool ringsPerceived;
+    boost::recursive_mutex perceptionMutex;
+    boost::atomic<bool> ringsPerceived;
     std::vector<Ring *> rings;
-    bool fragmentsPerceived;
+    boost::atomic<bool> ringMembershipPerceived;
+    std::vector<std::vector<Ring *> > atomRings;
+    std::vector<std::vector<Ring *> > bondRings;
+    boost::atomic<bool> aromaticityPerceived;
+    std::vector<bool> ringAromaticity;
+    std::vector<bool> atomAromaticity;
+    std::vector<bool> bondAromaticity;
+    boost::atomic<bool> fragmentsPerceived;
     std::vector<Fragment *> fragments;
+    std::vector<Fragment *> atomFragments;
+    std::vector<size_t> fragmentParents;
+    std::vector<size_t> fragmentSizes;
+    size_t fragmentSetCount;
+    std::vector<bool> fragmentVisited;
     std::vector<MoleculeWatcher *> watchers;
+    size_t editDepth;
+    bool editChanged;
+    std::vector<bool> removedAtoms;
+    std::vector<bool> removedBonds;
     VariantMap data;
-    std::map<const Atom *, Isotope> isotopes;
-    std::vector<std::string> atomTypes;
+    std::vector<Isotope::MassNumberType> massNumbers;
+    std::vector<bool> massNumbersSet;
+    std::vector<Stereochemistry::Type> atomStereochemistry;
+    std::vector<int> atomTypes;
+    std::vector<std::string> atomTypeNames;
+    boost::unordered_map<std::string, int> atomTypeIds;
     std::vector<Real> partialCharges;
     std::vector<std::pair<Atom*, Atom*> > bondAtoms;
     std::vector<std::vector<Bond *> > atomBonds;
     std::vector<Bond::BondOrderType> bondOrders;
+    std::vector<Stereochemistry::Type> bondStereochemistry;
     std::vector<boost::shared_ptr<CoordinateSet> > coordinateSets;
+    boost::atomic<bool> coordinatesCreated;
+    boost::shared_ptr<const GraphSnapshot> graphSnapshot;
+    boost::shared_ptr<const GraphDistanceMatrix> graphDistanceMatrix;
+    boost::shared_ptr<MoleculeArena> arena;
+    char *slab;
+    size_t slabRemaining;
+    size_t slotCount;
+    std::vector<void *> freeSlots;
 };
 
 } // end chemkit namespace
@@ -128,6 +128,14 @@ const Molecule* MoleculeWatcher::molecule() const
 ///
 /// This signal is emitted when the molecule's name changes.
 
+/// \fn void MoleculeWatcher::structureChanged(const Molecule *molecule)
+///
+/// This signal is emitted once at the end of an edit of the molecule
+/// instead of the individual signals for each change made during the
+/// edit.
+///
+/// \see Molecule::beginEdit()
+
 // --- Events ---------------------------------------------------- //
 void MoleculeWatcher::moleculeChanged(const Molecule *molecule, ChangeType changeType)
 {
@@ -135,6 +143,9 @@ void MoleculeWatcher::moleculeChanged(const Molecule *molecule, ChangeType chang
         case NameChanged:
             nameChanged(molecule);
             break;
+        case StructureChanged:
+            structureChanged(molecule);
+            break;
         default:
             break;
     }
@@ -64,7 +64,8 @@ public:
         BondAdded,
         BondRemoved,
         BondOrderChanged,
-        NameChanged
+        NameChanged,
+        StructureChanged
     };
 
     // construction and destruction
@@ -84,6 +85,7 @@ public:
     boost::signals2::signal<void (const Bond *bond)> bondRemoved;
     boost::signals2::signal<void (const Bond *bond)> bondOrderChanged;
     boost::signals2::signal<void (const Molecule *molecule)> nameChanged;
+    boost::signals2::signal<void (const Molecule *molecule)> structureChanged;
 
 private:
     void atomChanged(const Atom *atom, ChangeType changeType);
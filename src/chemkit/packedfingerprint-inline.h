@@ -0,0 +1,121 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_PACKEDFINGERPRINT_INLINE_H
+#define CHEMKIT_PACKEDFINGERPRINT_INLINE_H
+
+#include "packedfingerprint.h"
+
+#include <cassert>
+
+namespace chemkit {
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of bits in the fingerprint.
+inline size_t PackedFingerprint::size() const
+{
+    return m_size;
+}
+
+/// Returns \c true if the fingerprint contains no bits.
+inline bool PackedFingerprint::isEmpty() const
+{
+    return m_size == 0;
+}
+
+/// Returns the number of words in the fingerprint including the
+/// padding words.
+inline size_t PackedFingerprint::wordCount() const
+{
+    return m_wordCount;
+}
+
+/// Returns a pointer to the words in the fingerprint.
+inline PackedFingerprint::Word* PackedFingerprint::words()
+{
+    return m_words;
+}
+
+/// \overload
+inline const PackedFingerprint::Word* PackedFingerprint::words() const
+{
+    return m_words;
+}
+
+// --- Bits ---------------------------------------------------------------- //
+/// Sets the bit at \p index to \p value.
+inline void PackedFingerprint::set(size_t index, bool value)
+{
+    assert(index < m_size);
+
+    Word mask = Word(1) << (index % WordSize);
+
+    if(value){
+        m_words[index / WordSize] |= mask;
+    }
+    else{
+        m_words[index / WordSize] &= ~mask;
+    }
+}
+
+/// Clears the bit at \p index.
+inline void PackedFingerprint::reset(size_t index)
+{
+    set(index, false);
+}
+
+/// Returns \c true if the bit at \p index is set.
+inline bool PackedFingerprint::test(size_t index) const
+{
+    assert(index < m_size);
+
+    return (m_words[index / WordSize] >> (index % WordSize)) & 1;
+}
+
+// --- Operators ----------------------------------------------------------- //
+/// Returns \c true if the bit at \p index is set.
+inline bool PackedFingerprint::operator[](size_t index) const
+{
+    return test(index);
+}
+
+inline bool PackedFingerprint::operator!=(const PackedFingerprint &fingerprint) const
+{
+    return !operator==(fingerprint);
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_PACKEDFINGERPRINT_INLINE_H
@@ -0,0 +1,433 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "packedfingerprint.h"
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+
+#include <boost/align/aligned_alloc.hpp>
+
+// the x86 kernels are compiled for instruction sets beyond the
+// baseline and selected at run-time if the processor supports them.
+// the avx2 kernels use 64-bit extracts which are only available on
+// x86-64
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+    #define CHEMKIT_X86_FINGERPRINT_KERNELS
+    #include <immintrin.h>
+
+    #if defined(__x86_64__)
+        #define CHEMKIT_AVX2_FINGERPRINT_KERNELS
+    #endif
+#endif
+
+namespace chemkit {
+
+namespace {
+
+typedef PackedFingerprint::Word Word;
+
+// --- Kernels ------------------------------------------------------------- //
+// Returns the number of bits set in word.
+inline size_t popcount(Word word)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (word * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+size_t countGeneric(const Word *words, size_t wordCount)
+{
+    size_t count = 0;
+
+    for(size_t i = 0; i < wordCount; i++){
+        count += popcount(words[i]);
+    }
+
+    return count;
+}
+
+size_t intersectionCountGeneric(const Word *a, const Word *b, size_t wordCount)
+{
+    size_t count = 0;
+
+    for(size_t i = 0; i < wordCount; i++){
+        count += popcount(a[i] & b[i]);
+    }
+
+    return count;
+}
+
+#ifdef CHEMKIT_X86_FINGERPRINT_KERNELS
+__attribute__((target("popcnt")))
+size_t countPopcnt(const Word *words, size_t wordCount)
+{
+    size_t count = 0;
+
+    for(size_t i = 0; i < wordCount; i++){
+        count += __builtin_popcountll(words[i]);
+    }
+
+    return count;
+}
+
+__attribute__((target("popcnt")))
+size_t intersectionCountPopcnt(const Word *a, const Word *b, size_t wordCount)
+{
+    size_t count = 0;
+
+    for(size_t i = 0; i < wordCount; i++){
+        count += __builtin_popcountll(a[i] & b[i]);
+    }
+
+    return count;
+}
+
+#ifdef CHEMKIT_AVX2_FINGERPRINT_KERNELS
+// Returns the number of bits set in each byte of the vector. The
+// count for each nibble is looked up in a table with a shuffle.
+__attribute__((target("avx2")))
+inline __m256i byteCountsAvx2(__m256i vector)
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+
+    __m256i low = _mm256_and_si256(vector, mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(vector, 4), mask);
+
+    return _mm256_add_epi8(_mm256_shuffle_epi8(table, low),
+                           _mm256_shuffle_epi8(table, high));
+}
+
+// Returns the sum of the four 64-bit counts in the vector.
+__attribute__((target("avx2")))
+inline size_t horizontalSumAvx2(__m256i counts)
+{
+    return _mm256_extract_epi64(counts, 0) +
+           _mm256_extract_epi64(counts, 1) +
+           _mm256_extract_epi64(counts, 2) +
+           _mm256_extract_epi64(counts, 3);
+}
+
+__attribute__((target("avx2,popcnt")))
+size_t countAvx2(const Word *words, size_t wordCount)
+{
+    __m256i counts = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for(; i + 4 <= wordCount; i += 4){
+        __m256i vector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+
+        counts = _mm256_add_epi64(counts, _mm256_sad_epu8(byteCountsAvx2(vector),
+                                                          _mm256_setzero_si256()));
+    }
+
+    size_t count = horizontalSumAvx2(counts);
+    for(; i < wordCount; i++){
+        count += __builtin_popcountll(words[i]);
+    }
+
+    return count;
+}
+
+__attribute__((target("avx2,popcnt")))
+size_t intersectionCountAvx2(const Word *a, const Word *b, size_t wordCount)
+{
+    __m256i counts = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for(; i + 4 <= wordCount; i += 4){
+        __m256i vector = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+                                          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+
+        counts = _mm256_add_epi64(counts, _mm256_sad_epu8(byteCountsAvx2(vector),
+                                                          _mm256_setzero_si256()));
+    }
+
+    size_t count = horizontalSumAvx2(counts);
+    for(; i < wordCount; i++){
+        count += __builtin_popcountll(a[i] & b[i]);
+    }
+
+    return count;
+}
+#endif // CHEMKIT_AVX2_FINGERPRINT_KERNELS
+#endif // CHEMKIT_X86_FINGERPRINT_KERNELS
+
+// The Kernels class selects the fastest kernels supported by the
+// processor the first time they are used.
+class Kernels
+{
+public:
+    Kernels();
+
+    static const Kernels& instance();
+
+    size_t (*count)(const Word *words, size_t wordCount);
+    size_t (*intersectionCount)(const Word *a, const Word *b, size_t wordCount);
+};
+
+Kernels::Kernels()
+{
+    count = countGeneric;
+    intersectionCount = intersectionCountGeneric;
+
+#ifdef CHEMKIT_X86_FINGERPRINT_KERNELS
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("popcnt")){
+        count = countPopcnt;
+        intersectionCount = intersectionCountPopcnt;
+    }
+
+#ifdef CHEMKIT_AVX2_FINGERPRINT_KERNELS
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")){
+        count = countAvx2;
+        intersectionCount = intersectionCountAvx2;
+    }
+#endif
+#endif
+}
+
+const Kernels& Kernels::instance()
+{
+    static const Kernels kernels;
+
+    return kernels;
+}
+
+// --- Storage ------------------------------------------------------------- //
+Word* allocateWords(size_t wordCount)
+{
+    if(!wordCount){
+        return 0;
+    }
+
+    void *memory = boost::alignment::aligned_alloc(PackedFingerprint::Alignment,
+                                                   wordCount * sizeof(Word));
+    if(!memory){
+        throw std::bad_alloc();
+    }
+
+    return static_cast<Word *>(memory);
+}
+
+void freeWords(Word *words)
+{
+    boost::alignment::aligned_free(words);
+}
+
+} // end anonymous namespace
+
+// === PackedFingerprint =================================================== //
+/// \class PackedFingerprint packedfingerprint.h chemkit/packedfingerprint.h
+/// \ingroup chemkit
+/// \brief The PackedFingerprint class contains a fixed-width
+///        fingerprint packed into 64-bit words.
+///
+/// The words are aligned to the start of a cache line and padded
+/// with zero bits to a whole number of cache lines (512 bits). For
+/// example, a 1021 bit FP2 fingerprint occupies sixteen words. This
+/// allows the bit counts used for similarity to be computed a word
+/// (or a vector of words) at a time without allocating memory and
+/// without handling a partial last word.
+///
+/// The bit counting kernels use the processor's popcount and AVX2
+/// instructions when they are available.
+///
+/// \see Fingerprint, Bitset
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty fingerprint.
+PackedFingerprint::PackedFingerprint()
+    : m_size(0),
+      m_wordCount(0),
+      m_words(0)
+{
+}
+
+/// Creates a new fingerprint with \p size bits which are all clear.
+PackedFingerprint::PackedFingerprint(size_t size)
+    : m_size(size),
+      m_wordCount(wordCount(size)),
+      m_words(allocateWords(m_wordCount))
+{
+    clear();
+}
+
+/// Creates a new fingerprint containing the bits in \p bitset.
+PackedFingerprint::PackedFingerprint(const Bitset &bitset)
+    : m_size(bitset.size()),
+      m_wordCount(wordCount(bitset.size())),
+      m_words(allocateWords(m_wordCount))
+{
+    clear();
+
+    for(size_t i = bitset.find_first(); i != Bitset::npos; i = bitset.find_next(i)){
+        set(i);
+    }
+}
+
+/// Creates a new fingerprint as a copy of \p fingerprint.
+PackedFingerprint::PackedFingerprint(const PackedFingerprint &fingerprint)
+    : m_size(fingerprint.m_size),
+      m_wordCount(fingerprint.m_wordCount),
+      m_words(allocateWords(m_wordCount))
+{
+    if(m_wordCount){
+        std::memcpy(m_words, fingerprint.m_words, m_wordCount * sizeof(Word));
+    }
+}
+
+/// Destroys the fingerprint.
+PackedFingerprint::~PackedFingerprint()
+{
+    freeWords(m_words);
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of bits that are set in the fingerprint.
+size_t PackedFingerprint::count() const
+{
+    return count(m_words, m_wordCount);
+}
+
+/// Returns \c true if every bit set in \p fingerprint is also set
+/// in the fingerprint. Both fingerprints must be the same size.
+///
+/// This is used to screen molecules before a substructure search.
+/// A molecule can only contain a substructure if its fingerprint
+/// contains the substructure's fingerprint.
+bool PackedFingerprint::contains(const PackedFingerprint &fingerprint) const
+{
+    assert(m_size == fingerprint.m_size);
+
+    for(size_t i = 0; i < m_wordCount; i++){
+        if(fingerprint.m_words[i] & ~m_words[i]){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// --- Bits ---------------------------------------------------------------- //
+/// Clears every bit in the fingerprint.
+void PackedFingerprint::clear()
+{
+    if(m_wordCount){
+        std::memset(m_words, 0, m_wordCount * sizeof(Word));
+    }
+}
+
+// --- Conversions --------------------------------------------------------- //
+/// Returns a bitset containing the bits in the fingerprint.
+Bitset PackedFingerprint::toBitset() const
+{
+    Bitset bitset(m_size);
+
+    for(size_t i = 0; i < m_wordCount; i++){
+        Word word = m_words[i];
+
+        for(size_t bit = i * WordSize; word; bit++, word >>= 1){
+            if(word & 1){
+                bitset.set(bit);
+            }
+        }
+    }
+
+    return bitset;
+}
+
+// --- Operators ----------------------------------------------------------- //
+PackedFingerprint& PackedFingerprint::operator=(const PackedFingerprint &fingerprint)
+{
+    if(this != &fingerprint){
+        if(m_wordCount != fingerprint.m_wordCount){
+            Word *words = allocateWords(fingerprint.m_wordCount);
+            freeWords(m_words);
+            m_words = words;
+            m_wordCount = fingerprint.m_wordCount;
+        }
+
+        m_size = fingerprint.m_size;
+
+        if(m_wordCount){
+            std::memcpy(m_words, fingerprint.m_words, m_wordCount * sizeof(Word));
+        }
+    }
+
+    return *this;
+}
+
+bool PackedFingerprint::operator==(const PackedFingerprint &fingerprint) const
+{
+    return m_size == fingerprint.m_size &&
+           std::equal(m_words, m_words + m_wordCount, fingerprint.m_words);
+}
+
+// --- Static Methods ------------------------------------------------------ //
+/// Returns the number of words used to store a fingerprint with
+/// \p size bits. This is rounded up to a whole number of cache lines.
+size_t PackedFingerprint::wordCount(size_t size)
+{
+    const size_t bitsPerLine = Alignment * 8;
+
+    return (size + bitsPerLine - 1) / bitsPerLine * (bitsPerLine / WordSize);
+}
+
+/// Returns the number of bits set in the \p wordCount words starting
+/// at \p words.
+size_t PackedFingerprint::count(const Word *words, size_t wordCount)
+{
+    return Kernels::instance().count(words, wordCount);
+}
+
+/// Returns the number of bits set in both the \p wordCount words
+/// starting at \p a and the \p wordCount words starting at \p b.
+size_t PackedFingerprint::intersectionCount(const Word *a, const Word *b, size_t wordCount)
+{
+    return Kernels::instance().intersectionCount(a, b, wordCount);
+}
+
+} // end chemkit namespace
@@ -0,0 +1,107 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_PACKEDFINGERPRINT_H
+#define CHEMKIT_PACKEDFINGERPRINT_H
+
+#include "chemkit.h"
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#endif
+
+#include "bitset.h"
+
+namespace chemkit {
+
+class CHEMKIT_EXPORT PackedFingerprint
+{
+public:
+    // typedefs
+    typedef boost::uint64_t Word;
+
+    // constants
+    enum {
+        WordSize = 64,
+        Alignment = 64
+    };
+
+    // construction and destruction
+    PackedFingerprint();
+    explicit PackedFingerprint(size_t size);
+    explicit PackedFingerprint(const Bitset &bitset);
+    PackedFingerprint(const PackedFingerprint &fingerprint);
+    ~PackedFingerprint();
+
+    // properties
+    inline size_t size() const;
+    inline bool isEmpty() const;
+    inline size_t wordCount() const;
+    inline Word* words();
+    inline const Word* words() const;
+    size_t count() const;
+    bool contains(const PackedFingerprint &fingerprint) const;
+
+    // bits
+    inline void set(size_t index, bool value = true);
+    inline void reset(size_t index);
+    inline bool test(size_t index) const;
+    void clear();
+
+    // conversions
+    Bitset toBitset() const;
+
+    // operators
+    PackedFingerprint& operator=(const PackedFingerprint &fingerprint);
+    inline bool operator[](size_t index) const;
+    bool operator==(const PackedFingerprint &fingerprint) const;
+    inline bool operator!=(const PackedFingerprint &fingerprint) const;
+
+    // static methods
+    static size_t wordCount(size_t size);
+    static size_t count(const Word *words, size_t wordCount);
+    static size_t intersectionCount(const Word *a, const Word *b, size_t wordCount);
+
+private:
+    size_t m_size;
+    size_t m_wordCount;
+    Word *m_words;
+};
+
+} // end chemkit namespace
+
+#include "packedfingerprint-inline.h"
+
+#endif // CHEMKIT_PACKEDFINGERPRINT_H
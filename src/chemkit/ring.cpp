@@ -45,6 +45,7 @@
 #include "bond.h"
 #include "foreach.h"
 #include "molecule.h"
+#include "moleculeprivate.h"
 
 namespace chemkit {
 
@@ -60,7 +61,8 @@ namespace chemkit {
 // --- Construction and Destruction ---------------------------------------- //
 /// Creates a new ring that contains the atoms is \p path.
 Ring::Ring(std::vector<Atom *> path)
-    : m_atoms(path)
+    : m_atoms(path),
+      m_index(0)
 {
     assert(isValid());
 }
@@ -245,7 +247,23 @@ bool Ring::isFusedTo(const Ring *ring) const
 
 // --- Aromaticity --------------------------------------------------------- //
 /// Returns \c true if the ring is aromatic.
+///
+/// The aromaticity of every ring in the molecule is determined the
+/// first time this is called and is cached until the molecule's
+/// atoms, bonds, elements or bond orders change.
 bool Ring::isAromatic() const
+{
+    const Molecule *molecule = this->molecule();
+
+    if(!molecule->d->aromaticityPerceived){
+        molecule->perceiveAromaticity();
+    }
+
+    return molecule->d->ringAromaticity[m_index];
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+bool Ring::calculateAromaticity() const
 {
     // check for planarity of all ring atoms
     if(!isPlanar()){
@@ -302,7 +320,6 @@ bool Ring::isAromatic() const
     return false;
 }
 
-// --- Internal Methods ---------------------------------------------------- //
 bool Ring::isValid() const
 {
     if(size() < 3)
@@ -104,6 +104,7 @@ private:
     const Bond *previousBond(const Atom *atom) const;
     bool isPlanar() const;
     size_t piElectronCount() const;
+    bool calculateAromaticity() const;
 
     CHEMKIT_DISABLE_COPY(Ring)
 
@@ -111,6 +112,7 @@ private:
 
 private:
     std::vector<Atom *> m_atoms;
+    size_t m_index;
 };
 
 } // end chemkit namespace
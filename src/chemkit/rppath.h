@@ -38,12 +38,16 @@
 
 #include "chemkit.h"
 
+#include <map>
 #include <set>
 #include <limits>
+#include <iterator>
 #include <algorithm>
 
 #ifndef Q_MOC_RUN
 #include <boost/bind.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/unordered_map.hpp>
 #endif
 
 #include <Eigen/Core>
@@ -53,6 +57,7 @@
 #include "foreach.h"
 #include "fragment.h"
 #include "molecule.h"
+#include "concurrent.h"
 
 namespace chemkit {
 namespace algorithm {
@@ -298,24 +303,165 @@ inline bool Sssr<T>::isUnique(const std::vector<T> &path) const
     return true;
 }
 
-} // end detail namespace
+// Returns each ring formed from the paths of candidate in the order
+// they are checked.
+template<typename T>
+inline std::vector<std::vector<T> > candidateRings(const RingCandidate<T> &candidate,
+                                                   PidMatrix<T> &P,
+                                                   PidMatrix<T> &Pt)
+{
+    std::vector<std::vector<T> > rings;
+
+    T start = candidate.start();
+    T end = candidate.end();
+
+    // odd sized ring
+    if(candidate.size() & 1){
+        for(size_t i = 0; i < Pt(start, end).size(); i++){
+            std::vector<T> ring;
+            ring.push_back(start);
+            const std::vector<T> &path = Pt(start, end)[i];
+            ring.insert(ring.end(), path.begin(), path.end());
+            ring.push_back(end);
+            if(!P(end, start).empty()){
+                const std::vector<T> &returnPath = P(end, start)[0];
+                ring.insert(ring.end(), returnPath.begin(), returnPath.end());
+            }
 
-// Returns the smallest set of smallest rings in a graph using the
-// RP-Path algorithm.
+            rings.push_back(ring);
+        }
+    }
+    // even sized ring
+    else{
+        for(size_t i = 0; i < P(start, end).size() - 1; i++){
+            std::vector<T> ring;
+            ring.push_back(start);
+            const std::vector<T> &path = P(start, end)[i];
+            ring.insert(ring.end(), path.begin(), path.end());
+            ring.push_back(end);
+            const std::vector<T> &returnPath = P(end, start)[i+1];
+            ring.insert(ring.end(), returnPath.begin(), returnPath.end());
+
+            rings.push_back(ring);
+        }
+    }
+
+    return rings;
+}
+
+// Returns the bonds in ring as sorted pairs of vertices.
+template<typename T>
+inline std::vector<std::pair<T, T> > ringBonds(const std::vector<T> &ring)
+{
+    std::vector<std::pair<T, T> > bonds;
+    for(size_t i = 0; i < ring.size(); i++){
+        T next = ring[(i + 1) % ring.size()];
+
+        bonds.push_back(std::make_pair(std::min(ring[i], next),
+                                       std::max(ring[i], next)));
+    }
+
+    std::sort(bonds.begin(), bonds.end());
+
+    return bonds;
+}
+
+// Returns true if the rings found from candidates do not depend on
+// the order in which candidates of the same size are checked. The
+// candidates must be sorted by size.
 //
-// For a description of the algorithm see [Lee 2009].
+// For each size the rings which are valid and unique given the
+// smaller rings are collected. Any order finds the same rings if each
+// candidate forms at most one of them, each of them is still unique
+// given all of the others and there are no more rings in total than
+// the ring count.
 template<typename T>
-inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
+inline bool isOrderIndependent(const std::vector<RingCandidate<T> > &candidates,
+                               PidMatrix<T> &P,
+                               PidMatrix<T> &Pt,
+                               size_t ringCount)
+{
+    typedef std::vector<std::pair<T, T> > BondList;
+
+    Sssr<T> smallerRings;
+
+    size_t first = 0;
+    while(first < candidates.size()){
+        size_t last = first;
+        while(last < candidates.size() && candidates[last].size() == candidates[first].size()){
+            last++;
+        }
+
+        // rings of this size keyed by their bonds
+        std::map<BondList, std::vector<T> > rings;
+
+        for(size_t i = first; i < last; i++){
+            BondList candidateBonds;
+
+            foreach(const std::vector<T> &ring, candidateRings(candidates[i], P, Pt)){
+                if(!smallerRings.isValid(ring) || !smallerRings.isUnique(ring)){
+                    continue;
+                }
+
+                BondList bonds = ringBonds(ring);
+
+                if(candidateBonds.empty()){
+                    candidateBonds = bonds;
+                    rings.insert(std::make_pair(bonds, ring));
+                }
+                else if(bonds != candidateBonds){
+                    return false;
+                }
+            }
+        }
+
+        if(smallerRings.size() + rings.size() > ringCount){
+            return false;
+        }
+
+        typedef typename std::map<BondList, std::vector<T> >::const_iterator RingIterator;
+
+        for(RingIterator iter = rings.begin(); iter != rings.end(); ++iter){
+            Sssr<T> otherRings = smallerRings;
+
+            for(RingIterator otherIter = rings.begin(); otherIter != rings.end(); ++otherIter){
+                if(otherIter != iter){
+                    otherRings.append(otherIter->second);
+                }
+            }
+
+            if(!otherRings.isUnique(iter->second)){
+                return false;
+            }
+        }
+
+        for(RingIterator iter = rings.begin(); iter != rings.end(); ++iter){
+            smallerRings.append(iter->second);
+        }
+
+        first = last;
+    }
+
+    return true;
+}
+
+// Returns the rings in graph found by the RP-Path algorithm. If
+// orderIndependent is not null it is set to true if the same rings
+// are found regardless of the order in which the sort leaves ring
+// candidates of the same size.
+template<typename T>
+inline std::vector<std::vector<T> > findRings(const Graph<T> &graph, bool *orderIndependent)
 {
     typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> DistanceMatrix;
-    using chemkit::algorithm::detail::PidMatrix;
-    using chemkit::algorithm::detail::RingCandidate;
-    using chemkit::algorithm::detail::Sssr;
 
     T n = graph.size();
 
     T ringCount = graph.edgeCount() - graph.vertexCount() + 1;
     if(ringCount == 0){
+        if(orderIndependent){
+            *orderIndependent = true;
+        }
+
         return std::vector<std::vector<T> >();
     }
 
@@ -397,57 +543,244 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
     Sssr<T> sssr;
 
     foreach(const RingCandidate<T> &candidate, candidates){
-        // odd sized ring
-        if(candidate.size() & 1){
-            for(size_t i = 0; i < Pt(candidate.start(), candidate.end()).size(); i++){
-                std::vector<T> ring;
-                ring.push_back(candidate.start());
-                std::vector<T> &path = Pt(candidate.start(), candidate.end())[i];
-                ring.insert(ring.end(), path.begin(), path.end());
-                ring.push_back(candidate.end());
-                if(!P(candidate.end(), candidate.start()).empty()){
-                    path = P(candidate.end(), candidate.start())[0];
-                    ring.insert(ring.end(), path.begin(), path.end());
+        foreach(const std::vector<T> &ring, candidateRings(candidate, P, Pt)){
+            // check if ring is valid and unique
+            if(sssr.isValid(ring) && sssr.isUnique(ring)){
+                sssr.append(ring);
+                break;
+            }
+        }
+
+        if(sssr.size() == ringCount){
+            break;
+        }
+    }
+
+    if(orderIndependent){
+        *orderIndependent = isOrderIndependent(candidates, P, Pt, ringCount);
+    }
+
+    return sssr.rings();
+}
+
+} // end detail namespace
+
+// Returns the smallest set of smallest rings in a graph using the
+// RP-Path algorithm.
+//
+// For a description of the algorithm see [Lee 2009].
+template<typename T>
+inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
+{
+    return detail::findRings(graph, static_cast<bool *>(0));
+}
+
+namespace detail {
+
+inline bool compareAtomIndices(const Atom *a, const Atom *b)
+{
+    return a->index() < b->index();
+}
+
+inline bool compareFirstAtomIndices(const std::vector<Atom *> &a, const std::vector<Atom *> &b)
+{
+    return a.front()->index() < b.front()->index();
+}
+
+inline bool compareRingSizes(const std::vector<Atom *> &a, const std::vector<Atom *> &b)
+{
+    return a.size() < b.size();
+}
+
+// === RingSystemSearch ==================================================== //
+// Runs the RP-Path algorithm on each ring system.
+class RingSystemSearch
+{
+public:
+    typedef void result_type;
+
+    RingSystemSearch(const std::vector<std::vector<Atom *> > &ringSystems,
+                     std::vector<std::vector<std::vector<Atom *> > > &rings,
+                     std::vector<char> &orderIndependent)
+        : m_ringSystems(ringSystems),
+          m_rings(rings),
+          m_orderIndependent(orderIndependent)
+    {
+    }
+
+    void operator()(size_t index) const
+    {
+        const std::vector<Atom *> &atoms = m_ringSystems[index];
+
+        // create graph
+        Graph<size_t> graph(atoms.size());
+
+        for(size_t i = 0; i < atoms.size(); i++){
+            foreach(Atom *neighbor, atoms[i]->neighbors()){
+                if(neighbor->index() <= atoms[i]->index()){
+                    continue;
                 }
 
-                // check if ring is valid and unique
-                if(sssr.isValid(ring) && sssr.isUnique(ring)){
-                    sssr.append(ring);
-                    break;
+                // the atoms are sorted by index so the neighbor can
+                // be found with a binary search
+                std::vector<Atom *>::const_iterator iter =
+                    std::lower_bound(atoms.begin() + i + 1,
+                                     atoms.end(),
+                                     neighbor,
+                                     compareAtomIndices);
+
+                if(iter != atoms.end() && *iter == neighbor){
+                    graph.addEdge(i, iter - atoms.begin());
                 }
             }
         }
-        // even sized ring
-        else{
-            for(size_t i = 0; i < P(candidate.start(), candidate.end()).size() - 1; i++){
-                std::vector<T> ring;
-                ring.push_back(candidate.start());
-                std::vector<T> &path = P(candidate.start(), candidate.end())[i];
-                ring.insert(ring.end(), path.begin(), path.end());
-                ring.push_back(candidate.end());
-                path = P(candidate.end(), candidate.start())[i+1];
-                ring.insert(ring.end(), path.begin(), path.end());
-
-                // check if ring is valid and unique
-                if(sssr.isValid(ring) && sssr.isUnique(ring)){
-                    sssr.append(ring);
+
+        // perceive rings
+        bool orderIndependent = false;
+        std::vector<std::vector<size_t> > sssr = findRings(graph, &orderIndependent);
+        m_orderIndependent[index] = orderIndependent;
+
+        // convert from lists of indices to lists of atoms
+        std::vector<std::vector<Atom *> > &rings = m_rings[index];
+
+        foreach(const std::vector<size_t> &cycle, sssr){
+            std::vector<Atom *> ring(cycle.size());
+
+            for(size_t i = 0; i < cycle.size(); i++){
+                ring[i] = atoms[cycle[i]];
+            }
+
+            rings.push_back(ring);
+        }
+    }
+
+private:
+    const std::vector<std::vector<Atom *> > &m_ringSystems;
+    std::vector<std::vector<std::vector<Atom *> > > &m_rings;
+    std::vector<char> &m_orderIndependent;
+};
+
+// Returns the ring systems formed by atoms. Each ring system is a
+// biconnected component containing at least one cycle and is
+// returned as a list of atoms sorted by index. Atoms in acyclic
+// chains are not part of any ring system.
+//
+// The components are found with an iterative version of the
+// Hopcroft-Tarjan algorithm so very long chains do not overflow
+// the stack.
+inline std::vector<std::vector<Atom *> > ringSystems(const std::vector<Atom *> &atoms)
+{
+    const size_t none = std::numeric_limits<size_t>::max();
+
+    size_t n = atoms.size();
+
+    // create adjacency lists
+    boost::unordered_map<const Atom *, size_t> indices;
+    for(size_t i = 0; i < n; i++){
+        indices[atoms[i]] = i;
+    }
+
+    std::vector<std::vector<size_t> > adjacencyList(n);
+    for(size_t i = 0; i < n; i++){
+        foreach(const Atom *neighbor, atoms[i]->neighbors()){
+            boost::unordered_map<const Atom *, size_t>::const_iterator iter = indices.find(neighbor);
+
+            if(iter != indices.end()){
+                adjacencyList[i].push_back(iter->second);
+            }
+        }
+    }
+
+    std::vector<size_t> discovery(n, 0);
+    std::vector<size_t> low(n, 0);
+    std::vector<std::pair<size_t, size_t> > edges;
+    std::vector<boost::tuple<size_t, size_t, size_t> > stack;
+    std::vector<std::vector<Atom *> > systems;
+    size_t time = 0;
+
+    for(size_t root = 0; root < n; root++){
+        if(discovery[root]){
+            continue;
+        }
+
+        discovery[root] = low[root] = ++time;
+        stack.push_back(boost::make_tuple(root, none, 0));
+
+        while(!stack.empty()){
+            size_t vertex = boost::get<0>(stack.back());
+            size_t parent = boost::get<1>(stack.back());
+            size_t &next = boost::get<2>(stack.back());
+
+            if(next < adjacencyList[vertex].size()){
+                size_t neighbor = adjacencyList[vertex][next++];
+
+                if(!discovery[neighbor]){
+                    edges.push_back(std::make_pair(vertex, neighbor));
+                    discovery[neighbor] = low[neighbor] = ++time;
+                    stack.push_back(boost::make_tuple(neighbor, vertex, 0));
+                }
+                else if(neighbor != parent && discovery[neighbor] < discovery[vertex]){
+                    edges.push_back(std::make_pair(vertex, neighbor));
+                    low[vertex] = std::min(low[vertex], discovery[neighbor]);
+                }
+
+                continue;
+            }
+
+            stack.pop_back();
+
+            if(parent == none){
+                continue;
+            }
+
+            low[parent] = std::min(low[parent], low[vertex]);
+
+            if(low[vertex] < discovery[parent]){
+                continue;
+            }
+
+            // parent is an articulation point (or the root) so the
+            // edges above it form a biconnected component
+            std::vector<size_t> component;
+            size_t edgeCount = 0;
+
+            for(;;){
+                std::pair<size_t, size_t> edge = edges.back();
+                edges.pop_back();
+                edgeCount++;
+
+                component.push_back(edge.first);
+                component.push_back(edge.second);
+
+                if(edge.first == parent && edge.second == vertex){
                     break;
                 }
             }
-        }
 
-        if(sssr.size() == ringCount){
-            break;
+            // a single edge is a bridge and not part of a ring
+            if(edgeCount < 2){
+                continue;
+            }
+
+            std::vector<Atom *> system;
+            foreach(size_t index, component){
+                system.push_back(atoms[index]);
+            }
+
+            std::sort(system.begin(), system.end(), compareAtomIndices);
+            system.erase(std::unique(system.begin(), system.end()), system.end());
+
+            systems.push_back(system);
         }
     }
 
-    return sssr.rings();
+    return systems;
 }
 
-inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
+// Returns the rings found by running the RP-Path algorithm on all of
+// the atoms at once with only the acyclic atoms removed.
+inline std::vector<std::vector<Atom *> > fragmentRings(std::vector<Atom *> atoms)
 {
-    std::vector<Atom *> atoms = fragment->atoms();
-
     // remove any terminal atoms
     atoms.erase(std::remove_if(atoms.begin(), atoms.end(), boost::bind(&Atom::isTerminal, _1)), atoms.end());
 
@@ -485,6 +818,67 @@ inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
     return rings;
 }
 
+// Returns the smallest set of smallest rings for the atoms. The ring
+// systems are found first and the RP-Path algorithm is run on each
+// one separately. The rings are sorted by size.
+//
+// No shortest path between two atoms of a ring system leaves it, so
+// each system finds the same rings it does in a search of all the
+// atoms as long as they do not depend on the order in which ring
+// candidates of the same size are checked. That order depends on
+// every candidate in the fragment. If any system finds rings which
+// depend on it (e.g. a cage with several equally small rings) the
+// rings are found from all of the atoms at once instead so that the
+// result is the same as before the ring systems were split.
+inline std::vector<std::vector<Atom *> > perceiveRings(const std::vector<Atom *> &atoms)
+{
+    std::vector<std::vector<Atom *> > systems = ringSystems(atoms);
+
+    // order the ring systems by their first atom
+    std::sort(systems.begin(), systems.end(), compareFirstAtomIndices);
+
+    std::vector<std::vector<std::vector<Atom *> > > systemRings(systems.size());
+    std::vector<char> orderIndependent(systems.size(), false);
+    RingSystemSearch search(systems, systemRings, orderIndependent);
+
+    // search large sets of ring systems in parallel
+    size_t systemAtomCount = 0;
+    foreach(const std::vector<Atom *> &system, systems){
+        systemAtomCount += system.size();
+    }
+
+    if(systems.size() > 1 && systemAtomCount > 256){
+        chemkit::concurrent::parallel_for(0, systems.size(), search);
+    }
+    else{
+        for(size_t i = 0; i < systems.size(); i++){
+            search(i);
+        }
+    }
+
+    if(std::find(orderIndependent.begin(), orderIndependent.end(), false) != orderIndependent.end()){
+        return fragmentRings(atoms);
+    }
+
+    std::vector<std::vector<Atom *> > rings;
+    foreach(const std::vector<std::vector<Atom *> > &ringsInSystem, systemRings){
+        rings.insert(rings.end(), ringsInSystem.begin(), ringsInSystem.end());
+    }
+
+    std::stable_sort(rings.begin(), rings.end(), compareRingSizes);
+
+    return rings;
+}
+
+} // end detail namespace
+
+// Returns the smallest set of smallest rings in fragment.
+inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
+{
+    return detail::perceiveRings(fragment->atoms());
+}
+
+// Returns the smallest set of smallest rings in molecule.
 inline std::vector<std::vector<Atom *> > rppath(const Molecule *molecule)
 {
     std::vector<std::vector<Atom *> > rings;
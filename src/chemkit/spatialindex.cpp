@@ -0,0 +1,738 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "spatialindex.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <Eigen/Dense>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "atom.h"
+#include "foreach.h"
+#include "molecule.h"
+#include "unitcell.h"
+#include "cartesiancoordinates.h"
+
+namespace chemkit {
+
+namespace {
+
+typedef Eigen::Matrix<Real, 3, 3> Matrix3;
+typedef std::pair<Real, size_t> Neighbor;
+
+// collects the points visited within the query radius
+struct WithinCollector
+{
+    WithinCollector(std::vector<size_t> &indices)
+        : indices(indices)
+    {
+    }
+
+    void operator()(size_t index, Real)
+    {
+        indices.push_back(index);
+    }
+
+    std::vector<size_t> &indices;
+};
+
+// collects the visited points with an index greater than index
+struct PairCollector
+{
+    PairCollector(std::vector<SpatialIndex::Pair> &pairs)
+        : index(0),
+          pairs(pairs)
+    {
+    }
+
+    void operator()(size_t other, Real)
+    {
+        if(other > index){
+            pairs.push_back(std::make_pair(index, other));
+        }
+    }
+
+    size_t index;
+    std::vector<SpatialIndex::Pair> &pairs;
+};
+
+// collects the visited points along with their squared distance
+struct NeighborCollector
+{
+    NeighborCollector(std::vector<Neighbor> &neighbors)
+        : neighbors(neighbors)
+    {
+    }
+
+    void operator()(size_t index, Real squaredDistance)
+    {
+        neighbors.push_back(std::make_pair(squaredDistance, index));
+    }
+
+    std::vector<Neighbor> &neighbors;
+};
+
+// orders point indices by their coordinate along an axis
+struct AxisLess
+{
+    AxisLess(const std::vector<Point3> &positions, int axis)
+        : positions(positions),
+          axis(axis)
+    {
+    }
+
+    bool operator()(size_t a, size_t b) const
+    {
+        return positions[a][axis] < positions[b][axis];
+    }
+
+    const std::vector<Point3> &positions;
+    int axis;
+};
+
+} // end anonymous namespace
+
+// === SpatialIndexPrivate ================================================= //
+class SpatialIndexPrivate
+{
+public:
+    std::vector<Point3> positions;
+    Real requestedCellSize;
+    Real cellSize;
+    bool periodic;
+    Matrix3 cellMatrix;
+    Matrix3 inverseCellMatrix;
+    Real widths[3];
+    Point3 origin;
+    int dimensions[3];
+    std::vector<std::vector<size_t> > cells;
+    std::vector<size_t> pointCells;
+    mutable std::vector<size_t> treeOrder;
+    mutable std::vector<int> treeAxes;
+    mutable bool treeValid;
+    mutable boost::mutex treeMutex;
+
+    void buildGrid();
+    void cellCoordinates(const Point3 &point, int coordinates[3]) const;
+    size_t cellIndex(const Point3 &point) const;
+    Vector3 minimumImage(const Vector3 &vector) const;
+    template<typename Visitor> void visitWithin(const Point3 &point, Real radius, Visitor &visitor) const;
+    void updateTree() const;
+    void buildTree(size_t begin, size_t end) const;
+    void searchTree(size_t begin, size_t end, const Point3 &point, size_t k, std::vector<Neighbor> &heap) const;
+};
+
+void SpatialIndexPrivate::buildGrid()
+{
+    size_t size = positions.size();
+    size_t maximumCellCount = 8 * size + 8;
+
+    Real volume;
+    Real extents[3];
+
+    if(periodic){
+        Vector3 x = cellMatrix.col(0);
+        Vector3 y = cellMatrix.col(1);
+        Vector3 z = cellMatrix.col(2);
+
+        volume = std::abs(x.dot(y.cross(z)));
+        widths[0] = volume / y.cross(z).norm();
+        widths[1] = volume / z.cross(x).norm();
+        widths[2] = volume / x.cross(y).norm();
+
+        for(int i = 0; i < 3; i++){
+            extents[i] = widths[i];
+        }
+    }
+    else{
+        Point3 minimum = Point3::Zero();
+        Point3 maximum = Point3::Zero();
+
+        if(size){
+            minimum = maximum = positions[0];
+        }
+
+        foreach(const Point3 &position, positions){
+            minimum = minimum.cwiseMin(position);
+            maximum = maximum.cwiseMax(position);
+        }
+
+        origin = minimum;
+
+        volume = 1;
+        for(int i = 0; i < 3; i++){
+            extents[i] = maximum[i] - minimum[i];
+            volume *= extents[i] + 1;
+        }
+    }
+
+    // by default choose a cell size giving about two points per cell
+    cellSize = requestedCellSize;
+    if(cellSize <= 0){
+        cellSize = std::pow(2 * volume / std::max(size, size_t(1)), Real(1.0 / 3.0));
+    }
+
+    for(;;){
+        size_t cellCount = 1;
+
+        for(int i = 0; i < 3; i++){
+            if(periodic){
+                dimensions[i] = std::max(1, static_cast<int>(extents[i] / cellSize));
+            }
+            else{
+                dimensions[i] = static_cast<int>(extents[i] / cellSize) + 1;
+            }
+
+            cellCount *= dimensions[i];
+        }
+
+        // limit the memory used by very small cells
+        if(cellCount <= maximumCellCount){
+            break;
+        }
+
+        cellSize *= 1.25;
+    }
+
+    cells.assign(dimensions[0] * dimensions[1] * dimensions[2], std::vector<size_t>());
+    pointCells.resize(size);
+
+    for(size_t i = 0; i < size; i++){
+        size_t cell = cellIndex(positions[i]);
+        cells[cell].push_back(i);
+        pointCells[i] = cell;
+    }
+}
+
+void SpatialIndexPrivate::cellCoordinates(const Point3 &point, int coordinates[3]) const
+{
+    if(periodic){
+        Vector3 fractional = inverseCellMatrix * point;
+
+        for(int i = 0; i < 3; i++){
+            Real value = fractional[i] - std::floor(fractional[i]);
+            coordinates[i] = std::min(static_cast<int>(value * dimensions[i]), dimensions[i] - 1);
+        }
+    }
+    else{
+        for(int i = 0; i < 3; i++){
+            Real value = std::floor((point[i] - origin[i]) / cellSize);
+            value = std::max(Real(0), std::min(value, Real(dimensions[i] - 1)));
+            coordinates[i] = static_cast<int>(value);
+        }
+    }
+}
+
+size_t SpatialIndexPrivate::cellIndex(const Point3 &point) const
+{
+    int coordinates[3];
+    cellCoordinates(point, coordinates);
+
+    return (coordinates[2] * dimensions[1] + coordinates[1]) * dimensions[0] + coordinates[0];
+}
+
+Vector3 SpatialIndexPrivate::minimumImage(const Vector3 &vector) const
+{
+    if(!periodic){
+        return vector;
+    }
+
+    Vector3 fractional = inverseCellMatrix * vector;
+    for(int i = 0; i < 3; i++){
+        fractional[i] -= std::floor(fractional[i] + 0.5);
+    }
+
+    return cellMatrix * fractional;
+}
+
+// Calls visitor with the index and squared distance of each point
+// within radius of point.
+template<typename Visitor>
+void SpatialIndexPrivate::visitWithin(const Point3 &point, Real radius, Visitor &visitor) const
+{
+    if(positions.empty()){
+        return;
+    }
+
+    int lower[3];
+    int upper[3];
+
+    if(periodic){
+        Vector3 fractional = inverseCellMatrix * point;
+
+        for(int i = 0; i < 3; i++){
+            Real center = (fractional[i] - std::floor(fractional[i])) * dimensions[i];
+            Real span = radius / widths[i] * dimensions[i];
+
+            lower[i] = static_cast<int>(std::floor(center - span));
+            upper[i] = static_cast<int>(std::floor(center + span));
+
+            // visit each cell only once when the sphere wraps around
+            if(upper[i] - lower[i] + 1 >= dimensions[i]){
+                lower[i] = 0;
+                upper[i] = dimensions[i] - 1;
+            }
+        }
+    }
+    else{
+        for(int i = 0; i < 3; i++){
+            Real low = std::floor((point[i] - radius - origin[i]) / cellSize);
+            Real high = std::floor((point[i] + radius - origin[i]) / cellSize);
+
+            lower[i] = static_cast<int>(std::max(Real(0), std::min(low, Real(dimensions[i] - 1))));
+            upper[i] = static_cast<int>(std::max(Real(0), std::min(high, Real(dimensions[i] - 1))));
+        }
+    }
+
+    const Real squaredRadius = radius * radius;
+
+    for(int z = lower[2]; z <= upper[2]; z++){
+        int cz = ((z % dimensions[2]) + dimensions[2]) % dimensions[2];
+
+        for(int y = lower[1]; y <= upper[1]; y++){
+            int cy = ((y % dimensions[1]) + dimensions[1]) % dimensions[1];
+
+            for(int x = lower[0]; x <= upper[0]; x++){
+                int cx = ((x % dimensions[0]) + dimensions[0]) % dimensions[0];
+
+                const std::vector<size_t> &cell = cells[(cz * dimensions[1] + cy) * dimensions[0] + cx];
+
+                foreach(size_t index, cell){
+                    Real squaredDistance = minimumImage(positions[index] - point).squaredNorm();
+
+                    if(squaredDistance <= squaredRadius){
+                        visitor(index, squaredDistance);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Builds the k-d tree if the positions have changed since it was last
+// built. The tree is built lazily from the const nearest() method so
+// the build is guarded by a mutex to allow concurrent queries.
+void SpatialIndexPrivate::updateTree() const
+{
+    boost::lock_guard<boost::mutex> lock(treeMutex);
+
+    if(treeValid){
+        return;
+    }
+
+    treeOrder.resize(positions.size());
+    for(size_t i = 0; i < positions.size(); i++){
+        treeOrder[i] = i;
+    }
+    treeAxes.assign(positions.size(), 0);
+    buildTree(0, positions.size());
+    treeValid = true;
+}
+
+// Builds the k-d tree for the points in treeOrder between begin and
+// end. The median point of each range is split along the axis with
+// the largest extent.
+void SpatialIndexPrivate::buildTree(size_t begin, size_t end) const
+{
+    if(end - begin < 2){
+        return;
+    }
+
+    Point3 minimum = positions[treeOrder[begin]];
+    Point3 maximum = minimum;
+    for(size_t i = begin + 1; i < end; i++){
+        minimum = minimum.cwiseMin(positions[treeOrder[i]]);
+        maximum = maximum.cwiseMax(positions[treeOrder[i]]);
+    }
+
+    int axis;
+    (maximum - minimum).maxCoeff(&axis);
+
+    size_t middle = begin + (end - begin) / 2;
+
+    std::vector<size_t>::iterator first = treeOrder.begin();
+    std::nth_element(first + begin, first + middle, first + end,
+                     AxisLess(positions, axis));
+
+    treeAxes[middle] = axis;
+
+    buildTree(begin, middle);
+    buildTree(middle + 1, end);
+}
+
+void SpatialIndexPrivate::searchTree(size_t begin,
+                                     size_t end,
+                                     const Point3 &point,
+                                     size_t k,
+                                     std::vector<Neighbor> &heap) const
+{
+    if(begin >= end){
+        return;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    size_t index = treeOrder[middle];
+
+    Real squaredDistance = (positions[index] - point).squaredNorm();
+    if(heap.size() < k){
+        heap.push_back(std::make_pair(squaredDistance, index));
+        std::push_heap(heap.begin(), heap.end());
+    }
+    else if(squaredDistance < heap.front().first){
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = std::make_pair(squaredDistance, index);
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    if(end - begin == 1){
+        return;
+    }
+
+    int axis = treeAxes[middle];
+    Real delta = point[axis] - positions[index][axis];
+
+    // search the side containing the point first and then the other
+    // side only if it could contain a closer point
+    if(delta < 0){
+        searchTree(begin, middle, point, k, heap);
+        if(heap.size() < k || delta * delta < heap.front().first){
+            searchTree(middle + 1, end, point, k, heap);
+        }
+    }
+    else{
+        searchTree(middle + 1, end, point, k, heap);
+        if(heap.size() < k || delta * delta < heap.front().first){
+            searchTree(begin, middle, point, k, heap);
+        }
+    }
+}
+
+// === SpatialIndex ======================================================== //
+/// \class SpatialIndex spatialindex.h chemkit/spatialindex.h
+/// \ingroup chemkit
+/// \brief The SpatialIndex class provides fast neighbor searches
+///        over a set of points.
+///
+/// The SpatialIndex class stores the points in a uniform grid of
+/// cells which is used for radius searches and for finding every
+/// pair of points within a cutoff distance. A k-d tree is used to
+/// find the nearest neighbors of a point.
+///
+/// For example, to find every atom within 5 Angstroms of a point:
+/// \code
+/// SpatialIndex index(molecule);
+/// std::vector<size_t> atoms = index.within(Point3(1, 2, 3), 5.0);
+/// \endcode
+///
+/// If a unit cell is set with setUnitCell() then the points are
+/// treated as periodic and all distances are calculated between the
+/// closest periodic images. The search radius should be less than
+/// half of the smallest unit cell width.
+///
+/// Points can be moved with setPosition() without rebuilding the
+/// entire index.
+///
+/// \see CartesianCoordinates
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty spatial index.
+SpatialIndex::SpatialIndex()
+    : d(new SpatialIndexPrivate)
+{
+    d->requestedCellSize = 0;
+    d->cellSize = 0;
+    d->periodic = false;
+    d->treeValid = false;
+    d->buildGrid();
+}
+
+/// Creates a new spatial index containing the positions in
+/// \p coordinates with a cell size of \p cellSize. If \p cellSize
+/// is \c 0 then a cell size is chosen automatically.
+SpatialIndex::SpatialIndex(const CartesianCoordinates *coordinates, Real cellSize)
+    : d(new SpatialIndexPrivate)
+{
+    d->requestedCellSize = cellSize;
+    d->cellSize = 0;
+    d->periodic = false;
+    d->treeValid = false;
+    setCoordinates(coordinates);
+}
+
+/// Creates a new spatial index containing the positions of the
+/// atoms in \p molecule with a cell size of \p cellSize. If
+/// \p cellSize is \c 0 then a cell size is chosen automatically.
+SpatialIndex::SpatialIndex(const Molecule *molecule, Real cellSize)
+    : d(new SpatialIndexPrivate)
+{
+    d->requestedCellSize = cellSize;
+    d->cellSize = 0;
+    d->periodic = false;
+    d->treeValid = false;
+    setMolecule(molecule);
+}
+
+/// Destroys the spatial index object.
+SpatialIndex::~SpatialIndex()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Sets the positions in the index to \p positions.
+void SpatialIndex::setPositions(const std::vector<Point3> &positions)
+{
+    d->positions = positions;
+    d->treeValid = false;
+    d->buildGrid();
+}
+
+/// Sets the positions in the index to the positions in
+/// \p coordinates.
+void SpatialIndex::setCoordinates(const CartesianCoordinates *coordinates)
+{
+    std::vector<Point3> positions;
+
+    if(coordinates){
+        positions.reserve(coordinates->size());
+
+        for(size_t i = 0; i < coordinates->size(); i++){
+            positions.push_back(coordinates->position(i));
+        }
+    }
+
+    setPositions(positions);
+}
+
+/// Sets the positions in the index to the positions of the atoms
+/// in \p molecule. The index of each point is the index of its atom.
+void SpatialIndex::setMolecule(const Molecule *molecule)
+{
+    std::vector<Point3> positions;
+
+    if(molecule){
+        positions.reserve(molecule->size());
+
+        foreach(const Atom *atom, molecule->atoms()){
+            positions.push_back(atom->position());
+        }
+    }
+
+    setPositions(positions);
+}
+
+/// Returns the number of points in the index.
+size_t SpatialIndex::size() const
+{
+    return d->positions.size();
+}
+
+/// Returns \c true if the index contains no points.
+bool SpatialIndex::isEmpty() const
+{
+    return size() == 0;
+}
+
+/// Sets the size of each grid cell to \p size. If \p size is \c 0
+/// then a cell size giving a few points per cell is chosen
+/// automatically.
+void SpatialIndex::setCellSize(Real size)
+{
+    d->requestedCellSize = size;
+    d->buildGrid();
+}
+
+/// Returns the size of each grid cell.
+Real SpatialIndex::cellSize() const
+{
+    return d->cellSize;
+}
+
+/// Sets the unit cell for periodic boundary conditions to
+/// \p unitCell. If \p unitCell is \c 0 then the points are not
+/// periodic.
+void SpatialIndex::setUnitCell(const UnitCell *unitCell)
+{
+    d->periodic = unitCell != 0;
+
+    if(unitCell){
+        d->cellMatrix.col(0) = unitCell->x();
+        d->cellMatrix.col(1) = unitCell->y();
+        d->cellMatrix.col(2) = unitCell->z();
+        d->inverseCellMatrix = d->cellMatrix.inverse();
+    }
+
+    d->buildGrid();
+}
+
+/// Returns \c true if the index uses periodic boundary conditions.
+bool SpatialIndex::isPeriodic() const
+{
+    return d->periodic;
+}
+
+// --- Positions ----------------------------------------------------------- //
+/// Moves the point at \p index to \p position. Only the cell
+/// containing the point is updated so this is much faster than
+/// rebuilding the index when only a few points move.
+void SpatialIndex::setPosition(size_t index, const Point3 &position)
+{
+    assert(index < d->positions.size());
+
+    d->positions[index] = position;
+    d->treeValid = false;
+
+    size_t cell = d->cellIndex(position);
+    size_t previousCell = d->pointCells[index];
+
+    if(cell != previousCell){
+        std::vector<size_t> &points = d->cells[previousCell];
+        std::vector<size_t>::iterator iter = std::find(points.begin(), points.end(), index);
+        *iter = points.back();
+        points.pop_back();
+
+        d->cells[cell].push_back(index);
+        d->pointCells[index] = cell;
+    }
+}
+
+/// Returns the position of the point at \p index.
+Point3 SpatialIndex::position(size_t index) const
+{
+    assert(index < d->positions.size());
+
+    return d->positions[index];
+}
+
+/// Returns the vector from \p a to \p b. For periodic indices this
+/// is the vector to the closest periodic image of \p b.
+Vector3 SpatialIndex::displacement(const Point3 &a, const Point3 &b) const
+{
+    return d->minimumImage(b - a);
+}
+
+/// Returns the distance between the points at \p i and \p j.
+Real SpatialIndex::distance(size_t i, size_t j) const
+{
+    return displacement(position(i), position(j)).norm();
+}
+
+// --- Queries ------------------------------------------------------------- //
+/// Returns the indices of each point within \p radius of \p point
+/// sorted in increasing order.
+std::vector<size_t> SpatialIndex::within(const Point3 &point, Real radius) const
+{
+    std::vector<size_t> indices;
+
+    WithinCollector collector(indices);
+    d->visitWithin(point, radius, collector);
+
+    std::sort(indices.begin(), indices.end());
+
+    return indices;
+}
+
+/// Returns the indices of the \p k points closest to \p point sorted
+/// by increasing distance.
+///
+/// This method may be called from several threads at once.
+std::vector<size_t> SpatialIndex::nearest(const Point3 &point, size_t k) const
+{
+    k = std::min(k, size());
+
+    std::vector<Neighbor> neighbors;
+
+    if(k == 0){
+        return std::vector<size_t>();
+    }
+    else if(d->periodic){
+        // grow the search radius until it contains k points
+        Real radius = d->cellSize;
+        Real diameter = (d->cellMatrix.col(0).cwiseAbs() +
+                         d->cellMatrix.col(1).cwiseAbs() +
+                         d->cellMatrix.col(2).cwiseAbs()).norm();
+
+        for(;;){
+            neighbors.clear();
+            NeighborCollector collector(neighbors);
+            d->visitWithin(point, radius, collector);
+
+            if(neighbors.size() >= k || radius > diameter){
+                break;
+            }
+
+            radius *= 2;
+        }
+
+        std::partial_sort(neighbors.begin(), neighbors.begin() + k, neighbors.end());
+        neighbors.resize(k);
+    }
+    else{
+        d->updateTree();
+
+        neighbors.reserve(k + 1);
+        d->searchTree(0, size(), point, k, neighbors);
+        std::sort_heap(neighbors.begin(), neighbors.end());
+    }
+
+    std::vector<size_t> indices;
+    indices.reserve(neighbors.size());
+    foreach(const Neighbor &neighbor, neighbors){
+        indices.push_back(neighbor.second);
+    }
+
+    return indices;
+}
+
+/// Returns each pair of points within \p cutoff of each other. The
+/// first index of each pair is less than the second.
+std::vector<SpatialIndex::Pair> SpatialIndex::pairs(Real cutoff) const
+{
+    std::vector<Pair> pairs;
+
+    PairCollector collector(pairs);
+    for(size_t i = 0; i < size(); i++){
+        collector.index = i;
+        d->visitWithin(d->positions[i], cutoff, collector);
+    }
+
+    return pairs;
+}
+
+} // end chemkit namespace
@@ -0,0 +1,96 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_SPATIALINDEX_H
+#define CHEMKIT_SPATIALINDEX_H
+
+#include "chemkit.h"
+
+#include <vector>
+#include <utility>
+
+#include "point3.h"
+#include "vector3.h"
+
+namespace chemkit {
+
+class Molecule;
+class UnitCell;
+class CartesianCoordinates;
+class SpatialIndexPrivate;
+
+class CHEMKIT_EXPORT SpatialIndex
+{
+public:
+    // typedefs
+    typedef std::pair<size_t, size_t> Pair;
+
+    // construction and destruction
+    SpatialIndex();
+    SpatialIndex(const CartesianCoordinates *coordinates, Real cellSize = 0);
+    SpatialIndex(const Molecule *molecule, Real cellSize = 0);
+    ~SpatialIndex();
+
+    // properties
+    void setPositions(const std::vector<Point3> &positions);
+    void setCoordinates(const CartesianCoordinates *coordinates);
+    void setMolecule(const Molecule *molecule);
+    size_t size() const;
+    bool isEmpty() const;
+    void setCellSize(Real size);
+    Real cellSize() const;
+    void setUnitCell(const UnitCell *unitCell);
+    bool isPeriodic() const;
+
+    // positions
+    void setPosition(size_t index, const Point3 &position);
+    Point3 position(size_t index) const;
+    Vector3 displacement(const Point3 &a, const Point3 &b) const;
+    Real distance(size_t i, size_t j) const;
+
+    // queries
+    std::vector<size_t> within(const Point3 &point, Real radius) const;
+    std::vector<size_t> nearest(const Point3 &point, size_t k) const;
+    std::vector<Pair> pairs(Real cutoff) const;
+
+private:
+    CHEMKIT_DISABLE_COPY(SpatialIndex)
+
+    SpatialIndexPrivate* const d;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_SPATIALINDEX_H
@@ -38,6 +38,7 @@
 #include "atom.h"
 #include "bond.h"
 #include "molecule.h"
+#include "moleculeprivate.h"
 
 namespace chemkit {
 
@@ -46,6 +47,10 @@ namespace chemkit {
 /// \ingroup chemkit
 /// \brief The Stereochemistry class contains stereochemistry information
 ///        for the Atom's and Bond's in a Molecule.
+///
+/// The stereochemistry itself is stored by the molecule along with
+/// the other atom and bond properties. Stereochemistry objects only
+/// provide access to it.
 
 // --- Construction and Destruction ---------------------------------------- //
 /// Creates a new stereochemistry object for \p molecule.
@@ -72,12 +77,7 @@ void Stereochemistry::setStereochemistry(const Atom *atom, Type type)
 {
     assert(atom->molecule() == m_molecule);
 
-    if(type == None){
-        m_atomStereochemistry.erase(atom);
-    }
-    else{
-        m_atomStereochemistry[atom] = type;
-    }
+    m_molecule->d->atomStereochemistry[atom->index()] = type;
 }
 
 /// Sets the stereochemistry for \p bond to \p type.
@@ -85,36 +85,19 @@ void Stereochemistry::setStereochemistry(const Bond *bond, Type type)
 {
     assert(bond->molecule() == m_molecule);
 
-    if(type == None){
-        m_bondStereochemistry.erase(bond);
-    }
-    else{
-        m_bondStereochemistry[bond] = type;
-    }
+    m_molecule->d->bondStereochemistry[bond->index()] = type;
 }
 
 /// Returns the stereochemistry for \p atom.
 Stereochemistry::Type Stereochemistry::stereochemistry(const Atom *atom) const
 {
-    std::map<const Atom *, Type>::const_iterator iter = m_atomStereochemistry.find(atom);
-    if(iter == m_atomStereochemistry.end()){
-        return None;
-    }
-    else{
-        return iter->second;
-    }
+    return m_molecule->d->atomStereochemistry[atom->index()];
 }
 
 /// Returns the stereochemistry for \p bond.
 Stereochemistry::Type Stereochemistry::stereochemistry(const Bond *bond) const
 {
-    std::map<const Bond *, Type>::const_iterator iter = m_bondStereochemistry.find(bond);
-    if(iter == m_bondStereochemistry.end()){
-        return None;
-    }
-    else{
-        return iter->second;
-    }
+    return m_molecule->d->bondStereochemistry[bond->index()];
 }
 
 } // end chemkit namespace
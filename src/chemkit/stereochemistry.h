@@ -38,8 +38,6 @@
 
 #include "chemkit.h"
 
-#include <map>
-
 namespace chemkit {
 
 class Atom;
@@ -76,8 +74,6 @@ public:
 
 private:
     const Molecule *m_molecule;
-    std::map<const Atom *, Type> m_atomStereochemistry;
-    std::map<const Bond *, Type> m_bondStereochemistry;
 };
 
 } // end chemkit namespace
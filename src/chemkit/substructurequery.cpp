@@ -36,6 +36,7 @@
 #include "substructurequery.h"
 
 #include <boost/make_shared.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/mcgregor_common_subgraphs.hpp>
 
@@ -45,6 +46,8 @@
 #include "ring.h"
 #include "foreach.h"
 #include "molecule.h"
+#include "graphsnapshot.h"
+#include "packedfingerprint.h"
 
 namespace chemkit {
 
@@ -52,66 +55,240 @@ namespace {
 
 struct AtomComparator
 {
-    AtomComparator(const std::vector<Atom *> &sourceAtoms, const std::vector<Atom *> &targetAtoms)
-        : m_sourceAtoms(sourceAtoms),
+    AtomComparator(const std::vector<int> &sourceAtomicNumbers, const std::vector<Atom *> &targetAtoms)
+        : m_sourceAtomicNumbers(sourceAtomicNumbers),
           m_targetAtoms(targetAtoms)
     {
     }
 
     AtomComparator(const AtomComparator &other)
-        : m_sourceAtoms(other.m_sourceAtoms),
+        : m_sourceAtomicNumbers(other.m_sourceAtomicNumbers),
           m_targetAtoms(other.m_targetAtoms)
     {
     }
 
     bool operator()(size_t a, size_t b) const
     {
-        return m_sourceAtoms[a]->atomicNumber() == m_targetAtoms[b]->atomicNumber();
+        return m_sourceAtomicNumbers[a] == m_targetAtoms[b]->atomicNumber();
     }
 
-    const std::vector<Atom *> &m_sourceAtoms;
+    const std::vector<int> &m_sourceAtomicNumbers;
     const std::vector<Atom *> &m_targetAtoms;
 };
 
 struct BondComparator
 {
-    BondComparator(const std::vector<Atom *> &sourceAtoms, const std::vector<Atom *> &targetAtoms, int flags)
-        : m_sourceAtoms(sourceAtoms),
-          m_targetAtoms(targetAtoms),
+    BondComparator(const GraphSnapshot &source,
+                   const std::vector<bool> &sourceAromaticBonds,
+                   const Molecule *targetMolecule,
+                   const GraphSnapshot &target,
+                   int flags)
+        : m_source(source),
+          m_sourceAromaticBonds(sourceAromaticBonds),
+          m_targetMolecule(targetMolecule),
+          m_target(target),
           m_flags(flags)
     {
     }
 
     BondComparator(const BondComparator &other)
-        : m_sourceAtoms(other.m_sourceAtoms),
-          m_targetAtoms(other.m_targetAtoms),
+        : m_source(other.m_source),
+          m_sourceAromaticBonds(other.m_sourceAromaticBonds),
+          m_targetMolecule(other.m_targetMolecule),
+          m_target(other.m_target),
           m_flags(other.m_flags)
     {
     }
 
     bool operator()(size_t a1, size_t a2, size_t b1, size_t b2) const
     {
-        const Bond *bondA = m_sourceAtoms[a1]->bondTo(m_sourceAtoms[a2]);
-        const Bond *bondB = m_targetAtoms[b1]->bondTo(m_targetAtoms[b2]);
+        size_t bondA = m_source.bondIndex(a1, a2);
+        size_t bondB = m_target.bondIndex(b1, b2);
 
-        if(!bondA || !bondB){
+        if(bondA == GraphSnapshot::NullIndex || bondB == GraphSnapshot::NullIndex){
             return false;
         }
 
-        if(m_flags & SubstructureQuery::CompareAromaticity){
-            return (bondA->order() == bondB->order()) ||
-                   (bondA->isAromatic() && bondB->isAromatic());
+        if(m_source.bondOrder(a1, a2) == m_target.bondOrder(b1, b2)){
+            return true;
+        }
+        else if(m_flags & SubstructureQuery::CompareAromaticity){
+            return m_sourceAromaticBonds[bondA] &&
+                   m_targetMolecule->bond(bondB)->isAromatic();
         }
         else{
-            return bondA->order() == bondB->order();
+            return false;
         }
     }
 
-    const std::vector<Atom *> &m_sourceAtoms;
-    const std::vector<Atom *> &m_targetAtoms;
+    const GraphSnapshot &m_source;
+    const std::vector<bool> &m_sourceAromaticBonds;
+    const Molecule *m_targetMolecule;
+    const GraphSnapshot &m_target;
     int m_flags;
 };
 
+// Returns a value indicating how common atoms of the element are in
+// organic molecules. Less common elements have lower values.
+int elementFrequency(int atomicNumber)
+{
+    switch(atomicNumber){
+        case 1: return 4; // hydrogen
+        case 6: return 3; // carbon
+        case 8: return 2; // oxygen
+        case 7: return 1; // nitrogen
+        default: return 0;
+    }
+}
+
+// Returns the order in which the atoms should be matched. Atoms with
+// rare elements and many neighbors are matched first because they
+// have the fewest candidates in the target molecule. After the first
+// atom, only atoms bonded to those already in the order are chosen
+// (until the fragment is exhausted) so that every match is checked
+// against its neighbors as early as possible.
+std::vector<Atom *> matchOrder(const std::vector<Atom *> &atoms)
+{
+    GraphSnapshot graph(atoms);
+
+    std::vector<Atom *> order;
+    order.reserve(atoms.size());
+
+    std::vector<bool> ordered(atoms.size(), false);
+    std::vector<bool> adjacent(atoms.size(), false);
+    size_t adjacentCount = 0;
+
+    while(order.size() < atoms.size()){
+        size_t next = GraphSnapshot::NullIndex;
+
+        for(size_t i = 0; i < atoms.size(); i++){
+            if(ordered[i] || (adjacentCount && !adjacent[i])){
+                continue;
+            }
+
+            if(next == GraphSnapshot::NullIndex){
+                next = i;
+                continue;
+            }
+
+            int frequency = elementFrequency(atoms[i]->atomicNumber());
+            int nextFrequency = elementFrequency(atoms[next]->atomicNumber());
+
+            if(frequency < nextFrequency ||
+               (frequency == nextFrequency && graph.degree(i) > graph.degree(next))){
+                next = i;
+            }
+        }
+
+        order.push_back(atoms[next]);
+        ordered[next] = true;
+        if(adjacent[next]){
+            adjacentCount--;
+        }
+
+        foreach(size_t neighbor, graph.neighbors(next)){
+            if(!ordered[neighbor] && !adjacent[neighbor]){
+                adjacent[neighbor] = true;
+                adjacentCount++;
+            }
+        }
+    }
+
+    return order;
+}
+
+// The screening fingerprint has a bit for each path of up to
+// MaxScreeningPathLength bonds in the graph and for each ring closed
+// by one of the paths. Only paths starting at an anchor atom are
+// included. The anchors have the element of the first query atom to
+// be matched and at least its degree, so each query anchor is mapped
+// to a target anchor and every path in the query's fingerprint also
+// occurs in a molecule containing the query. Bond orders are left
+// out of the paths when aromaticity is compared as aromatic bonds of
+// different orders may then be matched.
+const size_t ScreeningFingerprintSize = 1024;
+const size_t MaxScreeningPathLength = 4;
+
+struct ScreeningGraph
+{
+    ScreeningGraph(const GraphSnapshot &graph, const std::vector<int> &atomicNumbers, int flags)
+        : graph(graph),
+          atomicNumbers(atomicNumbers),
+          compareBondOrders(!(flags & SubstructureQuery::CompareAromaticity)),
+          visited(graph.size(), false)
+    {
+    }
+
+    const GraphSnapshot &graph;
+    const std::vector<int> &atomicNumbers;
+    bool compareBondOrders;
+    std::vector<bool> visited;
+};
+
+void extendScreeningPath(ScreeningGraph &graph,
+                         size_t firstAtom,
+                         size_t atom,
+                         size_t length,
+                         size_t hash,
+                         PackedFingerprint &fingerprint)
+{
+    graph.visited[atom] = true;
+
+    const std::vector<size_t> &offsets = graph.graph.offsets();
+
+    for(size_t position = offsets[atom]; position < offsets[atom + 1]; position++){
+        size_t neighbor = graph.graph.neighborIndices()[position];
+
+        size_t pathHash = hash;
+        if(graph.compareBondOrders){
+            boost::hash_combine(pathHash, graph.graph.bondOrders()[position]);
+        }
+
+        if(neighbor == firstAtom && length > 1){
+            // path closes a ring
+            boost::hash_combine(pathHash, -1);
+            fingerprint.set(pathHash % ScreeningFingerprintSize);
+        }
+        else if(!graph.visited[neighbor] && length < MaxScreeningPathLength){
+            boost::hash_combine(pathHash, graph.atomicNumbers[neighbor]);
+            fingerprint.set(pathHash % ScreeningFingerprintSize);
+
+            extendScreeningPath(graph, firstAtom, neighbor, length + 1, pathHash, fingerprint);
+        }
+    }
+
+    graph.visited[atom] = false;
+}
+
+PackedFingerprint screeningFingerprint(const GraphSnapshot &graph,
+                                       const std::vector<int> &atomicNumbers,
+                                       int anchorAtomicNumber,
+                                       size_t anchorDegree,
+                                       int flags)
+{
+    PackedFingerprint fingerprint(ScreeningFingerprintSize);
+    ScreeningGraph screeningGraph(graph, atomicNumbers, flags);
+
+    for(size_t i = 0; i < graph.size(); i++){
+        if(atomicNumbers[i] != anchorAtomicNumber || graph.degree(i) < anchorDegree){
+            continue;
+        }
+
+        size_t hash = 0;
+        boost::hash_combine(hash, atomicNumbers[i]);
+
+        extendScreeningPath(screeningGraph, i, i, 0, hash, fingerprint);
+    }
+
+    return fingerprint;
+}
+
+// Returns the number of independent rings in the molecule.
+inline size_t cyclomaticNumber(const Molecule *molecule)
+{
+    return molecule->bondCount() + molecule->fragmentCount() - molecule->atomCount();
+}
+
 typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS> AdjacencyListGraph;
 
 struct AdjacencyListGraphVertexComparator
@@ -247,14 +424,130 @@ struct McgregorCommonSubgraphsCallback
 class SubstructureQueryPrivate
 {
 public:
+    void compile();
+    bool screen(const Molecule *molecule) const;
+
     boost::shared_ptr<Molecule> molecule;
     int flags;
+
+    // compiled query
+    std::vector<Atom *> atoms;
+    GraphSnapshot graph;
+    std::vector<int> atomicNumbers;
+    std::vector<bool> aromaticBonds;
+
+    // screening data
+    std::vector<std::pair<int, size_t> > elementCounts;
+    size_t ringCount;
+    PackedFingerprint fingerprint;
 };
 
+// Builds the query graph and the atom and bond data used when
+// matching. The atoms are stored in the order they will be matched.
+void SubstructureQueryPrivate::compile()
+{
+    atoms.clear();
+    atomicNumbers.clear();
+    aromaticBonds.clear();
+    elementCounts.clear();
+    ringCount = 0;
+    fingerprint = PackedFingerprint();
+
+    if(!molecule){
+        graph = GraphSnapshot();
+        return;
+    }
+
+    foreach(Atom *atom, molecule->atoms()){
+        if(flags & SubstructureQuery::CompareHydrogens || !atom->isTerminalHydrogen()){
+            atoms.push_back(atom);
+        }
+    }
+
+    atoms = matchOrder(atoms);
+    graph = GraphSnapshot(atoms);
+
+    atomicNumbers.reserve(atoms.size());
+    foreach(const Atom *atom, atoms){
+        atomicNumbers.push_back(atom->atomicNumber());
+    }
+
+    if(flags & SubstructureQuery::CompareAromaticity){
+        aromaticBonds.reserve(molecule->bondCount());
+        foreach(const Bond *bond, molecule->bonds()){
+            aromaticBonds.push_back(bond->isAromatic());
+        }
+    }
+
+    if(flags & SubstructureQuery::UseScreening && !atoms.empty()){
+        std::map<int, size_t> counts;
+        foreach(int atomicNumber, atomicNumbers){
+            counts[atomicNumber]++;
+        }
+        elementCounts.assign(counts.begin(), counts.end());
+
+        ringCount = cyclomaticNumber(molecule.get());
+
+        // the paths are anchored at the first atom to be matched
+        fingerprint = screeningFingerprint(graph,
+                                           atomicNumbers,
+                                           atomicNumbers[0],
+                                           graph.degree(0),
+                                           flags);
+    }
+}
+
+// Returns false if the molecule cannot contain the query because it
+// has fewer atoms of an element or fewer rings than the query.
+bool SubstructureQueryPrivate::screen(const Molecule *molecule) const
+{
+    if(molecule->atomCount() < atoms.size() ||
+       cyclomaticNumber(molecule) < ringCount){
+        return false;
+    }
+
+    if(elementCounts.empty()){
+        return true;
+    }
+
+    std::vector<size_t> counts(elementCounts.back().first + 1, 0);
+
+    foreach(const Atom *atom, molecule->atoms()){
+        size_t atomicNumber = atom->atomicNumber();
+
+        if(atomicNumber < counts.size() &&
+           (flags & SubstructureQuery::CompareHydrogens || !atom->isTerminalHydrogen())){
+            counts[atomicNumber]++;
+        }
+    }
+
+    for(size_t i = 0; i < elementCounts.size(); i++){
+        if(counts[elementCounts[i].first] < elementCounts[i].second){
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // === SubstructureQuery =================================================== //
 /// \class SubstructureQuery substructurequery.h chemkit/substructurequery.h
 /// \ingroup chemkit
 /// \brief The SubstructureQuery class represents a substructure query.
+///
+/// The query molecule is compiled when it is set (or when the flags
+/// are changed) so that matching it against many molecules only
+/// requires building the graph of each target molecule. If the query
+/// molecule is modified afterwards, setMolecule() must be called
+/// again for the changes to be used.
+///
+/// When the UseScreening flag is set each molecule is first compared
+/// against a summary of the query (its atom and ring counts and a
+/// fingerprint of the paths starting at its first matched atom).
+/// Molecules which cannot contain the query are rejected without
+/// running the isomorphism algorithm. Screening never changes which
+/// molecules match but it speeds up searches where most molecules
+/// do not.
 
 // --- Construction and Destruction ---------------------------------------- //
 /// Creates a new substructure query.
@@ -262,6 +555,7 @@ SubstructureQuery::SubstructureQuery()
   : d(new SubstructureQueryPrivate)
 {
     d->flags = 0;
+    d->compile();
 }
 
 /// Creates a new substructure query with \p molecule as the
@@ -271,6 +565,7 @@ SubstructureQuery::SubstructureQuery(const boost::shared_ptr<Molecule> &molecule
 {
     d->molecule = molecule;
     d->flags = 0;
+    d->compile();
 }
 
 /// Creates a new substructure query with \p formula in \p format as
@@ -280,6 +575,7 @@ SubstructureQuery::SubstructureQuery(const std::string &formula, const std::stri
 {
     d->molecule = boost::make_shared<Molecule>(formula, format);
     d->flags = 0;
+    d->compile();
 }
 
 /// Destroys the substructure query object.
@@ -293,6 +589,7 @@ SubstructureQuery::~SubstructureQuery()
 void SubstructureQuery::setMolecule(const boost::shared_ptr<Molecule> &molecule)
 {
     d->molecule = molecule;
+    d->compile();
 }
 
 /// Sets the substructure molecule to \p formula with \p format.
@@ -311,6 +608,7 @@ boost::shared_ptr<Molecule> SubstructureQuery::molecule() const
 void SubstructureQuery::setFlags(int flags)
 {
     d->flags = flags;
+    d->compile();
 }
 
 /// Returns the query flags.
@@ -353,37 +651,19 @@ bool SubstructureQuery::matches(const Molecule *molecule) const
 /// atoms in the substructure molecule and the atoms in \p molecule.
 std::map<Atom *, Atom *> SubstructureQuery::mapping(const Molecule *molecule) const
 {
-    Graph<size_t> source;
-    Graph<size_t> target;
+    if(d->flags & UseScreening && !d->screen(molecule)){
+        return std::map<Atom *, Atom *>();
+    }
 
-    std::vector<Atom *> sourceAtoms;
+    boost::shared_ptr<const GraphSnapshot> target;
     std::vector<Atom *> targetAtoms;
 
     if(d->flags & CompareHydrogens){
-        source.resize(d->molecule->size());
-        sourceAtoms = std::vector<Atom *>(d->molecule->atoms().begin(), d->molecule->atoms().end());
-
-        if(!(d->flags & CompareAtomsOnly)){
-            foreach(const Bond *bond, d->molecule->bonds()){
-                source.addEdge(bond->atom1()->index(), bond->atom2()->index());
-            }
-        }
-
-        target.resize(molecule->size());
         targetAtoms = std::vector<Atom *>(molecule->atoms().begin(), molecule->atoms().end());
-
-        if(!(d->flags & CompareAtomsOnly)){
-            foreach(const Bond *bond, molecule->bonds()){
-                target.addEdge(bond->atom1()->index(), bond->atom2()->index());
-            }
-        }
+        target = molecule->graphSnapshot();
     }
     else{
-        foreach(Atom *atom, d->molecule->atoms()){
-            if(!atom->isTerminalHydrogen()){
-                sourceAtoms.push_back(atom);
-            }
-        }
+        targetAtoms.reserve(molecule->atomCount());
 
         foreach(Atom *atom, molecule->atoms()){
             if(!atom->isTerminalHydrogen()){
@@ -391,39 +671,38 @@ std::map<Atom *, Atom *> SubstructureQuery::mapping(const Molecule *molecule) co
             }
         }
 
-        source.resize(sourceAtoms.size());
-        target.resize(targetAtoms.size());
+        target = boost::make_shared<GraphSnapshot>(targetAtoms);
+    }
 
-        if(!(d->flags & CompareAtomsOnly)){
-            for(size_t i = 0; i < sourceAtoms.size(); i++){
-                for(size_t j = i + 1; j < sourceAtoms.size(); j++){
-                    if(sourceAtoms[i]->isBondedTo(sourceAtoms[j])){
-                        source.addEdge(i, j);
-                    }
-                }
-            }
+    // check that the molecule contains every path in the query
+    if(d->flags & UseScreening && !d->graph.isEmpty()){
+        std::vector<int> targetAtomicNumbers;
+        targetAtomicNumbers.reserve(targetAtoms.size());
+        foreach(const Atom *atom, targetAtoms){
+            targetAtomicNumbers.push_back(atom->atomicNumber());
+        }
 
-            for(size_t i = 0; i < targetAtoms.size(); i++){
-                for(size_t j = i + 1; j < targetAtoms.size(); j++){
-                    if(targetAtoms[i]->isBondedTo(targetAtoms[j])){
-                        target.addEdge(i, j);
-                    }
-                }
-            }
+        PackedFingerprint targetFingerprint = screeningFingerprint(*target,
+                                                                   targetAtomicNumbers,
+                                                                   d->atomicNumbers[0],
+                                                                   d->graph.degree(0),
+                                                                   d->flags);
+        if(!targetFingerprint.contains(d->fingerprint)){
+            return std::map<Atom *, Atom *>();
         }
     }
 
-    AtomComparator atomComparator(sourceAtoms, targetAtoms);
-    BondComparator bondComparator(sourceAtoms, targetAtoms, d->flags);
+    AtomComparator atomComparator(d->atomicNumbers, targetAtoms);
+    BondComparator bondComparator(d->graph, d->aromaticBonds, molecule, *target, d->flags);
 
     // run vf2 isomorphism algorithm
-    std::map<size_t, size_t> mapping = chemkit::algorithm::vf2(source,
-                                                               target,
+    std::map<size_t, size_t> mapping = chemkit::algorithm::vf2(d->graph,
+                                                               *target,
                                                                atomComparator,
                                                                bondComparator);
 
     // check for exact match
-    if(d->flags & CompareExact && mapping.size() != source.size()){
+    if(d->flags & CompareExact && mapping.size() != d->graph.size()){
         return std::map<Atom *, Atom *>();
     }
 
@@ -431,7 +710,7 @@ std::map<Atom *, Atom *> SubstructureQuery::mapping(const Molecule *molecule) co
     std::map<Atom *, Atom *> atomMapping;
 
     for(std::map<size_t, size_t>::iterator i = mapping.begin(); i != mapping.end(); ++i){
-        atomMapping[sourceAtoms[i->first]] = targetAtoms[i->second];
+        atomMapping[d->atoms[i->first]] = targetAtoms[i->second];
     }
 
     return atomMapping;
@@ -61,7 +61,8 @@ public:
         CompareAtomsOnly = 0x00,
         CompareHydrogens = 0x01,
         CompareAromaticity = 0x02,
-        CompareExact = 0x04
+        CompareExact = 0x04,
+        UseScreening = 0x08
     };
 
     // construction and destruction
@@ -0,0 +1,330 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "threadpool.h"
+
+#include <deque>
+#include <vector>
+#include <cstdlib>
+
+#include <boost/thread.hpp>
+#include <boost/lexical_cast.hpp>
+
+namespace chemkit {
+
+namespace {
+
+// identifies the pool and queue of the current worker thread
+struct WorkerContext
+{
+    const ThreadPoolPrivate *pool;
+    size_t index;
+};
+
+boost::thread_specific_ptr<WorkerContext> currentWorker;
+
+} // end anonymous namespace
+
+// === ThreadPoolPrivate =================================================== //
+class ThreadPoolPrivate
+{
+public:
+    struct Queue
+    {
+        boost::mutex mutex;
+        std::deque<ThreadPool::Task> tasks;
+    };
+
+    std::vector<Queue *> queues;
+    boost::thread_group threads;
+    boost::mutex mutex;
+    boost::condition_variable taskAvailable;
+    boost::condition_variable done;
+    long pendingCount;
+    size_t activeCount;
+    size_t nextQueue;
+    bool stopping;
+
+    bool takeTask(size_t index, ThreadPool::Task &task);
+    void runTask(const ThreadPool::Task &task);
+    void work(size_t index);
+};
+
+// Takes a task from the back of the queue at index, or failing that
+// steals one from the front of another queue.
+bool ThreadPoolPrivate::takeTask(size_t index, ThreadPool::Task &task)
+{
+    if(index < queues.size()){
+        Queue *queue = queues[index];
+        boost::lock_guard<boost::mutex> lock(queue->mutex);
+
+        if(!queue->tasks.empty()){
+            task.swap(queue->tasks.back());
+            queue->tasks.pop_back();
+            return true;
+        }
+    }
+
+    for(size_t i = 0; i < queues.size(); i++){
+        Queue *queue = queues[(index + i + 1) % queues.size()];
+        boost::lock_guard<boost::mutex> lock(queue->mutex);
+
+        if(!queue->tasks.empty()){
+            task.swap(queue->tasks.front());
+            queue->tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPoolPrivate::runTask(const ThreadPool::Task &task)
+{
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        pendingCount--;
+        activeCount++;
+    }
+
+    // tasks report errors through their futures so any exception
+    // reaching here is dropped to keep the worker alive
+    try {
+        task();
+    }
+    catch(...){
+    }
+
+    boost::lock_guard<boost::mutex> lock(mutex);
+    activeCount--;
+    if(pendingCount <= 0 && activeCount == 0){
+        done.notify_all();
+    }
+}
+
+void ThreadPoolPrivate::work(size_t index)
+{
+    WorkerContext *context = new WorkerContext;
+    context->pool = this;
+    context->index = index;
+    currentWorker.reset(context);
+
+    for(;;){
+        ThreadPool::Task task;
+
+        if(takeTask(index, task)){
+            runTask(task);
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> lock(mutex);
+        while(pendingCount <= 0 && !stopping){
+            taskAvailable.wait(lock);
+        }
+
+        if(stopping && pendingCount <= 0){
+            return;
+        }
+    }
+}
+
+// === ThreadPool ========================================================== //
+/// \class ThreadPool threadpool.h chemkit/threadpool.h
+/// \ingroup chemkit
+/// \brief The ThreadPool class manages a set of worker threads.
+///
+/// Each worker thread has its own task queue. Tasks started from a
+/// worker thread are added to its own queue and idle workers steal
+/// tasks from the queues of busy workers.
+///
+/// Most code should not use the ThreadPool class directly but
+/// instead use the functions in the chemkit::concurrent namespace
+/// which run their tasks on the globalInstance() pool.
+///
+/// \see concurrent::run(), concurrent::parallel_for()
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new thread pool with \p threadCount worker threads. If
+/// \p threadCount is \c 0 then defaultThreadCount() threads are used.
+ThreadPool::ThreadPool(size_t threadCount)
+    : d(new ThreadPoolPrivate)
+{
+    if(threadCount == 0){
+        threadCount = defaultThreadCount();
+    }
+
+    d->pendingCount = 0;
+    d->activeCount = 0;
+    d->nextQueue = 0;
+    d->stopping = false;
+
+    for(size_t i = 0; i < threadCount; i++){
+        d->queues.push_back(new ThreadPoolPrivate::Queue);
+    }
+
+    for(size_t i = 0; i < threadCount; i++){
+        d->threads.create_thread(boost::bind(&ThreadPoolPrivate::work, d, i));
+    }
+}
+
+/// Destroys the thread pool. This waits for all started tasks to
+/// finish.
+ThreadPool::~ThreadPool()
+{
+    {
+        boost::lock_guard<boost::mutex> lock(d->mutex);
+        d->stopping = true;
+    }
+
+    d->taskAvailable.notify_all();
+    d->threads.join_all();
+
+    for(size_t i = 0; i < d->queues.size(); i++){
+        delete d->queues[i];
+    }
+
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of worker threads in the pool.
+size_t ThreadPool::threadCount() const
+{
+    return d->queues.size();
+}
+
+/// Returns \c true if the calling thread is one of the worker
+/// threads of the pool.
+bool ThreadPool::isWorkerThread() const
+{
+    const WorkerContext *context = currentWorker.get();
+
+    return context && context->pool == d;
+}
+
+// --- Tasks --------------------------------------------------------------- //
+/// Starts \p task on one of the worker threads.
+void ThreadPool::start(const Task &task)
+{
+    size_t index;
+
+    const WorkerContext *context = currentWorker.get();
+    if(context && context->pool == d){
+        index = context->index;
+    }
+    else{
+        boost::lock_guard<boost::mutex> lock(d->mutex);
+        index = d->nextQueue++ % d->queues.size();
+    }
+
+    // the task is counted before it is queued so that a worker which
+    // takes it immediately never sees a negative count
+    {
+        boost::lock_guard<boost::mutex> lock(d->mutex);
+        d->pendingCount++;
+    }
+
+    {
+        ThreadPoolPrivate::Queue *queue = d->queues[index];
+        boost::lock_guard<boost::mutex> lock(queue->mutex);
+        queue->tasks.push_back(task);
+    }
+
+    d->taskAvailable.notify_one();
+}
+
+/// Runs a single queued task in the calling thread. Returns \c false
+/// if there were no queued tasks.
+///
+/// This is used by threads waiting for the results of other tasks
+/// so that they help to make progress instead of blocking.
+bool ThreadPool::runPendingTask()
+{
+    const WorkerContext *context = currentWorker.get();
+    size_t index = context && context->pool == d ? context->index : d->queues.size();
+
+    Task task;
+    if(!d->takeTask(index, task)){
+        return false;
+    }
+
+    d->runTask(task);
+    return true;
+}
+
+/// Waits until all of the started tasks have finished.
+void ThreadPool::waitForDone()
+{
+    boost::unique_lock<boost::mutex> lock(d->mutex);
+    while(d->pendingCount > 0 || d->activeCount > 0){
+        d->done.wait(lock);
+    }
+}
+
+// --- Static Methods ------------------------------------------------------ //
+/// Returns the global thread pool. The pool is created the first
+/// time this is called and is shared by the entire process.
+ThreadPool* ThreadPool::globalInstance()
+{
+    // the global pool is never destroyed so that tasks which are
+    // still running when the process exits are not waited for
+    static ThreadPool *instance = new ThreadPool;
+
+    return instance;
+}
+
+/// Returns the default number of worker threads. This is the value
+/// of the \c CHEMKIT_THREAD_COUNT environment variable if it is set
+/// and otherwise the number of hardware threads.
+size_t ThreadPool::defaultThreadCount()
+{
+    const char *value = getenv("CHEMKIT_THREAD_COUNT");
+    if(value){
+        try {
+            long count = boost::lexical_cast<long>(value);
+            if(count > 0){
+                return count;
+            }
+        }
+        catch(boost::bad_lexical_cast &){
+        }
+    }
+
+    size_t count = boost::thread::hardware_concurrency();
+
+    return count > 0 ? count : 1;
+}
+
+} // end chemkit namespace
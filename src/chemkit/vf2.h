@@ -76,20 +76,20 @@ inline SharedState<T>::SharedState(T sourceSize, T targetSize)
 
 // The State class represents a single state in the isomorphism detection
 // algorithm. Every state uses and modifies the same SharedState object.
-template<typename T, typename VertexComparator, typename EdgeComparator>
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
 class State
 {
 public:
     typedef T SizeType;
     enum { NullIndex = SizeType(-1) }; // represents an invalid vertex index
 
-    State(const Graph<T> &source, const Graph<T> &target, VertexComparator compareVertices, EdgeComparator compareEdges);
+    State(const GraphType &source, const GraphType &target, VertexComparator compareVertices, EdgeComparator compareEdges);
     State(const State *state);
     ~State();
 
     SizeType size() const { return m_size; }
-    const Graph<T>& source() const { return m_source; }
-    const Graph<T>& target() const { return m_target; }
+    const GraphType& source() const { return m_source; }
+    const GraphType& target() const { return m_target; }
     std::map<T, T> mapping() const;
     bool succeeded() const;
     void addPair(const std::pair<T, T> &candidate);
@@ -103,8 +103,8 @@ private:
     SizeType m_size;
     SizeType m_sourceTerminalSize;
     SizeType m_targetTerminalSize;
-    const Graph<T> &m_source;
-    const Graph<T> &m_target;
+    const GraphType &m_source;
+    const GraphType &m_target;
     std::pair<T, T> m_lastAddition;
     SharedState<T> *m_sharedState;
     bool m_ownSharedState;
@@ -112,11 +112,11 @@ private:
     EdgeComparator m_compareEdges;
 };
 
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline State<T, VertexComparator, EdgeComparator>::State(const Graph<T> &source,
-                                                         const Graph<T> &target,
-                                                         VertexComparator compareVertices,
-                                                         EdgeComparator compareEdges)
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline State<T, GraphType, VertexComparator, EdgeComparator>::State(const GraphType &source,
+                                                                    const GraphType &target,
+                                                                    VertexComparator compareVertices,
+                                                                    EdgeComparator compareEdges)
     : m_size(0),
       m_sourceTerminalSize(0),
       m_targetTerminalSize(0),
@@ -130,8 +130,8 @@ inline State<T, VertexComparator, EdgeComparator>::State(const Graph<T> &source,
 {
 }
 
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline State<T, VertexComparator, EdgeComparator>::State(const State *state)
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline State<T, GraphType, VertexComparator, EdgeComparator>::State(const State *state)
     : m_size(state->m_size),
       m_sourceTerminalSize(state->m_sourceTerminalSize),
       m_targetTerminalSize(state->m_targetTerminalSize),
@@ -145,23 +145,23 @@ inline State<T, VertexComparator, EdgeComparator>::State(const State *state)
 {
 }
 
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline State<T, VertexComparator, EdgeComparator>::~State()
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline State<T, GraphType, VertexComparator, EdgeComparator>::~State()
 {
     if(m_ownSharedState)
         delete m_sharedState;
 }
 
 // Returns true if the state contains an isomorphism.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline bool State<T, VertexComparator, EdgeComparator>::succeeded() const
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline bool State<T, GraphType, VertexComparator, EdgeComparator>::succeeded() const
 {
     return m_size == m_source.size();
 }
 
 // Returns the current isomorphism for the state as a std::map.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline std::map<T, T> State<T, VertexComparator, EdgeComparator>::mapping() const
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline std::map<T, T> State<T, GraphType, VertexComparator, EdgeComparator>::mapping() const
 {
     std::map<T, T> mapping;
 
@@ -175,8 +175,8 @@ inline std::map<T, T> State<T, VertexComparator, EdgeComparator>::mapping() cons
 // Returns the next candidate pair (sourceAtom, targetAtom) to be added to the
 // state. The candidate should be checked for feasibility and then added using
 // the addPair() method.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline std::pair<T, T> State<T, VertexComparator, EdgeComparator>::nextCandidate(const std::pair<T, T> &lastCandidate)
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline std::pair<T, T> State<T, GraphType, VertexComparator, EdgeComparator>::nextCandidate(const std::pair<T, T> &lastCandidate)
 {
     T lastSourceAtom = lastCandidate.first;
     T lastTargetAtom = lastCandidate.second;
@@ -231,8 +231,8 @@ inline std::pair<T, T> State<T, VertexComparator, EdgeComparator>::nextCandidate
 
 // Adds the candidate pair (sourceAtom, targetAtom) to the state. The candidate
 // pair must be feasible to add it to the state.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline void State<T, VertexComparator, EdgeComparator>::addPair(const std::pair<T, T> &candidate)
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline void State<T, GraphType, VertexComparator, EdgeComparator>::addPair(const std::pair<T, T> &candidate)
 {
     m_size++;
     m_lastAddition = candidate;
@@ -270,8 +270,8 @@ inline void State<T, VertexComparator, EdgeComparator>::addPair(const std::pair<
 
 // Restores the shared state to how it was before adding the last candidate
 // pair. Assumes addPair() has been called on the state only once.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline void State<T, VertexComparator, EdgeComparator>::backTrack()
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline void State<T, GraphType, VertexComparator, EdgeComparator>::backTrack()
 {
     T addedSourceAtom = m_lastAddition.first;
 
@@ -303,8 +303,8 @@ inline void State<T, VertexComparator, EdgeComparator>::backTrack()
     m_lastAddition = nullCandidate();
 }
 
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline bool State<T, VertexComparator, EdgeComparator>::isFeasible(const std::pair<T, T> &candidate)
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline bool State<T, GraphType, VertexComparator, EdgeComparator>::isFeasible(const std::pair<T, T> &candidate)
 {
     T sourceAtom = candidate.first;
     T targetAtom = candidate.second;
@@ -351,12 +351,15 @@ inline bool State<T, VertexComparator, EdgeComparator>::isFeasible(const std::pa
         }
     }
 
+    // the target may contain bonds that are not in the source so a new
+    // source neighbor can also be matched to a terminal target neighbor
     return (sourceTerminalNeighborCount <= targetTerminalNeighborCount) &&
-           (sourceNewNeighborCount <= targetNewNeighborCount);
+           (sourceTerminalNeighborCount + sourceNewNeighborCount <=
+            targetTerminalNeighborCount + targetNewNeighborCount);
 }
 
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline bool match(State<T, VertexComparator, EdgeComparator> *state, std::map<T, T> &mapping)
+template<typename T, typename GraphType, typename VertexComparator, typename EdgeComparator>
+inline bool match(State<T, GraphType, VertexComparator, EdgeComparator> *state, std::map<T, T> &mapping)
 {
     if(state->succeeded()){
         mapping = state->mapping();
@@ -376,7 +379,7 @@ inline bool match(State<T, VertexComparator, EdgeComparator> *state, std::map<T,
         lastCandidate = candidate;
 
         if(state->isFeasible(candidate)){
-            State<T, VertexComparator, EdgeComparator> nextState(state);
+            State<T, GraphType, VertexComparator, EdgeComparator> nextState(state);
             nextState.addPair(candidate);
             found = match(&nextState, mapping);
             nextState.backTrack();
@@ -388,20 +391,26 @@ inline bool match(State<T, VertexComparator, EdgeComparator> *state, std::map<T,
 
 } // end detail namespace
 
-template<typename T, typename VertexComparator, typename EdgeComparator>
-std::map<T, T> vf2(const Graph<T> &a,
-                   const Graph<T> &b,
-                   VertexComparator vertexComparator,
-                   EdgeComparator edgeComparator)
+// Returns a mapping between the vertices in graph a and the vertices in
+// graph b. The graph type must provide the VertexType typedef and the
+// size(), neighbors() and isAdjacent() methods (e.g. Graph<T> and
+// GraphSnapshot).
+template<typename GraphType, typename VertexComparator, typename EdgeComparator>
+std::map<typename GraphType::VertexType, typename GraphType::VertexType> vf2(const GraphType &a,
+                                                                            const GraphType &b,
+                                                                            VertexComparator vertexComparator,
+                                                                            EdgeComparator edgeComparator)
 {
+    typedef typename GraphType::VertexType T;
+
     using detail::State;
     using detail::match;
 
     // create initial empty state
-    State<T, VertexComparator, EdgeComparator> state(a,
-                                                     b,
-                                                     vertexComparator,
-                                                     edgeComparator);
+    State<T, GraphType, VertexComparator, EdgeComparator> state(a,
+                                                                b,
+                                                                vertexComparator,
+                                                                edgeComparator);
 
     // create empty mapping
     std::map<T, T> mapping;
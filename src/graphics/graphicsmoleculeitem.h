@@ -110,6 +110,7 @@ private:
     void bondAdded(const Bond *bond);
     void bondRemoved(const Bond *bond);
     void bondOrderChanged(const Bond *bond);
+    void structureChanged(const Molecule *molecule);
 
 private:
     GraphicsMoleculeItemPrivate* const d;
@@ -0,0 +1,127 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fingerprintfile.h"
+
+#include <boost/make_shared.hpp>
+
+#include <chemkit/fingerprintdatabase.h>
+
+namespace chemkit {
+
+// === FingerprintFilePrivate ============================================== //
+class FingerprintFilePrivate
+{
+public:
+    boost::shared_ptr<FingerprintDatabase> database;
+};
+
+// === FingerprintFile ===================================================== //
+/// \class FingerprintFile fingerprintfile.h chemkit/fingerprintfile.h
+/// \ingroup chemkit-io
+/// \brief The FingerprintFile class contains a fingerprint database.
+///
+/// The following example shows how to write the FP2 fingerprints
+/// for a set of molecules to an FPS file:
+/// \code
+/// boost::shared_ptr<FingerprintDatabase> database =
+///     boost::make_shared<FingerprintDatabase>("fp2");
+///
+/// foreach(const Molecule *molecule, molecules){
+///     database->addMolecule(molecule);
+/// }
+///
+/// FingerprintFile file;
+/// file.setDatabase(database);
+/// file.write("molecules.fps");
+/// \endcode
+///
+/// \see FingerprintDatabase
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new fingerprint file.
+FingerprintFile::FingerprintFile()
+    : d(new FingerprintFilePrivate)
+{
+    d->database = boost::make_shared<FingerprintDatabase>();
+}
+
+/// Creates a new fingerprint file with \p fileName.
+FingerprintFile::FingerprintFile(const std::string &fileName)
+    : GenericFile<FingerprintFile, FingerprintFileFormat>(fileName),
+      d(new FingerprintFilePrivate)
+{
+    d->database = boost::make_shared<FingerprintDatabase>();
+}
+
+/// Destroys the fingerprint file object.
+FingerprintFile::~FingerprintFile()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of fingerprints in the file.
+size_t FingerprintFile::size() const
+{
+    return d->database->size();
+}
+
+/// Returns \c true if the file contains no fingerprints.
+bool FingerprintFile::isEmpty() const
+{
+    return size() == 0;
+}
+
+// --- File Contents ------------------------------------------------------- //
+/// Sets the fingerprint database for the file to \p database.
+void FingerprintFile::setDatabase(const boost::shared_ptr<FingerprintDatabase> &database)
+{
+    d->database = database;
+}
+
+/// Returns the fingerprint database for the file.
+boost::shared_ptr<FingerprintDatabase> FingerprintFile::database() const
+{
+    return d->database;
+}
+
+/// Replaces the database in the file with a new, empty database.
+void FingerprintFile::clear()
+{
+    d->database = boost::make_shared<FingerprintDatabase>();
+}
+
+} // end chemkit namespace
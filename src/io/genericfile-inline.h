@@ -55,6 +55,32 @@
 
 namespace chemkit {
 
+// === GenericFile::ReadScope ============================================== //
+// Calls beginRead() on construction and endRead() on destruction so
+// that the file is restored even if the format throws while reading.
+template<typename File, typename Format>
+class GenericFile<File, Format>::ReadScope
+{
+public:
+    ReadScope(GenericFile<File, Format> *file)
+        : m_file(file)
+    {
+        m_file->beginRead();
+    }
+
+    ~ReadScope()
+    {
+        m_file->endRead();
+    }
+
+private:
+    ReadScope(const ReadScope &);
+    ReadScope& operator=(const ReadScope &);
+
+private:
+    GenericFile<File, Format> *m_file;
+};
+
 // === GenericFile ========================================================= //
 /// \class GenericFile genericfile.h chemkit/genericfile.h
 /// \ingroup chemkit-io
@@ -227,8 +253,9 @@ inline bool GenericFile<File, Format>::read()
         return false;
     }
 
-    // open file
-    std::ifstream file(m_fileName.c_str());
+    // open file. binary mode keeps binary and compressed formats
+    // intact on platforms which translate line endings
+    std::ifstream file(m_fileName.c_str(), std::ios::in | std::ios::binary);
     if(!file.is_open()){
         setErrorString("Failed to open file for reading.");
         return false;
@@ -325,7 +352,11 @@ inline bool GenericFile<File, Format>::read(std::istream &input)
     inputStream.push(input);
 
     // read the file
-    bool ok = m_format->read(inputStream, static_cast<File *>(this));
+    bool ok;
+    {
+        ReadScope scope(this);
+        ok = m_format->read(inputStream, static_cast<File *>(this));
+    }
     if(!ok){
         setErrorString(m_format->errorString());
     }
@@ -364,7 +395,11 @@ inline bool GenericFile<File, Format>::read(const boost::iostreams::mapped_file_
     }
 
     // read the file
-    bool ok = m_format->readMappedFile(input, static_cast<File *>(this));
+    bool ok;
+    {
+        ReadScope scope(this);
+        ok = m_format->readMappedFile(input, static_cast<File *>(this));
+    }
     if(!ok){
         setErrorString(m_format->errorString());
     }
@@ -401,7 +436,7 @@ inline bool GenericFile<File, Format>::write(const std::string &fileName)
 template<typename File, typename Format>
 inline bool GenericFile<File, Format>::write(const std::string &fileName, const std::string &formatName)
 {
-    std::ofstream file(fileName.c_str());
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
     if(!file.is_open()){
         setErrorString((boost::format("Failed to open '%s' for writing") % fileName).str());
         return false;
@@ -461,6 +496,24 @@ inline bool GenericFile<File, Format>::write(std::ostream &output, Format *forma
     return format->write(static_cast<const File *>(this), outputStream);
 }
 
+/// Called immediately before the file format reads data into the
+/// file. The default implementation does nothing.
+///
+/// \internal
+template<typename File, typename Format>
+inline void GenericFile<File, Format>::beginRead()
+{
+}
+
+/// Called immediately after the file format has read data into the
+/// file. The default implementation does nothing.
+///
+/// \internal
+template<typename File, typename Format>
+inline void GenericFile<File, Format>::endRead()
+{
+}
+
 // --- File Data ----------------------------------------------------------- //
 /// Sets data with \p name to \p value for the file.
 template<typename File, typename Format>
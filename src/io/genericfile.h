@@ -103,9 +103,13 @@ public:
     static std::vector<std::string> compressionFormats();
 
 protected:
+    virtual void beginRead();
+    virtual void endRead();
     void setErrorString(const std::string &errorString);
 
 private:
+    class ReadScope;
+
     std::string suffix(const std::string &fileName);
 
 private:
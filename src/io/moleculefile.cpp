@@ -40,6 +40,7 @@
 #include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
 #include <chemkit/variantmap.h>
+#include <chemkit/moleculearena.h>
 
 namespace chemkit {
 
@@ -49,6 +50,8 @@ class MoleculeFilePrivate
 public:
     std::vector<boost::shared_ptr<Molecule> > molecules;
     VariantMap fileData;
+    boost::shared_ptr<MoleculeArena> arena;
+    boost::shared_ptr<MoleculeArena> previousArena;
 };
 
 // === MoleculeFile ======================================================== //
@@ -116,6 +119,25 @@ bool MoleculeFile::isEmpty() const
     return size() == 0;
 }
 
+/// Sets the arena used to store the atoms and bonds of molecules
+/// read from the file to \p arena. Sharing a single arena packs the
+/// molecules in the file contiguously in memory which reduces the
+/// cost of reading files containing many small molecules. If
+/// \p arena is \c 0 each molecule uses its own arena (the default).
+///
+/// \see MoleculeArena
+void MoleculeFile::setArena(const boost::shared_ptr<MoleculeArena> &arena)
+{
+    d->arena = arena;
+}
+
+/// Returns the arena used to store the atoms and bonds of molecules
+/// read from the file.
+boost::shared_ptr<MoleculeArena> MoleculeFile::arena() const
+{
+    return d->arena;
+}
+
 // --- File Contents ------------------------------------------------------- //
 /// Adds the molecule to the file.
 void MoleculeFile::addMolecule(const boost::shared_ptr<Molecule> &molecule)
@@ -218,4 +240,28 @@ void MoleculeFile::quickWrite(const Molecule *molecule, const std::string &fileN
     file.write(fileName);
 }
 
+// --- Internal Methods ---------------------------------------------------- //
+/// Makes the file's arena current while molecules are being read so
+/// that they are allocated from it.
+///
+/// \internal
+void MoleculeFile::beginRead()
+{
+    if(d->arena){
+        d->previousArena = MoleculeArena::currentArena();
+        MoleculeArena::setCurrentArena(d->arena);
+    }
+}
+
+/// Restores the arena that was current before reading.
+///
+/// \internal
+void MoleculeFile::endRead()
+{
+    if(d->arena){
+        MoleculeArena::setCurrentArena(d->previousArena);
+        d->previousArena.reset();
+    }
+}
+
 } // end chemkit namespace
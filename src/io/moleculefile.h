@@ -52,6 +52,7 @@
 namespace chemkit {
 
 class Molecule;
+class MoleculeArena;
 class MoleculeFilePrivate;
 
 class CHEMKIT_IO_EXPORT MoleculeFile : public GenericFile<MoleculeFile, MoleculeFileFormat>
@@ -68,6 +69,8 @@ public:
     // properties
     size_t size() const;
     bool isEmpty() const;
+    void setArena(const boost::shared_ptr<MoleculeArena> &arena);
+    boost::shared_ptr<MoleculeArena> arena() const;
 
     // file contents
     void addMolecule(const boost::shared_ptr<Molecule> &molecule);
@@ -83,6 +86,10 @@ public:
     static boost::shared_ptr<Molecule> quickRead(const std::string &fileName);
     static void quickWrite(const Molecule *molecule, const std::string &fileName);
 
+protected:
+    virtual void beginRead();
+    virtual void endRead();
+
 private:
     MoleculeFilePrivate* const d;
 };
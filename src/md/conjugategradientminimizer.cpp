@@ -0,0 +1,134 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "conjugategradientminimizer.h"
+
+#include <algorithm>
+
+namespace chemkit {
+
+// === ConjugateGradientMinimizer ========================================== //
+/// \class ConjugateGradientMinimizer conjugategradientminimizer.h chemkit/conjugategradientminimizer.h
+/// \ingroup chemkit-md
+/// \brief The ConjugateGradientMinimizer class implements the
+///        Polak-Ribiere conjugate gradient minimization algorithm.
+///
+/// The conjugate gradient coefficient is clamped to be non-negative
+/// (PR+), which restarts the search along the negative gradient
+/// whenever the previous direction stops being useful.
+///
+/// \see Minimizer
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new conjugate gradient minimizer.
+ConjugateGradientMinimizer::ConjugateGradientMinimizer()
+    : Minimizer("conjugate-gradient")
+{
+    restart();
+}
+
+/// Destroys the conjugate gradient minimizer object.
+ConjugateGradientMinimizer::~ConjugateGradientMinimizer()
+{
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+bool ConjugateGradientMinimizer::iterate()
+{
+    const std::vector<Vector3> &gradient = currentGradient();
+
+    bool restarted = m_direction.size() != gradient.size();
+
+    if(restarted){
+        m_direction.resize(gradient.size());
+        for(size_t i = 0; i < gradient.size(); i++){
+            m_direction[i] = -gradient[i];
+        }
+    }
+    else{
+        // polak-ribiere coefficient
+        Real beta = (dot(gradient, gradient) - dot(gradient, m_previousGradient)) /
+                    dot(m_previousGradient, m_previousGradient);
+        beta = std::max(Real(0), beta);
+
+        for(size_t i = 0; i < gradient.size(); i++){
+            m_direction[i] = -gradient[i] + beta * m_direction[i];
+        }
+
+        // fall back to steepest descent if the new direction
+        // does not point downhill
+        if(dot(gradient, m_direction) >= 0){
+            for(size_t i = 0; i < gradient.size(); i++){
+                m_direction[i] = -gradient[i];
+            }
+        }
+    }
+
+    Real slope = dot(gradient, m_direction);
+
+    Real step;
+    if(m_step > 0){
+        step = m_step * m_slope / slope;
+    }
+    else{
+        step = 0.2 * maximumStepLength(m_direction);
+    }
+
+    m_previousGradient = gradient;
+
+    if(!lineSearch(m_direction, step, 0.1)){
+        bool steepest = restarted;
+        restart();
+
+        // try again along the negative gradient in the next
+        // iteration unless this already was a steepest descent step
+        return !steepest;
+    }
+
+    m_step = step;
+    m_slope = slope;
+
+    return true;
+}
+
+void ConjugateGradientMinimizer::restart()
+{
+    m_step = 0;
+    m_slope = 0;
+    m_direction.clear();
+    m_previousGradient.clear();
+}
+
+} // end chemkit namespace
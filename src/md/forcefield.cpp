@@ -35,6 +35,9 @@
 
 #include "forcefield.h"
 
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
 #include <chemkit/foreach.h>
 #include <chemkit/constants.h>
 #include <chemkit/concurrent.h>
@@ -42,8 +45,10 @@
 #include <chemkit/cartesiancoordinates.h>
 
 #include "topology.h"
+#include "neighborlist.h"
 #include "topologybuilder.h"
 #include "forcefieldcalculation.h"
+#include "forcefieldcalculationbatch.h"
 
 namespace chemkit {
 
@@ -55,12 +60,83 @@ public:
     int flags;
     boost::shared_ptr<Topology> topology;
     std::vector<ForceFieldCalculation *> calculations;
+    std::vector<ForceFieldCalculationBatch *> batches;
+    std::vector<ForceFieldCalculation *> batchCalculations;
+    bool batchCalculationsCreated;
+    boost::mutex batchCalculationsMutex;
+    Real nonbondedCutoff;
+    Real nonbondedSwitchDistance;
+    NeighborList neighborList;
+    std::vector<ForceFieldCalculationBatch *> nonbondedBatches;
+    bool nonbondedCalculationsValid;
+    boost::shared_mutex nonbondedMutex;
     std::string parameterSet;
     std::string parameterFile;
     std::map<std::string, std::string> parameterSets;
     std::string errorString;
+
+    bool isNonbondedBatch(const ForceFieldCalculationBatch *batch) const;
+    void deleteBatchCalculations();
+    void clearBatches();
+    void setupNeighborList();
+    bool needsNonbondedUpdate(const CartesianCoordinates *coordinates) const;
 };
 
+// Returns true if the batch is filled from the neighbor list.
+bool ForceFieldPrivate::isNonbondedBatch(const ForceFieldCalculationBatch *batch) const
+{
+    return std::find(nonbondedBatches.begin(), nonbondedBatches.end(), batch) != nonbondedBatches.end();
+}
+
+// Deletes the calculations created from the batches. They are
+// created again the next time they are requested.
+void ForceFieldPrivate::deleteBatchCalculations()
+{
+    foreach(ForceFieldCalculation *calculation, batchCalculations){
+        delete calculation;
+    }
+
+    batchCalculations.clear();
+    batchCalculationsCreated = false;
+}
+
+void ForceFieldPrivate::clearBatches()
+{
+    deleteBatchCalculations();
+
+    foreach(ForceFieldCalculationBatch *batch, batches){
+        delete batch;
+    }
+
+    batches.clear();
+    nonbondedBatches.clear();
+    nonbondedCalculationsValid = false;
+}
+
+// Sets the exclusions for the neighbor list from the topology.
+void ForceFieldPrivate::setupNeighborList()
+{
+    neighborList.clearExclusions();
+
+    if(!topology){
+        return;
+    }
+
+    neighborList.addExclusions(topology.get());
+}
+
+// Returns true if the nonbonded batches must be refilled before they
+// can be used to evaluate the energy for coordinates. The caller must
+// hold a lock on the nonbonded mutex.
+bool ForceFieldPrivate::needsNonbondedUpdate(const CartesianCoordinates *coordinates) const
+{
+    if(nonbondedBatches.empty()){
+        return false;
+    }
+
+    return !nonbondedCalculationsValid || neighborList.needsRebuild(coordinates);
+}
+
 // === ForceField ========================================================== //
 /// \class ForceField forcefield.h chemkit/forcefield.h
 /// \ingroup chemkit-md
@@ -93,6 +169,10 @@ ForceField::ForceField(const std::string &name)
 {
     d->name = name;
     d->flags = 0;
+    d->nonbondedCutoff = 0;
+    d->nonbondedSwitchDistance = 0;
+    d->nonbondedCalculationsValid = false;
+    d->batchCalculationsCreated = false;
 }
 
 /// Destroys a force field.
@@ -102,6 +182,9 @@ ForceField::~ForceField()
     foreach(ForceFieldCalculation *calculation, d->calculations){
         delete calculation;
     }
+    d->calculations.clear();
+
+    d->clearBatches();
 
     delete d;
 }
@@ -146,16 +229,23 @@ void ForceField::setTopology(const boost::shared_ptr<Topology> &topology)
         delete calculation;
     }
     d->calculations.clear();
+
+    // remove old calculation batches
+    d->clearBatches();
 }
 
 /// Builds a topology for the molecule and sets it with setTopology().
 ///
+/// If a nonbonded cutoff has been set the topology will only contain
+/// exclusions instead of every nonbonded interaction.
+///
 /// \see TopologyBuilder
 void ForceField::setTopologyFromMolecule(const Molecule *molecule)
 {
     TopologyBuilder builder;
     builder.setAtomTyper(name());
     builder.setPartialChargeModel(name());
+    builder.setExplicitNonbondedInteractions(d->nonbondedCutoff == 0);
     builder.addMolecule(molecule);
     setTopology(builder.topology());
 }
@@ -175,6 +265,12 @@ bool ForceField::setup()
 /// Returns \c true if the force field is setup.
 bool ForceField::isSetup() const
 {
+    foreach(const ForceFieldCalculationBatch *batch, d->batches){
+        if(!batch->isSetup()){
+            return false;
+        }
+    }
+
     foreach(const ForceFieldCalculation *calculation, d->calculations){
         if(!calculation->isSetup()){
             return false;
@@ -234,6 +330,10 @@ std::string ForceField::parameterFile() const
 }
 
 // --- Calculations -------------------------------------------------------- //
+/// Adds \p calculation to the force field. Calculations added with
+/// this method are evaluated individually. Force fields should
+/// instead add the calculations for the interactions in their
+/// topology with addCalculationBatch().
 void ForceField::addCalculation(ForceFieldCalculation *calculation)
 {
     calculation->setForceField(this);
@@ -248,15 +348,64 @@ void ForceField::removeCalculation(ForceFieldCalculation *calculation)
 }
 
 /// Returns a list of all the calculations in the force field.
+///
+/// The batches store only the atoms and parameters of their
+/// calculations. The first time this method is called a calculation
+/// is created with createCalculation() for each of them. Changing a
+/// parameter of one of these calculations also changes the parameter
+/// in its batch. The calculations in nonbonded batches are not
+/// included.
+///
+/// This method is thread-safe.
 std::vector<ForceFieldCalculation *> ForceField::calculations() const
 {
-    return d->calculations;
+    boost::lock_guard<boost::mutex> lock(d->batchCalculationsMutex);
+
+    if(!d->batchCalculationsCreated){
+        foreach(ForceFieldCalculationBatch *batch, d->batches){
+            if(d->isNonbondedBatch(batch)){
+                continue;
+            }
+
+            for(size_t i = 0; i < batch->size(); i++){
+                ForceFieldCalculation *calculation = createCalculation(batch->type(), batch->atoms(i));
+                if(!calculation){
+                    continue;
+                }
+
+                const Real *parameters = batch->parameters(i);
+                for(int j = 0; j < calculation->parameterCount(); j++){
+                    calculation->setParameter(j, parameters[j]);
+                }
+
+                calculation->setForceField(const_cast<ForceField *>(this));
+                calculation->setSetup(batch->isSetup(i));
+                calculation->setBatch(batch, i);
+                d->batchCalculations.push_back(calculation);
+            }
+        }
+
+        d->batchCalculationsCreated = true;
+    }
+
+    std::vector<ForceFieldCalculation *> calculations = d->batchCalculations;
+    calculations.insert(calculations.end(), d->calculations.begin(), d->calculations.end());
+
+    return calculations;
 }
 
 /// Returns the number of calculations in the force field.
 size_t ForceField::calculationCount() const
 {
-    return d->calculations.size();
+    size_t count = d->calculations.size();
+
+    foreach(const ForceFieldCalculationBatch *batch, d->batches){
+        if(!d->isNonbondedBatch(batch)){
+            count += batch->size();
+        }
+    }
+
+    return count;
 }
 
 void ForceField::setCalculationSetup(ForceFieldCalculation *calculation, bool setup)
@@ -264,11 +413,217 @@ void ForceField::setCalculationSetup(ForceFieldCalculation *calculation, bool se
     calculation->setSetup(setup);
 }
 
+/// Adds \p batch to the force field. The batch should already
+/// contain the atoms and parameters for each of its calculations.
+///
+/// Force fields should create a batch for each type of interaction
+/// in their topology at the end of their setup() method instead of
+/// creating a ForceFieldCalculation for each interaction. Adding a
+/// batch replaces any existing batch of the same type. The force
+/// field takes ownership of \p batch.
+///
+/// \see ForceFieldKernelBatch, createCalculation()
+void ForceField::addCalculationBatch(ForceFieldCalculationBatch *batch)
+{
+    d->deleteBatchCalculations();
+
+    for(size_t i = 0; i < d->batches.size(); i++){
+        if(d->batches[i]->type() == batch->type()){
+            delete d->batches[i];
+            d->batches[i] = batch;
+            return;
+        }
+    }
+
+    d->batches.push_back(batch);
+}
+
+/// Returns a list of the calculation batches in the force field.
+std::vector<ForceFieldCalculationBatch *> ForceField::calculationBatches() const
+{
+    return d->batches;
+}
+
+/// Adds \p batch for nonbonded calculations to the force field. The
+/// batch is filled with a calculation for each pair of atoms in the
+/// neighborList() using the parameters from nonbondedParameters().
+/// Whenever the neighbor list is rebuilt the batch is refilled.
+///
+/// Force field implementations should use this instead of creating
+/// explicit nonbonded calculations when nonbondedCutoff() is greater
+/// than zero. The force field takes ownership of \p batch.
+///
+/// \see setNonbondedCutoff()
+void ForceField::addNonbondedCalculationBatch(ForceFieldCalculationBatch *batch)
+{
+    if(d->nonbondedBatches.empty()){
+        d->setupNeighborList();
+    }
+
+    d->deleteBatchCalculations();
+
+    for(size_t i = 0; i < d->batches.size(); i++){
+        if(d->batches[i]->type() == batch->type()){
+            d->nonbondedBatches.erase(std::remove(d->nonbondedBatches.begin(),
+                                                  d->nonbondedBatches.end(),
+                                                  d->batches[i]),
+                                      d->nonbondedBatches.end());
+            delete d->batches[i];
+            d->batches.erase(d->batches.begin() + i);
+            break;
+        }
+    }
+
+    batch->setCutoff(d->nonbondedCutoff);
+    batch->setSwitchDistance(d->nonbondedSwitchDistance);
+    d->batches.push_back(batch);
+    d->nonbondedBatches.push_back(batch);
+    d->nonbondedCalculationsValid = false;
+}
+
+/// Returns a new calculation of \p type for \p atoms. This is used
+/// by calculations() to create a calculation for each entry in the
+/// batches. The parameters of the calculation are set from the batch
+/// afterwards.
+///
+/// Force fields which use addCalculationBatch() should reimplement
+/// this method. The default implementation returns \c 0.
+ForceFieldCalculation* ForceField::createCalculation(int type, const size_t *atoms) const
+{
+    CHEMKIT_UNUSED(type);
+    CHEMKIT_UNUSED(atoms);
+
+    return 0;
+}
+
+/// Sets the parameters for the nonbonded calculation between atoms
+/// \p a and \p b in the batch with \p type. The \p oneFour flag is
+/// \c true if the atoms are at the ends of a torsion interaction.
+/// Returns \c false if there is no calculation between the atoms.
+///
+/// Force fields which use addNonbondedCalculationBatch() must
+/// reimplement this method. The default implementation returns
+/// \c false.
+bool ForceField::nonbondedParameters(int type, size_t a, size_t b, bool oneFour, Real *parameters) const
+{
+    CHEMKIT_UNUSED(type);
+    CHEMKIT_UNUSED(a);
+    CHEMKIT_UNUSED(b);
+    CHEMKIT_UNUSED(oneFour);
+    CHEMKIT_UNUSED(parameters);
+
+    return false;
+}
+
+// --- Nonbonded Interactions ---------------------------------------------- //
+/// Sets the cutoff distance for nonbonded interactions to \p cutoff.
+///
+/// By default the cutoff is \c 0 and the force field contains a
+/// nonbonded calculation for every pair of atoms separated by more
+/// than two bonds. This requires time and memory quadratic in the
+/// number of atoms.
+///
+/// With a cutoff greater than zero the nonbonded calculations are
+/// created from a NeighborList which contains each pair of atoms
+/// within the cutoff plus the neighborListSkin(). Pairs with an
+/// exclusion in the topology are skipped. The neighbor list is
+/// rebuilt automatically when the atoms have moved far enough.
+///
+/// Setting the cutoff also sets the nonbondedSwitchDistance() to two
+/// Angstroms less than the cutoff so that the energy and gradient go
+/// smoothly to zero at the cutoff.
+///
+/// The cutoff must be set before calling setTopologyFromMolecule()
+/// and setup().
+///
+/// \code
+/// forceField->setNonbondedCutoff(10.0);
+/// forceField->setTopologyFromMolecule(protein);
+/// forceField->setup();
+/// \endcode
+void ForceField::setNonbondedCutoff(Real cutoff)
+{
+    d->nonbondedCutoff = cutoff;
+    d->neighborList.setCutoff(cutoff);
+
+    foreach(ForceFieldCalculationBatch *batch, d->nonbondedBatches){
+        batch->setCutoff(cutoff);
+    }
+
+    setNonbondedSwitchDistance(std::max(cutoff - 2, Real(0)));
+
+    d->nonbondedCalculationsValid = false;
+}
+
+/// Returns the cutoff distance for nonbonded interactions.
+Real ForceField::nonbondedCutoff() const
+{
+    return d->nonbondedCutoff;
+}
+
+/// Sets the distance at which the nonbonded interactions start to
+/// be switched off to \p distance. Between this distance and the
+/// nonbondedCutoff() the energy of each interaction is multiplied by
+/// a switching function which goes smoothly from one to zero. If
+/// \p distance is not less than the cutoff the interactions are
+/// truncated at the cutoff and the energy is discontinuous there.
+///
+/// \see ForceFieldKernelBatch
+void ForceField::setNonbondedSwitchDistance(Real distance)
+{
+    d->nonbondedSwitchDistance = distance;
+
+    foreach(ForceFieldCalculationBatch *batch, d->nonbondedBatches){
+        batch->setSwitchDistance(distance);
+    }
+}
+
+/// Returns the distance at which the nonbonded interactions start to
+/// be switched off.
+Real ForceField::nonbondedSwitchDistance() const
+{
+    return d->nonbondedSwitchDistance;
+}
+
+/// Sets the skin distance for the neighbor list to \p skin. The
+/// default skin distance is \c 2 Angstroms.
+void ForceField::setNeighborListSkin(Real skin)
+{
+    d->neighborList.setSkin(skin);
+    d->nonbondedCalculationsValid = false;
+}
+
+/// Returns the skin distance for the neighbor list.
+Real ForceField::neighborListSkin() const
+{
+    return d->neighborList.skin();
+}
+
+/// Returns the neighbor list used to create the nonbonded
+/// calculations.
+const NeighborList* ForceField::neighborList() const
+{
+    return &d->neighborList;
+}
+
 /// \copydoc Potential::energy()
 Real ForceField::energy(const CartesianCoordinates *coordinates) const
 {
+    // the nonbonded batches are shared by concurrent evaluations and
+    // are only refilled while no other evaluation is using them
+    boost::shared_lock<boost::shared_mutex> lock(d->nonbondedMutex);
+    while(d->needsNonbondedUpdate(coordinates)){
+        lock.unlock();
+        updateNonbondedCalculations(coordinates);
+        lock.lock();
+    }
+
     Real energy = 0;
 
+    foreach(const ForceFieldCalculationBatch *batch, d->batches){
+        energy += batch->energy(coordinates);
+    }
+
     foreach(const ForceFieldCalculation *calculation, d->calculations){
         energy += calculation->energy(coordinates);
     }
@@ -280,17 +635,8 @@ Real ForceField::energy(const CartesianCoordinates *coordinates) const
 std::vector<Vector3> ForceField::gradient(const CartesianCoordinates *coordinates) const
 {
     if(d->flags & AnalyticalGradient){
-        std::vector<Vector3> gradient(size());
-        std::fill(gradient.begin(), gradient.end(), Vector3(0, 0, 0));
-
-        foreach(const ForceFieldCalculation *calculation, d->calculations){
-            std::vector<Vector3> atomGradients = calculation->gradient(coordinates);
-
-            for(size_t i = 0; i < atomGradients.size(); i++){
-                gradient[calculation->atom(i)] += atomGradients[i];
-            }
-        }
-
+        std::vector<Vector3> gradient;
+        energyAndGradient(coordinates, gradient);
         return gradient;
     }
     else{
@@ -298,6 +644,45 @@ std::vector<Vector3> ForceField::gradient(const CartesianCoordinates *coordinate
     }
 }
 
+/// \copydoc Potential::energyAndGradient()
+Real ForceField::energyAndGradient(const CartesianCoordinates *coordinates,
+                                   std::vector<Vector3> &gradient) const
+{
+    if(!(d->flags & AnalyticalGradient)){
+        return Potential::energyAndGradient(coordinates, gradient);
+    }
+
+    // the nonbonded batches are shared by concurrent evaluations and
+    // are only refilled while no other evaluation is using them
+    boost::shared_lock<boost::shared_mutex> lock(d->nonbondedMutex);
+    while(d->needsNonbondedUpdate(coordinates)){
+        lock.unlock();
+        updateNonbondedCalculations(coordinates);
+        lock.lock();
+    }
+
+    gradient.resize(size());
+    std::fill(gradient.begin(), gradient.end(), Vector3(0, 0, 0));
+
+    Real energy = 0;
+
+    foreach(const ForceFieldCalculationBatch *batch, d->batches){
+        energy += batch->energyAndGradient(coordinates, gradient);
+    }
+
+    foreach(const ForceFieldCalculation *calculation, d->calculations){
+        energy += calculation->energy(coordinates);
+
+        std::vector<Vector3> atomGradients = calculation->gradient(coordinates);
+
+        for(size_t i = 0; i < atomGradients.size(); i++){
+            gradient[calculation->atom(i)] += atomGradients[i];
+        }
+    }
+
+    return energy;
+}
+
 // --- Error Handling ------------------------------------------------------ //
 /// Sets a string that describes the last error that occurred.
 void ForceField::setErrorString(const std::string &errorString)
@@ -325,4 +710,38 @@ std::vector<std::string> ForceField::forceFields()
     return PluginManager::instance()->pluginClassNames<ForceField>();
 }
 
+// --- Internal Methods ---------------------------------------------------- //
+// Refills the nonbonded calculation batches if the neighbor list has
+// been rebuilt for the coordinates.
+void ForceField::updateNonbondedCalculations(const CartesianCoordinates *coordinates) const
+{
+    boost::unique_lock<boost::shared_mutex> lock(d->nonbondedMutex);
+
+    if(d->nonbondedBatches.empty()){
+        return;
+    }
+
+    bool rebuilt = d->neighborList.update(coordinates);
+    if(!rebuilt && d->nonbondedCalculationsValid){
+        return;
+    }
+
+    foreach(ForceFieldCalculationBatch *batch, d->nonbondedBatches){
+        batch->clear();
+        batch->reserve(d->neighborList.size());
+
+        std::vector<Real> parameters(std::max(batch->parameterCount(), size_t(1)));
+
+        foreach(const NeighborList::Pair &pair, d->neighborList.pairs()){
+            bool oneFour = d->topology->isOneFour(pair[0], pair[1]);
+
+            if(nonbondedParameters(batch->type(), pair[0], pair[1], oneFour, &parameters[0])){
+                batch->addCalculation(pair.data(), &parameters[0]);
+            }
+        }
+    }
+
+    d->nonbondedCalculationsValid = true;
+}
+
 } // end chemkit namespace
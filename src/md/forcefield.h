@@ -51,11 +51,13 @@
 
 #include "potential.h"
 #include "forcefieldcalculation.h"
+#include "forcefieldcalculationbatch.h"
 
 namespace chemkit {
 
 class Molecule;
 class Topology;
+class NeighborList;
 class ForceFieldPrivate;
 class CartesianCoordinates;
 
@@ -92,8 +94,17 @@ public:
     // calculations
     std::vector<ForceFieldCalculation *> calculations() const;
     size_t calculationCount() const;
+    std::vector<ForceFieldCalculationBatch *> calculationBatches() const;
+    void setNonbondedCutoff(Real cutoff);
+    Real nonbondedCutoff() const;
+    void setNonbondedSwitchDistance(Real distance);
+    Real nonbondedSwitchDistance() const;
+    void setNeighborListSkin(Real skin);
+    Real neighborListSkin() const;
+    const NeighborList* neighborList() const;
     Real energy(const CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<Vector3> gradient(const CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    Real energyAndGradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const CHEMKIT_OVERRIDE;
 
     // error handling
     std::string errorString() const;
@@ -108,10 +119,17 @@ protected:
     void addCalculation(ForceFieldCalculation *calculation);
     void removeCalculation(ForceFieldCalculation *calculation);
     void setCalculationSetup(ForceFieldCalculation *calculation, bool setup);
+    void addCalculationBatch(ForceFieldCalculationBatch *batch);
+    void addNonbondedCalculationBatch(ForceFieldCalculationBatch *batch);
+    virtual ForceFieldCalculation* createCalculation(int type, const size_t *atoms) const;
+    virtual bool nonbondedParameters(int type, size_t a, size_t b, bool oneFour, Real *parameters) const;
     void addParameterSet(const std::string &name, const std::string &fileName);
     void removeParameterSet(const std::string &name);
     void setErrorString(const std::string &errorString);
 
+private:
+    void updateNonbondedCalculations(const CartesianCoordinates *coordinates) const;
+
 private:
     ForceFieldPrivate* const d;
 };
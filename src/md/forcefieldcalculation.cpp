@@ -39,6 +39,7 @@
 
 #include "topology.h"
 #include "forcefield.h"
+#include "forcefieldcalculationbatch.h"
 
 namespace chemkit {
 
@@ -47,6 +48,8 @@ class ForceFieldCalculationPrivate
 {
 public:
     ForceField *forceField;
+    ForceFieldCalculationBatch *batch;
+    size_t batchIndex;
     int type;
     bool setup;
     std::vector<Real> parameters;
@@ -59,6 +62,11 @@ public:
 /// \brief The ForceFieldCalculation class represents an energy
 ///        calculation in a force field.
 ///
+/// The calculations returned by ForceField::calculations() are
+/// created from the entries in a ForceFieldCalculationBatch. Any
+/// changes to their atoms or parameters are also made to the copy
+/// stored in the batch which is used to evaluate the energy.
+///
 /// \see ForceField
 
 // --- Construction and Destruction ---------------------------------------- //
@@ -68,6 +76,8 @@ ForceFieldCalculation::ForceFieldCalculation(int type,
     : d(new ForceFieldCalculationPrivate)
 {
     d->forceField = 0;
+    d->batch = 0;
+    d->batchIndex = 0;
     d->type = type;
     d->setup = false;
     d->atoms.resize(atomCount);
@@ -108,6 +118,10 @@ boost::shared_ptr<Topology> ForceFieldCalculation::topology() const
 void ForceFieldCalculation::setAtom(size_t index, size_t atom)
 {
     d->atoms[index] = atom;
+
+    if(d->batch){
+        d->batch->setAtom(d->batchIndex, index, atom);
+    }
 }
 
 /// Returns the atom at index in the calculation.
@@ -138,6 +152,10 @@ std::string ForceFieldCalculation::atomType(size_t index) const
 void ForceFieldCalculation::setParameter(int index, Real value)
 {
     d->parameters[index] = value;
+
+    if(d->batch){
+        d->batch->setParameter(d->batchIndex, index, value);
+    }
 }
 
 /// Returns the parameter at index.
@@ -245,4 +263,17 @@ void ForceFieldCalculation::setForceField(ForceField *forceField)
     d->forceField = forceField;
 }
 
+// Sets the batch which contains the calculation at index. A batch
+// of 0 means the calculation is evaluated individually.
+void ForceFieldCalculation::setBatch(ForceFieldCalculationBatch *batch, size_t index)
+{
+    d->batch = batch;
+    d->batchIndex = index;
+}
+
+ForceFieldCalculationBatch* ForceFieldCalculation::batch() const
+{
+    return d->batch;
+}
+
 } // end chemkit namespace
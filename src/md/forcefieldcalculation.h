@@ -51,6 +51,7 @@ namespace chemkit {
 class Topology;
 class ForceField;
 class CartesianCoordinates;
+class ForceFieldCalculationBatch;
 class ForceFieldCalculationPrivate;
 
 class CHEMKIT_MD_EXPORT ForceFieldCalculation
@@ -97,8 +98,11 @@ protected:
 private:
     void setSetup(bool setup);
     void setForceField(ForceField *forceField);
+    void setBatch(ForceFieldCalculationBatch *batch, size_t index);
+    ForceFieldCalculationBatch* batch() const;
 
     friend class ForceField;
+    friend class ForceFieldPrivate;
 
 private:
     ForceFieldCalculationPrivate* const d;
@@ -0,0 +1,219 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_FORCEFIELDCALCULATIONBATCH_INLINE_H
+#define CHEMKIT_FORCEFIELDCALCULATIONBATCH_INLINE_H
+
+#include "forcefieldcalculationbatch.h"
+
+#include <chemkit/cartesiancoordinates.h>
+
+namespace chemkit {
+
+// === ForceFieldKernelBatch =============================================== //
+/// \class ForceFieldKernelBatch forcefieldcalculationbatch.h chemkit/forcefieldcalculationbatch.h
+/// \ingroup chemkit-md
+/// \brief The ForceFieldKernelBatch class evaluates a batch of
+///        calculations with a single kernel.
+///
+/// The \p Kernel type must provide the number of atoms and
+/// parameters for each calculation along with static methods
+/// which evaluate a single calculation. For example:
+/// \code
+/// struct BondKernel
+/// {
+///     enum { AtomCount = 2, ParameterCount = 2 };
+///
+///     static Real energy(const CartesianCoordinates *coordinates,
+///                        const size_t *atoms,
+///                        const Real *parameters);
+///
+///     static Real energyAndGradient(const CartesianCoordinates *coordinates,
+///                                   const size_t *atoms,
+///                                   const Real *parameters,
+///                                   std::vector<Vector3> &gradient);
+/// };
+/// \endcode
+///
+/// If the batch has a cutoff() the calculations in two atom batches
+/// whose atoms are further apart than the cutoff are skipped. The
+/// energy of calculations between the switchDistance() and the
+/// cutoff is multiplied by the switching function:
+///
+/** \f[ S(r) = \frac{(r_{c}^{2} - r^{2})^{2} (r_{c}^{2} + 2r^{2} - 3r_{s}^{2})}
+///                  {(r_{c}^{2} - r_{s}^{2})^{3}} \f]
+**/
+///
+/// The kernel's energyAndGradient() method returns the energy of the
+/// calculation and adds the gradient for each of its atoms to the
+/// corresponding entry in \p gradient.
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new kernel batch for calculations of \p type.
+template<typename Kernel>
+inline ForceFieldKernelBatch<Kernel>::ForceFieldKernelBatch(int type)
+    : ForceFieldCalculationBatch(type, Kernel::AtomCount, Kernel::ParameterCount)
+{
+}
+
+// --- Energy -------------------------------------------------------------- //
+/// Returns the total energy of the calculations in the batch.
+template<typename Kernel>
+inline Real ForceFieldKernelBatch<Kernel>::energy(const CartesianCoordinates *coordinates) const
+{
+    if(isEmpty()){
+        return 0;
+    }
+
+    const size_t *atoms = this->atoms(0);
+    const Real *parameters = this->parameters(0);
+
+    Real energy = 0;
+    Real cutoffSquared = cutoff() * cutoff();
+    bool pairCutoff = Kernel::AtomCount == 2 && cutoffSquared > 0;
+
+    for(size_t i = 0; i < size(); i++){
+        Real factor = 1;
+
+        if(pairCutoff){
+            Real distanceSquared = ((*coordinates)[atoms[0]] - (*coordinates)[atoms[1]]).squaredNorm();
+
+            if(distanceSquared > cutoffSquared){
+                atoms += Kernel::AtomCount;
+                parameters += Kernel::ParameterCount;
+                continue;
+            }
+
+            factor = switchingFunction(distanceSquared, 0);
+        }
+
+        energy += factor * Kernel::energy(coordinates, atoms, parameters);
+
+        atoms += Kernel::AtomCount;
+        parameters += Kernel::ParameterCount;
+    }
+
+    return energy;
+}
+
+/// Returns the total energy of the calculations in the batch and
+/// adds the gradient of each calculation to \p gradient.
+template<typename Kernel>
+inline Real ForceFieldKernelBatch<Kernel>::energyAndGradient(const CartesianCoordinates *coordinates,
+                                                             std::vector<Vector3> &gradient) const
+{
+    if(isEmpty()){
+        return 0;
+    }
+
+    const size_t *atoms = this->atoms(0);
+    const Real *parameters = this->parameters(0);
+
+    Real energy = 0;
+    Real cutoffSquared = cutoff() * cutoff();
+    bool pairCutoff = Kernel::AtomCount == 2 && cutoffSquared > 0;
+
+    for(size_t i = 0; i < size(); i++){
+        if(!pairCutoff){
+            energy += Kernel::energyAndGradient(coordinates, atoms, parameters, gradient);
+
+            atoms += Kernel::AtomCount;
+            parameters += Kernel::ParameterCount;
+            continue;
+        }
+
+        Vector3 distance = (*coordinates)[atoms[0]] - (*coordinates)[atoms[1]];
+        Real distanceSquared = distance.squaredNorm();
+
+        if(distanceSquared > cutoffSquared){
+            atoms += Kernel::AtomCount;
+            parameters += Kernel::ParameterCount;
+            continue;
+        }
+
+        Real derivative = 0;
+        Real factor = switchingFunction(distanceSquared, &derivative);
+
+        if(factor == 1){
+            energy += Kernel::energyAndGradient(coordinates, atoms, parameters, gradient);
+        }
+        else{
+            // scale the gradient from the kernel by the switching
+            // function and add the gradient of the switching function
+            Vector3 gradientA = gradient[atoms[0]];
+            Vector3 gradientB = gradient[atoms[1]];
+
+            Real pairEnergy = Kernel::energyAndGradient(coordinates, atoms, parameters, gradient);
+
+            gradient[atoms[0]] = gradientA + factor * (gradient[atoms[0]] - gradientA) + pairEnergy * derivative * distance;
+            gradient[atoms[1]] = gradientB + factor * (gradient[atoms[1]] - gradientB) - pairEnergy * derivative * distance;
+
+            energy += factor * pairEnergy;
+        }
+
+        atoms += Kernel::AtomCount;
+        parameters += Kernel::ParameterCount;
+    }
+
+    return energy;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+// Returns the value of the switching function for two atoms whose
+// squared distance is distanceSquared. If derivative is not null it
+// is set to the derivative of the function divided by the distance.
+template<typename Kernel>
+inline Real ForceFieldKernelBatch<Kernel>::switchingFunction(Real distanceSquared, Real *derivative) const
+{
+    Real switchSquared = switchDistance() * switchDistance();
+    if(distanceSquared <= switchSquared || switchDistance() >= cutoff()){
+        return 1;
+    }
+
+    Real cutoffSquared = cutoff() * cutoff();
+    Real width = cutoffSquared - switchSquared;
+    Real denominator = width * width * width;
+    Real outer = cutoffSquared - distanceSquared;
+
+    if(derivative){
+        *derivative = 12 * outer * (switchSquared - distanceSquared) / denominator;
+    }
+
+    return outer * outer * (cutoffSquared + 2 * distanceSquared - 3 * switchSquared) / denominator;
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_FORCEFIELDCALCULATIONBATCH_INLINE_H
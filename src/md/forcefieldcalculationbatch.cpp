@@ -0,0 +1,247 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "forcefieldcalculationbatch.h"
+
+#include <cassert>
+#include <algorithm>
+
+namespace chemkit {
+
+// === ForceFieldCalculationBatchPrivate =================================== //
+class ForceFieldCalculationBatchPrivate
+{
+public:
+    int type;
+    size_t atomCount;
+    size_t parameterCount;
+    Real cutoff;
+    Real switchDistance;
+    std::vector<size_t> atoms;
+    std::vector<Real> parameters;
+    std::vector<size_t> failedCalculations;
+};
+
+// === ForceFieldCalculationBatch ========================================== //
+/// \class ForceFieldCalculationBatch forcefieldcalculationbatch.h chemkit/forcefieldcalculationbatch.h
+/// \ingroup chemkit-md
+/// \brief The ForceFieldCalculationBatch class represents a set of
+///        force field calculations of the same type.
+///
+/// The atom indices and parameters for each calculation in the batch
+/// are stored contiguously which allows the energy and gradient of
+/// the entire batch to be evaluated without a virtual method call
+/// or memory allocation for each calculation.
+///
+/// Force fields create batches with the ForceFieldKernelBatch class,
+/// fill them with the atoms and parameters for each interaction in
+/// their topology and add them with ForceField::addCalculationBatch().
+///
+/// \see ForceField, ForceFieldKernelBatch
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new batch for calculations of \p type which contain
+/// \p atomCount atoms and \p parameterCount parameters each.
+ForceFieldCalculationBatch::ForceFieldCalculationBatch(int type,
+                                                       size_t atomCount,
+                                                       size_t parameterCount)
+    : d(new ForceFieldCalculationBatchPrivate)
+{
+    d->type = type;
+    d->atomCount = atomCount;
+    d->parameterCount = parameterCount;
+    d->cutoff = 0;
+    d->switchDistance = 0;
+}
+
+/// Destroys the batch.
+ForceFieldCalculationBatch::~ForceFieldCalculationBatch()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the type of the calculations in the batch.
+///
+/// \see ForceFieldCalculation::type()
+int ForceFieldCalculationBatch::type() const
+{
+    return d->type;
+}
+
+/// Returns the number of atoms in each calculation.
+size_t ForceFieldCalculationBatch::atomCount() const
+{
+    return d->atomCount;
+}
+
+/// Returns the number of parameters in each calculation.
+size_t ForceFieldCalculationBatch::parameterCount() const
+{
+    return d->parameterCount;
+}
+
+/// Returns the number of calculations in the batch.
+size_t ForceFieldCalculationBatch::size() const
+{
+    if(!d->atomCount){
+        return 0;
+    }
+
+    return d->atoms.size() / d->atomCount;
+}
+
+/// Returns \c true if the batch contains no calculations.
+bool ForceFieldCalculationBatch::isEmpty() const
+{
+    return d->atoms.empty();
+}
+
+/// Returns \c true if every calculation in the batch was setup.
+bool ForceFieldCalculationBatch::isSetup() const
+{
+    return d->failedCalculations.empty();
+}
+
+/// Returns \c true if the calculation at \p index was setup.
+bool ForceFieldCalculationBatch::isSetup(size_t index) const
+{
+    return !std::binary_search(d->failedCalculations.begin(),
+                               d->failedCalculations.end(),
+                               index);
+}
+
+/// Sets the cutoff distance for the calculations to \p cutoff.
+/// Calculations with two atoms further apart than \p cutoff are
+/// skipped when evaluating the batch. A cutoff of \c 0 disables
+/// the cutoff (the default).
+void ForceFieldCalculationBatch::setCutoff(Real cutoff)
+{
+    d->cutoff = cutoff;
+}
+
+/// Returns the cutoff distance for the calculations.
+Real ForceFieldCalculationBatch::cutoff() const
+{
+    return d->cutoff;
+}
+
+/// Sets the distance at which the energy of two atom calculations
+/// starts to be switched off to \p distance. Between this distance
+/// and the cutoff() the energy is smoothly scaled to zero so that
+/// the energy and gradient are continuous at the cutoff. If \p distance
+/// is not less than the cutoff() the energy is truncated instead.
+void ForceFieldCalculationBatch::setSwitchDistance(Real distance)
+{
+    d->switchDistance = distance;
+}
+
+/// Returns the distance at which the energy of two atom calculations
+/// starts to be switched off.
+Real ForceFieldCalculationBatch::switchDistance() const
+{
+    return d->switchDistance;
+}
+
+// --- Calculations -------------------------------------------------------- //
+/// Adds a calculation with \p atoms and \p parameters to the batch.
+/// If \p setup is \c false the parameters for the calculation could
+/// not be found and the force field is not setup.
+void ForceFieldCalculationBatch::addCalculation(const size_t *atoms, const Real *parameters, bool setup)
+{
+    if(!setup){
+        d->failedCalculations.push_back(size());
+    }
+
+    d->atoms.insert(d->atoms.end(), atoms, atoms + d->atomCount);
+    d->parameters.insert(d->parameters.end(), parameters, parameters + d->parameterCount);
+}
+
+/// Reserves space for \p size calculations.
+void ForceFieldCalculationBatch::reserve(size_t size)
+{
+    d->atoms.reserve(size * d->atomCount);
+    d->parameters.reserve(size * d->parameterCount);
+}
+
+/// Removes all of the calculations from the batch.
+void ForceFieldCalculationBatch::clear()
+{
+    d->atoms.clear();
+    d->parameters.clear();
+    d->failedCalculations.clear();
+}
+
+/// Sets the \p atom of the calculation at \p index to \p value.
+void ForceFieldCalculationBatch::setAtom(size_t index, size_t atom, size_t value)
+{
+    assert(index < size() && atom < d->atomCount);
+
+    d->atoms[index * d->atomCount + atom] = value;
+}
+
+/// Returns a pointer to the atom indices for the calculation at
+/// \p index. The atoms for the following calculations are stored
+/// directly after them.
+const size_t* ForceFieldCalculationBatch::atoms(size_t index) const
+{
+    assert(index < size());
+
+    return &d->atoms[index * d->atomCount];
+}
+
+/// Sets the \p parameter of the calculation at \p index to \p value.
+void ForceFieldCalculationBatch::setParameter(size_t index, size_t parameter, Real value)
+{
+    assert(index < size() && parameter < d->parameterCount);
+
+    d->parameters[index * d->parameterCount + parameter] = value;
+}
+
+/// Returns a pointer to the parameters for the calculation at
+/// \p index. The parameters for the following calculations are
+/// stored directly after them.
+const Real* ForceFieldCalculationBatch::parameters(size_t index) const
+{
+    assert(index < size());
+
+    if(!d->parameterCount){
+        return 0;
+    }
+
+    return &d->parameters[index * d->parameterCount];
+}
+
+} // end chemkit namespace
@@ -114,6 +114,20 @@ std::vector<Vector3> Integrator::gradient() const
     return d->potential->gradient(&d->coordinates);
 }
 
+/// Returns the energy of the system and writes its gradient to
+/// \p gradient.
+///
+/// \see Potential::energyAndGradient()
+Real Integrator::energyAndGradient(std::vector<Vector3> &gradient) const
+{
+    if(!d->potential){
+        gradient.clear();
+        return 0;
+    }
+
+    return d->potential->energyAndGradient(&d->coordinates, gradient);
+}
+
 /// Returns the root-mean-square gradient.
 Real Integrator::rmsg() const
 {
@@ -0,0 +1,195 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "lbfgsminimizer.h"
+
+#include <algorithm>
+
+namespace chemkit {
+
+// === LbfgsMinimizer ====================================================== //
+/// \class LbfgsMinimizer lbfgsminimizer.h chemkit/lbfgsminimizer.h
+/// \ingroup chemkit-md
+/// \brief The LbfgsMinimizer class implements the limited-memory
+///        BFGS minimization algorithm.
+///
+/// L-BFGS approximates the inverse hessian from the position and
+/// gradient changes of the last historySize() iterations. Each step
+/// is found with a line search satisfying the strong Wolfe
+/// conditions.
+///
+/// This is the default minimizer used by MoleculeGeometryOptimizer.
+///
+/// \see Minimizer
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new L-BFGS minimizer.
+LbfgsMinimizer::LbfgsMinimizer()
+    : Minimizer("lbfgs")
+{
+    m_historySize = 8;
+    restart();
+}
+
+/// Destroys the L-BFGS minimizer object.
+LbfgsMinimizer::~LbfgsMinimizer()
+{
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Sets the number of previous iterations used to approximate the
+/// inverse hessian to \p size. The default is \c 8.
+void LbfgsMinimizer::setHistorySize(size_t size)
+{
+    m_historySize = std::max(size_t(1), size);
+    restart();
+}
+
+/// Returns the number of previous iterations used to approximate
+/// the inverse hessian.
+size_t LbfgsMinimizer::historySize() const
+{
+    return m_historySize;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+bool LbfgsMinimizer::iterate()
+{
+    const std::vector<Vector3> &gradient = currentGradient();
+    const size_t size = gradient.size();
+
+    if(m_count > 0 && m_s[(m_next + m_historySize - 1) % m_historySize].size() != size){
+        restart();
+    }
+
+    // two-loop recursion for the search direction
+    m_direction = gradient;
+
+    for(size_t k = 0; k < m_count; k++){
+        size_t index = (m_next + m_historySize - 1 - k) % m_historySize;
+
+        m_alpha[index] = m_rho[index] * dot(m_s[index], m_direction);
+        for(size_t i = 0; i < size; i++){
+            m_direction[i] -= m_alpha[index] * m_y[index][i];
+        }
+    }
+
+    if(m_count > 0){
+        size_t newest = (m_next + m_historySize - 1) % m_historySize;
+        Real gamma = dot(m_s[newest], m_y[newest]) / dot(m_y[newest], m_y[newest]);
+        for(size_t i = 0; i < size; i++){
+            m_direction[i] *= gamma;
+        }
+    }
+
+    for(size_t k = m_count; k > 0; k--){
+        size_t index = (m_next + m_historySize - k) % m_historySize;
+
+        Real beta = m_rho[index] * dot(m_y[index], m_direction);
+        for(size_t i = 0; i < size; i++){
+            m_direction[i] += (m_alpha[index] - beta) * m_s[index][i];
+        }
+    }
+
+    for(size_t i = 0; i < size; i++){
+        m_direction[i] = -m_direction[i];
+    }
+
+    // fall back to steepest descent if the direction does not
+    // point downhill
+    bool steepest = m_count == 0;
+    if(!steepest && dot(gradient, m_direction) >= 0){
+        restart();
+
+        for(size_t i = 0; i < size; i++){
+            m_direction[i] = -gradient[i];
+        }
+
+        steepest = true;
+    }
+
+    // the scaled direction is well sized so the unit step is
+    // tried first, otherwise start with a small step
+    Real step = steepest ? 0.2 * maximumStepLength(m_direction) : 1;
+
+    m_previousGradient = gradient;
+
+    if(!lineSearch(m_direction, step, 0.9)){
+        restart();
+
+        // try again along the negative gradient in the next
+        // iteration unless this already was a steepest descent step
+        return !steepest;
+    }
+
+    // store the position and gradient changes if they keep the
+    // inverse hessian approximation positive definite
+    const std::vector<Vector3> &newGradient = currentGradient();
+
+    Real sy = 0;
+    for(size_t i = 0; i < size; i++){
+        sy += step * m_direction[i].dot(newGradient[i] - m_previousGradient[i]);
+    }
+
+    if(sy > 0){
+        std::vector<Vector3> &s = m_s[m_next];
+        std::vector<Vector3> &y = m_y[m_next];
+        s.resize(size);
+        y.resize(size);
+
+        for(size_t i = 0; i < size; i++){
+            s[i] = step * m_direction[i];
+            y[i] = newGradient[i] - m_previousGradient[i];
+        }
+
+        m_rho[m_next] = 1.0 / sy;
+        m_next = (m_next + 1) % m_historySize;
+        m_count = std::min(m_count + 1, m_historySize);
+    }
+
+    return true;
+}
+
+void LbfgsMinimizer::restart()
+{
+    m_count = 0;
+    m_next = 0;
+    m_s.assign(m_historySize, std::vector<Vector3>());
+    m_y.assign(m_historySize, std::vector<Vector3>());
+    m_rho.assign(m_historySize, 0);
+    m_alpha.assign(m_historySize, 0);
+}
+
+} // end chemkit namespace
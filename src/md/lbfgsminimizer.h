@@ -0,0 +1,74 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_LBFGSMINIMIZER_H
+#define CHEMKIT_LBFGSMINIMIZER_H
+
+#include "md.h"
+
+#include "minimizer.h"
+
+namespace chemkit {
+
+class CHEMKIT_MD_EXPORT LbfgsMinimizer : public Minimizer
+{
+public:
+    // construction and destruction
+    LbfgsMinimizer();
+    ~LbfgsMinimizer() CHEMKIT_OVERRIDE;
+
+    // properties
+    void setHistorySize(size_t size);
+    size_t historySize() const;
+
+protected:
+    bool iterate() CHEMKIT_OVERRIDE;
+    void restart() CHEMKIT_OVERRIDE;
+
+private:
+    size_t m_historySize;
+    size_t m_count;
+    size_t m_next;
+    std::vector<std::vector<Vector3> > m_s;
+    std::vector<std::vector<Vector3> > m_y;
+    std::vector<Real> m_rho;
+    std::vector<Real> m_alpha;
+    std::vector<Vector3> m_direction;
+    std::vector<Vector3> m_previousGradient;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_LBFGSMINIMIZER_H
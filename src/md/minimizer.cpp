@@ -0,0 +1,611 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "minimizer.h"
+
+#include <limits>
+#include <algorithm>
+
+#include <boost/math/special_functions/fpclassify.hpp>
+
+#include <chemkit/cartesiancoordinates.h>
+
+#include "potential.h"
+#include "lbfgsminimizer.h"
+#include "steepestdescentminimizer.h"
+#include "conjugategradientminimizer.h"
+
+namespace chemkit {
+
+namespace {
+
+// sufficient decrease constant for the line search
+const Real SufficientDecrease = 1e-4;
+
+// maximum number of energy evaluations in each line search phase
+const size_t MaximumBracketEvaluations = 10;
+const size_t MaximumZoomEvaluations = 10;
+
+// returns the minimum of the cubic interpolating the energies and
+// slopes at lo and hi. falls back to bisection when the cubic has
+// no minimum or it lies too close to the ends of the interval.
+Real interpolate(Real lo, Real hi, Real energyLo, Real energyHi, Real slopeLo, Real slopeHi)
+{
+    Real midpoint = 0.5 * (lo + hi);
+
+    if(!(boost::math::isfinite)(energyHi) || !(boost::math::isfinite)(slopeHi)){
+        return midpoint;
+    }
+
+    Real d1 = slopeLo + slopeHi - 3 * (energyLo - energyHi) / (lo - hi);
+    Real d2squared = d1 * d1 - slopeLo * slopeHi;
+    if(d2squared < 0){
+        return midpoint;
+    }
+
+    Real d2 = hi > lo ? std::sqrt(d2squared) : -std::sqrt(d2squared);
+    Real step = hi - (hi - lo) * (slopeHi + d2 - d1) / (slopeHi - slopeLo + 2 * d2);
+
+    Real margin = 0.1 * std::abs(hi - lo);
+    if(!(boost::math::isfinite)(step) ||
+       step < std::min(lo, hi) + margin ||
+       step > std::max(lo, hi) - margin){
+        return midpoint;
+    }
+
+    return step;
+}
+
+} // end anonymous namespace
+
+// === MinimizerPrivate ==================================================== //
+class MinimizerPrivate
+{
+public:
+    std::string name;
+    size_t maximumIterations;
+    Real energyTolerance;
+    Real gradientTolerance;
+    Real maximumStep;
+    bool initialized;
+    bool stalled;
+    bool stepAccepted;
+    size_t iterationCount;
+    size_t evaluationCount;
+    Real energy;
+    Real energyChange;
+    Real rmsg;
+    std::vector<Vector3> gradient;
+    std::vector<Vector3> trialGradient;
+    std::vector<Vector3> loGradient;
+    std::vector<Point3> initialPositions;
+};
+
+// === Minimizer =========================================================== //
+/// \class Minimizer minimizer.h chemkit/minimizer.h
+/// \ingroup chemkit-md
+/// \brief The Minimizer class is the base class for energy
+///        minimization algorithms.
+///
+/// Each call to integrate() performs a single iteration of the
+/// minimization algorithm. The minimize() method iterates until
+/// the minimization has converged, stalled, or the maximum number
+/// of iterations has been reached.
+///
+/// The minimization is considered converged when either the
+/// root-mean-square gradient falls below gradientTolerance() or
+/// the energy changes by less than energyTolerance() in a single
+/// iteration.
+///
+/// The following minimizers are provided:
+///     - \c steepest-descent (SteepestDescentMinimizer)
+///     - \c conjugate-gradient (ConjugateGradientMinimizer)
+///     - \c lbfgs (LbfgsMinimizer)
+///
+/// \see MoleculeGeometryOptimizer
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new minimizer with \p name.
+Minimizer::Minimizer(const std::string &name)
+    : d(new MinimizerPrivate)
+{
+    d->name = name;
+    d->maximumIterations = 1000;
+    d->energyTolerance = 1e-6;
+    d->gradientTolerance = 0.1;
+    d->maximumStep = 0.3;
+    d->initialized = false;
+    d->stalled = false;
+    d->stepAccepted = false;
+    d->iterationCount = 0;
+    d->evaluationCount = 0;
+    d->energy = 0;
+    d->energyChange = std::numeric_limits<Real>::infinity();
+    d->rmsg = 0;
+}
+
+/// Destroys the minimizer object.
+Minimizer::~Minimizer()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the name of the minimizer.
+std::string Minimizer::name() const
+{
+    return d->name;
+}
+
+/// Sets the maximum number of iterations performed by minimize()
+/// to \p iterations. The default is \c 1000.
+void Minimizer::setMaximumIterations(size_t iterations)
+{
+    d->maximumIterations = iterations;
+}
+
+/// Returns the maximum number of iterations.
+size_t Minimizer::maximumIterations() const
+{
+    return d->maximumIterations;
+}
+
+/// Sets the energy tolerance to \p tolerance. The minimization is
+/// converged when the energy changes by less than \p tolerance in
+/// a single iteration. The default is \c 1e-6.
+void Minimizer::setEnergyTolerance(Real tolerance)
+{
+    d->energyTolerance = tolerance;
+}
+
+/// Returns the energy tolerance.
+Real Minimizer::energyTolerance() const
+{
+    return d->energyTolerance;
+}
+
+/// Sets the gradient tolerance to \p tolerance. The minimization is
+/// converged when the root-mean-square gradient falls below
+/// \p tolerance. The default is \c 0.1.
+void Minimizer::setGradientTolerance(Real tolerance)
+{
+    d->gradientTolerance = tolerance;
+}
+
+/// Returns the gradient tolerance.
+Real Minimizer::gradientTolerance() const
+{
+    return d->gradientTolerance;
+}
+
+/// Sets the maximum distance that any atom is moved in a single
+/// iteration to \p step. The default is \c 0.3 Angstroms.
+void Minimizer::setMaximumStep(Real step)
+{
+    d->maximumStep = step;
+}
+
+/// Returns the maximum step size.
+Real Minimizer::maximumStep() const
+{
+    return d->maximumStep;
+}
+
+// --- Minimization -------------------------------------------------------- //
+/// Resets the minimizer. This clears the iteration and evaluation
+/// counts along with any history kept by the algorithm and then
+/// evaluates the energy and gradient at the current coordinates.
+///
+/// This should be called after the coordinates or the potential
+/// have been changed.
+void Minimizer::reset()
+{
+    d->initialized = false;
+    d->stalled = false;
+    d->iterationCount = 0;
+    d->evaluationCount = 0;
+    d->energyChange = std::numeric_limits<Real>::infinity();
+
+    restart();
+
+    if(!potential() || !coordinates()){
+        return;
+    }
+
+    Real energy = evaluate(d->trialGradient);
+    setCurrentState(energy, d->trialGradient);
+    d->initialized = true;
+}
+
+/// Performs a single iteration of the minimization algorithm.
+void Minimizer::integrate()
+{
+    if(!potential() || !coordinates()){
+        return;
+    }
+
+    if(!d->initialized || d->gradient.size() != potential()->size()){
+        reset();
+    }
+
+    Real initialEnergy = d->energy;
+
+    if(!(boost::math::isfinite)(initialEnergy) || !(boost::math::isfinite)(d->rmsg)){
+        // if the energy or gradient is not finite then most likely
+        // two atoms are on top of each other or three are collinear
+        // so we 'wiggle' each atom by one Angstrom in a random
+        // direction and start over
+        CartesianCoordinates *coordinates = this->coordinates();
+        for(size_t i = 0; i < coordinates->size(); i++){
+            (*coordinates)[i] += Vector3::Random().normalized();
+        }
+
+        restart();
+
+        Real energy = evaluate(d->trialGradient);
+        setCurrentState(energy, d->trialGradient);
+        d->iterationCount++;
+        return;
+    }
+
+    d->stepAccepted = false;
+    d->stalled = !iterate();
+    d->iterationCount++;
+
+    // iterations which restart the algorithm without moving the
+    // atoms do not count towards energy convergence
+    if(d->stepAccepted){
+        d->energyChange = std::abs(d->energy - initialEnergy);
+    }
+    else{
+        d->energyChange = std::numeric_limits<Real>::infinity();
+    }
+}
+
+/// Runs the minimization until it converges, stalls or reaches the
+/// maximum number of iterations. Returns \c true if the
+/// minimization converged.
+bool Minimizer::minimize()
+{
+    reset();
+
+    while(!converged() &&
+          !d->stalled &&
+          d->iterationCount < d->maximumIterations){
+        integrate();
+    }
+
+    return converged();
+}
+
+/// Returns \c true if the minimization has converged.
+bool Minimizer::converged() const
+{
+    if(!d->initialized){
+        return false;
+    }
+
+    return d->rmsg < d->gradientTolerance ||
+           d->energyChange < d->energyTolerance;
+}
+
+/// Returns \c true if the last iteration failed to find a lower
+/// energy along its search direction.
+bool Minimizer::isStalled() const
+{
+    return d->stalled;
+}
+
+/// Returns the number of iterations performed since the last
+/// reset().
+size_t Minimizer::iterationCount() const
+{
+    return d->iterationCount;
+}
+
+/// Returns the number of energy and gradient evaluations performed
+/// since the last reset().
+size_t Minimizer::evaluationCount() const
+{
+    return d->evaluationCount;
+}
+
+/// Returns the energy at the current coordinates.
+Real Minimizer::currentEnergy() const
+{
+    return d->energy;
+}
+
+/// Returns the root-mean-square gradient at the current
+/// coordinates.
+Real Minimizer::currentRmsg() const
+{
+    return d->rmsg;
+}
+
+// --- Static Methods ------------------------------------------------------ //
+/// Creates a new minimizer from \p name. Returns \c 0 if \p name is
+/// not a supported minimizer.
+///
+/// \see minimizers()
+Minimizer* Minimizer::create(const std::string &name)
+{
+    if(name == "lbfgs"){
+        return new LbfgsMinimizer;
+    }
+    else if(name == "conjugate-gradient"){
+        return new ConjugateGradientMinimizer;
+    }
+    else if(name == "steepest-descent"){
+        return new SteepestDescentMinimizer;
+    }
+
+    return 0;
+}
+
+/// Returns a list of the names of the supported minimizers.
+std::vector<std::string> Minimizer::minimizers()
+{
+    std::vector<std::string> names;
+    names.push_back("conjugate-gradient");
+    names.push_back("lbfgs");
+    names.push_back("steepest-descent");
+    return names;
+}
+
+// --- Protected Methods --------------------------------------------------- //
+/// \fn bool Minimizer::iterate()
+///
+/// Performs a single iteration starting from the current
+/// coordinates. Returns \c false if no lower energy could be found.
+
+/// Called when the minimizer is reset or restarted. Minimizers
+/// which keep a history of previous iterations should clear it.
+void Minimizer::restart()
+{
+}
+
+/// Returns the gradient at the current coordinates.
+const std::vector<Vector3>& Minimizer::currentGradient() const
+{
+    return d->gradient;
+}
+
+/// Evaluates the energy and gradient at the current coordinates.
+Real Minimizer::evaluate(std::vector<Vector3> &gradient)
+{
+    d->evaluationCount++;
+
+    return potential()->energyAndGradient(coordinates(), gradient);
+}
+
+/// Searches for a lower energy along \p direction starting with a
+/// step length of \p step. The accepted step satisfies the strong
+/// Wolfe conditions with the curvature constant \p curvature.
+///
+/// On success the coordinates are moved to the new position, the
+/// current energy and gradient are updated, \p step is set to the
+/// accepted step length and \c true is returned. Otherwise the
+/// coordinates are left unchanged and \c false is returned.
+bool Minimizer::lineSearch(const std::vector<Vector3> &direction, Real &step, Real curvature)
+{
+    const CartesianCoordinates *coordinates = this->coordinates();
+    d->initialPositions.resize(coordinates->size());
+    for(size_t i = 0; i < coordinates->size(); i++){
+        d->initialPositions[i] = coordinates->position(i);
+    }
+
+    const Real energy0 = d->energy;
+    const Real slope0 = dot(d->gradient, direction);
+    if(!(slope0 < 0)){
+        return false;
+    }
+
+    const Real maximum = maximumStepLength(direction);
+    step = std::min(step, maximum);
+
+    Real previousStep = 0;
+    Real previousEnergy = energy0;
+    Real previousSlope = slope0;
+    d->loGradient = d->gradient;
+
+    for(size_t i = 0; i < MaximumBracketEvaluations; i++){
+        Real energy = trial(direction, step, d->trialGradient);
+        Real slope = dot(d->trialGradient, direction);
+
+        if(!(boost::math::isfinite)(energy) ||
+           !(boost::math::isfinite)(slope) ||
+           energy > energy0 + SufficientDecrease * step * slope0 ||
+           (i > 0 && energy >= previousEnergy)){
+            return zoom(direction, previousStep, step, previousEnergy, energy,
+                        previousSlope, slope, slope0, curvature, step);
+        }
+
+        if(std::abs(slope) <= -curvature * slope0){
+            setCurrentState(energy, d->trialGradient);
+            return true;
+        }
+
+        if(slope >= 0){
+            d->loGradient.swap(d->trialGradient);
+            return zoom(direction, step, previousStep, energy, previousEnergy,
+                        slope, previousSlope, slope0, curvature, step);
+        }
+
+        previousStep = step;
+        previousEnergy = energy;
+        previousSlope = slope;
+        d->loGradient.swap(d->trialGradient);
+
+        if(step >= maximum){
+            break;
+        }
+
+        step = std::min(2 * step, maximum);
+    }
+
+    // accept the last step as it lowered the energy
+    moveTo(direction, previousStep);
+    step = previousStep;
+    setCurrentState(previousEnergy, d->loGradient);
+    return true;
+}
+
+/// Returns the step length along \p direction which moves the
+/// atom furthest by maximumStep().
+Real Minimizer::maximumStepLength(const std::vector<Vector3> &direction) const
+{
+    Real maximumNorm = 0;
+    for(size_t i = 0; i < direction.size(); i++){
+        maximumNorm = std::max(maximumNorm, direction[i].norm());
+    }
+
+    if(maximumNorm == 0){
+        return 0;
+    }
+
+    return d->maximumStep / maximumNorm;
+}
+
+/// Returns the dot product of \p a and \p b.
+Real Minimizer::dot(const std::vector<Vector3> &a, const std::vector<Vector3> &b)
+{
+    assert(a.size() == b.size());
+
+    Real sum = 0;
+    for(size_t i = 0; i < a.size(); i++){
+        sum += a[i].dot(b[i]);
+    }
+
+    return sum;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+void Minimizer::setCurrentState(Real energy, std::vector<Vector3> &gradient)
+{
+    d->energy = energy;
+    d->gradient.swap(gradient);
+    d->stepAccepted = true;
+
+    Real sum = 0;
+    for(size_t i = 0; i < d->gradient.size(); i++){
+        sum += d->gradient[i].squaredNorm();
+    }
+
+    d->rmsg = d->gradient.empty() ? 0 : std::sqrt(sum / (3.0 * d->gradient.size()));
+}
+
+// Narrows the interval between lo and hi until a step satisfying
+// the strong Wolfe conditions is found. The energy at lo is always
+// the lowest found so far and its gradient is stored in loGradient.
+bool Minimizer::zoom(const std::vector<Vector3> &direction,
+                     Real lo,
+                     Real hi,
+                     Real energyLo,
+                     Real energyHi,
+                     Real slopeLo,
+                     Real slopeHi,
+                     Real slope0,
+                     Real curvature,
+                     Real &step)
+{
+    const Real energy0 = d->energy;
+
+    for(size_t i = 0; i < MaximumZoomEvaluations; i++){
+        Real alpha = interpolate(lo, hi, energyLo, energyHi, slopeLo, slopeHi);
+        Real energy = trial(direction, alpha, d->trialGradient);
+        Real slope = dot(d->trialGradient, direction);
+
+        if(!(boost::math::isfinite)(energy) ||
+           !(boost::math::isfinite)(slope) ||
+           energy > energy0 + SufficientDecrease * alpha * slope0 ||
+           energy >= energyLo){
+            hi = alpha;
+            energyHi = energy;
+            slopeHi = slope;
+        }
+        else{
+            if(std::abs(slope) <= -curvature * slope0){
+                step = alpha;
+                setCurrentState(energy, d->trialGradient);
+                return true;
+            }
+
+            if(slope * (hi - lo) >= 0){
+                hi = lo;
+                energyHi = energyLo;
+                slopeHi = slopeLo;
+            }
+
+            lo = alpha;
+            energyLo = energy;
+            slopeLo = slope;
+            d->loGradient.swap(d->trialGradient);
+        }
+    }
+
+    // fall back to the lowest energy found
+    moveTo(direction, lo);
+
+    if(lo == 0){
+        return false;
+    }
+
+    step = lo;
+    setCurrentState(energyLo, d->loGradient);
+    return true;
+}
+
+// Moves the coordinates to the initial positions plus step times
+// direction.
+void Minimizer::moveTo(const std::vector<Vector3> &direction, Real step)
+{
+    CartesianCoordinates *coordinates = this->coordinates();
+
+    for(size_t i = 0; i < coordinates->size(); i++){
+        (*coordinates)[i] = d->initialPositions[i] + step * direction[i];
+    }
+}
+
+// Moves the coordinates to the initial positions plus step times
+// direction and evaluates the energy and gradient there.
+Real Minimizer::trial(const std::vector<Vector3> &direction, Real step, std::vector<Vector3> &gradient)
+{
+    moveTo(direction, step);
+
+    return evaluate(gradient);
+}
+
+} // end chemkit namespace
@@ -0,0 +1,113 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_MINIMIZER_H
+#define CHEMKIT_MINIMIZER_H
+
+#include "md.h"
+
+#include <string>
+#include <vector>
+
+#include "integrator.h"
+
+namespace chemkit {
+
+class MinimizerPrivate;
+
+class CHEMKIT_MD_EXPORT Minimizer : public Integrator
+{
+public:
+    // construction and destruction
+    virtual ~Minimizer();
+
+    // properties
+    std::string name() const;
+    void setMaximumIterations(size_t iterations);
+    size_t maximumIterations() const;
+    void setEnergyTolerance(Real tolerance);
+    Real energyTolerance() const;
+    void setGradientTolerance(Real tolerance);
+    Real gradientTolerance() const;
+    void setMaximumStep(Real step);
+    Real maximumStep() const;
+
+    // minimization
+    void reset();
+    void integrate() CHEMKIT_OVERRIDE;
+    bool minimize();
+    bool converged() const;
+    bool isStalled() const;
+    size_t iterationCount() const;
+    size_t evaluationCount() const;
+    Real currentEnergy() const;
+    Real currentRmsg() const;
+
+    // static methods
+    static Minimizer* create(const std::string &name);
+    static std::vector<std::string> minimizers();
+
+protected:
+    Minimizer(const std::string &name);
+    virtual bool iterate() = 0;
+    virtual void restart();
+    const std::vector<Vector3>& currentGradient() const;
+    Real evaluate(std::vector<Vector3> &gradient);
+    bool lineSearch(const std::vector<Vector3> &direction, Real &step, Real curvature);
+    Real maximumStepLength(const std::vector<Vector3> &direction) const;
+    static Real dot(const std::vector<Vector3> &a, const std::vector<Vector3> &b);
+
+private:
+    void setCurrentState(Real energy, std::vector<Vector3> &gradient);
+    bool zoom(const std::vector<Vector3> &direction,
+              Real lo,
+              Real hi,
+              Real energyLo,
+              Real energyHi,
+              Real slopeLo,
+              Real slopeHi,
+              Real slope0,
+              Real curvature,
+              Real &step);
+    void moveTo(const std::vector<Vector3> &direction, Real step);
+    Real trial(const std::vector<Vector3> &direction, Real step, std::vector<Vector3> &gradient);
+
+private:
+    MinimizerPrivate* const d;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_MINIMIZER_H
@@ -35,104 +35,16 @@
 
 #include "moleculegeometryoptimizer.h"
 
-#include <boost/make_shared.hpp>
-#include <boost/math/special_functions/fpclassify.hpp>
-
 #include <chemkit/atom.h>
 #include <chemkit/molecule.h>
 #include <chemkit/concurrent.h>
 #include <chemkit/cartesiancoordinates.h>
 
+#include "minimizer.h"
 #include "forcefield.h"
-#include "integrator.h"
 
 namespace chemkit {
 
-namespace {
-
-class SteepestDescentIntegrator : public Integrator
-{
-public:
-    void integrate() CHEMKIT_OVERRIDE;
-};
-
-void SteepestDescentIntegrator::integrate()
-{
-    CartesianCoordinates *coordinates = this->coordinates();
-    boost::shared_ptr<Potential> potential = this->potential();
-
-    if(!potential || !coordinates){
-        return;
-    }
-
-    // optimization parameters
-    Real step = 0.05;
-    Real stepConv = 1e-5;
-    size_t stepCount = 10;
-
-    // calculate initial energy and gradient
-    Real initialEnergy = potential->energy(coordinates);
-    std::vector<Vector3> gradient = potential->gradient(coordinates);
-
-    // perform line search
-    for(size_t i = 0; i < stepCount; i++){
-        // save initial coordinates
-        CartesianCoordinates initialCoordinates = *coordinates;
-
-        // move each atom against its gradient
-        for(size_t atomIndex = 0; atomIndex < potential->size(); atomIndex++){
-            (*coordinates)[atomIndex] += -gradient[atomIndex] * step;
-        }
-
-        // calculate new energy
-        Real finalEnergy = potential->energy(coordinates);
-
-        // if the final energy is NaN then most likely the
-        // simulation exploded so we reset the initial atom
-        // positions and then 'wiggle' each atom by one
-        // Angstrom in a random direction
-        if((boost::math::isnan)(finalEnergy)){
-            for(size_t atomIndex = 0; atomIndex < potential->size(); atomIndex++){
-                Point3 position = initialCoordinates.position(atomIndex);
-                position += Vector3::Random().normalized();
-                coordinates->setPosition(atomIndex, position);
-            }
-
-            // recalculate gradient
-            gradient = potential->gradient(coordinates);
-
-            // continue to next step
-            continue;
-        }
-
-        if(finalEnergy < initialEnergy && std::abs(finalEnergy - initialEnergy) < stepConv){
-            break;
-        }
-        else if(finalEnergy < initialEnergy){
-            // we reduced the energy, so set a bigger step size
-            step *= 2;
-
-            // maximum step size is 1
-            if(step > 1){
-                step = 1;
-            }
-
-            // the initial energy for the next step
-            // is the final energy of this step
-            initialEnergy = finalEnergy;
-        }
-        else if(finalEnergy > initialEnergy){
-            // we went too far, so reset initial atom positions
-            *coordinates = initialCoordinates;
-
-            // and reduce step size
-            step *= 0.1;
-        }
-    }
-}
-
-} // end anonymous namespace
-
 // === MoleculeGeometryOptimizerPrivate ==================================== //
 class MoleculeGeometryOptimizerPrivate
 {
@@ -141,7 +53,11 @@ public:
     boost::shared_ptr<ForceField> forceField;
     std::string forceFieldName;
     std::string errorString;
-    boost::shared_ptr<Integrator> integrator;
+    std::string minimizerName;
+    boost::shared_ptr<Minimizer> minimizer;
+    size_t maximumIterations;
+    Real energyTolerance;
+    Real gradientTolerance;
 };
 
 // === MoleculeGeometryOptimizer =========================================== //
@@ -154,7 +70,8 @@ public:
 /// to simplify the process of setting up a force field and
 /// performing an energy minimization run for a single molecule.
 ///
-/// By default the UFF force field is used.
+/// By default the UFF force field is used along with the L-BFGS
+/// minimizer (see LbfgsMinimizer).
 ///
 /// The easiest way to optimize the geometry for a molecule is to
 /// use the optimizeCoordinate() static method as follows:
@@ -186,7 +103,11 @@ MoleculeGeometryOptimizer::MoleculeGeometryOptimizer(Molecule *molecule)
 {
     d->molecule = molecule;
     d->forceFieldName = "uff";
-    d->integrator = boost::make_shared<SteepestDescentIntegrator>();
+    d->minimizerName = "lbfgs";
+    d->minimizer = boost::shared_ptr<Minimizer>(Minimizer::create(d->minimizerName));
+    d->maximumIterations = d->minimizer->maximumIterations();
+    d->energyTolerance = d->minimizer->energyTolerance();
+    d->gradientTolerance = d->minimizer->gradientTolerance();
 }
 
 /// Destroys the geometry optmizer object.
@@ -228,6 +149,74 @@ std::string MoleculeGeometryOptimizer::forceField() const
     return d->forceFieldName;
 }
 
+/// Sets the minimization algorithm to \p minimizer. Returns \c false
+/// if \p minimizer is not supported. The default is \c lbfgs.
+///
+/// \see Minimizer::minimizers()
+bool MoleculeGeometryOptimizer::setMinimizer(const std::string &minimizer)
+{
+    boost::shared_ptr<Minimizer> instance(Minimizer::create(minimizer));
+    if(!instance){
+        d->errorString = "Minimizer '" + minimizer + "' is not supported.";
+        return false;
+    }
+
+    d->minimizerName = minimizer;
+    d->minimizer = instance;
+
+    return true;
+}
+
+/// Returns the name of the minimization algorithm.
+std::string MoleculeGeometryOptimizer::minimizer() const
+{
+    return d->minimizerName;
+}
+
+/// Sets the maximum number of iterations performed by optimize() to
+/// \p iterations. The default is \c 1000.
+void MoleculeGeometryOptimizer::setMaximumIterations(size_t iterations)
+{
+    d->maximumIterations = iterations;
+    d->minimizer->setMaximumIterations(iterations);
+}
+
+/// Returns the maximum number of iterations.
+size_t MoleculeGeometryOptimizer::maximumIterations() const
+{
+    return d->maximumIterations;
+}
+
+/// Sets the energy tolerance to \p tolerance. The optimization is
+/// converged when the energy changes by less than \p tolerance in
+/// a single step. The default is \c 1e-6.
+void MoleculeGeometryOptimizer::setEnergyTolerance(Real tolerance)
+{
+    d->energyTolerance = tolerance;
+    d->minimizer->setEnergyTolerance(tolerance);
+}
+
+/// Returns the energy tolerance.
+Real MoleculeGeometryOptimizer::energyTolerance() const
+{
+    return d->energyTolerance;
+}
+
+/// Sets the gradient tolerance to \p tolerance. The optimization is
+/// converged when the root-mean-square gradient falls below
+/// \p tolerance. The default is \c 0.1.
+void MoleculeGeometryOptimizer::setGradientTolerance(Real tolerance)
+{
+    d->gradientTolerance = tolerance;
+    d->minimizer->setGradientTolerance(tolerance);
+}
+
+/// Returns the gradient tolerance.
+Real MoleculeGeometryOptimizer::gradientTolerance() const
+{
+    return d->gradientTolerance;
+}
+
 // --- Energy -------------------------------------------------------------- //
 /// Returns the current energy of the force field.
 Real MoleculeGeometryOptimizer::energy() const
@@ -236,7 +225,7 @@ Real MoleculeGeometryOptimizer::energy() const
         return 0;
     }
 
-    return d->integrator->energy();
+    return d->minimizer->currentEnergy();
 }
 
 // --- Optimization -------------------------------------------------------- //
@@ -254,8 +243,11 @@ bool MoleculeGeometryOptimizer::setup()
         return false;
     }
 
-    d->integrator->setPotential(d->forceField);
-    d->integrator->setCoordinates(d->molecule->coordinates());
+    d->minimizer->setPotential(d->forceField);
+    d->minimizer->setCoordinates(d->molecule->coordinates());
+    d->minimizer->setMaximumIterations(d->maximumIterations);
+    d->minimizer->setEnergyTolerance(d->energyTolerance);
+    d->minimizer->setGradientTolerance(d->gradientTolerance);
 
     d->forceField->setTopologyFromMolecule(d->molecule);
     if(!d->forceField->setup()){
@@ -263,51 +255,65 @@ bool MoleculeGeometryOptimizer::setup()
         return false;
     }
 
+    d->minimizer->reset();
+
     return true;
 }
 
-/// Performs a single geometry optimization step. Returns \c true if
-/// converged. The minimization is considered converged when the
-/// root mean square gradient is below the convergance value.
+/// Performs a single iteration of the minimization algorithm.
 void MoleculeGeometryOptimizer::step()
 {
     if(!d->molecule || !d->forceField){
         return;
     }
 
-    // perform a single integration step
-    d->integrator->integrate();
+    // perform a single minimization iteration
+    d->minimizer->integrate();
 }
 
 /// Returns \c true if the optimization algorithm has converged. By
 /// default, the algorithm is considered converged when the
 /// root-mean-square gradient of the force field falls below \c 0.1.
+///
+/// \see setGradientTolerance(), setEnergyTolerance()
 bool MoleculeGeometryOptimizer::converged()
 {
     if(!d->forceField){
         return false;
     }
 
-    // check for convergance
-    return d->integrator->rmsg() < 0.1;
+    return d->minimizer->converged();
 }
 
 /// Optimizes the geometry of the molecule. Returns \c true if the
-/// optimization algorithm converged.
+/// optimization algorithm converged within the maximum number of
+/// iterations.
 bool MoleculeGeometryOptimizer::optimize()
 {
     if(!setup()){
         return false;
     }
 
-    while(!converged()){
-        step();
-    }
+    bool converged = d->minimizer->minimize();
 
     // write the optimized coordinates to the molecule
     writeCoordinates();
 
-    return true;
+    return converged;
+}
+
+/// Returns the number of iterations performed since the last call
+/// to setup().
+size_t MoleculeGeometryOptimizer::iterationCount() const
+{
+    return d->minimizer->iterationCount();
+}
+
+/// Returns the number of energy and gradient evaluations performed
+/// since the last call to setup().
+size_t MoleculeGeometryOptimizer::evaluationCount() const
+{
+    return d->minimizer->evaluationCount();
 }
 
 /// Writes the optimized coordinates to the molecule.
@@ -317,7 +323,7 @@ void MoleculeGeometryOptimizer::writeCoordinates()
         return;
     }
 
-    const CartesianCoordinates *coordinates = d->integrator->coordinates();
+    const CartesianCoordinates *coordinates = d->minimizer->coordinates();
 
     for(size_t i = 0; i < d->molecule->size(); i++){
         d->molecule->atom(i)->setPosition(coordinates->position(i));
@@ -61,6 +61,14 @@ public:
     Molecule* molecule() const;
     bool setForceField(const std::string &forceField);
     std::string forceField() const;
+    bool setMinimizer(const std::string &minimizer);
+    std::string minimizer() const;
+    void setMaximumIterations(size_t iterations);
+    size_t maximumIterations() const;
+    void setEnergyTolerance(Real tolerance);
+    Real energyTolerance() const;
+    void setGradientTolerance(Real tolerance);
+    Real gradientTolerance() const;
 
     // energy
     Real energy() const;
@@ -71,6 +79,8 @@ public:
     bool converged();
     bool optimize();
     void writeCoordinates();
+    size_t iterationCount() const;
+    size_t evaluationCount() const;
 
     // error handling
     std::string errorString() const;
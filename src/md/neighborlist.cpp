@@ -0,0 +1,351 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "neighborlist.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <chemkit/foreach.h>
+#include <chemkit/cartesiancoordinates.h>
+
+#include "topology.h"
+
+namespace chemkit {
+
+// === NeighborListPrivate ================================================= //
+class NeighborListPrivate
+{
+public:
+    Real cutoff;
+    Real skin;
+    std::vector<NeighborList::Pair> pairs;
+    std::vector<std::vector<size_t> > exclusions;
+    std::vector<Point3> positions;
+    bool valid;
+};
+
+// === NeighborList ======================================================== //
+/// \class NeighborList neighborlist.h chemkit/neighborlist.h
+/// \ingroup chemkit-md
+/// \brief The NeighborList class contains the atom pairs within a
+///        cutoff distance of each other.
+///
+/// The neighbor list is a Verlet list which contains each pair of
+/// atoms closer than cutoff() + skin(). The list is built using a
+/// grid of cells with sides at least as long as the list distance
+/// which makes rebuilding the list linear in the number of atoms.
+///
+/// Calling update() only rebuilds the list when at least one atom
+/// has moved more than half of the skin distance since the last
+/// rebuild. Until then every pair of atoms closer than cutoff() is
+/// guaranteed to be in the list.
+///
+/// Pairs of atoms with an exclusion between them are never added
+/// to the list.
+///
+/// \see ForceField::setNonbondedCutoff()
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new neighbor list with \p cutoff and \p skin.
+NeighborList::NeighborList(Real cutoff, Real skin)
+    : d(new NeighborListPrivate)
+{
+    d->cutoff = cutoff;
+    d->skin = skin;
+    d->valid = false;
+}
+
+/// Destroys the neighbor list.
+NeighborList::~NeighborList()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Sets the cutoff distance to \p cutoff.
+void NeighborList::setCutoff(Real cutoff)
+{
+    d->cutoff = cutoff;
+    d->valid = false;
+}
+
+/// Returns the cutoff distance. The default is \c 10 Angstroms.
+Real NeighborList::cutoff() const
+{
+    return d->cutoff;
+}
+
+/// Sets the skin distance to \p skin.
+void NeighborList::setSkin(Real skin)
+{
+    d->skin = skin;
+    d->valid = false;
+}
+
+/// Returns the skin distance. The default is \c 2 Angstroms.
+Real NeighborList::skin() const
+{
+    return d->skin;
+}
+
+/// Returns the number of pairs in the neighbor list.
+size_t NeighborList::size() const
+{
+    return d->pairs.size();
+}
+
+/// Returns \c true if the neighbor list contains no pairs.
+bool NeighborList::isEmpty() const
+{
+    return d->pairs.empty();
+}
+
+// --- Exclusions ---------------------------------------------------------- //
+/// Adds an exclusion between atoms \p i and \p j.
+void NeighborList::addExclusion(size_t i, size_t j)
+{
+    if(i > j){
+        std::swap(i, j);
+    }
+
+    if(i >= d->exclusions.size()){
+        d->exclusions.resize(i + 1);
+    }
+
+    std::vector<size_t> &exclusions = d->exclusions[i];
+    std::vector<size_t>::iterator iter = std::lower_bound(exclusions.begin(), exclusions.end(), j);
+    if(iter == exclusions.end() || *iter != j){
+        exclusions.insert(iter, j);
+    }
+
+    d->valid = false;
+}
+
+/// Adds each of the exclusions from \p topology.
+void NeighborList::addExclusions(const Topology *topology)
+{
+    foreach(const Topology::Exclusion &exclusion, topology->exclusions()){
+        addExclusion(exclusion[0], exclusion[1]);
+    }
+}
+
+/// Returns \c true if there is an exclusion between atoms \p i and
+/// \p j.
+bool NeighborList::isExcluded(size_t i, size_t j) const
+{
+    if(i > j){
+        std::swap(i, j);
+    }
+
+    if(i >= d->exclusions.size()){
+        return false;
+    }
+
+    const std::vector<size_t> &exclusions = d->exclusions[i];
+
+    return std::binary_search(exclusions.begin(), exclusions.end(), j);
+}
+
+/// Removes all of the exclusions.
+void NeighborList::clearExclusions()
+{
+    d->exclusions.clear();
+    d->valid = false;
+}
+
+// --- Pairs --------------------------------------------------------------- //
+/// Returns a range containing each pair in the neighbor list. The
+/// first atom index in each pair is less than the second.
+NeighborList::PairRange NeighborList::pairs() const
+{
+    return boost::make_iterator_range(d->pairs.begin(), d->pairs.end());
+}
+
+/// Rebuilds the neighbor list for \p coordinates if needed. Returns
+/// \c true if the list was rebuilt.
+///
+/// \see needsRebuild()
+bool NeighborList::update(const CartesianCoordinates *coordinates)
+{
+    if(!needsRebuild(coordinates)){
+        return false;
+    }
+
+    rebuild(coordinates);
+
+    return true;
+}
+
+/// Rebuilds the neighbor list for \p coordinates.
+void NeighborList::rebuild(const CartesianCoordinates *coordinates)
+{
+    d->pairs.clear();
+    d->positions.resize(coordinates->size());
+    d->valid = true;
+
+    size_t size = coordinates->size();
+    if(size == 0){
+        return;
+    }
+
+    for(size_t i = 0; i < size; i++){
+        d->positions[i] = (*coordinates)[i];
+    }
+
+    // find the bounds of the coordinates
+    Point3 minimum = d->positions[0];
+    Point3 maximum = d->positions[0];
+    for(size_t i = 1; i < size; i++){
+        minimum = minimum.cwiseMin(d->positions[i]);
+        maximum = maximum.cwiseMax(d->positions[i]);
+    }
+
+    Real listDistance = d->cutoff + d->skin;
+    Real listDistanceSquared = listDistance * listDistance;
+    Vector3 extent = maximum - minimum;
+
+    // the cells must be at least as large as the list distance, they
+    // are enlarged for very sparse systems to bound the cell count
+    Real cellSize = std::max(listDistance, Real(1e-3));
+    size_t maximumCellCount = std::max(size_t(8) * size, size_t(27));
+    size_t dimensions[3];
+
+    for(;;){
+        for(int i = 0; i < 3; i++){
+            dimensions[i] = static_cast<size_t>(std::floor(extent[i] / cellSize)) + 1;
+        }
+
+        if(Real(dimensions[0]) * Real(dimensions[1]) * Real(dimensions[2]) <= Real(maximumCellCount)){
+            break;
+        }
+
+        cellSize *= 2;
+    }
+
+    size_t cellCount = dimensions[0] * dimensions[1] * dimensions[2];
+
+    // sort the atoms by cell
+    std::vector<size_t> atomCells(size);
+    std::vector<size_t> cellStart(cellCount + 1, 0);
+
+    for(size_t i = 0; i < size; i++){
+        const Point3 &position = d->positions[i];
+
+        size_t x = std::min(static_cast<size_t>((position.x() - minimum.x()) / cellSize), dimensions[0] - 1);
+        size_t y = std::min(static_cast<size_t>((position.y() - minimum.y()) / cellSize), dimensions[1] - 1);
+        size_t z = std::min(static_cast<size_t>((position.z() - minimum.z()) / cellSize), dimensions[2] - 1);
+
+        size_t cell = (z * dimensions[1] + y) * dimensions[0] + x;
+        atomCells[i] = cell;
+        cellStart[cell + 1]++;
+    }
+
+    for(size_t i = 0; i < cellCount; i++){
+        cellStart[i + 1] += cellStart[i];
+    }
+
+    std::vector<size_t> cellAtoms(size);
+    std::vector<size_t> cellOffset(cellStart.begin(), cellStart.end() - 1);
+    for(size_t i = 0; i < size; i++){
+        cellAtoms[cellOffset[atomCells[i]]++] = i;
+    }
+
+    // find the pairs in each cell and its neighboring cells
+    for(size_t i = 0; i < size; i++){
+        const Point3 &position = d->positions[i];
+
+        size_t cell = atomCells[i];
+        size_t x = cell % dimensions[0];
+        size_t y = (cell / dimensions[0]) % dimensions[1];
+        size_t z = cell / (dimensions[0] * dimensions[1]);
+
+        for(size_t nz = (z > 0 ? z - 1 : 0); nz <= std::min(z + 1, dimensions[2] - 1); nz++){
+            for(size_t ny = (y > 0 ? y - 1 : 0); ny <= std::min(y + 1, dimensions[1] - 1); ny++){
+                for(size_t nx = (x > 0 ? x - 1 : 0); nx <= std::min(x + 1, dimensions[0] - 1); nx++){
+                    size_t neighborCell = (nz * dimensions[1] + ny) * dimensions[0] + nx;
+
+                    for(size_t k = cellStart[neighborCell]; k < cellStart[neighborCell + 1]; k++){
+                        size_t j = cellAtoms[k];
+
+                        if(j <= i){
+                            continue;
+                        }
+                        else if((d->positions[j] - position).squaredNorm() > listDistanceSquared){
+                            continue;
+                        }
+                        else if(isExcluded(i, j)){
+                            continue;
+                        }
+
+                        Pair pair;
+                        pair[0] = i;
+                        pair[1] = j;
+                        d->pairs.push_back(pair);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// Returns \c true if the neighbor list must be rebuilt for
+/// \p coordinates. This is the case when an atom has moved more
+/// than half of the skin distance since the last rebuild.
+bool NeighborList::needsRebuild(const CartesianCoordinates *coordinates) const
+{
+    if(!d->valid || coordinates->size() != d->positions.size()){
+        return true;
+    }
+
+    Real maximumDistanceSquared = (d->skin / 2) * (d->skin / 2);
+
+    for(size_t i = 0; i < coordinates->size(); i++){
+        if(((*coordinates)[i] - d->positions[i]).squaredNorm() > maximumDistanceSquared){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Forces the neighbor list to be rebuilt on the next call to
+/// update().
+void NeighborList::invalidate()
+{
+    d->valid = false;
+}
+
+} // end chemkit namespace
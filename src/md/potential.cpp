@@ -141,6 +141,25 @@ std::vector<Vector3> Potential::numericalGradient(const CartesianCoordinates *co
     return gradient;
 }
 
+/// Returns the potential energy of the system and writes the
+/// gradient of the energy with respect to \p coordinates to
+/// \p gradient. Any previous contents of \p gradient are replaced.
+///
+/// Calculating both values together is faster than calling energy()
+/// and gradient() separately because the geometry of each term only
+/// needs to be computed once and \p gradient can be reused between
+/// calls without reallocating. The default implementation calls
+/// energy() and gradient().
+///
+/// \see energy(), gradient()
+Real Potential::energyAndGradient(const CartesianCoordinates *coordinates,
+                                  std::vector<Vector3> &gradient) const
+{
+    gradient = this->gradient(coordinates);
+
+    return energy(coordinates);
+}
+
 /// Returns the root-mean-square gradient.
 Real Potential::rmsg(const CartesianCoordinates *coordinates) const
 {
@@ -64,6 +64,7 @@ public:
     boost::shared_future<Real> energyAsync(const CartesianCoordinates *coordinates) const;
     virtual std::vector<Vector3> gradient(const CartesianCoordinates *coordinates) const;
     std::vector<Vector3> numericalGradient(const CartesianCoordinates *coordinates) const;
+    virtual Real energyAndGradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const;
     Real rmsg(const CartesianCoordinates *coordinates) const;
 };
 
@@ -0,0 +1,104 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "steepestdescentminimizer.h"
+
+namespace chemkit {
+
+// === SteepestDescentMinimizer ============================================ //
+/// \class SteepestDescentMinimizer steepestdescentminimizer.h chemkit/steepestdescentminimizer.h
+/// \ingroup chemkit-md
+/// \brief The SteepestDescentMinimizer class implements the
+///        steepest descent minimization algorithm.
+///
+/// Each iteration performs a line search along the negative
+/// gradient. Steepest descent is robust far from a minimum but
+/// converges slowly near one. LbfgsMinimizer is usually a better
+/// choice.
+///
+/// \see Minimizer
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new steepest descent minimizer.
+SteepestDescentMinimizer::SteepestDescentMinimizer()
+    : Minimizer("steepest-descent")
+{
+    restart();
+}
+
+/// Destroys the steepest descent minimizer object.
+SteepestDescentMinimizer::~SteepestDescentMinimizer()
+{
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+bool SteepestDescentMinimizer::iterate()
+{
+    const std::vector<Vector3> &gradient = currentGradient();
+
+    m_direction.resize(gradient.size());
+    for(size_t i = 0; i < gradient.size(); i++){
+        m_direction[i] = -gradient[i];
+    }
+
+    Real slope = dot(gradient, m_direction);
+
+    // start from the step that gave the same first-order energy
+    // change in the last iteration
+    Real step;
+    if(m_step > 0){
+        step = m_step * m_slope / slope;
+    }
+    else{
+        step = 0.2 * maximumStepLength(m_direction);
+    }
+
+    if(!lineSearch(m_direction, step, 0.9)){
+        return false;
+    }
+
+    m_step = step;
+    m_slope = slope;
+
+    return true;
+}
+
+void SteepestDescentMinimizer::restart()
+{
+    m_step = 0;
+    m_slope = 0;
+}
+
+} // end chemkit namespace
@@ -35,9 +35,11 @@
 
 #include "topology.h"
 
-#include <boost/range/algorithm.hpp>
+#include <algorithm>
 
-#include <chemkit/foreach.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 namespace chemkit {
 
@@ -46,7 +48,9 @@ class TopologyPrivate
 {
 public:
     size_t size;
-    std::vector<std::string> types;
+    std::vector<int> types;
+    std::vector<std::string> typeNames;
+    boost::unordered_map<std::string, int> typeIds;
     std::vector<Real> masses;
     std::vector<Real> charges;
     std::vector<Real> radii;
@@ -55,16 +59,69 @@ public:
     std::vector<Topology::TorsionInteraction> torsionInteractions;
     std::vector<Topology::ImproperTorsionInteraction> improperTorsionInteractions;
     std::vector<Topology::NonbondedInteraction> nonbondedInteractions;
+    std::vector<Topology::Exclusion> exclusions;
     std::vector<int> bondedInteractionTypes;
     std::vector<int> angleInteractionTypes;
     std::vector<int> torsionInteractionTypes;
+    boost::unordered_map<Topology::BondedInteraction, size_t> bondedInteractionIndices;
+    boost::unordered_map<Topology::AngleInteraction, size_t> angleInteractionIndices;
+    boost::unordered_map<Topology::TorsionInteraction, size_t> torsionInteractionIndices;
+    boost::unordered_set<Topology::NonbondedInteraction> oneFourPairs;
+    boost::unordered_set<Topology::Exclusion> exclusionSet;
+
+    static Topology::BondedInteraction bondedKey(size_t i, size_t j);
+    static Topology::AngleInteraction angleKey(size_t i, size_t j, size_t k);
+    static Topology::TorsionInteraction torsionKey(size_t i, size_t j, size_t k, size_t l);
 };
 
+// The interaction indices are keyed on a canonical ordering of the
+// atoms so that an interaction can be found in either direction.
+Topology::BondedInteraction TopologyPrivate::bondedKey(size_t i, size_t j)
+{
+    Topology::BondedInteraction key;
+    key[0] = std::min(i, j);
+    key[1] = std::max(i, j);
+    return key;
+}
+
+Topology::AngleInteraction TopologyPrivate::angleKey(size_t i, size_t j, size_t k)
+{
+    Topology::AngleInteraction key;
+    key[0] = std::min(i, k);
+    key[1] = j;
+    key[2] = std::max(i, k);
+    return key;
+}
+
+Topology::TorsionInteraction TopologyPrivate::torsionKey(size_t i, size_t j, size_t k, size_t l)
+{
+    Topology::TorsionInteraction key;
+    if(i < l || (i == l && j < k)){
+        key[0] = i;
+        key[1] = j;
+        key[2] = k;
+        key[3] = l;
+    }
+    else{
+        key[0] = l;
+        key[1] = k;
+        key[2] = j;
+        key[3] = i;
+    }
+    return key;
+}
+
 // === Topology ============================================================ //
 /// \class Topology topology.h chemkit/topology.h
 /// \ingroup chemkit-md
 /// \brief The Topology class represents a molecular dynamics topology.
 ///
+/// Atom types are stored as integer ids into a table of type names
+/// owned by the topology. Each name is stored once no matter how many
+/// atoms have that type. Force fields can use the ids returned from
+/// typeId() to look up their parameters once per type instead of
+/// once per atom or interaction.
+///
 /// \see Trajectory, TopologyFile
 
 // --- Construction and Destruction ---------------------------------------- //
@@ -94,7 +151,7 @@ void Topology::resize(size_t size)
 {
     d->size = size;
 
-    d->types.resize(size);
+    d->types.resize(size, -1);
     d->masses.resize(size);
     d->charges.resize(size);
     d->radii.resize(size);
@@ -115,14 +172,33 @@ bool Topology::isEmpty() const
 // --- Atom Properties ----------------------------------------------------- //
 /// Sets the type for the atom at \p index to \p type.
 void Topology::setType(size_t index, const std::string &type)
+{
+    setTypeId(index, addType(type));
+}
+
+/// Returns the type for the atom at \p index. Returns an empty string
+/// if the atom's type has not been set.
+std::string Topology::type(size_t index) const
 {
     assert(index < d->types.size());
 
-    d->types[index] = type;
+    return typeName(d->types[index]);
 }
 
-/// Returns the type for the atom at \p index.
-std::string Topology::type(size_t index) const
+/// Sets the type for the atom at \p index to the type with \p id.
+///
+/// \see addType()
+void Topology::setTypeId(size_t index, int id)
+{
+    assert(index < d->types.size());
+    assert(id >= -1 && id < static_cast<int>(d->typeNames.size()));
+
+    d->types[index] = id;
+}
+
+/// Returns the id of the type for the atom at \p index. Returns
+/// \c -1 if the atom's type has not been set.
+int Topology::typeId(size_t index) const
 {
     assert(index < d->types.size());
 
@@ -161,12 +237,74 @@ Real Topology::charge(size_t index)
     return d->charges[index];
 }
 
+// --- Types --------------------------------------------------------------- //
+/// Adds a type with \p name to the type table and returns its id. If
+/// the type is already in the table its existing id is returned.
+int Topology::addType(const std::string &name)
+{
+    boost::unordered_map<std::string, int>::const_iterator iter = d->typeIds.find(name);
+    if(iter != d->typeIds.end()){
+        return iter->second;
+    }
+
+    int id = static_cast<int>(d->typeNames.size());
+    d->typeNames.push_back(name);
+    d->typeIds[name] = id;
+
+    return id;
+}
+
+/// Returns the name of the type with \p id. Returns an empty string
+/// if \p id is not in the type table.
+std::string Topology::typeName(int id) const
+{
+    if(id < 0 || static_cast<size_t>(id) >= d->typeNames.size()){
+        return std::string();
+    }
+
+    return d->typeNames[id];
+}
+
+/// Returns the number of types in the type table.
+size_t Topology::typeCount() const
+{
+    return d->typeNames.size();
+}
+
+/// Returns the numeric value of the type of each atom. This is
+/// useful for force fields whose types are numbers (e.g. MMFF). Each
+/// type name is converted once. Atoms without a type or with a type
+/// name which is not a number are given \c 0.
+std::vector<int> Topology::typeNumbers() const
+{
+    std::vector<int> typeNumbers(d->typeNames.size(), 0);
+    for(size_t type = 0; type < d->typeNames.size(); type++){
+        try{
+            typeNumbers[type] = boost::lexical_cast<int>(d->typeNames[type]);
+        }
+        catch(boost::bad_lexical_cast &){
+            typeNumbers[type] = 0;
+        }
+    }
+
+    std::vector<int> numbers(d->size, 0);
+    for(size_t i = 0; i < d->size; i++){
+        if(d->types[i] != -1){
+            numbers[i] = typeNumbers[d->types[i]];
+        }
+    }
+
+    return numbers;
+}
+
 // --- Interactions -------------------------------------------------------- //
 void Topology::addBondedInteraction(size_t i, size_t j)
 {
     BondedInteraction interaction;
     interaction[0] = i;
     interaction[1] = j;
+    d->bondedInteractionIndices.insert(std::make_pair(d->bondedKey(i, j),
+                                                      d->bondedInteractions.size()));
     d->bondedInteractions.push_back(interaction);
     d->bondedInteractionTypes.push_back(0);
 }
@@ -184,28 +322,21 @@ size_t Topology::bondedInteractionCount() const
 
 void Topology::setBondedInteractionType(size_t i, size_t j, int type)
 {
-    BondedInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
+    boost::unordered_map<BondedInteraction, size_t>::const_iterator iter =
+        d->bondedInteractionIndices.find(d->bondedKey(i, j));
 
-    BondedInteractionRange::const_iterator iter =
-        boost::find(d->bondedInteractions, interaction);
-
-    if(iter != d->bondedInteractions.end()){
-        size_t index = iter - d->bondedInteractions.begin();
-
-        d->bondedInteractionTypes[index] = type;
+    if(iter != d->bondedInteractionIndices.end()){
+        d->bondedInteractionTypes[iter->second] = type;
     }
 }
 
 int Topology::bondedInteractionType(size_t i, size_t j) const
 {
-    for(size_t index = 0; index < d->bondedInteractions.size(); index++){
-        const BondedInteraction &interaction = d->bondedInteractions[index];
-        if((interaction[0] == i && interaction[1] == j) ||
-           (interaction[1] == i && interaction[0] == j)){
-            return d->bondedInteractionTypes[index];
-        }
+    boost::unordered_map<BondedInteraction, size_t>::const_iterator iter =
+        d->bondedInteractionIndices.find(d->bondedKey(i, j));
+
+    if(iter != d->bondedInteractionIndices.end()){
+        return d->bondedInteractionTypes[iter->second];
     }
 
     return 0;
@@ -217,6 +348,8 @@ void Topology::addAngleInteraction(size_t i, size_t j, size_t k)
     interaction[0] = i;
     interaction[1] = j;
     interaction[2] = k;
+    d->angleInteractionIndices.insert(std::make_pair(d->angleKey(i, j, k),
+                                                     d->angleInteractions.size()));
     d->angleInteractions.push_back(interaction);
     d->angleInteractionTypes.push_back(0);
 }
@@ -234,42 +367,21 @@ size_t Topology::angleInteractionCount() const
 
 void Topology::setAngleInteractionType(size_t i, size_t j, size_t k, int type)
 {
-    AngleInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-    interaction[2] = k;
-
-    AngleInteractionRange::const_iterator iter =
-        boost::find(d->angleInteractions, interaction);
-
-    if(iter != d->angleInteractions.end()){
-        size_t index = iter - d->angleInteractions.begin();
+    boost::unordered_map<AngleInteraction, size_t>::const_iterator iter =
+        d->angleInteractionIndices.find(d->angleKey(i, j, k));
 
-        d->angleInteractionTypes[index] = type;
+    if(iter != d->angleInteractionIndices.end()){
+        d->angleInteractionTypes[iter->second] = type;
     }
 }
 
 int Topology::angleInteractionType(size_t i, size_t j, size_t k) const
 {
-    AngleInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-    interaction[2] = k;
-
-    AngleInteractionRange::const_iterator iter =
-        boost::find(d->angleInteractions, interaction);
-
-    if(iter == d->angleInteractions.end()){
-        interaction[0] = k;
-        interaction[2] = i;
-
-        iter = boost::find(d->angleInteractions, interaction);
-    }
-
-    if(iter != d->angleInteractions.end()){
-        size_t index = iter - d->angleInteractions.begin();
+    boost::unordered_map<AngleInteraction, size_t>::const_iterator iter =
+        d->angleInteractionIndices.find(d->angleKey(i, j, k));
 
-        return d->angleInteractionTypes[index];
+    if(iter != d->angleInteractionIndices.end()){
+        return d->angleInteractionTypes[iter->second];
     }
 
     return 0;
@@ -282,8 +394,13 @@ void Topology::addTorsionInteraction(size_t i, size_t j, size_t k, size_t l)
     interaction[1] = j;
     interaction[2] = k;
     interaction[3] = l;
+    d->torsionInteractionIndices.insert(std::make_pair(d->torsionKey(i, j, k, l),
+                                                       d->torsionInteractions.size()));
     d->torsionInteractions.push_back(interaction);
     d->torsionInteractionTypes.push_back(0);
+
+    // the first and last atoms of the torsion are one-four
+    d->oneFourPairs.insert(d->bondedKey(i, l));
 }
 
 Topology::TorsionInteractionRange Topology::torsionInteractions() const
@@ -299,46 +416,21 @@ size_t Topology::torsionInteractionCount() const
 
 void Topology::setTorsionInteractionType(size_t i, size_t j, size_t k, size_t l, int type)
 {
-    TorsionInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-    interaction[2] = k;
-    interaction[3] = l;
+    boost::unordered_map<TorsionInteraction, size_t>::const_iterator iter =
+        d->torsionInteractionIndices.find(d->torsionKey(i, j, k, l));
 
-    TorsionInteractionRange::const_iterator iter =
-        boost::find(d->torsionInteractions, interaction);
-
-    if(iter != d->torsionInteractions.end()){
-        size_t index = iter - d->torsionInteractions.begin();
-
-        d->torsionInteractionTypes[index] = type;
+    if(iter != d->torsionInteractionIndices.end()){
+        d->torsionInteractionTypes[iter->second] = type;
     }
 }
 
 int Topology::torsionInteractionType(size_t i, size_t j, size_t k, size_t l) const
 {
-    TorsionInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-    interaction[2] = k;
-    interaction[3] = l;
+    boost::unordered_map<TorsionInteraction, size_t>::const_iterator iter =
+        d->torsionInteractionIndices.find(d->torsionKey(i, j, k, l));
 
-    TorsionInteractionRange::const_iterator iter =
-        boost::find(d->torsionInteractions, interaction);
-
-    if(iter == d->torsionInteractions.end()){
-        interaction[0] = l;
-        interaction[1] = k;
-        interaction[2] = j;
-        interaction[3] = i;
-
-        iter = boost::find(d->torsionInteractions, interaction);
-    }
-
-    if(iter != d->torsionInteractions.end()){
-        size_t index = iter - d->torsionInteractions.begin();
-
-        return d->torsionInteractionTypes[index];
+    if(iter != d->torsionInteractionIndices.end()){
+        return d->torsionInteractionTypes[iter->second];
     }
 
     return 0;
@@ -385,16 +477,43 @@ size_t Topology::nonbondedInteractionCount() const
 }
 
 /// Returns \c true if atoms \p i and \p j are in a one-four configuration.
-bool Topology::isOneFour(size_t i, size_t j)
+bool Topology::isOneFour(size_t i, size_t j) const
 {
-    foreach(const TorsionInteraction &torsion, d->torsionInteractions){
-        if((torsion[0] == i && torsion[3] == j) ||
-           (torsion[0] == j && torsion[3] == i)){
-            return true;
-        }
+    return d->oneFourPairs.count(d->bondedKey(i, j)) != 0;
+}
+
+// --- Exclusions ---------------------------------------------------------- //
+/// Adds an exclusion between atoms \p i and \p j. Excluded atom
+/// pairs do not have nonbonded interactions when the nonbonded
+/// calculations are created from a NeighborList.
+///
+/// \see ForceField::setNonbondedCutoff()
+void Topology::addExclusion(size_t i, size_t j)
+{
+    Exclusion exclusion = d->bondedKey(i, j);
+    if(d->exclusionSet.insert(exclusion).second){
+        d->exclusions.push_back(exclusion);
     }
+}
+
+/// Returns a range containing each exclusion in the topology.
+Topology::ExclusionRange Topology::exclusions() const
+{
+    return boost::make_iterator_range(d->exclusions.begin(),
+                                      d->exclusions.end());
+}
+
+/// Returns the number of exclusions in the topology.
+size_t Topology::exclusionCount() const
+{
+    return d->exclusions.size();
+}
 
-    return false;
+/// Returns \c true if there is an exclusion between atoms \p i
+/// and \p j.
+bool Topology::isExcluded(size_t i, size_t j) const
+{
+    return d->exclusionSet.count(d->bondedKey(i, j)) != 0;
 }
 
 } // end chemkit namespace
@@ -59,11 +59,13 @@ public:
     typedef boost::array<size_t, 4> TorsionInteraction;
     typedef boost::array<size_t, 4> ImproperTorsionInteraction;
     typedef boost::array<size_t, 2> NonbondedInteraction;
+    typedef boost::array<size_t, 2> Exclusion;
     typedef boost::iterator_range<std::vector<BondedInteraction>::const_iterator> BondedInteractionRange;
     typedef boost::iterator_range<std::vector<AngleInteraction>::const_iterator> AngleInteractionRange;
     typedef boost::iterator_range<std::vector<TorsionInteraction>::const_iterator> TorsionInteractionRange;
     typedef boost::iterator_range<std::vector<ImproperTorsionInteraction>::const_iterator> ImproperTorsionInteractionRange;
     typedef boost::iterator_range<std::vector<NonbondedInteraction>::const_iterator> NonbondedInteractionRange;
+    typedef boost::iterator_range<std::vector<Exclusion>::const_iterator> ExclusionRange;
 
     // construction and destruction
     Topology();
@@ -78,11 +80,19 @@ public:
     // atom properties
     void setType(size_t index, const std::string &type);
     std::string type(size_t index) const;
+    void setTypeId(size_t index, int id);
+    int typeId(size_t index) const;
     void setMass(size_t index, Real mass);
     Real mass(size_t index);
     void setCharge(size_t index, Real charge);
     Real charge(size_t index);
 
+    // types
+    int addType(const std::string &name);
+    std::string typeName(int id) const;
+    size_t typeCount() const;
+    std::vector<int> typeNumbers() const;
+
     // interations
     void addBondedInteraction(size_t i, size_t j);
     BondedInteractionRange bondedInteractions() const;
@@ -105,7 +115,13 @@ public:
     void addNonbondedInteraction(size_t i, size_t j);
     NonbondedInteractionRange nonbondedInteractions() const;
     size_t nonbondedInteractionCount() const;
-    bool isOneFour(size_t i, size_t j);
+    bool isOneFour(size_t i, size_t j) const;
+
+    // exclusions
+    void addExclusion(size_t i, size_t j);
+    ExclusionRange exclusions() const;
+    size_t exclusionCount() const;
+    bool isExcluded(size_t i, size_t j) const;
 
 private:
     TopologyPrivate* const d;
@@ -35,6 +35,8 @@
 
 #include "topologybuilder.h"
 
+#include <set>
+
 #include <boost/make_shared.hpp>
 
 #include <chemkit/atom.h>
@@ -48,30 +50,13 @@
 
 namespace chemkit {
 
-namespace {
-
-bool atomsWithinTwoBonds(const Atom *a, const Atom *b)
-{
-    foreach(const Atom *neighbor, a->neighbors()){
-        if(neighbor == b){
-            return true;
-        }
-        else if(neighbor->isBondedTo(b)){
-            return true;
-        }
-    }
-
-    return false;
-}
-
-} // end anonymous namespace
-
 // === TopologyBuilderPrivate ============================================== //
 class TopologyBuilderPrivate
 {
 public:
     std::string atomTyper;
     std::string partialChargeModel;
+    bool explicitNonbondedInteractions;
     boost::shared_ptr<Topology> topology;
 };
 
@@ -105,6 +90,7 @@ public:
 TopologyBuilder::TopologyBuilder()
     : d(new TopologyBuilderPrivate)
 {
+    d->explicitNonbondedInteractions = true;
     d->topology = boost::make_shared<Topology>();
 }
 
@@ -143,6 +129,26 @@ bool TopologyBuilder::setPartialChargeModel(const std::string &model)
     return true;
 }
 
+/// Sets whether or not a nonbonded interaction is added to the
+/// topology for every pair of atoms separated by more than two
+/// bonds. The default is \c true.
+///
+/// Storing every nonbonded pair requires memory quadratic in the
+/// number of atoms. When the nonbonded calculations are created
+/// from a NeighborList (see ForceField::setNonbondedCutoff()) only
+/// the exclusions are needed and this can be set to \c false.
+void TopologyBuilder::setExplicitNonbondedInteractions(bool enabled)
+{
+    d->explicitNonbondedInteractions = enabled;
+}
+
+/// Returns \c true if nonbonded interactions are added to the
+/// topology.
+bool TopologyBuilder::explicitNonbondedInteractions() const
+{
+    return d->explicitNonbondedInteractions;
+}
+
 // --- Topology ------------------------------------------------------------ //
 /// Adds \p molecule to the topology.
 void TopologyBuilder::addMolecule(const Molecule *molecule)
@@ -170,14 +176,31 @@ void TopologyBuilder::addMolecule(const Molecule *molecule)
     if(atomTyper){
         atomTyper->setMolecule(molecule);
 
+        // map from the typer's type ids to the topology's type ids. each
+        // type name is only added to the topology once
+        std::vector<int> typeIds;
+
         foreach(const Atom *atom, molecule->atoms()){
-            topology->setType(initialSize + atom->index(), atomTyper->type(atom));
+            int id = atomTyper->typeId(atom);
+            if(id < 0){
+                continue;
+            }
+
+            if(static_cast<size_t>(id) >= typeIds.size()){
+                typeIds.resize(id + 1, -1);
+            }
+            if(typeIds[id] == -1){
+                typeIds[id] = topology->addType(atomTyper->typeName(id));
+            }
+
+            topology->setTypeId(initialSize + atom->index(), typeIds[id]);
         }
     }
 
     // set atom masses
-    foreach(const Atom *atom, molecule->atoms()){
-        topology->setMass(initialSize + atom->index(), atom->mass());
+    std::vector<Real> masses = molecule->masses();
+    for(size_t i = 0; i < masses.size(); i++){
+        topology->setMass(initialSize + i, masses[i]);
     }
 
     // set atom charges
@@ -189,8 +212,9 @@ void TopologyBuilder::addMolecule(const Molecule *molecule)
         }
     }
     else{
-        foreach(const Atom *atom, molecule->atoms()){
-            topology->setCharge(initialSize + atom->index(), atom->partialCharge());
+        std::vector<Real> charges = molecule->partialCharges();
+        for(size_t i = 0; i < charges.size(); i++){
+            topology->setCharge(initialSize + i, charges[i]);
         }
     }
 
@@ -202,8 +226,8 @@ void TopologyBuilder::addMolecule(const Molecule *molecule)
         if(atomTyper){
             int type = atomTyper->bondedInteractionType(bond->atom1(), bond->atom2());
             if(type != 0){
-                topology->setBondedInteractionType(bond->atom1()->index(),
-                                                   bond->atom2()->index(),
+                topology->setBondedInteractionType(initialSize + bond->atom1()->index(),
+                                                   initialSize + bond->atom2()->index(),
                                                    type);
             }
         }
@@ -287,13 +311,39 @@ void TopologyBuilder::addMolecule(const Molecule *molecule)
         }
     }
 
+    // add exclusions for atoms within two bonds
+    foreach(const Atom *atom, molecule->atoms()){
+        std::set<size_t> excludedAtoms;
+
+        foreach(const Atom *neighbor, atom->neighbors()){
+            excludedAtoms.insert(neighbor->index());
+
+            foreach(const Atom *secondNeighbor, neighbor->neighbors()){
+                excludedAtoms.insert(secondNeighbor->index());
+            }
+        }
+
+        foreach(size_t index, excludedAtoms){
+            if(atom->index() < index){
+                topology->addExclusion(initialSize + atom->index(),
+                                       initialSize + index);
+            }
+        }
+    }
+
     // add nonbonded interactions
+    if(!d->explicitNonbondedInteractions){
+        return;
+    }
+
     std::vector<const Atom *> atoms(molecule->atoms().begin(), molecule->atoms().end());
     for(size_t i = 0; i < atoms.size(); i++){
         for(size_t j = i + 1; j < atoms.size(); j++){
-            if(!atomsWithinTwoBonds(atoms[i], atoms[j])){
-                topology->addNonbondedInteraction(initialSize + atoms[i]->index(),
-                                                  initialSize + atoms[j]->index());
+            size_t a = initialSize + atoms[i]->index();
+            size_t b = initialSize + atoms[j]->index();
+
+            if(!topology->isExcluded(a, b)){
+                topology->addNonbondedInteraction(a, b);
             }
         }
     }
@@ -68,6 +68,8 @@ public:
     bool isEmpty() const;
     bool setAtomTyper(const std::string &atomTyper);
     bool setPartialChargeModel(const std::string &model);
+    void setExplicitNonbondedInteractions(bool enabled);
+    bool explicitNonbondedInteractions() const;
 
     // topology
     void addMolecule(const Molecule *molecule);
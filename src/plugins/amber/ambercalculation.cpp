@@ -36,6 +36,7 @@
 #include "ambercalculation.h"
 
 #include "amberparameters.h"
+#include "amberforcefield.h"
 
 #include <chemkit/topology.h>
 #include <chemkit/constants.h>
@@ -55,18 +56,22 @@ AmberBondCalculation::AmberBondCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool AmberBondCalculation::setup(const AmberParameters *parameters)
+bool AmberBondCalculation::setup(const AmberForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    std::string typeA = atomType(0);
-    std::string typeB = atomType(1);
+    const AmberParameters *amberParameters = forceField->parameters();
 
-    const AmberBondParameters *bondParameters = parameters->bondParameters(typeA, typeB);
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
+
+    std::string typeA = topology->type(atoms[0]);
+    std::string typeB = topology->type(atoms[1]);
+
+    const AmberBondParameters *bondParameters = amberParameters->bondParameters(typeA, typeB);
     if(!bondParameters){
         return false;
     }
 
-    setParameter(0, bondParameters->kb);
-    setParameter(1, bondParameters->r0);
+    parameters[0] = bondParameters->kb;
+    parameters[1] = bondParameters->r0;
 
     return true;
 }
@@ -113,19 +118,23 @@ AmberAngleCalculation::AmberAngleCalculation(size_t a, size_t b, size_t c)
     setAtom(2, c);
 }
 
-bool AmberAngleCalculation::setup(const AmberParameters *parameters)
+bool AmberAngleCalculation::setup(const AmberForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    std::string typeA = atomType(0);
-    std::string typeB = atomType(1);
-    std::string typeC = atomType(2);
+    const AmberParameters *amberParameters = forceField->parameters();
+
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
 
-    const AmberAngleParameters *angleParameters = parameters->angleParameters(typeA, typeB, typeC);
+    std::string typeA = topology->type(atoms[0]);
+    std::string typeB = topology->type(atoms[1]);
+    std::string typeC = topology->type(atoms[2]);
+
+    const AmberAngleParameters *angleParameters = amberParameters->angleParameters(typeA, typeB, typeC);
     if(!angleParameters){
         return false;
     }
 
-    setParameter(0, angleParameters->ka);
-    setParameter(1, angleParameters->theta0);
+    parameters[0] = angleParameters->ka;
+    parameters[1] = angleParameters->theta0;
 
     return true;
 }
@@ -176,29 +185,33 @@ AmberTorsionCalculation::AmberTorsionCalculation(size_t a, size_t b, size_t c, s
     setAtom(3, d);
 }
 
-bool AmberTorsionCalculation::setup(const AmberParameters *parameters)
+bool AmberTorsionCalculation::setup(const AmberForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    std::string typeA = atomType(0);
-    std::string typeB = atomType(1);
-    std::string typeC = atomType(2);
-    std::string typeD = atomType(3);
-
-    const AmberTorsionParameters *torsionParameters = parameters->torsionParameters(typeA,
-                                                                                    typeB,
-                                                                                    typeC,
-                                                                                    typeD);
+    const AmberParameters *amberParameters = forceField->parameters();
+
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
+
+    std::string typeA = topology->type(atoms[0]);
+    std::string typeB = topology->type(atoms[1]);
+    std::string typeC = topology->type(atoms[2]);
+    std::string typeD = topology->type(atoms[3]);
+
+    const AmberTorsionParameters *torsionParameters = amberParameters->torsionParameters(typeA,
+                                                                                         typeB,
+                                                                                         typeC,
+                                                                                         typeD);
     if(!torsionParameters){
         return false;
     }
 
-    setParameter(0, torsionParameters->V1);
-    setParameter(1, torsionParameters->V2);
-    setParameter(2, torsionParameters->V3);
-    setParameter(3, torsionParameters->V4);
-    setParameter(4, torsionParameters->gamma1);
-    setParameter(5, torsionParameters->gamma2);
-    setParameter(6, torsionParameters->gamma3);
-    setParameter(7, torsionParameters->gamma4);
+    parameters[0] = torsionParameters->V1;
+    parameters[1] = torsionParameters->V2;
+    parameters[2] = torsionParameters->V3;
+    parameters[3] = torsionParameters->V4;
+    parameters[4] = torsionParameters->gamma1;
+    parameters[5] = torsionParameters->gamma2;
+    parameters[6] = torsionParameters->gamma3;
+    parameters[7] = torsionParameters->gamma4;
 
     return true;
 }
@@ -268,19 +281,23 @@ std::vector<chemkit::Vector3> AmberTorsionCalculation::gradient(const chemkit::C
 
 // === AmberNonbondedCalculation =========================================== //
 AmberNonbondedCalculation::AmberNonbondedCalculation(size_t a, size_t b)
-    : AmberCalculation(VanDerWaals | Electrostatic, 2, 2)
+    : AmberCalculation(VanDerWaals | Electrostatic, 2, 4)
 {
     setAtom(0, a);
     setAtom(1, b);
 }
 
-bool AmberNonbondedCalculation::setup(const AmberParameters *parameters)
+bool AmberNonbondedCalculation::setup(const AmberForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    std::string typeA = atomType(0);
-    std::string typeB = atomType(1);
+    const AmberParameters *amberParameters = forceField->parameters();
+
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
+
+    std::string typeA = topology->type(atoms[0]);
+    std::string typeB = topology->type(atoms[1]);
 
-    const struct AmberNonbondedParameters *parametersA = parameters->nonbondedParameters(typeA);
-    const struct AmberNonbondedParameters *parametersB = parameters->nonbondedParameters(typeB);
+    const struct AmberNonbondedParameters *parametersA = amberParameters->nonbondedParameters(typeA);
+    const struct AmberNonbondedParameters *parametersB = amberParameters->nonbondedParameters(typeB);
     if(!parametersA || !parametersB){
         return false;
     }
@@ -288,8 +305,10 @@ bool AmberNonbondedCalculation::setup(const AmberParameters *parameters)
     chemkit::Real epsilon = parametersA->wellDepth + parametersB->wellDepth;
     chemkit::Real sigma = parametersA->vanDerWaalsRadius + parametersB->vanDerWaalsRadius;
 
-    setParameter(0, epsilon);
-    setParameter(1, sigma);
+    parameters[0] = epsilon;
+    parameters[1] = sigma;
+    parameters[2] = topology->charge(atoms[0]);
+    parameters[3] = topology->charge(atoms[1]);
 
     return true;
 }
@@ -301,8 +320,8 @@ chemkit::Real AmberNonbondedCalculation::energy(const chemkit::CartesianCoordina
 
     chemkit::Real epsilon = parameter(0);
     chemkit::Real sigma = parameter(1);
-    chemkit::Real qa = topology()->charge(a);
-    chemkit::Real qb = topology()->charge(b);
+    chemkit::Real qa = parameter(2);
+    chemkit::Real qb = parameter(3);
     chemkit::Real r = coordinates->distance(a, b);
     chemkit::Real e0 = 1;
 
@@ -319,8 +338,8 @@ std::vector<chemkit::Vector3> AmberNonbondedCalculation::gradient(const chemkit:
 
     chemkit::Real epsilon = parameter(0);
     chemkit::Real sigma = parameter(1);
-    chemkit::Real qa = topology()->charge(a);
-    chemkit::Real qb = topology()->charge(b);
+    chemkit::Real qa = parameter(2);
+    chemkit::Real qb = parameter(3);
     chemkit::Real e0 = 1;
     chemkit::Real pi = chemkit::constants::Pi;
 
@@ -38,13 +38,10 @@
 
 #include <chemkit/forcefieldcalculation.h>
 
-class AmberParameters;
+class AmberForceField;
 
 class AmberCalculation : public chemkit::ForceFieldCalculation
 {
-public:
-    virtual bool setup(const AmberParameters *parameters) = 0;
-
 protected:
     AmberCalculation(int type, int atomCount, int parameterCount);
 };
@@ -54,7 +51,7 @@ class AmberBondCalculation : public AmberCalculation
 public:
     AmberBondCalculation(size_t a, size_t b);
 
-    bool setup(const AmberParameters *parameters);
+    static bool setup(const AmberForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -64,7 +61,7 @@ class AmberAngleCalculation : public AmberCalculation
 public:
     AmberAngleCalculation(size_t a, size_t b, size_t c);
 
-    bool setup(const AmberParameters *parameters);
+    static bool setup(const AmberForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -74,7 +71,7 @@ class AmberTorsionCalculation : public AmberCalculation
 public:
     AmberTorsionCalculation(size_t a, size_t b, size_t c, size_t d);
 
-    bool setup(const AmberParameters *parameters);
+    static bool setup(const AmberForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -84,7 +81,7 @@ class AmberNonbondedCalculation : public AmberCalculation
 public:
     AmberNonbondedCalculation(size_t a, size_t b);
 
-    bool setup(const AmberParameters *parameters);
+    static bool setup(const AmberForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -38,12 +38,14 @@
 
 #include "amberforcefield.h"
 
+#include "amberkernel.h"
 #include "amberatomtyper.h"
 #include "amberparameters.h"
 #include "ambercalculation.h"
 
 #include <chemkit/foreach.h>
 #include <chemkit/topology.h>
+#include <chemkit/forcefieldcalculationbatch.h>
 
 // --- Construction and Destruction ---------------------------------------- //
 AmberForceField::AmberForceField()
@@ -67,39 +69,87 @@ bool AmberForceField::setup()
         return false;
     }
 
+    bool ok = true;
+
+    // bond calculations
+    chemkit::ForceFieldKernelBatch<AmberBondKernel> *bondBatch =
+        new chemkit::ForceFieldKernelBatch<AmberBondKernel>(chemkit::ForceFieldCalculation::BondStrech);
+    bondBatch->reserve(topology->bondedInteractionCount());
+
     foreach(const chemkit::Topology::BondedInteraction &interaction, topology->bondedInteractions()){
-        addCalculation(new AmberBondCalculation(interaction[0],
-                                                interaction[1]));
+        chemkit::Real parameters[AmberBondKernel::ParameterCount] = { 0 };
+        bool setup = AmberBondCalculation::setup(this, interaction.data(), parameters);
+        bondBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(bondBatch);
+
+    // angle calculations
+    chemkit::ForceFieldKernelBatch<AmberAngleKernel> *angleBatch =
+        new chemkit::ForceFieldKernelBatch<AmberAngleKernel>(chemkit::ForceFieldCalculation::AngleBend);
+    angleBatch->reserve(topology->angleInteractionCount());
+
     foreach(const chemkit::Topology::AngleInteraction &interaction, topology->angleInteractions()){
-        addCalculation(new AmberAngleCalculation(interaction[0],
-                                                 interaction[1],
-                                                 interaction[2]));
+        chemkit::Real parameters[AmberAngleKernel::ParameterCount] = { 0 };
+        bool setup = AmberAngleCalculation::setup(this, interaction.data(), parameters);
+        angleBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(angleBatch);
+
+    // torsion calculations
+    chemkit::ForceFieldKernelBatch<AmberTorsionKernel> *torsionBatch =
+        new chemkit::ForceFieldKernelBatch<AmberTorsionKernel>(chemkit::ForceFieldCalculation::Torsion);
+    torsionBatch->reserve(topology->torsionInteractionCount());
+
     foreach(const chemkit::Topology::TorsionInteraction &interaction, topology->torsionInteractions()){
-        addCalculation(new AmberTorsionCalculation(interaction[0],
-                                                   interaction[1],
-                                                   interaction[2],
-                                                   interaction[3]));
+        chemkit::Real parameters[AmberTorsionKernel::ParameterCount] = { 0 };
+        bool setup = AmberTorsionCalculation::setup(this, interaction.data(), parameters);
+        torsionBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
-    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
-        addCalculation(new AmberNonbondedCalculation(interaction[0],
-                                                     interaction[1]));
-    }
+    addCalculationBatch(torsionBatch);
 
-    bool ok = true;
+    // nonbonded calculations
+    m_nonbondedParameters.clear();
+
+    if(nonbondedCutoff() > 0){
+        // look up the parameters for each type once
+        std::vector<const AmberNonbondedParameters *> typeParameters(topology->typeCount());
+        for(size_t type = 0; type < topology->typeCount(); type++){
+            typeParameters[type] = m_parameters->nonbondedParameters(topology->typeName(type));
+        }
+
+        // atom parameters for the nonbonded calculations
+        for(size_t i = 0; i < topology->size(); i++){
+            int type = topology->typeId(i);
 
-    foreach(chemkit::ForceFieldCalculation *calculation, calculations()){
-        bool setup = static_cast<AmberCalculation *>(calculation)->setup(m_parameters);
+            const AmberNonbondedParameters *parameters = type != -1 ? typeParameters[type] : 0;
+            if(!parameters){
+                ok = false;
+            }
 
-        if(!setup){
-            ok = false;
+            m_nonbondedParameters.push_back(parameters);
+        }
+
+        addNonbondedCalculationBatch(new chemkit::ForceFieldKernelBatch<AmberNonbondedKernel>(chemkit::ForceFieldCalculation::VanDerWaals | chemkit::ForceFieldCalculation::Electrostatic));
+    }
+    else{
+        chemkit::ForceFieldKernelBatch<AmberNonbondedKernel> *nonbondedBatch =
+            new chemkit::ForceFieldKernelBatch<AmberNonbondedKernel>(chemkit::ForceFieldCalculation::VanDerWaals | chemkit::ForceFieldCalculation::Electrostatic);
+        nonbondedBatch->reserve(topology->nonbondedInteractionCount());
+
+        foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+            chemkit::Real parameters[AmberNonbondedKernel::ParameterCount] = { 0 };
+            bool setup = AmberNonbondedCalculation::setup(this, interaction.data(), parameters);
+            nonbondedBatch->addCalculation(interaction.data(), parameters, setup);
+            ok = ok && setup;
         }
 
-        setCalculationSetup(calculation, setup);
+        addCalculationBatch(nonbondedBatch);
     }
 
     return ok;
@@ -109,3 +159,41 @@ const AmberParameters* AmberForceField::parameters() const
 {
     return m_parameters;
 }
+
+chemkit::ForceFieldCalculation* AmberForceField::createCalculation(int type, const size_t *atoms) const
+{
+    switch(type){
+        case chemkit::ForceFieldCalculation::BondStrech:
+            return new AmberBondCalculation(atoms[0], atoms[1]);
+        case chemkit::ForceFieldCalculation::AngleBend:
+            return new AmberAngleCalculation(atoms[0], atoms[1], atoms[2]);
+        case chemkit::ForceFieldCalculation::Torsion:
+            return new AmberTorsionCalculation(atoms[0], atoms[1], atoms[2], atoms[3]);
+        case chemkit::ForceFieldCalculation::VanDerWaals | chemkit::ForceFieldCalculation::Electrostatic:
+            return new AmberNonbondedCalculation(atoms[0], atoms[1]);
+        default:
+            return 0;
+    }
+}
+
+bool AmberForceField::nonbondedParameters(int type, size_t a, size_t b, bool oneFour, chemkit::Real *parameters) const
+{
+    CHEMKIT_UNUSED(oneFour);
+
+    if(type != (chemkit::ForceFieldCalculation::VanDerWaals | chemkit::ForceFieldCalculation::Electrostatic)){
+        return false;
+    }
+
+    const AmberNonbondedParameters *parametersA = m_nonbondedParameters[a];
+    const AmberNonbondedParameters *parametersB = m_nonbondedParameters[b];
+    if(!parametersA || !parametersB){
+        return false;
+    }
+
+    parameters[0] = parametersA->wellDepth + parametersB->wellDepth;
+    parameters[1] = parametersA->vanDerWaalsRadius + parametersB->vanDerWaalsRadius;
+    parameters[2] = topology()->charge(a);
+    parameters[3] = topology()->charge(b);
+
+    return true;
+}
@@ -36,9 +36,12 @@
 #ifndef AMBERFORCEFIELD_H
 #define AMBERFORCEFIELD_H
 
+#include <vector>
+
 #include <chemkit/forcefield.h>
 
 class AmberParameters;
+struct AmberNonbondedParameters;
 
 class AmberForceField : public chemkit::ForceField
 {
@@ -51,8 +54,13 @@ public:
     virtual bool setup();
     const AmberParameters* parameters() const;
 
+protected:
+    virtual chemkit::ForceFieldCalculation* createCalculation(int type, const size_t *atoms) const;
+    virtual bool nonbondedParameters(int type, size_t a, size_t b, bool oneFour, chemkit::Real *parameters) const;
+
 private:
     AmberParameters *m_parameters;
+    std::vector<const AmberNonbondedParameters *> m_nonbondedParameters;
 };
 
 #endif // AMBERFORCEFIELD_H
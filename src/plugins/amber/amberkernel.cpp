@@ -0,0 +1,213 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "amberkernel.h"
+
+#include <chemkit/geometry.h>
+#include <chemkit/constants.h>
+#include <chemkit/cartesiancoordinates.h>
+
+// === AmberBondKernel ===================================================== //
+chemkit::Real AmberBondKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+    chemkit::Real dr = r - r0;
+
+    return kb * (dr*dr);
+}
+
+chemkit::Real AmberBondKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+
+    // dE/dr
+    chemkit::Real de_dr = 2.0 * kb * (r - r0);
+
+    boost::array<chemkit::Vector3, 2> dr = chemkit::geometry::distanceGradient(a, b);
+
+    gradient[atoms[0]] += dr[0] * de_dr;
+    gradient[atoms[1]] += dr[1] * de_dr;
+
+    return kb * ((r - r0) * (r - r0));
+}
+
+// === AmberAngleKernel ==================================================== //
+chemkit::Real AmberAngleKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
+    chemkit::Real theta = chemkit::geometry::angle((*coordinates)[atoms[0]],
+                                                   (*coordinates)[atoms[1]],
+                                                   (*coordinates)[atoms[2]]);
+    chemkit::Real dt = theta - theta0;
+
+    return ka * (dt*dt);
+}
+
+chemkit::Real AmberAngleKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
+    chemkit::Real theta = chemkit::geometry::angle(a, b, c);
+
+    // dE/dtheta
+    chemkit::Real de_dtheta = 2.0 * ka * (theta - theta0);
+
+    boost::array<chemkit::Vector3, 3> dtheta = chemkit::geometry::angleGradient(a, b, c);
+
+    gradient[atoms[0]] += dtheta[0] * de_dtheta;
+    gradient[atoms[1]] += dtheta[1] * de_dtheta;
+    gradient[atoms[2]] += dtheta[2] * de_dtheta;
+
+    return ka * ((theta - theta0) * (theta - theta0));
+}
+
+// === AmberTorsionKernel ================================================== //
+chemkit::Real AmberTorsionKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
+    chemkit::Real V4 = parameters[3];
+    chemkit::Real gamma1 = parameters[4];
+    chemkit::Real gamma2 = parameters[5];
+    chemkit::Real gamma3 = parameters[6];
+    chemkit::Real gamma4 = parameters[7];
+
+    chemkit::Real angle = chemkit::geometry::torsionAngle((*coordinates)[atoms[0]],
+                                                          (*coordinates)[atoms[1]],
+                                                          (*coordinates)[atoms[2]],
+                                                          (*coordinates)[atoms[3]]);
+
+    chemkit::Real energy = 0;
+    energy += V1 * (1.0 + cos((1.0 * angle - gamma1) * chemkit::constants::DegreesToRadians));
+    energy += V2 * (1.0 + cos((2.0 * angle - gamma2) * chemkit::constants::DegreesToRadians));
+    energy += V3 * (1.0 + cos((3.0 * angle - gamma3) * chemkit::constants::DegreesToRadians));
+    energy += V4 * (1.0 + cos((4.0 * angle - gamma4) * chemkit::constants::DegreesToRadians));
+
+    return energy;
+}
+
+chemkit::Real AmberTorsionKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+    const chemkit::Point3 &d = (*coordinates)[atoms[3]];
+
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
+    chemkit::Real V4 = parameters[3];
+    chemkit::Real gamma1 = parameters[4];
+    chemkit::Real gamma2 = parameters[5];
+    chemkit::Real gamma3 = parameters[6];
+    chemkit::Real gamma4 = parameters[7];
+
+    chemkit::Real phi = chemkit::geometry::torsionAngle(a, b, c, d);
+
+    // dE/dphi
+    chemkit::Real de_dphi = 0;
+    de_dphi += V1 * (-sin((1.0 * phi - gamma1) * chemkit::constants::DegreesToRadians) * 1.0);
+    de_dphi += V2 * (-sin((2.0 * phi - gamma2) * chemkit::constants::DegreesToRadians) * 2.0);
+    de_dphi += V3 * (-sin((3.0 * phi - gamma3) * chemkit::constants::DegreesToRadians) * 3.0);
+    de_dphi += V4 * (-sin((4.0 * phi - gamma4) * chemkit::constants::DegreesToRadians) * 4.0);
+    de_dphi *= chemkit::constants::DegreesToRadians;
+
+    boost::array<chemkit::Vector3, 4> dphi = chemkit::geometry::torsionAngleGradient(a, b, c, d);
+
+    gradient[atoms[0]] += dphi[0] * de_dphi;
+    gradient[atoms[1]] += dphi[1] * de_dphi;
+    gradient[atoms[2]] += dphi[2] * de_dphi;
+    gradient[atoms[3]] += dphi[3] * de_dphi;
+
+    return V1 * (1.0 + cos((1.0 * phi - gamma1) * chemkit::constants::DegreesToRadians)) +
+           V2 * (1.0 + cos((2.0 * phi - gamma2) * chemkit::constants::DegreesToRadians)) +
+           V3 * (1.0 + cos((3.0 * phi - gamma3) * chemkit::constants::DegreesToRadians)) +
+           V4 * (1.0 + cos((4.0 * phi - gamma4) * chemkit::constants::DegreesToRadians));
+}
+
+// === AmberNonbondedKernel ================================================ //
+chemkit::Real AmberNonbondedKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real epsilon = parameters[0];
+    chemkit::Real sigma = parameters[1];
+    chemkit::Real qa = parameters[2];
+    chemkit::Real qb = parameters[3];
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+    chemkit::Real e0 = 1;
+
+    chemkit::Real vanDerWaalsTerm = epsilon * (pow(sigma/r, 12) - 2 * pow(sigma/r, 6));
+    chemkit::Real electrostaticTerm = (qa * qb) / (4.0 * chemkit::constants::Pi * e0 * r);
+
+    return vanDerWaalsTerm + electrostaticTerm;
+}
+
+chemkit::Real AmberNonbondedKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real epsilon = parameters[0];
+    chemkit::Real sigma = parameters[1];
+    chemkit::Real qa = parameters[2];
+    chemkit::Real qb = parameters[3];
+    chemkit::Real e0 = 1;
+    chemkit::Real pi = chemkit::constants::Pi;
+
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+    chemkit::Real sr = sigma / r;
+
+    // dE/dr
+    chemkit::Real de_dr = (-12 * epsilon * sigma / pow(r, 2) * (pow(sr, 11) - pow(sr, 5))) - ((qa * qb) / (4.0 * pi * e0 * pow(r, 2)));
+
+    boost::array<chemkit::Vector3, 2> dr = chemkit::geometry::distanceGradient(a, b);
+
+    gradient[atoms[0]] += dr[0] * de_dr;
+    gradient[atoms[1]] += dr[1] * de_dr;
+
+    return epsilon * (pow(sr, 12) - 2 * pow(sr, 6)) + (qa * qb) / (4.0 * pi * e0 * r);
+}
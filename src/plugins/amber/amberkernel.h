@@ -0,0 +1,84 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef AMBERKERNEL_H
+#define AMBERKERNEL_H
+
+#include <vector>
+
+#include <chemkit/vector3.h>
+
+namespace chemkit {
+class CartesianCoordinates;
+}
+
+// The kernels evaluate a single calculation from the atoms and
+// parameters stored in a chemkit::ForceFieldKernelBatch. Their
+// parameters are laid out identically to the corresponding
+// AmberCalculation classes.
+
+struct AmberBondKernel
+{
+    enum { AtomCount = 2, ParameterCount = 2 };
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient);
+};
+
+struct AmberAngleKernel
+{
+    enum { AtomCount = 3, ParameterCount = 2 };
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient);
+};
+
+struct AmberTorsionKernel
+{
+    enum { AtomCount = 4, ParameterCount = 8 };
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient);
+};
+
+struct AmberNonbondedKernel
+{
+    enum { AtomCount = 2, ParameterCount = 4 };
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient);
+};
+
+#endif // AMBERKERNEL_H
@@ -40,6 +40,7 @@
 #include <chemkit/bond.h>
 #include <chemkit/ring.h>
 #include <chemkit/foreach.h>
+#include <chemkit/graphsnapshot.h>
 
 // The FP2 fingerprint implementation is adapted from code provided
 // by Chris Morley.
@@ -53,67 +54,110 @@ Fp2Fingerprint::~Fp2Fingerprint()
 {
 }
 
+// The FragmentGraph struct contains the bonding graph of the molecule
+// along with the atom and bond properties used to build fragments.
+struct Fp2Fingerprint::FragmentGraph
+{
+    boost::shared_ptr<const chemkit::GraphSnapshot> snapshot;
+    std::vector<unsigned char> atomicNumbers;
+    std::vector<bool> terminalHydrogens;
+    std::vector<chemkit::Bond::BondOrderType> bondOrders;
+};
+
 // Returns the FP2 fingerprint value for the molecule.
 chemkit::Bitset Fp2Fingerprint::value(const chemkit::Molecule *molecule) const
 {
-    // create bitset
-    chemkit::Bitset fingerprint(1021);
+    return packedValue(molecule).toBitset();
+}
+
+// Returns the FP2 fingerprint value for the molecule as a packed
+// fingerprint.
+chemkit::PackedFingerprint Fp2Fingerprint::packedValue(const chemkit::Molecule *molecule) const
+{
+    // create fingerprint
+    chemkit::PackedFingerprint fingerprint(1021);
+
+    // gather the graph and the atom and bond properties
+    FragmentGraph graph;
+    graph.snapshot = molecule->graphSnapshot();
+    graph.atomicNumbers.reserve(molecule->atomCount());
+    graph.terminalHydrogens.reserve(molecule->atomCount());
+    graph.bondOrders.reserve(molecule->bondCount());
 
     foreach(const chemkit::Atom *atom, molecule->atoms()){
+        graph.atomicNumbers.push_back(atom->atomicNumber());
+        graph.terminalHydrogens.push_back(atom->isTerminalHydrogen());
+    }
+
+    foreach(const chemkit::Bond *bond, molecule->bonds()){
+        graph.bondOrders.push_back(bond->isAromatic() ? 5 : bond->order());
+    }
+
+    Fragment fragment;
+    std::vector<bool> visited(molecule->atomCount());
+
+    for(size_t i = 0; i < molecule->atomCount(); i++){
         // skip fragments starting at terminal hydrogens
-        if(atom->isTerminalHydrogen()){
+        if(graph.terminalHydrogens[i]){
             continue;
         }
 
         // add each atom fragment to the fingerprint
-        addFragments(atom, fingerprint);
+        extendFragment(fragment,
+                       1,
+                       visited,
+                       i,
+                       chemkit::GraphSnapshot::NullIndex,
+                       i,
+                       graph,
+                       fingerprint);
     }
 
     return fingerprint;
 }
 
-// Add all fragments starting at atom to the fingerprint.
-void Fp2Fingerprint::addFragments(const chemkit::Atom *atom,
-                                  chemkit::Bitset &fingerprint) const
-{
-    Fragment fragment;
-    chemkit::Bitset visited(atom->molecule()->atomCount());
-    extendFragment(fragment, 1, visited, atom, 0, atom, fingerprint);
-}
-
-// Extend the fragment to atom.
-void Fp2Fingerprint::extendFragment(Fragment fragment,
+// Extend the fragment to atom. The fragment and visited atoms are
+// restored to their previous state before returning.
+void Fp2Fingerprint::extendFragment(Fragment &fragment,
                                     size_t depth,
-                                    chemkit::Bitset visited,
-                                    const chemkit::Atom *atom,
-                                    const chemkit::Bond *bond,
-                                    const chemkit::Atom *firstAtom,
-                                    chemkit::Bitset &fingerprint) const
+                                    std::vector<bool> &visited,
+                                    size_t atom,
+                                    size_t bond,
+                                    size_t firstAtom,
+                                    const FragmentGraph &graph,
+                                    chemkit::PackedFingerprint &fingerprint) const
 {
     const size_t MaxFragmentSize = 7;
 
+    const chemkit::GraphSnapshot &snapshot = *graph.snapshot;
+
     chemkit::Bond::BondOrderType bondOrder = 0;
-    if(bond){
-        bondOrder = bond->isAromatic() ? 5 : bond->order();
+    if(bond != chemkit::GraphSnapshot::NullIndex){
+        bondOrder = graph.bondOrders[bond];
     }
 
+    // save the state of the fragment so it can be restored
+    size_t fragmentSize = fragment.size();
+    unsigned char firstBondOrder = fragmentSize ? fragment[0] : 0;
+
     fragment.push_back(bondOrder);
-    fragment.push_back(atom->atomicNumber());
-    visited.set(atom->index());
+    fragment.push_back(graph.atomicNumbers[atom]);
+    visited[atom] = true;
 
-    foreach(const chemkit::Bond *neighborBond, atom->bonds()){
+    for(size_t position = snapshot.offsets()[atom]; position < snapshot.offsets()[atom + 1]; position++){
+        size_t neighborBond = snapshot.bondIndices()[position];
         if(neighborBond == bond){
             continue; // don't retrace steps
         }
 
-        const chemkit::Atom *neighbor = neighborBond->otherAtom(atom);
-        if(neighbor->isTerminalHydrogen()){
+        size_t neighbor = snapshot.neighborIndices()[position];
+        if(graph.terminalHydrogens[neighbor]){
             continue; // don't include terminal hydrogens
         }
 
         // if the neighbor is an atom that we've already visited
         // then this fragment forms a ring
-        if(visited.test(neighbor->index())){
+        if(visited[neighbor]){
             if(neighbor == firstAtom){
                 // add bond at front for the ring
                 fragment[0] = bondOrder;
@@ -154,6 +198,7 @@ void Fp2Fingerprint::extendFragment(Fragment fragment,
                                neighbor,
                                neighborBond,
                                firstAtom,
+                               graph,
                                fingerprint);
             }
         }
@@ -163,6 +208,13 @@ void Fp2Fingerprint::extendFragment(Fragment fragment,
     if(fragment[0] == 0 && (depth > 1 || fragment[1] > 8 || fragment[1] < 6)){
         fingerprint.set(canonicalHash(fragment));
     }
+
+    // restore the fragment and visited atoms
+    fragment.resize(fragmentSize);
+    if(fragmentSize){
+        fragment[0] = firstBondOrder;
+    }
+    visited[atom] = false;
 }
 
 // Returns the canonical hash value for the fragment.
@@ -48,19 +48,20 @@ public:
     ~Fp2Fingerprint();
 
     chemkit::Bitset value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::PackedFingerprint packedValue(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
 
 private:
     typedef std::vector<unsigned char> Fragment;
+    struct FragmentGraph;
 
-    void addFragments(const chemkit::Atom *atom,
-                      chemkit::Bitset &fingerprint) const;
-    void extendFragment(Fragment fragment,
+    void extendFragment(Fragment &fragment,
                         size_t depth,
-                        chemkit::Bitset visited,
-                        const chemkit::Atom *atom,
-                        const chemkit::Bond *bond,
-                        const chemkit::Atom *firstAtom,
-                        chemkit::Bitset &fingerprint) const;
+                        std::vector<bool> &visited,
+                        size_t atom,
+                        size_t bond,
+                        size_t firstAtom,
+                        const FragmentGraph &graph,
+                        chemkit::PackedFingerprint &fingerprint) const;
     static size_t canonicalHash(const Fragment &fragment);
 };
 
@@ -0,0 +1,341 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fpsbfileformat.h"
+
+#include <vector>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+
+#include <chemkit/fingerprintfile.h>
+#include <chemkit/fingerprintdatabase.h>
+
+// The FPSB format is a binary companion to the FPS format. It stores
+// the fingerprints in the same layout used by FingerprintDatabase so
+// that a memory-mapped file can be searched without parsing or
+// copying the fingerprints.
+//
+// The file starts with a 128 byte header:
+//
+//   offset  size  contents
+//        0     8  magic string "CKFPSB1\0"
+//        8     8  byte order mark (0x0102030405060708)
+//       16     8  number of bits in each fingerprint
+//       24     8  number of fingerprints
+//       32     8  offset of the fingerprint words
+//       40     8  offset of the bucket offsets
+//       48     8  offset of the fingerprint indices
+//       56     8  offset of the fingerprint positions
+//       64     8  offset of the identifier offsets
+//       72     8  offset of the identifier characters
+//       80    48  fingerprint name (nul-padded)
+//
+// Each section starts on a 64 byte boundary. The fingerprint words
+// are ordered by their number of set bits and each fingerprint is
+// padded to a whole number of cache lines. All values are stored in
+// the byte order of the machine that wrote the file.
+
+namespace {
+
+typedef boost::uint64_t Offset;
+
+const char Magic[8] = { 'C', 'K', 'F', 'P', 'S', 'B', '1', '\0' };
+const Offset ByteOrderMark = 0x0102030405060708ULL;
+const size_t HeaderSize = 128;
+const size_t NameSize = 48;
+const size_t SectionAlignment = 64;
+
+struct Header
+{
+    char magic[8];
+    Offset byteOrderMark;
+    Offset fingerprintSize;
+    Offset size;
+    Offset wordsOffset;
+    Offset bucketOffsetsOffset;
+    Offset indicesOffset;
+    Offset positionsOffset;
+    Offset identifierOffsetsOffset;
+    Offset identifiersOffset;
+    char name[NameSize];
+};
+
+inline Offset alignOffset(Offset offset)
+{
+    return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+}
+
+// Writes the values to the output stream followed by padding to
+// the next section boundary.
+template<typename T>
+void writeSection(std::ostream &output, const T *values, size_t count)
+{
+    Offset size = count * sizeof(T);
+    if(size){
+        output.write(reinterpret_cast<const char *>(values), size);
+    }
+
+    static const char padding[SectionAlignment] = { 0 };
+    output.write(padding, alignOffset(size) - size);
+}
+
+// Returns true if the section with count values of type T lies
+// within the file.
+template<typename T>
+inline bool isValidSection(Offset offset, Offset count, size_t fileSize)
+{
+    return offset % sizeof(T) == 0 &&
+           offset <= fileSize &&
+           count <= (fileSize - offset) / sizeof(T);
+}
+
+} // end anonymous namespace
+
+FpsbFileFormat::FpsbFileFormat()
+    : chemkit::FingerprintFileFormat("fpsb")
+{
+}
+
+// Reads the file from the input stream. The contents of the stream
+// are copied into memory and used in place.
+bool FpsbFileFormat::read(std::istream &input, chemkit::FingerprintFile *file)
+{
+    std::string contents((std::istreambuf_iterator<char>(input)),
+                         std::istreambuf_iterator<char>());
+
+    // copy into words so that the data is suitably aligned
+    boost::shared_ptr<std::vector<Offset> > data =
+        boost::make_shared<std::vector<Offset> >((contents.size() + sizeof(Offset) - 1) / sizeof(Offset));
+    if(!contents.empty()){
+        std::memcpy(&(*data)[0], contents.data(), contents.size());
+    }
+
+    return readData(data->empty() ? 0 : reinterpret_cast<const char *>(&(*data)[0]),
+                    contents.size(),
+                    data,
+                    file);
+}
+
+// Uses the fingerprints directly from the memory-mapped file. The
+// header, the offset tables and the bit count of each fingerprint
+// are checked before the database uses them.
+bool FpsbFileFormat::readMappedFile(const boost::iostreams::mapped_file_source &input,
+                                    chemkit::FingerprintFile *file)
+{
+    // the copy of the mapped file shares the mapping which is kept
+    // open while the database is using it
+    boost::shared_ptr<const void> owner =
+        boost::make_shared<boost::iostreams::mapped_file_source>(input);
+
+    return readData(input.data(), input.size(), owner, file);
+}
+
+bool FpsbFileFormat::readData(const char *data,
+                              size_t size,
+                              const boost::shared_ptr<const void> &owner,
+                              chemkit::FingerprintFile *file)
+{
+    if(size < HeaderSize){
+        setErrorString("File is too small to contain a header.");
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+
+    if(std::memcmp(header.magic, Magic, sizeof(Magic)) != 0){
+        setErrorString("File is not an FPSB file.");
+        return false;
+    }
+    else if(header.byteOrderMark != ByteOrderMark){
+        setErrorString("File was written with a different byte order.");
+        return false;
+    }
+
+    // check that each section lies within the file
+    Offset wordCount = chemkit::PackedFingerprint::wordCount(header.fingerprintSize);
+    if(header.fingerprintSize >= size * 8 ||
+       (wordCount && header.size > size / (wordCount * sizeof(chemkit::PackedFingerprint::Word))) ||
+       !isValidSection<chemkit::PackedFingerprint::Word>(header.wordsOffset, header.size * wordCount, size) ||
+       !isValidSection<Offset>(header.bucketOffsetsOffset, header.fingerprintSize + 2, size) ||
+       !isValidSection<Offset>(header.indicesOffset, header.size, size) ||
+       !isValidSection<Offset>(header.positionsOffset, header.size, size) ||
+       !isValidSection<Offset>(header.identifierOffsetsOffset, header.size + 1, size) ||
+       !isValidSection<char>(header.identifiersOffset, 0, size)){
+        setErrorString("File is truncated or corrupt.");
+        return false;
+    }
+
+    chemkit::FingerprintDatabase::ExternalStorage storage;
+    storage.size = header.size;
+    storage.fingerprintSize = header.fingerprintSize;
+    storage.words = reinterpret_cast<const chemkit::PackedFingerprint::Word *>(data + header.wordsOffset);
+    storage.bucketOffsets = reinterpret_cast<const Offset *>(data + header.bucketOffsetsOffset);
+    storage.indices = reinterpret_cast<const Offset *>(data + header.indicesOffset);
+    storage.positions = reinterpret_cast<const Offset *>(data + header.positionsOffset);
+    storage.identifierOffsets = reinterpret_cast<const Offset *>(data + header.identifierOffsetsOffset);
+    storage.identifiers = data + header.identifiersOffset;
+    storage.owner = owner;
+
+    // check that the buckets cover each fingerprint
+    if(storage.bucketOffsets[0] != 0 || storage.bucketOffsets[header.fingerprintSize + 1] != header.size){
+        setErrorString("File contains invalid bucket offsets.");
+        return false;
+    }
+    for(Offset i = 0; i <= header.fingerprintSize; i++){
+        if(storage.bucketOffsets[i] > storage.bucketOffsets[i + 1]){
+            setErrorString("File contains invalid bucket offsets.");
+            return false;
+        }
+    }
+
+    // check that each fingerprint is in the bucket for its number of
+    // set bits since the searches skip whole buckets by that number
+    for(Offset i = 0; i <= header.fingerprintSize; i++){
+        for(Offset j = storage.bucketOffsets[i]; j < storage.bucketOffsets[i + 1]; j++){
+            if(chemkit::PackedFingerprint::count(storage.words + j * wordCount, wordCount) != i){
+                setErrorString("File contains a fingerprint in the wrong bucket.");
+                return false;
+            }
+        }
+    }
+
+    // check that the indices and positions are inverse permutations
+    // so that the database never follows one out of range
+    for(Offset i = 0; i < header.size; i++){
+        Offset index = storage.indices[i];
+        if(index >= header.size || storage.positions[index] != i){
+            setErrorString("File contains invalid fingerprint indices.");
+            return false;
+        }
+    }
+
+    // check that each identifier lies within the file
+    if(storage.identifierOffsets[0] != 0 ||
+       storage.identifierOffsets[header.size] > size - header.identifiersOffset){
+        setErrorString("File contains invalid identifier offsets.");
+        return false;
+    }
+    for(Offset i = 0; i < header.size; i++){
+        if(storage.identifierOffsets[i] > storage.identifierOffsets[i + 1]){
+            setErrorString("File contains invalid identifier offsets.");
+            return false;
+        }
+    }
+
+    boost::shared_ptr<chemkit::FingerprintDatabase> database =
+        boost::make_shared<chemkit::FingerprintDatabase>();
+
+    std::string name(header.name, std::find(header.name, header.name + NameSize, '\0'));
+    if(!name.empty()){
+        database->setFingerprint(name);
+    }
+
+    database->setExternalStorage(storage);
+    file->setDatabase(database);
+
+    return true;
+}
+
+bool FpsbFileFormat::write(const chemkit::FingerprintFile *file, std::ostream &output)
+{
+    const chemkit::FingerprintDatabase *database = file->database().get();
+
+    const size_t size = database->size();
+    const size_t fingerprintSize = database->fingerprintSize();
+    const size_t wordCount = chemkit::PackedFingerprint::wordCount(fingerprintSize);
+
+    // order the fingerprints by their number of set bits
+    std::vector<Offset> counts(size);
+    std::vector<Offset> bucketOffsets(fingerprintSize + 2, 0);
+    for(size_t i = 0; i < size; i++){
+        counts[i] = database->fingerprint(i).count();
+        bucketOffsets[counts[i] + 1]++;
+    }
+    for(size_t i = 1; i < bucketOffsets.size(); i++){
+        bucketOffsets[i] += bucketOffsets[i - 1];
+    }
+
+    std::vector<Offset> indices(size);
+    std::vector<Offset> positions(size);
+    std::vector<Offset> next(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for(size_t i = 0; i < size; i++){
+        positions[i] = next[counts[i]]++;
+        indices[positions[i]] = i;
+    }
+
+    std::vector<Offset> identifierOffsets(1, 0);
+    std::string identifiers;
+    for(size_t i = 0; i < size; i++){
+        identifiers += database->identifier(i);
+        identifierOffsets.push_back(identifiers.size());
+    }
+
+    // write header
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.byteOrderMark = ByteOrderMark;
+    header.fingerprintSize = fingerprintSize;
+    header.size = size;
+    header.wordsOffset = HeaderSize;
+    header.bucketOffsetsOffset = header.wordsOffset + alignOffset(size * wordCount * sizeof(chemkit::PackedFingerprint::Word));
+    header.indicesOffset = header.bucketOffsetsOffset + alignOffset(bucketOffsets.size() * sizeof(Offset));
+    header.positionsOffset = header.indicesOffset + alignOffset(size * sizeof(Offset));
+    header.identifierOffsetsOffset = header.positionsOffset + alignOffset(size * sizeof(Offset));
+    header.identifiersOffset = header.identifierOffsetsOffset + alignOffset(identifierOffsets.size() * sizeof(Offset));
+    std::strncpy(header.name, database->fingerprint().c_str(), NameSize - 1);
+
+    output.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+
+    // write fingerprints
+    for(size_t i = 0; i < size; i++){
+        chemkit::PackedFingerprint fingerprint = database->fingerprint(indices[i]);
+        output.write(reinterpret_cast<const char *>(fingerprint.words()),
+                     wordCount * sizeof(chemkit::PackedFingerprint::Word));
+    }
+
+    writeSection(output, &bucketOffsets[0], bucketOffsets.size());
+    writeSection(output, indices.empty() ? 0 : &indices[0], indices.size());
+    writeSection(output, positions.empty() ? 0 : &positions[0], positions.size());
+    writeSection(output, &identifierOffsets[0], identifierOffsets.size());
+    output.write(identifiers.data(), identifiers.size());
+
+    return output.good();
+}
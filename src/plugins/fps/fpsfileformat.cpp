@@ -127,7 +127,7 @@ bool FpsFileFormat::write(const chemkit::MoleculeFile *file, std::ostream &outpu
     // write header
     output << "#FPS1" << std::endl;
     output << "#num_bits=" << fingerprint->size() << std::endl;
-    output << "#type=" << fingerprintTypeString() << std::endl;
+    output << "#type=" << fingerprintTypeString(fingerprintName) << std::endl;
     output << "#software=chemkit/" << CHEMKIT_VERSION_STRING << std::endl;
     output << "#date=" << dateTimeString() << std::endl;
 
@@ -163,7 +163,7 @@ chemkit::Variant FpsFileFormat::defaultOption(const std::string &name) const
 
 // Returns the date and time as a string formatted according to
 // the FPS file format standard.
-std::string FpsFileFormat::dateTimeString() const
+std::string FpsFileFormat::dateTimeString()
 {
     time_t rawtime = time(NULL);
     struct tm *timeinfo = gmtime(&rawtime);
@@ -175,10 +175,8 @@ std::string FpsFileFormat::dateTimeString() const
 }
 
 // Returns a string containing the type of the fingerprint.
-std::string FpsFileFormat::fingerprintTypeString() const
+std::string FpsFileFormat::fingerprintTypeString(const std::string &fingerprint)
 {
-    std::string fingerprint = option("fingerprint").toString();
-
     if(fingerprint == "fp2"){
         return "chemkit-FP2/1";
     }
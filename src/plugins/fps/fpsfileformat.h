@@ -46,12 +46,11 @@ public:
 
     bool write(const chemkit::MoleculeFile *file, std::ostream &output) CHEMKIT_OVERRIDE;
 
+    static std::string dateTimeString();
+    static std::string fingerprintTypeString(const std::string &fingerprint);
+
 protected:
     chemkit::Variant defaultOption(const std::string &name) const CHEMKIT_OVERRIDE;
-
-private:
-    std::string dateTimeString() const;
-    std::string fingerprintTypeString() const;
 };
 
 #endif // FPSFILEFORMAT_H
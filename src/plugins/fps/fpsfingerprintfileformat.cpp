@@ -0,0 +1,242 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fpsfingerprintfileformat.h"
+
+#include "fpsfileformat.h"
+
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include <chemkit/fingerprintfile.h>
+#include <chemkit/fingerprintdatabase.h>
+
+namespace {
+
+// Returns the value of the hex digit or -1 if it is not a hex digit.
+inline int hexValue(char digit)
+{
+    if(digit >= '0' && digit <= '9'){
+        return digit - '0';
+    }
+    else if(digit >= 'a' && digit <= 'f'){
+        return digit - 'a' + 10;
+    }
+    else if(digit >= 'A' && digit <= 'F'){
+        return digit - 'A' + 10;
+    }
+
+    return -1;
+}
+
+// Decodes the hex encoded fingerprint into the words of fingerprint.
+// Returns false if the string is not valid hex.
+bool decodeFingerprint(const char *hex, size_t length, chemkit::PackedFingerprint &fingerprint)
+{
+    chemkit::PackedFingerprint::Word *words = fingerprint.words();
+    std::fill(words, words + fingerprint.wordCount(), 0);
+
+    for(size_t i = 0; i < length / 2; i++){
+        int high = hexValue(hex[2 * i]);
+        int low = hexValue(hex[2 * i + 1]);
+        if(high < 0 || low < 0){
+            return false;
+        }
+
+        words[i / 8] |= chemkit::PackedFingerprint::Word((high << 4) | low) << (8 * (i % 8));
+    }
+
+    // clear the padding bits after the last bit
+    size_t size = fingerprint.size();
+    if(size % chemkit::PackedFingerprint::WordSize){
+        words[size / chemkit::PackedFingerprint::WordSize] &=
+            (chemkit::PackedFingerprint::Word(1) << (size % chemkit::PackedFingerprint::WordSize)) - 1;
+    }
+
+    return true;
+}
+
+// Returns the name of the fingerprint for the FPS type string.
+std::string fingerprintName(const std::string &type)
+{
+    if(type == "chemkit-FP2/1"){
+        return "fp2";
+    }
+    else if(type == "PubChem/1"){
+        return "pubchem";
+    }
+    else if(boost::ends_with(type, "/1")){
+        return type.substr(0, type.size() - 2);
+    }
+
+    return std::string();
+}
+
+} // end anonymous namespace
+
+FpsFingerprintFileFormat::FpsFingerprintFileFormat()
+    : chemkit::FingerprintFileFormat("fps")
+{
+}
+
+// Reads the fingerprints and identifiers from the input stream.
+//
+// Reference:
+//   http://code.google.com/p/chem-fingerprints/wiki/FPS
+bool FpsFingerprintFileFormat::read(std::istream &input, chemkit::FingerprintFile *file)
+{
+    boost::shared_ptr<chemkit::FingerprintDatabase> database =
+        boost::make_shared<chemkit::FingerprintDatabase>();
+
+    size_t size = 0;
+    size_t lineNumber = 0;
+    chemkit::PackedFingerprint fingerprint;
+    std::string line;
+
+    while(std::getline(input, line)){
+        lineNumber++;
+
+        if(!line.empty() && line[line.size() - 1] == '\r'){
+            line.erase(line.size() - 1);
+        }
+
+        if(line.empty()){
+            continue;
+        }
+
+        // read header lines
+        if(line[0] == '#'){
+            if(boost::starts_with(line, "#num_bits=")){
+                try {
+                    size = boost::lexical_cast<size_t>(line.substr(10));
+                }
+                catch(boost::bad_lexical_cast &){
+                    setErrorString((boost::format("Invalid number of bits on line %d.") % lineNumber).str());
+                    return false;
+                }
+            }
+            else if(boost::starts_with(line, "#type=") && database->isEmpty()){
+                std::string name = fingerprintName(line.substr(6));
+                if(!name.empty()){
+                    database->setFingerprint(name);
+                }
+            }
+
+            continue;
+        }
+
+        // the fingerprint is followed by a tab and the identifier
+        size_t end = line.find('\t');
+        if(end == std::string::npos){
+            end = line.size();
+        }
+
+        if(fingerprint.isEmpty()){
+            // without a num_bits header the size is the number of bits
+            // in the first fingerprint
+            if(size == 0){
+                size = end * 4;
+            }
+
+            database->setFingerprintSize(size);
+            fingerprint = chemkit::PackedFingerprint(size);
+        }
+
+        if(end != (size + 7) / 8 * 2 || !decodeFingerprint(line.c_str(), end, fingerprint)){
+            setErrorString((boost::format("Invalid fingerprint on line %d.") % lineNumber).str());
+            return false;
+        }
+
+        std::string identifier;
+        if(end < line.size()){
+            size_t identifierEnd = line.find('\t', end + 1);
+            if(identifierEnd == std::string::npos){
+                identifierEnd = line.size();
+            }
+
+            identifier = line.substr(end + 1, identifierEnd - end - 1);
+        }
+
+        database->addFingerprint(fingerprint, identifier);
+    }
+
+    file->setDatabase(database);
+
+    return true;
+}
+
+// Writes each fingerprint in the database and its identifier to
+// the output stream.
+//
+// Reference:
+//   http://code.google.com/p/chem-fingerprints/wiki/FPS
+bool FpsFingerprintFileFormat::write(const chemkit::FingerprintFile *file, std::ostream &output)
+{
+    const chemkit::FingerprintDatabase *database = file->database().get();
+
+    // write header
+    output << "#FPS1" << std::endl;
+    output << "#num_bits=" << database->fingerprintSize() << std::endl;
+    if(!database->fingerprint().empty()){
+        output << "#type=" << FpsFileFormat::fingerprintTypeString(database->fingerprint()) << std::endl;
+    }
+    output << "#software=chemkit/" << CHEMKIT_VERSION_STRING << std::endl;
+    output << "#date=" << FpsFileFormat::dateTimeString() << std::endl;
+
+    // each fingerprint is written as the hex encoding of its bytes
+    // with the first byte containing bits zero through seven
+    const char *digits = "0123456789abcdef";
+    const size_t byteCount = (database->fingerprintSize() + 7) / 8;
+    std::string line;
+
+    for(size_t i = 0; i < database->size(); i++){
+        chemkit::PackedFingerprint fingerprint = database->fingerprint(i);
+        const chemkit::PackedFingerprint::Word *words = fingerprint.words();
+
+        line.clear();
+        for(size_t j = 0; j < byteCount; j++){
+            unsigned int byte = (words[j / 8] >> (8 * (j % 8))) & 0xff;
+
+            line += digits[byte >> 4];
+            line += digits[byte & 0x0f];
+        }
+
+        output << line << "\t" << database->identifier(i) << "\n";
+    }
+
+    return true;
+}
@@ -35,7 +35,9 @@
 
 #include <chemkit/plugin.h>
 
+#include "fpsbfileformat.h"
 #include "fpsfileformat.h"
+#include "fpsfingerprintfileformat.h"
 
 class FpsPlugin : public chemkit::Plugin
 {
@@ -44,6 +46,8 @@ public:
         : chemkit::Plugin("fps")
     {
         CHEMKIT_REGISTER_MOLECULE_FILE_FORMAT("fps", FpsFileFormat);
+        CHEMKIT_REGISTER_FINGERPRINT_FILE_FORMAT("fps", FpsFingerprintFileFormat);
+        CHEMKIT_REGISTER_FINGERPRINT_FILE_FORMAT("fpsb", FpsbFileFormat);
     }
 };
 
@@ -35,52 +35,10 @@
 
 #include "graphdescriptors.h"
 
-#include <set>
-#include <vector>
+#include <limits>
 
-#include <chemkit/atom.h>
-#include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
-
-namespace {
-
-// Returns the graph distance between the two atoms.
-int distanceBetween(const chemkit::Atom *a, const chemkit::Atom *b)
-{
-    int distance = 0;
-
-    std::set<const chemkit::Atom*> visited;
-
-    std::vector<const chemkit::Atom*> row;
-    row.push_back(a);
-
-    while(!row.empty()){
-        std::vector<const chemkit::Atom*> nextRow;
-
-        foreach(const chemkit::Atom *atom, row){
-            if(atom == b){
-                return distance;
-            }
-
-            visited.insert(atom);
-
-            foreach(const chemkit::Atom *neighbor, atom->neighbors()){
-                if(visited.find(neighbor) != visited.end()){
-                    continue;
-                }
-
-                nextRow.push_back(neighbor);
-            }
-        }
-
-        row = nextRow;
-        distance++;
-    }
-
-    return 0;
-}
-
-} // end anonymous namespace
+#include <chemkit/graphdistancematrix.h>
 
 // === GraphDensityDescriptor ============================================== //
 GraphDensityDescriptor::GraphDensityDescriptor()
@@ -110,23 +68,7 @@ GraphDiameterDescriptor::GraphDiameterDescriptor()
 
 chemkit::Variant GraphDiameterDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    int diameter = 0;
-
-    for(size_t i = 0; i < molecule->size(); i++){
-        const chemkit::Atom *a = molecule->atom(i);
-
-        for(size_t j = i + 1; j < molecule->size(); j++){
-            const chemkit::Atom *b = molecule->atom(j);
-
-            int distance = distanceBetween(a, b);
-
-            if(distance > diameter){
-                diameter = distance;
-            }
-        }
-    }
-
-    return diameter;
+    return molecule->graphDistanceMatrix()->diameter();
 }
 
 // === GraphOrderDescriptor ================================================ //
@@ -150,29 +92,11 @@ GraphRadiusDescriptor::GraphRadiusDescriptor()
 
 chemkit::Variant GraphRadiusDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    int radius = std::numeric_limits<int>::max();
-
-    for(size_t i = 0; i < molecule->size(); i++){
-        const chemkit::Atom *a = molecule->atom(i);
-
-        int eccentricity = 0;
-
-        for(size_t j = 0; j < molecule->size(); j++){
-            const chemkit::Atom *b = molecule->atom(j);
-
-            int distance = distanceBetween(a, b);
-
-            if(distance > eccentricity){
-                eccentricity = distance;
-            }
-        }
-
-        if(eccentricity < radius){
-            radius = eccentricity;
-        }
+    if(molecule->isEmpty()){
+        return std::numeric_limits<int>::max();
     }
 
-    return radius;
+    return molecule->graphDistanceMatrix()->radius();
 }
 
 // === GraphSizeDescriptor ================================================= //
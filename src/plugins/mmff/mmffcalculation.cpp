@@ -35,14 +35,13 @@
 
 #include "mmffcalculation.h"
 
-#include <boost/lexical_cast.hpp>
-
 #include <chemkit/topology.h>
 #include <chemkit/constants.h>
 #include <chemkit/forcefield.h>
 #include <chemkit/cartesiancoordinates.h>
 
 #include "mmffparameters.h"
+#include "mmffforcefield.h"
 
 // === MmffCalculation ===================================================== //
 MmffCalculation::MmffCalculation(int type, int atomCount, int parameterCount)
@@ -58,21 +57,23 @@ MmffBondStrechCalculation::MmffBondStrechCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool MmffBondStrechCalculation::setup(const MmffParameters *parameters)
+bool MmffBondStrechCalculation::setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const MmffParameters *mmffParameters = forceField->parameters();
 
-    size_t a = atom(0);
-    size_t b = atom(1);
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
 
-    int typeA = boost::lexical_cast<int>(topology->type(a));
-    int typeB = boost::lexical_cast<int>(topology->type(b));
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    int typeA = forceField->typeNumber(a);
+    int typeB = forceField->typeNumber(b);
     int bondType = topology->bondedInteractionType(a, b);
 
-    const MmffBondStrechParameters *bondStrechParameters = parameters->bondStrechParameters(bondType, typeA, typeB);
+    const MmffBondStrechParameters *bondStrechParameters = mmffParameters->bondStrechParameters(bondType, typeA, typeB);
     if(bondStrechParameters){
-        setParameter(0, bondStrechParameters->kb);
-        setParameter(1, bondStrechParameters->r0);
+        parameters[0] = bondStrechParameters->kb;
+        parameters[1] = bondStrechParameters->r0;
         return true;
     }
 
@@ -127,25 +128,27 @@ MmffAngleBendCalculation::MmffAngleBendCalculation(size_t a, size_t b, size_t c)
     setAtom(2, c);
 }
 
-bool MmffAngleBendCalculation::setup(const MmffParameters *parameters)
+bool MmffAngleBendCalculation::setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const MmffParameters *mmffParameters = forceField->parameters();
 
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
+
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    int typeA = boost::lexical_cast<int>(topology->type(a));
-    int typeB = boost::lexical_cast<int>(topology->type(b));
-    int typeC = boost::lexical_cast<int>(topology->type(c));
+    int typeA = forceField->typeNumber(a);
+    int typeB = forceField->typeNumber(b);
+    int typeC = forceField->typeNumber(c);
     int angleType = topology->angleInteractionType(a, b, c);
 
     const MmffAngleBendParameters *angleBendParameters =
-        parameters->angleBendParameters(angleType, typeA, typeB, typeC);
+        mmffParameters->angleBendParameters(angleType, typeA, typeB, typeC);
 
     if(angleBendParameters){
-        setParameter(0, angleBendParameters->ka);
-        setParameter(1, angleBendParameters->theta0);
+        parameters[0] = angleBendParameters->ka;
+        parameters[1] = angleBendParameters->theta0;
         return true;
     }
 
@@ -203,65 +206,67 @@ MmffStrechBendCalculation::MmffStrechBendCalculation(size_t a, size_t b, size_t
     setAtom(2, c);
 }
 
-bool MmffStrechBendCalculation::setup(const MmffParameters *parameters)
+bool MmffStrechBendCalculation::setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const MmffParameters *mmffParameters = forceField->parameters();
 
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
+
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    int typeA = boost::lexical_cast<int>(topology->type(a));
-    int typeB = boost::lexical_cast<int>(topology->type(b));
-    int typeC = boost::lexical_cast<int>(topology->type(c));
+    int typeA = forceField->typeNumber(a);
+    int typeB = forceField->typeNumber(b);
+    int typeC = forceField->typeNumber(c);
     int bondTypeAB = topology->bondedInteractionType(a, b);
     int bondTypeBC = topology->bondedInteractionType(b, c);
     int angleType = topology->angleInteractionType(a, b, c);
 
     int strechBendType =
-        parameters->calculateStrechBendType(bondTypeAB, bondTypeBC, angleType);
+        mmffParameters->calculateStrechBendType(bondTypeAB, bondTypeBC, angleType);
 
     bool parametersSwapped = false;
     const MmffStrechBendParameters *strechBendParameters =
-        parameters->strechBendParameters(strechBendType, typeA, typeB, typeC);
+        mmffParameters->strechBendParameters(strechBendType, typeA, typeB, typeC);
     if(!strechBendParameters){
         strechBendType =
-            parameters->calculateStrechBendType(bondTypeBC, bondTypeAB, angleType);
+            mmffParameters->calculateStrechBendType(bondTypeBC, bondTypeAB, angleType);
         strechBendParameters =
-            parameters->strechBendParameters(strechBendType, typeC, typeB, typeA);
+            mmffParameters->strechBendParameters(strechBendType, typeC, typeB, typeA);
 
         if(strechBendParameters){
             parametersSwapped = true;
         }
         else{
-            strechBendParameters = parameters->defaultStrechBendParameters(typeA, typeB, typeC);
+            strechBendParameters = mmffParameters->defaultStrechBendParameters(typeA, typeB, typeC);
 
             if(!strechBendParameters){
-                strechBendParameters = parameters->defaultStrechBendParameters(typeC, typeB, typeA);
+                strechBendParameters = mmffParameters->defaultStrechBendParameters(typeC, typeB, typeA);
                 parametersSwapped = true;
             }
         }
     }
 
     const MmffBondStrechParameters *bondStrechParameters_ab =
-        parameters->bondStrechParameters(bondTypeAB, typeA, typeB);
+        mmffParameters->bondStrechParameters(bondTypeAB, typeA, typeB);
     const MmffBondStrechParameters *bondStrechParameters_bc =
-        parameters->bondStrechParameters(bondTypeBC, typeB, typeC);
+        mmffParameters->bondStrechParameters(bondTypeBC, typeB, typeC);
     const MmffAngleBendParameters *angleBendParameters =
-        parameters->angleBendParameters(angleType, typeA, typeB, typeC);
+        mmffParameters->angleBendParameters(angleType, typeA, typeB, typeC);
     if(strechBendParameters && bondStrechParameters_ab && bondStrechParameters_bc && angleBendParameters){
         if(parametersSwapped){
-            setParameter(1, strechBendParameters->kba_ijk);
-            setParameter(0, strechBendParameters->kba_kji);
+            parameters[1] = strechBendParameters->kba_ijk;
+            parameters[0] = strechBendParameters->kba_kji;
         }
         else{
-            setParameter(0, strechBendParameters->kba_ijk);
-            setParameter(1, strechBendParameters->kba_kji);
+            parameters[0] = strechBendParameters->kba_ijk;
+            parameters[1] = strechBendParameters->kba_kji;
         }
 
-        setParameter(2, bondStrechParameters_ab->r0);
-        setParameter(3, bondStrechParameters_bc->r0);
-        setParameter(4, angleBendParameters->theta0);
+        parameters[2] = bondStrechParameters_ab->r0;
+        parameters[3] = bondStrechParameters_bc->r0;
+        parameters[4] = angleBendParameters->theta0;
         return true;
     }
 
@@ -333,27 +338,27 @@ MmffOutOfPlaneBendingCalculation::MmffOutOfPlaneBendingCalculation(size_t a, siz
     setAtom(3, d);
 }
 
-bool MmffOutOfPlaneBendingCalculation::setup(const MmffParameters *parameters)
+bool MmffOutOfPlaneBendingCalculation::setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const MmffParameters *mmffParameters = forceField->parameters();
 
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    int typeA = boost::lexical_cast<int>(topology->type(a));
-    int typeB = boost::lexical_cast<int>(topology->type(b));
-    int typeC = boost::lexical_cast<int>(topology->type(c));
-    int typeD = boost::lexical_cast<int>(topology->type(d));
+    int typeA = forceField->typeNumber(a);
+    int typeB = forceField->typeNumber(b);
+    int typeC = forceField->typeNumber(c);
+    int typeD = forceField->typeNumber(d);
 
     const MmffOutOfPlaneBendingParameters *outOfPlaneBendingParameters =
-        parameters->outOfPlaneBendingParameters(typeA, typeB, typeC, typeD);
+        mmffParameters->outOfPlaneBendingParameters(typeA, typeB, typeC, typeD);
     if(!outOfPlaneBendingParameters){
         return false;
     }
 
-    setParameter(0, outOfPlaneBendingParameters->koop);
+    parameters[0] = outOfPlaneBendingParameters->koop;
     return true;
 }
 
@@ -404,30 +409,32 @@ MmffTorsionCalculation::MmffTorsionCalculation(size_t a, size_t b, size_t c, siz
     setAtom(3, d);
 }
 
-bool MmffTorsionCalculation::setup(const MmffParameters *parameters)
+bool MmffTorsionCalculation::setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const MmffParameters *mmffParameters = forceField->parameters();
 
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
+
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    int typeA = boost::lexical_cast<int>(topology->type(a));
-    int typeB = boost::lexical_cast<int>(topology->type(b));
-    int typeC = boost::lexical_cast<int>(topology->type(c));
-    int typeD = boost::lexical_cast<int>(topology->type(d));
+    int typeA = forceField->typeNumber(a);
+    int typeB = forceField->typeNumber(b);
+    int typeC = forceField->typeNumber(c);
+    int typeD = forceField->typeNumber(d);
     int torsionType = topology->torsionInteractionType(a, b, c, d);
 
     const MmffTorsionParameters *torsionParameters =
-        parameters->torsionParameters(torsionType, typeA, typeB, typeC, typeD);
+        mmffParameters->torsionParameters(torsionType, typeA, typeB, typeC, typeD);
     if(!torsionParameters){
         return false;
     }
 
-    setParameter(0, torsionParameters->V1);
-    setParameter(1, torsionParameters->V2);
-    setParameter(2, torsionParameters->V3);
+    parameters[0] = torsionParameters->V1;
+    parameters[1] = torsionParameters->V2;
+    parameters[2] = torsionParameters->V3;
 
     return true;
 }
@@ -481,22 +488,39 @@ MmffVanDerWaalsCalculation::MmffVanDerWaalsCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool MmffVanDerWaalsCalculation::setup(const MmffParameters *parameters)
+bool MmffVanDerWaalsCalculation::setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const MmffParameters *mmffParameters = forceField->parameters();
 
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    int typeA = boost::lexical_cast<int>(topology->type(a));
-    int typeB = boost::lexical_cast<int>(topology->type(b));
+    int typeA = forceField->typeNumber(a);
+    int typeB = forceField->typeNumber(b);
 
-    const MmffVanDerWaalsParameters *parametersA = parameters->vanDerWaalsParameters(typeA);
-    const MmffVanDerWaalsParameters *parametersB = parameters->vanDerWaalsParameters(typeB);
+    const MmffVanDerWaalsParameters *parametersA = mmffParameters->vanDerWaalsParameters(typeA);
+    const MmffVanDerWaalsParameters *parametersB = mmffParameters->vanDerWaalsParameters(typeB);
     if(!parametersA || !parametersB){
         return false;
     }
 
+    chemkit::Real rs;
+    chemkit::Real eps;
+    combineParameters(parametersA, parametersB, &rs, &eps);
+
+    parameters[0] = rs;
+    parameters[1] = eps;
+
+    return true;
+}
+
+// Calculates the van der waals parameters for the interaction between
+// atoms with parametersA and parametersB using the combination rules.
+void MmffVanDerWaalsCalculation::combineParameters(const MmffVanDerWaalsParameters *parametersA,
+                                                   const MmffVanDerWaalsParameters *parametersB,
+                                                   chemkit::Real *rs,
+                                                   chemkit::Real *eps)
+{
     chemkit::Real N_a = parametersA->N;
     chemkit::Real N_b = parametersB->N;
     chemkit::Real A_a = parametersA->A;
@@ -516,27 +540,20 @@ bool MmffVanDerWaalsCalculation::setup(const MmffParameters *parameters)
     chemkit::Real gamma = (rs_aa - rs_bb) / (rs_aa + rs_bb);
 
     // equation 10
-    chemkit::Real rs;
-
     if(DA_a == 'D' || (DA_b == 'D')){
-        rs = 0.5 * (rs_aa + rs_bb);
+        *rs = 0.5 * (rs_aa + rs_bb);
     }
     else{
-        rs = 0.5 * (rs_aa + rs_bb) * (1.0 + 0.2 * (1.0 - exp(-12.0 * gamma * gamma)));
+        *rs = 0.5 * (rs_aa + rs_bb) * (1.0 + 0.2 * (1.0 - exp(-12.0 * gamma * gamma)));
     }
 
     // equation 12
-    chemkit::Real eps = ((181.16 * G_a * G_b * alpha_a * alpha_b) / (sqrt(alpha_a / N_a) + sqrt(alpha_b / N_b))) * pow(rs, -6.0);
+    *eps = ((181.16 * G_a * G_b * alpha_a * alpha_b) / (sqrt(alpha_a / N_a) + sqrt(alpha_b / N_b))) * pow(*rs, -6.0);
 
     if((DA_a == 'D' && DA_b == 'A') || (DA_a == 'A' && DA_b == 'D')){
-        rs *= 0.8;
-        eps *= 0.5;
+        *rs *= 0.8;
+        *eps *= 0.5;
     }
-
-    setParameter(0, rs);
-    setParameter(1, eps);
-
-    return true;
 }
 
 chemkit::Real MmffVanDerWaalsCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
@@ -582,14 +599,12 @@ MmffElectrostaticCalculation::MmffElectrostaticCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool MmffElectrostaticCalculation::setup(const MmffParameters *parameters)
+bool MmffElectrostaticCalculation::setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    CHEMKIT_UNUSED(parameters);
-
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
 
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
     chemkit::Real oneFourScaling;
 
@@ -600,9 +615,9 @@ bool MmffElectrostaticCalculation::setup(const MmffParameters *parameters)
         oneFourScaling = 1.0;
     }
 
-    setParameter(0, topology->charge(a));
-    setParameter(1, topology->charge(b));
-    setParameter(2, oneFourScaling);
+    parameters[0] = topology->charge(a);
+    parameters[1] = topology->charge(b);
+    parameters[2] = oneFourScaling;
 
     return true;
 }
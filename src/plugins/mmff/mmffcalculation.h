@@ -38,13 +38,11 @@
 
 #include <chemkit/forcefieldcalculation.h>
 
-class MmffParameters;
+class MmffForceField;
+struct MmffVanDerWaalsParameters;
 
 class MmffCalculation : public chemkit::ForceFieldCalculation
 {
-public:
-    virtual bool setup(const MmffParameters *parameters) = 0;
-
 protected:
     MmffCalculation(int type, int atomCount, int parameterCount);
 };
@@ -54,7 +52,7 @@ class MmffBondStrechCalculation : public MmffCalculation
 public:
     MmffBondStrechCalculation(size_t a, size_t b);
 
-    bool setup(const MmffParameters *parameters);
+    static bool setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -64,7 +62,7 @@ class MmffAngleBendCalculation : public MmffCalculation
 public:
     MmffAngleBendCalculation(size_t a, size_t b, size_t c);
 
-    bool setup(const MmffParameters *parameters);
+    static bool setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -74,7 +72,7 @@ class MmffStrechBendCalculation : public MmffCalculation
 public:
     MmffStrechBendCalculation(size_t a, size_t b, size_t c);
 
-    bool setup(const MmffParameters *parameters);
+    static bool setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -84,7 +82,7 @@ class MmffOutOfPlaneBendingCalculation : public MmffCalculation
 public:
     MmffOutOfPlaneBendingCalculation(size_t a, size_t b, size_t c, size_t d);
 
-    bool setup(const MmffParameters *parameters);
+    static bool setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -94,7 +92,7 @@ class MmffTorsionCalculation : public MmffCalculation
 public:
     MmffTorsionCalculation(size_t a, size_t b, size_t c, size_t d);
 
-    bool setup(const MmffParameters *parameters);
+    static bool setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -104,7 +102,11 @@ class MmffVanDerWaalsCalculation : public MmffCalculation
 public:
     MmffVanDerWaalsCalculation(size_t a, size_t b);
 
-    bool setup(const MmffParameters *parameters);
+    static bool setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
+    static void combineParameters(const MmffVanDerWaalsParameters *parametersA,
+                                  const MmffVanDerWaalsParameters *parametersB,
+                                  chemkit::Real *rs,
+                                  chemkit::Real *eps);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -114,7 +116,7 @@ class MmffElectrostaticCalculation : public MmffCalculation
 public:
     MmffElectrostaticCalculation(size_t a, size_t b);
 
-    bool setup(const MmffParameters *parameters);
+    static bool setup(const MmffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
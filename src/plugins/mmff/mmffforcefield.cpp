@@ -47,6 +47,8 @@
 
 #include "mmffforcefield.h"
 
+
+#include "mmffkernel.h"
 #include "mmffatomtyper.h"
 #include "mmffparameters.h"
 #include "mmffcalculation.h"
@@ -56,6 +58,7 @@
 #include <chemkit/molecule.h>
 #include <chemkit/topology.h>
 #include <chemkit/pluginmanager.h>
+#include <chemkit/forcefieldcalculationbatch.h>
 
 // --- Construction and Destruction ---------------------------------------- //
 MmffForceField::MmffForceField()
@@ -96,65 +99,128 @@ bool MmffForceField::setup()
         return false;
     }
 
+    // convert each type name in the topology to its mmff type number once
+    m_typeNumbers = topology->typeNumbers();
+
+    bool ok = true;
+
     // bond strech calculations
-    foreach(const chemkit::Topology::BondedInteraction &interaction, topology->bondedInteractions()){
-        size_t a = interaction[0];
-        size_t b = interaction[1];
+    chemkit::ForceFieldKernelBatch<MmffBondStrechKernel> *bondStrechBatch =
+        new chemkit::ForceFieldKernelBatch<MmffBondStrechKernel>(chemkit::ForceFieldCalculation::BondStrech);
+    bondStrechBatch->reserve(topology->bondedInteractionCount());
 
-        addCalculation(new MmffBondStrechCalculation(a, b));
+    foreach(const chemkit::Topology::BondedInteraction &interaction, topology->bondedInteractions()){
+        chemkit::Real parameters[MmffBondStrechKernel::ParameterCount] = { 0 };
+        bool setup = MmffBondStrechCalculation::setup(this, interaction.data(), parameters);
+        bondStrechBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(bondStrechBatch);
+
     // angle bend and strech bend calculations
+    chemkit::ForceFieldKernelBatch<MmffAngleBendKernel> *angleBendBatch =
+        new chemkit::ForceFieldKernelBatch<MmffAngleBendKernel>(chemkit::ForceFieldCalculation::AngleBend);
+    angleBendBatch->reserve(topology->angleInteractionCount());
+    chemkit::ForceFieldKernelBatch<MmffStrechBendKernel> *strechBendBatch =
+        new chemkit::ForceFieldKernelBatch<MmffStrechBendKernel>(chemkit::ForceFieldCalculation::BondStrech | chemkit::ForceFieldCalculation::AngleBend);
+    strechBendBatch->reserve(topology->angleInteractionCount());
+
     foreach(const chemkit::Topology::AngleInteraction &interaction, topology->angleInteractions()){
-        size_t a = interaction[0];
-        size_t b = interaction[1];
-        size_t c = interaction[2];
+        chemkit::Real angleBendParameters[MmffAngleBendKernel::ParameterCount] = { 0 };
+        bool setup = MmffAngleBendCalculation::setup(this, interaction.data(), angleBendParameters);
+        angleBendBatch->addCalculation(interaction.data(), angleBendParameters, setup);
+        ok = ok && setup;
 
-        addCalculation(new MmffAngleBendCalculation(a, b, c));
-        addCalculation(new MmffStrechBendCalculation(a, b, c));
+        chemkit::Real strechBendParameters[MmffStrechBendKernel::ParameterCount] = { 0 };
+        setup = MmffStrechBendCalculation::setup(this, interaction.data(), strechBendParameters);
+        strechBendBatch->addCalculation(interaction.data(), strechBendParameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(angleBendBatch);
+    addCalculationBatch(strechBendBatch);
+
     // out of plane bending calculation (for each trigonal center)
+    chemkit::ForceFieldKernelBatch<MmffOutOfPlaneBendingKernel> *outOfPlaneBendingBatch =
+        new chemkit::ForceFieldKernelBatch<MmffOutOfPlaneBendingKernel>(chemkit::ForceFieldCalculation::Inversion);
+    outOfPlaneBendingBatch->reserve(3 * topology->improperTorsionInteractionCount());
+
     foreach(const chemkit::Topology::ImproperTorsionInteraction &interaction, topology->improperTorsionInteractions()){
         size_t a = interaction[0];
         size_t b = interaction[1];
         size_t c = interaction[2];
         size_t d = interaction[3];
 
-        addCalculation(new MmffOutOfPlaneBendingCalculation(a, b, c, d));
-        addCalculation(new MmffOutOfPlaneBendingCalculation(a, b, d, c));
-        addCalculation(new MmffOutOfPlaneBendingCalculation(c, b, d, a));
+        const size_t outOfPlaneBendings[3][4] = {
+            { a, b, c, d },
+            { a, b, d, c },
+            { c, b, d, a }
+        };
+
+        for(int i = 0; i < 3; i++){
+            chemkit::Real parameters[MmffOutOfPlaneBendingKernel::ParameterCount] = { 0 };
+            bool setup = MmffOutOfPlaneBendingCalculation::setup(this, outOfPlaneBendings[i], parameters);
+            outOfPlaneBendingBatch->addCalculation(outOfPlaneBendings[i], parameters, setup);
+            ok = ok && setup;
+        }
     }
 
+    addCalculationBatch(outOfPlaneBendingBatch);
+
     // torsion calculations (for each dihedral)
-    foreach(const chemkit::Topology::TorsionInteraction &interaction, topology->torsionInteractions()){
-        size_t a = interaction[0];
-        size_t b = interaction[1];
-        size_t c = interaction[2];
-        size_t d = interaction[3];
+    chemkit::ForceFieldKernelBatch<MmffTorsionKernel> *torsionBatch =
+        new chemkit::ForceFieldKernelBatch<MmffTorsionKernel>(chemkit::ForceFieldCalculation::Torsion);
+    torsionBatch->reserve(topology->torsionInteractionCount());
 
-        addCalculation(new MmffTorsionCalculation(a, b, c, d));
+    foreach(const chemkit::Topology::TorsionInteraction &interaction, topology->torsionInteractions()){
+        chemkit::Real parameters[MmffTorsionKernel::ParameterCount] = { 0 };
+        bool setup = MmffTorsionCalculation::setup(this, interaction.data(), parameters);
+        torsionBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(torsionBatch);
+
     // van der waals and electrostatic calculations
-    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
-        size_t a = interaction[0];
-        size_t b = interaction[1];
+    m_vanDerWaalsParameters.clear();
 
-        addCalculation(new MmffVanDerWaalsCalculation(a, b));
-        addCalculation(new MmffElectrostaticCalculation(a, b));
-    }
+    if(nonbondedCutoff() > 0){
+        // atom parameters for the nonbonded calculations
+        for(size_t i = 0; i < topology->size(); i++){
+            const MmffVanDerWaalsParameters *parameters = m_parameters->vanDerWaalsParameters(m_typeNumbers[i]);
+            if(!parameters){
+                ok = false;
+            }
 
-    bool ok = true;
+            m_vanDerWaalsParameters.push_back(parameters);
+        }
+
+        addNonbondedCalculationBatch(new chemkit::ForceFieldKernelBatch<MmffVanDerWaalsKernel>(chemkit::ForceFieldCalculation::VanDerWaals));
+        addNonbondedCalculationBatch(new chemkit::ForceFieldKernelBatch<MmffElectrostaticKernel>(chemkit::ForceFieldCalculation::Electrostatic));
+    }
+    else{
+        chemkit::ForceFieldKernelBatch<MmffVanDerWaalsKernel> *vanDerWaalsBatch =
+            new chemkit::ForceFieldKernelBatch<MmffVanDerWaalsKernel>(chemkit::ForceFieldCalculation::VanDerWaals);
+        vanDerWaalsBatch->reserve(topology->nonbondedInteractionCount());
+        chemkit::ForceFieldKernelBatch<MmffElectrostaticKernel> *electrostaticBatch =
+            new chemkit::ForceFieldKernelBatch<MmffElectrostaticKernel>(chemkit::ForceFieldCalculation::Electrostatic);
+        electrostaticBatch->reserve(topology->nonbondedInteractionCount());
 
-    foreach(chemkit::ForceFieldCalculation *calculation, calculations()){
-        bool setup = static_cast<MmffCalculation *>(calculation)->setup(m_parameters);
+        foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+            chemkit::Real vanDerWaalsParameters[MmffVanDerWaalsKernel::ParameterCount] = { 0 };
+            bool setup = MmffVanDerWaalsCalculation::setup(this, interaction.data(), vanDerWaalsParameters);
+            vanDerWaalsBatch->addCalculation(interaction.data(), vanDerWaalsParameters, setup);
+            ok = ok && setup;
 
-        if(!setup){
-            ok = false;
+            chemkit::Real electrostaticParameters[MmffElectrostaticKernel::ParameterCount] = { 0 };
+            setup = MmffElectrostaticCalculation::setup(this, interaction.data(), electrostaticParameters);
+            electrostaticBatch->addCalculation(interaction.data(), electrostaticParameters, setup);
+            ok = ok && setup;
         }
 
-        setCalculationSetup(calculation, setup);
+        addCalculationBatch(vanDerWaalsBatch);
+        addCalculationBatch(electrostaticBatch);
     }
 
     return ok;
@@ -164,3 +230,55 @@ const MmffParameters* MmffForceField::parameters() const
 {
     return m_parameters;
 }
+
+// Returns the numeric mmff type for the atom at index in the topology.
+int MmffForceField::typeNumber(size_t atom) const
+{
+    return m_typeNumbers[atom];
+}
+
+chemkit::ForceFieldCalculation* MmffForceField::createCalculation(int type, const size_t *atoms) const
+{
+    switch(type){
+        case chemkit::ForceFieldCalculation::BondStrech:
+            return new MmffBondStrechCalculation(atoms[0], atoms[1]);
+        case chemkit::ForceFieldCalculation::AngleBend:
+            return new MmffAngleBendCalculation(atoms[0], atoms[1], atoms[2]);
+        case chemkit::ForceFieldCalculation::BondStrech | chemkit::ForceFieldCalculation::AngleBend:
+            return new MmffStrechBendCalculation(atoms[0], atoms[1], atoms[2]);
+        case chemkit::ForceFieldCalculation::Inversion:
+            return new MmffOutOfPlaneBendingCalculation(atoms[0], atoms[1], atoms[2], atoms[3]);
+        case chemkit::ForceFieldCalculation::Torsion:
+            return new MmffTorsionCalculation(atoms[0], atoms[1], atoms[2], atoms[3]);
+        case chemkit::ForceFieldCalculation::VanDerWaals:
+            return new MmffVanDerWaalsCalculation(atoms[0], atoms[1]);
+        case chemkit::ForceFieldCalculation::Electrostatic:
+            return new MmffElectrostaticCalculation(atoms[0], atoms[1]);
+        default:
+            return 0;
+    }
+}
+
+bool MmffForceField::nonbondedParameters(int type, size_t a, size_t b, bool oneFour, chemkit::Real *parameters) const
+{
+    if(type == chemkit::ForceFieldCalculation::VanDerWaals){
+        const MmffVanDerWaalsParameters *parametersA = m_vanDerWaalsParameters[a];
+        const MmffVanDerWaalsParameters *parametersB = m_vanDerWaalsParameters[b];
+        if(!parametersA || !parametersB){
+            return false;
+        }
+
+        MmffVanDerWaalsCalculation::combineParameters(parametersA, parametersB, &parameters[0], &parameters[1]);
+
+        return true;
+    }
+    else if(type == chemkit::ForceFieldCalculation::Electrostatic){
+        parameters[0] = topology()->charge(a);
+        parameters[1] = topology()->charge(b);
+        parameters[2] = oneFour ? 0.75 : 1.0;
+
+        return true;
+    }
+
+    return false;
+}
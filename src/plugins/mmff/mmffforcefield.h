@@ -53,9 +53,16 @@ public:
     // parameterization
     virtual bool setup();
     const MmffParameters* parameters() const;
+    int typeNumber(size_t atom) const;
+
+protected:
+    virtual chemkit::ForceFieldCalculation* createCalculation(int type, const size_t *atoms) const;
+    virtual bool nonbondedParameters(int type, size_t a, size_t b, bool oneFour, chemkit::Real *parameters) const;
 
 private:
     MmffParameters *m_parameters;
+    std::vector<int> m_typeNumbers;
+    std::vector<const MmffVanDerWaalsParameters *> m_vanDerWaalsParameters;
 };
 
 #endif // MMFFFORCEFIELD_H
@@ -0,0 +1,318 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "mmffkernel.h"
+
+#include <chemkit/geometry.h>
+#include <chemkit/cartesiancoordinates.h>
+
+// === MmffBondStrechKernel ================================================ //
+chemkit::Real MmffBondStrechKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+    chemkit::Real dr = r - r0;
+    chemkit::Real cs = -2.0; // cubic strech constant
+
+    // equation 2
+    return 143.9325 * (kb / 2) * (dr*dr) * (1 + cs * dr + ((7.0/12.0)*(cs*cs)) * (dr*dr));
+}
+
+chemkit::Real MmffBondStrechKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+    chemkit::Real dr = r - r0;
+    chemkit::Real cs = -2.0; // cubic strech constant
+
+    // dE/dr
+    chemkit::Real de_dr = 143.9325 * kb * dr * (1 + cs * dr + (7.0/12.0 * (cs*cs) * (dr*dr)) + 0.5 * dr * (cs + (14.0/12.0 * (cs*cs) * dr)));
+
+    boost::array<chemkit::Vector3, 2> ddr = chemkit::geometry::distanceGradient(a, b);
+
+    gradient[atoms[0]] += ddr[0] * de_dr;
+    gradient[atoms[1]] += ddr[1] * de_dr;
+
+    return 143.9325 * (kb / 2) * (dr*dr) * (1 + cs * dr + ((7.0/12.0)*(cs*cs)) * (dr*dr));
+}
+
+// === MmffAngleBendKernel ================================================= //
+chemkit::Real MmffAngleBendKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real ka = parameters[0];
+    chemkit::Real t0 = parameters[1];
+
+    chemkit::Real cb = -0.007; // cubic bend constant
+    chemkit::Real t = chemkit::geometry::angle((*coordinates)[atoms[0]],
+                                               (*coordinates)[atoms[1]],
+                                               (*coordinates)[atoms[2]]);
+    chemkit::Real dt = t - t0;
+
+    // equation 3
+    return 0.043844 * (ka / 2.0) * pow(dt, 2) * (1 + cb * dt);
+}
+
+chemkit::Real MmffAngleBendKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+
+    chemkit::Real ka = parameters[0];
+    chemkit::Real t0 = parameters[1];
+
+    chemkit::Real cb = -0.007; // cubic bend constant
+    chemkit::Real t = chemkit::geometry::angle(a, b, c);
+    chemkit::Real dt = t - t0;
+
+    // dE/dt
+    chemkit::Real de_dt = 0.043844 * ka * dt * (1 + cb * dt + 0.5 * cb * dt);
+
+    boost::array<chemkit::Vector3, 3> ddt = chemkit::geometry::angleGradient(a, b, c);
+
+    gradient[atoms[0]] += ddt[0] * de_dt;
+    gradient[atoms[1]] += ddt[1] * de_dt;
+    gradient[atoms[2]] += ddt[2] * de_dt;
+
+    return 0.043844 * (ka / 2.0) * pow(dt, 2) * (1 + cb * dt);
+}
+
+// === MmffStrechBendKernel ================================================ //
+chemkit::Real MmffStrechBendKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+
+    chemkit::Real kba_ijk = parameters[0];
+    chemkit::Real kba_kji = parameters[1];
+    chemkit::Real r0_ab = parameters[2];
+    chemkit::Real r0_bc = parameters[3];
+    chemkit::Real t0 = parameters[4];
+
+    chemkit::Real r_ab = chemkit::geometry::distance(a, b);
+    chemkit::Real r_bc = chemkit::geometry::distance(b, c);
+    chemkit::Real dr_ab = r_ab - r0_ab;
+    chemkit::Real dr_bc = r_bc - r0_bc;
+    chemkit::Real t = chemkit::geometry::angle(a, b, c);
+    chemkit::Real dt = t - t0;
+
+    // equation 5
+    return 2.51210 * (kba_ijk * dr_ab + kba_kji * dr_bc) * dt;
+}
+
+chemkit::Real MmffStrechBendKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+
+    chemkit::Real kba_ijk = parameters[0];
+    chemkit::Real kba_kji = parameters[1];
+    chemkit::Real r0_ab = parameters[2];
+    chemkit::Real r0_bc = parameters[3];
+    chemkit::Real t0 = parameters[4];
+
+    chemkit::Real r_ab = chemkit::geometry::distance(a, b);
+    chemkit::Real r_bc = chemkit::geometry::distance(b, c);
+    chemkit::Real dr_ab = r_ab - r0_ab;
+    chemkit::Real dr_bc = r_bc - r0_bc;
+    chemkit::Real t = chemkit::geometry::angle(a, b, c);
+    chemkit::Real dt = t - t0;
+
+    boost::array<chemkit::Vector3, 2> distanceGradientAB = chemkit::geometry::distanceGradient(a, b);
+    boost::array<chemkit::Vector3, 2> distanceGradientBC = chemkit::geometry::distanceGradient(b, c);
+    boost::array<chemkit::Vector3, 3> angleGradientABC = chemkit::geometry::angleGradient(a, b, c);
+
+    gradient[atoms[0]] += (distanceGradientAB[0] * kba_ijk * dt + angleGradientABC[0] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
+    gradient[atoms[1]] += ((distanceGradientAB[1] * kba_ijk + distanceGradientBC[0] * kba_kji) * dt + angleGradientABC[1] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
+    gradient[atoms[2]] += ((distanceGradientBC[1] * kba_kji) * dt + angleGradientABC[2] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
+
+    return 2.51210 * (kba_ijk * dr_ab + kba_kji * dr_bc) * dt;
+}
+
+// === MmffOutOfPlaneBendingKernel ========================================= //
+chemkit::Real MmffOutOfPlaneBendingKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real angle = chemkit::geometry::wilsonAngle((*coordinates)[atoms[0]],
+                                                         (*coordinates)[atoms[1]],
+                                                         (*coordinates)[atoms[2]],
+                                                         (*coordinates)[atoms[3]]);
+    chemkit::Real koop = parameters[0];
+
+    // equation 6
+    return 0.043844 * (koop / 2.0) * (angle*angle);
+}
+
+chemkit::Real MmffOutOfPlaneBendingKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+    const chemkit::Point3 &d = (*coordinates)[atoms[3]];
+
+    chemkit::Real angle = chemkit::geometry::wilsonAngle(a, b, c, d);
+    chemkit::Real koop = parameters[0];
+
+    // dE/dw
+    chemkit::Real de_dw = 0.043844 * koop * angle;
+
+    boost::array<chemkit::Vector3, 4> dw = chemkit::geometry::wilsonAngleGradient(a, b, c, d);
+
+    gradient[atoms[0]] += dw[0] * de_dw;
+    gradient[atoms[1]] += dw[1] * de_dw;
+    gradient[atoms[2]] += dw[2] * de_dw;
+    gradient[atoms[3]] += dw[3] * de_dw;
+
+    return 0.043844 * (koop / 2.0) * (angle*angle);
+}
+
+// === MmffTorsionKernel =================================================== //
+chemkit::Real MmffTorsionKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real angle = chemkit::geometry::torsionAngleRadians((*coordinates)[atoms[0]],
+                                                                 (*coordinates)[atoms[1]],
+                                                                 (*coordinates)[atoms[2]],
+                                                                 (*coordinates)[atoms[3]]);
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
+
+    // equation 7
+    return 0.5 * (V1 * (1.0 + cos(angle)) + V2 * (1.0 - cos(2.0 * angle)) + V3 * (1.0 + cos(3.0 * angle)));
+}
+
+chemkit::Real MmffTorsionKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+    const chemkit::Point3 &d = (*coordinates)[atoms[3]];
+
+    chemkit::Real phi = chemkit::geometry::torsionAngleRadians(a, b, c, d);
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
+
+    // dE/dphi
+    chemkit::Real de_dphi = 0.5 * (-V1 * sin(phi) + 2 * V2 * sin(2 * phi) - 3 * V3 * sin(3 * phi));
+
+    boost::array<chemkit::Vector3, 4> dphi = chemkit::geometry::torsionAngleGradientRadians(a, b, c, d);
+
+    gradient[atoms[0]] += dphi[0] * de_dphi;
+    gradient[atoms[1]] += dphi[1] * de_dphi;
+    gradient[atoms[2]] += dphi[2] * de_dphi;
+    gradient[atoms[3]] += dphi[3] * de_dphi;
+
+    return 0.5 * (V1 * (1.0 + cos(phi)) + V2 * (1.0 - cos(2.0 * phi)) + V3 * (1.0 + cos(3.0 * phi)));
+}
+
+// === MmffVanDerWaalsKernel =============================================== //
+chemkit::Real MmffVanDerWaalsKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real rs = parameters[0];
+    chemkit::Real eps = parameters[1];
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+
+    // equation 8
+    return eps * pow(((1.07 * rs) / (r + 0.07 * rs)), 7) * (((1.12 * pow(rs, 7)) / (pow(r, 7) + 0.12 * pow(rs, 7))) - 2);
+}
+
+chemkit::Real MmffVanDerWaalsKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real rs = parameters[0];
+    chemkit::Real eps = parameters[1];
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+
+    // dE/dr
+    chemkit::Real de_dr = 7 * eps * pow(1.07 * rs / (r + 0.07 * rs), 6) *
+                           ((-1.07 * rs / pow(r + 0.07 * rs, 2)) * (1.12 * pow(rs, 7) / (pow(r, 7) + 0.12 * pow(rs, 7)) - 2) +
+                           (-1.12 * pow(rs, 7) * pow(r, 6) / pow(pow(r, 7) + 0.12 * pow(rs, 7), 2)) * (1.07 * rs / (r + 0.07 * rs)));
+
+    boost::array<chemkit::Vector3, 2> dr = chemkit::geometry::distanceGradient(a, b);
+
+    gradient[atoms[0]] += dr[0] * de_dr;
+    gradient[atoms[1]] += dr[1] * de_dr;
+
+    return eps * pow(((1.07 * rs) / (r + 0.07 * rs)), 7) * (((1.12 * pow(rs, 7)) / (pow(r, 7) + 0.12 * pow(rs, 7))) - 2);
+}
+
+// === MmffElectrostaticKernel ============================================= //
+chemkit::Real MmffElectrostaticKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
+    chemkit::Real oneFourScaling = parameters[2];
+
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+    chemkit::Real e = 1.0; // dielectric constant
+    chemkit::Real d = 0.05; // electrostatic buffering constant
+
+    // equation 13
+    return ((332.0716 * qa * qb) / (e * (r + d))) * oneFourScaling;
+}
+
+chemkit::Real MmffElectrostaticKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
+    chemkit::Real oneFourScaling = parameters[2];
+
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+    chemkit::Real e = 1.0; // dielectric constant
+    chemkit::Real d = 0.05; // electrostatic buffering constant
+
+    chemkit::Real de_dr = 332.0716 * qa * qb * oneFourScaling * (-1.0 / (e * pow(r + d, 2)));
+
+    boost::array<chemkit::Vector3, 2> dr = chemkit::geometry::distanceGradient(a, b);
+
+    gradient[atoms[0]] += dr[0] * de_dr;
+    gradient[atoms[1]] += dr[1] * de_dr;
+
+    return ((332.0716 * qa * qb) / (e * (r + d))) * oneFourScaling;
+}
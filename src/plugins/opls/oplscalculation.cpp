@@ -35,12 +35,13 @@
 
 #include "oplscalculation.h"
 
-#include <boost/lexical_cast.hpp>
-
 #include <chemkit/topology.h>
 #include <chemkit/constants.h>
 #include <chemkit/cartesiancoordinates.h>
 
+#include "oplsforcefield.h"
+#include "oplsparameters.h"
+
 // === OplsCalculation ===================================================== //
 OplsCalculation::OplsCalculation(int type, int atomCount, int parameterCount)
     : chemkit::ForceFieldCalculation(type, atomCount, parameterCount)
@@ -55,18 +56,20 @@ OplsBondStrechCalculation::OplsBondStrechCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool OplsBondStrechCalculation::setup(const OplsParameters *parameters)
+bool OplsBondStrechCalculation::setup(const OplsForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    int typeA = boost::lexical_cast<int>(atomType(0));
-    int typeB = boost::lexical_cast<int>(atomType(1));
+    const OplsParameters *oplsParameters = forceField->parameters();
+
+    int typeA = forceField->typeNumber(atoms[0]);
+    int typeB = forceField->typeNumber(atoms[1]);
 
-    const OplsBondStrechParameters *p = parameters->bondStrechParameters(typeA, typeB);
+    const OplsBondStrechParameters *p = oplsParameters->bondStrechParameters(typeA, typeB);
     if(!p){
         return false;
     }
 
-    setParameter(0, p->kb);
-    setParameter(1, p->r0);
+    parameters[0] = p->kb;
+    parameters[1] = p->r0;
 
     return true;
 }
@@ -114,19 +117,21 @@ OplsAngleBendCalculation::OplsAngleBendCalculation(size_t a, size_t b, size_t c)
     setAtom(2, c);
 }
 
-bool OplsAngleBendCalculation::setup(const OplsParameters *parameters)
+bool OplsAngleBendCalculation::setup(const OplsForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    int typeA = boost::lexical_cast<int>(atomType(0));
-    int typeB = boost::lexical_cast<int>(atomType(1));
-    int typeC = boost::lexical_cast<int>(atomType(2));
+    const OplsParameters *oplsParameters = forceField->parameters();
 
-    const OplsAngleBendParameters *p = parameters->angleBendParameters(typeA, typeB, typeC);
+    int typeA = forceField->typeNumber(atoms[0]);
+    int typeB = forceField->typeNumber(atoms[1]);
+    int typeC = forceField->typeNumber(atoms[2]);
+
+    const OplsAngleBendParameters *p = oplsParameters->angleBendParameters(typeA, typeB, typeC);
     if(!p){
         return false;
     }
 
-    setParameter(0, p->ka);
-    setParameter(1, p->theta0 * chemkit::constants::DegreesToRadians);
+    parameters[0] = p->ka;
+    parameters[1] = p->theta0 * chemkit::constants::DegreesToRadians;
 
     return true;
 }
@@ -178,21 +183,23 @@ OplsTorsionCalculation::OplsTorsionCalculation(size_t a, size_t b, size_t c, siz
     setAtom(3, d);
 }
 
-bool OplsTorsionCalculation::setup(const OplsParameters *parameters)
+bool OplsTorsionCalculation::setup(const OplsForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    int typeA = boost::lexical_cast<int>(atomType(0));
-    int typeB = boost::lexical_cast<int>(atomType(1));
-    int typeC = boost::lexical_cast<int>(atomType(2));
-    int typeD = boost::lexical_cast<int>(atomType(3));
+    const OplsParameters *oplsParameters = forceField->parameters();
+
+    int typeA = forceField->typeNumber(atoms[0]);
+    int typeB = forceField->typeNumber(atoms[1]);
+    int typeC = forceField->typeNumber(atoms[2]);
+    int typeD = forceField->typeNumber(atoms[3]);
 
-    const OplsTorsionParameters *p = parameters->torsionParameters(typeA, typeB, typeC, typeD);
+    const OplsTorsionParameters *p = oplsParameters->torsionParameters(typeA, typeB, typeC, typeD);
     if(!p){
         return false;
     }
 
-    setParameter(0, p->v1);
-    setParameter(1, p->v2);
-    setParameter(2, p->v3);
+    parameters[0] = p->v1;
+    parameters[1] = p->v2;
+    parameters[2] = p->v3;
 
     return true;
 }
@@ -247,33 +254,35 @@ OplsNonbondedCalculation::OplsNonbondedCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool OplsNonbondedCalculation::setup(const OplsParameters *parameters)
+bool OplsNonbondedCalculation::setup(const OplsForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    int typeA = boost::lexical_cast<int>(atomType(0));
-    int typeB = boost::lexical_cast<int>(atomType(1));
+    const OplsParameters *oplsParameters = forceField->parameters();
+
+    int typeA = forceField->typeNumber(atoms[0]);
+    int typeB = forceField->typeNumber(atoms[1]);
 
-    const OplsVanDerWaalsParameters *pa = parameters->vanDerWaalsParameters(typeA);
-    const OplsVanDerWaalsParameters *pb = parameters->vanDerWaalsParameters(typeB);
+    const OplsVanDerWaalsParameters *pa = oplsParameters->vanDerWaalsParameters(typeA);
+    const OplsVanDerWaalsParameters *pb = oplsParameters->vanDerWaalsParameters(typeB);
     if(!pa || !pb){
         return false;
     }
 
-    chemkit::Real qa = parameters->partialCharge(typeA);
-    chemkit::Real qb = parameters->partialCharge(typeB);
+    chemkit::Real qa = oplsParameters->partialCharge(typeA);
+    chemkit::Real qb = oplsParameters->partialCharge(typeB);
     chemkit::Real sigma = sqrt(pa->sigma * pb->sigma);
     chemkit::Real epsilon = sqrt(pa->epsilon * pb->epsilon);
 
-    setParameter(0, qa);
-    setParameter(1, qb);
-    setParameter(2, sigma);
-    setParameter(3, epsilon);
+    parameters[0] = qa;
+    parameters[1] = qb;
+    parameters[2] = sigma;
+    parameters[3] = epsilon;
 
     // one-four scaling
-    if(topology()->isOneFour(atom(0), atom(1))){
-        setParameter(4, 0.5);
+    if(forceField->topology()->isOneFour(atoms[0], atoms[1])){
+        parameters[4] = 0.5;
     }
     else{
-        setParameter(4, 1.0);
+        parameters[4] = 1.0;
     }
 
     return true;
@@ -38,13 +38,10 @@
 
 #include <chemkit/forcefieldcalculation.h>
 
-#include "oplsparameters.h"
+class OplsForceField;
 
 class OplsCalculation : public chemkit::ForceFieldCalculation
 {
-public:
-    virtual bool setup(const OplsParameters *parameters) = 0;
-
 protected:
     OplsCalculation(int type, int atomCount, int parameterCount);
 };
@@ -54,7 +51,7 @@ class OplsBondStrechCalculation : public OplsCalculation
 public:
     OplsBondStrechCalculation(size_t a, size_t b);
 
-    bool setup(const OplsParameters *parameters);
+    static bool setup(const OplsForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -64,7 +61,7 @@ class OplsAngleBendCalculation : public OplsCalculation
 public:
     OplsAngleBendCalculation(size_t a, size_t b, size_t c);
 
-    bool setup(const OplsParameters *parameters);
+    static bool setup(const OplsForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -74,7 +71,7 @@ class OplsTorsionCalculation : public OplsCalculation
 public:
     OplsTorsionCalculation(size_t a, size_t b, size_t c, size_t d);
 
-    bool setup(const OplsParameters *parameters);
+    static bool setup(const OplsForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -84,7 +81,7 @@ class OplsNonbondedCalculation : public OplsCalculation
 public:
     OplsNonbondedCalculation(size_t a, size_t b);
 
-    bool setup(const OplsParameters *parameters);
+    static bool setup(const OplsForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
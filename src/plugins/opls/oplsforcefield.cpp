@@ -37,11 +37,14 @@
 
 #include "oplsforcefield.h"
 
+
 #include <chemkit/plugin.h>
 #include <chemkit/foreach.h>
 #include <chemkit/topology.h>
 #include <chemkit/pluginmanager.h>
+#include <chemkit/forcefieldcalculationbatch.h>
 
+#include "oplskernel.h"
 #include "oplsatomtyper.h"
 #include "oplsparameters.h"
 #include "oplscalculation.h"
@@ -72,40 +75,137 @@ bool OplsForceField::setup()
         return false;
     }
 
+    // convert each type name in the topology to its opls type number once
+    m_typeNumbers = topology->typeNumbers();
+
+    bool ok = true;
+
+    // bond strech calculations
+    chemkit::ForceFieldKernelBatch<OplsBondStrechKernel> *bondStrechBatch =
+        new chemkit::ForceFieldKernelBatch<OplsBondStrechKernel>(chemkit::ForceFieldCalculation::BondStrech);
+    bondStrechBatch->reserve(topology->bondedInteractionCount());
+
     foreach(const chemkit::Topology::BondedInteraction &interaction, topology->bondedInteractions()){
-        addCalculation(new OplsBondStrechCalculation(interaction[0],
-                                                     interaction[1]));
+        chemkit::Real parameters[OplsBondStrechKernel::ParameterCount] = { 0 };
+        bool setup = OplsBondStrechCalculation::setup(this, interaction.data(), parameters);
+        bondStrechBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(bondStrechBatch);
+
+    // angle bend calculations
+    chemkit::ForceFieldKernelBatch<OplsAngleBendKernel> *angleBendBatch =
+        new chemkit::ForceFieldKernelBatch<OplsAngleBendKernel>(chemkit::ForceFieldCalculation::AngleBend);
+    angleBendBatch->reserve(topology->angleInteractionCount());
+
     foreach(const chemkit::Topology::AngleInteraction &interaction, topology->angleInteractions()){
-        addCalculation(new OplsAngleBendCalculation(interaction[0],
-                                                    interaction[1],
-                                                    interaction[2]));
+        chemkit::Real parameters[OplsAngleBendKernel::ParameterCount] = { 0 };
+        bool setup = OplsAngleBendCalculation::setup(this, interaction.data(), parameters);
+        angleBendBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(angleBendBatch);
+
+    // torsion calculations
+    chemkit::ForceFieldKernelBatch<OplsTorsionKernel> *torsionBatch =
+        new chemkit::ForceFieldKernelBatch<OplsTorsionKernel>(chemkit::ForceFieldCalculation::Torsion);
+    torsionBatch->reserve(topology->torsionInteractionCount());
+
     foreach(const chemkit::Topology::TorsionInteraction &interaction, topology->torsionInteractions()){
-        addCalculation(new OplsTorsionCalculation(interaction[0],
-                                                  interaction[1],
-                                                  interaction[2],
-                                                  interaction[3]));
+        chemkit::Real parameters[OplsTorsionKernel::ParameterCount] = { 0 };
+        bool setup = OplsTorsionCalculation::setup(this, interaction.data(), parameters);
+        torsionBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
-    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
-        addCalculation(new OplsNonbondedCalculation(interaction[0],
-                                                    interaction[1]));
-    }
+    addCalculationBatch(torsionBatch);
 
-    bool ok = true;
+    // nonbonded calculations
+    m_vanDerWaalsParameters.clear();
+    m_partialCharges.clear();
+
+    if(nonbondedCutoff() > 0){
+        // atom parameters for the nonbonded calculations
+        for(size_t i = 0; i < topology->size(); i++){
+            int type = m_typeNumbers[i];
 
-    foreach(chemkit::ForceFieldCalculation *calculation, calculations()){
-        bool setup = static_cast<OplsCalculation *>(calculation)->setup(m_parameters);
+            const OplsVanDerWaalsParameters *parameters = m_parameters->vanDerWaalsParameters(type);
+            if(!parameters){
+                ok = false;
+            }
 
-        if(!setup){
-            ok = false;
+            m_vanDerWaalsParameters.push_back(parameters);
+            m_partialCharges.push_back(m_parameters->partialCharge(type));
         }
 
-        setCalculationSetup(calculation, setup);
+        addNonbondedCalculationBatch(new chemkit::ForceFieldKernelBatch<OplsNonbondedKernel>(chemkit::ForceFieldCalculation::VanDerWaals | chemkit::ForceFieldCalculation::Electrostatic));
+    }
+    else{
+        chemkit::ForceFieldKernelBatch<OplsNonbondedKernel> *nonbondedBatch =
+            new chemkit::ForceFieldKernelBatch<OplsNonbondedKernel>(chemkit::ForceFieldCalculation::VanDerWaals | chemkit::ForceFieldCalculation::Electrostatic);
+        nonbondedBatch->reserve(topology->nonbondedInteractionCount());
+
+        foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+            chemkit::Real parameters[OplsNonbondedKernel::ParameterCount] = { 0 };
+            bool setup = OplsNonbondedCalculation::setup(this, interaction.data(), parameters);
+            nonbondedBatch->addCalculation(interaction.data(), parameters, setup);
+            ok = ok && setup;
+        }
+
+        addCalculationBatch(nonbondedBatch);
     }
 
     return ok;
 }
+
+const OplsParameters* OplsForceField::parameters() const
+{
+    return m_parameters;
+}
+
+// Returns the numeric opls type for the atom at index in the topology.
+int OplsForceField::typeNumber(size_t atom) const
+{
+    return m_typeNumbers[atom];
+}
+
+chemkit::ForceFieldCalculation* OplsForceField::createCalculation(int type, const size_t *atoms) const
+{
+    switch(type){
+        case chemkit::ForceFieldCalculation::BondStrech:
+            return new OplsBondStrechCalculation(atoms[0], atoms[1]);
+        case chemkit::ForceFieldCalculation::AngleBend:
+            return new OplsAngleBendCalculation(atoms[0], atoms[1], atoms[2]);
+        case chemkit::ForceFieldCalculation::Torsion:
+            return new OplsTorsionCalculation(atoms[0], atoms[1], atoms[2], atoms[3]);
+        case chemkit::ForceFieldCalculation::VanDerWaals | chemkit::ForceFieldCalculation::Electrostatic:
+            return new OplsNonbondedCalculation(atoms[0], atoms[1]);
+        default:
+            return 0;
+    }
+}
+
+bool OplsForceField::nonbondedParameters(int type, size_t a, size_t b, bool oneFour, chemkit::Real *parameters) const
+{
+    if(type != (chemkit::ForceFieldCalculation::VanDerWaals | chemkit::ForceFieldCalculation::Electrostatic)){
+        return false;
+    }
+
+    const OplsVanDerWaalsParameters *pa = m_vanDerWaalsParameters[a];
+    const OplsVanDerWaalsParameters *pb = m_vanDerWaalsParameters[b];
+    if(!pa || !pb){
+        return false;
+    }
+
+    parameters[0] = m_partialCharges[a];
+    parameters[1] = m_partialCharges[b];
+    parameters[2] = sqrt(pa->sigma * pb->sigma);
+    parameters[3] = sqrt(pa->epsilon * pb->epsilon);
+
+    // one-four scaling
+    parameters[4] = oneFour ? 0.5 : 1.0;
+
+    return true;
+}
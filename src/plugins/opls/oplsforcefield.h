@@ -36,9 +36,12 @@
 #ifndef OPLSFORCEFIELD_H
 #define OPLSFORCEFIELD_H
 
+#include <vector>
+
 #include <chemkit/forcefield.h>
 
 class OplsParameters;
+struct OplsVanDerWaalsParameters;
 
 class OplsForceField : public chemkit::ForceField
 {
@@ -49,9 +52,18 @@ public:
 
     // parameterization
     bool setup();
+    const OplsParameters* parameters() const;
+    int typeNumber(size_t atom) const;
+
+protected:
+    chemkit::ForceFieldCalculation* createCalculation(int type, const size_t *atoms) const;
+    bool nonbondedParameters(int type, size_t a, size_t b, bool oneFour, chemkit::Real *parameters) const;
 
 private:
     OplsParameters *m_parameters;
+    std::vector<int> m_typeNumbers;
+    std::vector<const OplsVanDerWaalsParameters *> m_vanDerWaalsParameters;
+    std::vector<chemkit::Real> m_partialCharges;
 };
 
 #endif // OPLSFORCEFIELD_H
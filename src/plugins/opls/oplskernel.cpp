@@ -0,0 +1,190 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "oplskernel.h"
+
+#include <chemkit/geometry.h>
+#include <chemkit/cartesiancoordinates.h>
+
+// === OplsBondStrechKernel ================================================ //
+chemkit::Real OplsBondStrechKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+
+    return kb * pow(r - r0, 2);
+}
+
+chemkit::Real OplsBondStrechKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+
+    boost::array<chemkit::Vector3, 2> dr = chemkit::geometry::distanceGradient(a, b);
+
+    // dE/dr
+    chemkit::Real de_dr = 2.0 * kb * (r - r0);
+
+    gradient[atoms[0]] += dr[0] * de_dr;
+    gradient[atoms[1]] += dr[1] * de_dr;
+
+    return kb * pow(r - r0, 2);
+}
+
+// === OplsAngleBendKernel ================================================= //
+chemkit::Real OplsAngleBendKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
+
+    chemkit::Real theta = chemkit::geometry::angleRadians((*coordinates)[atoms[0]],
+                                                          (*coordinates)[atoms[1]],
+                                                          (*coordinates)[atoms[2]]);
+
+    return ka * pow(theta - theta0, 2);
+}
+
+chemkit::Real OplsAngleBendKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
+
+    chemkit::Real theta = chemkit::geometry::angleRadians(a, b, c);
+
+    boost::array<chemkit::Vector3, 3> dtheta = chemkit::geometry::angleGradientRadians(a, b, c);
+
+    // dE/dtheta
+    chemkit::Real de_dtheta = (2.0 * ka * (theta - theta0));
+
+    gradient[atoms[0]] += dtheta[0] * de_dtheta;
+    gradient[atoms[1]] += dtheta[1] * de_dtheta;
+    gradient[atoms[2]] += dtheta[2] * de_dtheta;
+
+    return ka * pow(theta - theta0, 2);
+}
+
+// === OplsTorsionKernel =================================================== //
+chemkit::Real OplsTorsionKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real v1 = parameters[0];
+    chemkit::Real v2 = parameters[1];
+    chemkit::Real v3 = parameters[2];
+
+    chemkit::Real phi = chemkit::geometry::torsionAngleRadians((*coordinates)[atoms[0]],
+                                                               (*coordinates)[atoms[1]],
+                                                               (*coordinates)[atoms[2]],
+                                                               (*coordinates)[atoms[3]]);
+
+    return (1.0/2.0) * (v1 * (1.0 + cos(phi)) + v2 * (1.0 - cos(2.0 * phi)) + v3 * (1.0 + cos(3.0 * phi)));
+}
+
+chemkit::Real OplsTorsionKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+    const chemkit::Point3 &d = (*coordinates)[atoms[3]];
+
+    chemkit::Real v1 = parameters[0];
+    chemkit::Real v2 = parameters[1];
+    chemkit::Real v3 = parameters[2];
+
+    chemkit::Real phi = chemkit::geometry::torsionAngleRadians(a, b, c, d);
+
+    // dE/dphi
+    chemkit::Real de_dphi = (1.0/2.0) * (-v1 * sin(phi) + 2.0 * v2 * sin(2.0 * phi) - 3.0 * v3 * sin(3.0 * phi));
+
+    boost::array<chemkit::Vector3, 4> dphi = chemkit::geometry::torsionAngleGradientRadians(a, b, c, d);
+
+    gradient[atoms[0]] += dphi[0] * de_dphi;
+    gradient[atoms[1]] += dphi[1] * de_dphi;
+    gradient[atoms[2]] += dphi[2] * de_dphi;
+    gradient[atoms[3]] += dphi[3] * de_dphi;
+
+    return (1.0/2.0) * (v1 * (1.0 + cos(phi)) + v2 * (1.0 - cos(2.0 * phi)) + v3 * (1.0 + cos(3.0 * phi)));
+}
+
+// === OplsNonbondedKernel ================================================= //
+chemkit::Real OplsNonbondedKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
+    chemkit::Real e = 332.06; // vacuum permitivity
+    chemkit::Real sigma = parameters[2];
+    chemkit::Real epsilon = parameters[3];
+    chemkit::Real scale = parameters[4];
+
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+
+    return scale * ((qa * qb * e) / r + 4.0 * epsilon * (pow(sigma / r, 12) - pow(sigma / r, 6)));
+}
+
+chemkit::Real OplsNonbondedKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
+    chemkit::Real e = 332.06; // vacuum permitivity
+    chemkit::Real sigma = parameters[2];
+    chemkit::Real epsilon = parameters[3];
+    chemkit::Real scale = parameters[4];
+
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+    chemkit::Real sr = sigma / r;
+
+    // dE/dr
+    chemkit::Real de_dr = scale * ((1.0 / pow(r, 3)) * (-qa * qb * e + -4.0 * epsilon * sigma * (12.0 * pow(sr, 11) - 6.0 * pow(sr, 5))));
+
+    // dE/da
+    chemkit::Vector3 de_da = (a - b) * de_dr;
+
+    gradient[atoms[0]] += de_da;
+    gradient[atoms[1]] -= de_da;
+
+    return scale * ((qa * qb * e) / r + 4.0 * epsilon * (pow(sr, 12) - pow(sr, 6)));
+}
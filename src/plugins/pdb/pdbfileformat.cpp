@@ -80,20 +80,16 @@ PdbAtom::PdbAtom(const char *data)
     sscanf(&data[31], "%lf%lf%lf", &x, &y, &z);
     position = chemkit::Point3(x, y, z);
 
-    // atomic number
-    std::string symbol;
-    for(int i = 77; i < 79 && isalpha(data[i]); i++){
-        symbol += tolower(data[i]);
+    // atomic number, symbols are in upper case
+    size_t length = 0;
+    while(length < 2 && isalpha(data[77 + length])){
+        length++;
     }
-    boost::trim(symbol);
-    symbol[0] = toupper(symbol[0]);
-    element = chemkit::Element::fromSymbol(symbol);
+    element = chemkit::Element::fromSymbolCaseInsensitive(&data[77], length);
 
     if(!element.isValid()){
         // try atomic number from name
-        symbol = boost::to_lower_copy(name);
-        symbol[0] = toupper(symbol[0]);
-        element = chemkit::Element::fromSymbol(symbol);
+        element = chemkit::Element::fromSymbolCaseInsensitive(name);
     }
 }
 
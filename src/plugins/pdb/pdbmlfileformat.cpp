@@ -138,8 +138,8 @@ bool PdbmlFileFormat::read(std::istream &input, chemkit::PolymerFile *file)
                     atomDataNode = atomDataNode->next_sibling();
                 }
 
-                // add atom and set its data
-                chemkit::Atom *atom = polymer->addAtom(symbol);
+                // add atom and set its data, symbols are in upper case
+                chemkit::Atom *atom = polymer->addAtom(chemkit::Element::fromSymbolCaseInsensitive(symbol));
                 if(atom){
                     // atomic coordinates
                     if(!x.empty() && !y.empty() && !z.empty()){
@@ -54,154 +54,159 @@ PubChemFingerprint::~PubChemFingerprint()
 
 chemkit::Bitset PubChemFingerprint::value(const chemkit::Molecule *molecule) const
 {
-    chemkit::Bitset bitset(881);
+    return packedValue(molecule).toBitset();
+}
+
+chemkit::PackedFingerprint PubChemFingerprint::packedValue(const chemkit::Molecule *molecule) const
+{
+    chemkit::PackedFingerprint fingerprint(881);
 
     // section 1 - hierarchic element counts
     size_t hydrogenCount = molecule->atomCount(chemkit::Atom::Hydrogen);
-    bitset[0] = hydrogenCount >= 4;
-    bitset[1] = hydrogenCount >= 8;
-    bitset[2] = hydrogenCount >= 16;
-    bitset[3] = hydrogenCount >= 32;
+    fingerprint.set(0, hydrogenCount >= 4);
+    fingerprint.set(1, hydrogenCount >= 8);
+    fingerprint.set(2, hydrogenCount >= 16);
+    fingerprint.set(3, hydrogenCount >= 32);
 
     size_t lithiumCount = molecule->atomCount(chemkit::Atom::Lithium);
-    bitset[4] = lithiumCount >= 1;
-    bitset[5] = lithiumCount >= 2;
+    fingerprint.set(4, lithiumCount >= 1);
+    fingerprint.set(5, lithiumCount >= 2);
 
     size_t boronCount = molecule->atomCount(chemkit::Atom::Boron);
-    bitset[6] = boronCount >= 1;
-    bitset[7] = boronCount >= 2;
-    bitset[8] = boronCount >= 4;
+    fingerprint.set(6, boronCount >= 1);
+    fingerprint.set(7, boronCount >= 2);
+    fingerprint.set(8, boronCount >= 4);
 
     size_t carbonCount = molecule->atomCount(chemkit::Atom::Carbon);
-    bitset[9] = carbonCount >= 2;
-    bitset[10] = carbonCount >= 4;
-    bitset[11] = carbonCount >= 8;
-    bitset[12] = carbonCount >= 16;
-    bitset[13] = carbonCount >= 32;
+    fingerprint.set(9, carbonCount >= 2);
+    fingerprint.set(10, carbonCount >= 4);
+    fingerprint.set(11, carbonCount >= 8);
+    fingerprint.set(12, carbonCount >= 16);
+    fingerprint.set(13, carbonCount >= 32);
 
     size_t nitrogenCount = molecule->atomCount(chemkit::Atom::Nitrogen);
-    bitset[14] = nitrogenCount >= 1;
-    bitset[15] = nitrogenCount >= 2;
-    bitset[16] = nitrogenCount >= 4;
-    bitset[17] = nitrogenCount >= 8;
+    fingerprint.set(14, nitrogenCount >= 1);
+    fingerprint.set(15, nitrogenCount >= 2);
+    fingerprint.set(16, nitrogenCount >= 4);
+    fingerprint.set(17, nitrogenCount >= 8);
 
     size_t oxygenCount = molecule->atomCount(chemkit::Atom::Oxygen);
-    bitset[18] = oxygenCount >= 1;
-    bitset[19] = oxygenCount >= 2;
-    bitset[20] = oxygenCount >= 4;
-    bitset[21] = oxygenCount >= 8;
-    bitset[22] = oxygenCount >= 16;
+    fingerprint.set(18, oxygenCount >= 1);
+    fingerprint.set(19, oxygenCount >= 2);
+    fingerprint.set(20, oxygenCount >= 4);
+    fingerprint.set(21, oxygenCount >= 8);
+    fingerprint.set(22, oxygenCount >= 16);
 
     size_t fluorineCount = molecule->atomCount(chemkit::Atom::Fluorine);
-    bitset[23] = fluorineCount >= 1;
-    bitset[24] = fluorineCount >= 2;
-    bitset[25] = fluorineCount >= 4;
+    fingerprint.set(23, fluorineCount >= 1);
+    fingerprint.set(24, fluorineCount >= 2);
+    fingerprint.set(25, fluorineCount >= 4);
 
     size_t sodiumCount = molecule->atomCount(chemkit::Atom::Sodium);
-    bitset[26] = sodiumCount >= 1;
-    bitset[27] = sodiumCount >= 2;
+    fingerprint.set(26, sodiumCount >= 1);
+    fingerprint.set(27, sodiumCount >= 2);
 
     size_t siliconCount = molecule->atomCount(chemkit::Atom::Silicon);
-    bitset[28] = siliconCount >= 1;
-    bitset[29] = siliconCount >= 2;
+    fingerprint.set(28, siliconCount >= 1);
+    fingerprint.set(29, siliconCount >= 2);
 
     size_t phosphorusCount = molecule->atomCount(chemkit::Atom::Phosphorus);
-    bitset[30] = phosphorusCount >= 1;
-    bitset[31] = phosphorusCount >= 2;
-    bitset[32] = phosphorusCount >= 4;
+    fingerprint.set(30, phosphorusCount >= 1);
+    fingerprint.set(31, phosphorusCount >= 2);
+    fingerprint.set(32, phosphorusCount >= 4);
 
     size_t sulfurCount = molecule->atomCount(chemkit::Atom::Sulfur);
-    bitset[33] = sulfurCount >= 1;
-    bitset[34] = sulfurCount >= 2;
-    bitset[35] = sulfurCount >= 4;
-    bitset[36] = sulfurCount >= 8;
+    fingerprint.set(33, sulfurCount >= 1);
+    fingerprint.set(34, sulfurCount >= 2);
+    fingerprint.set(35, sulfurCount >= 4);
+    fingerprint.set(36, sulfurCount >= 8);
 
     size_t chlorineCount = molecule->atomCount(chemkit::Atom::Chlorine);
-    bitset[37] = chlorineCount >= 1;
-    bitset[38] = chlorineCount >= 2;
-    bitset[39] = chlorineCount >= 4;
-    bitset[40] = chlorineCount >= 8;
+    fingerprint.set(37, chlorineCount >= 1);
+    fingerprint.set(38, chlorineCount >= 2);
+    fingerprint.set(39, chlorineCount >= 4);
+    fingerprint.set(40, chlorineCount >= 8);
 
     size_t potassiumCount = molecule->atomCount(chemkit::Atom::Potassium);
-    bitset[41] = potassiumCount >= 1;
-    bitset[42] = potassiumCount >= 2;
+    fingerprint.set(41, potassiumCount >= 1);
+    fingerprint.set(42, potassiumCount >= 2);
 
     size_t bromineCount = molecule->atomCount(chemkit::Atom::Bromine);
-    bitset[43] = bromineCount >= 1;
-    bitset[44] = bromineCount >= 2;
-    bitset[45] = bromineCount >= 4;
+    fingerprint.set(43, bromineCount >= 1);
+    fingerprint.set(44, bromineCount >= 2);
+    fingerprint.set(45, bromineCount >= 4);
 
     size_t iodineCount = molecule->atomCount(chemkit::Atom::Iodine);
-    bitset[46] = iodineCount >= 1;
-    bitset[47] = iodineCount >= 2;
-    bitset[48] = iodineCount >= 4;
+    fingerprint.set(46, iodineCount >= 1);
+    fingerprint.set(47, iodineCount >= 2);
+    fingerprint.set(48, iodineCount >= 4);
 
-    bitset[49] = molecule->contains(chemkit::Atom::Beryllium);
-    bitset[50] = molecule->contains(chemkit::Atom::Magnesium);
-    bitset[51] = molecule->contains(chemkit::Atom::Aluminum);
-    bitset[52] = molecule->contains(chemkit::Atom::Calcium);
-    bitset[53] = molecule->contains(chemkit::Atom::Scandium);
-    bitset[54] = molecule->contains(chemkit::Atom::Titanium);
-    bitset[55] = molecule->contains(chemkit::Atom::Vanadium);
-    bitset[56] = molecule->contains(chemkit::Atom::Chromium);
-    bitset[57] = molecule->contains(chemkit::Atom::Manganese);
-    bitset[58] = molecule->contains(chemkit::Atom::Iron);
-    bitset[59] = molecule->contains(chemkit::Atom::Cobalt);
-    bitset[60] = molecule->contains(chemkit::Atom::Nickel);
-    bitset[61] = molecule->contains(chemkit::Atom::Copper);
-    bitset[62] = molecule->contains(chemkit::Atom::Zinc);
-    bitset[63] = molecule->contains(chemkit::Atom::Gallium);
-    bitset[64] = molecule->contains(chemkit::Atom::Germanium);
-    bitset[65] = molecule->contains(chemkit::Atom::Arsenic);
-    bitset[66] = molecule->contains(chemkit::Atom::Selenium);
-    bitset[67] = molecule->contains(chemkit::Atom::Krypton);
-    bitset[68] = molecule->contains(chemkit::Atom::Rubidium);
-    bitset[69] = molecule->contains(chemkit::Atom::Strontium);
-    bitset[70] = molecule->contains(chemkit::Atom::Yttrium);
-    bitset[71] = molecule->contains(chemkit::Atom::Zirconium);
-    bitset[72] = molecule->contains(chemkit::Atom::Niobium);
-    bitset[73] = molecule->contains(chemkit::Atom::Molybdenum);
-    bitset[74] = molecule->contains(chemkit::Atom::Ruthenium);
-    bitset[75] = molecule->contains(chemkit::Atom::Rhodium);
-    bitset[76] = molecule->contains(chemkit::Atom::Palladium);
-    bitset[77] = molecule->contains(chemkit::Atom::Silver);
-    bitset[78] = molecule->contains(chemkit::Atom::Cadmium);
-    bitset[79] = molecule->contains(chemkit::Atom::Indium);
-    bitset[80] = molecule->contains(chemkit::Atom::Tin);
-    bitset[81] = molecule->contains(chemkit::Atom::Antimony);
-    bitset[82] = molecule->contains(chemkit::Atom::Tellurium);
-    bitset[83] = molecule->contains(chemkit::Atom::Xenon);
-    bitset[84] = molecule->contains(chemkit::Atom::Cesium);
-    bitset[85] = molecule->contains(chemkit::Atom::Barium);
-    bitset[86] = molecule->contains(chemkit::Atom::Lutetium);
-    bitset[87] = molecule->contains(chemkit::Atom::Hafnium);
-    bitset[88] = molecule->contains(chemkit::Atom::Tantalum);
-    bitset[89] = molecule->contains(chemkit::Atom::Tungsten);
-    bitset[90] = molecule->contains(chemkit::Atom::Rhenium);
-    bitset[91] = molecule->contains(chemkit::Atom::Osmium);
-    bitset[92] = molecule->contains(chemkit::Atom::Iridium);
-    bitset[93] = molecule->contains(chemkit::Atom::Platinum);
-    bitset[94] = molecule->contains(chemkit::Atom::Gold);
-    bitset[95] = molecule->contains(chemkit::Atom::Mercury);
-    bitset[96] = molecule->contains(chemkit::Atom::Thallium);
-    bitset[97] = molecule->contains(chemkit::Atom::Lead);
-    bitset[98] = molecule->contains(chemkit::Atom::Bismuth);
-    bitset[99] = molecule->contains(chemkit::Atom::Lanthanum);
-    bitset[100] = molecule->contains(chemkit::Atom::Cerium);
-    bitset[101] = molecule->contains(chemkit::Atom::Praseodymium);
-    bitset[102] = molecule->contains(chemkit::Atom::Neodymium);
-    bitset[103] = molecule->contains(chemkit::Atom::Promethium);
-    bitset[104] = molecule->contains(chemkit::Atom::Samarium);
-    bitset[105] = molecule->contains(chemkit::Atom::Europium);
-    bitset[106] = molecule->contains(chemkit::Atom::Gadolinium);
-    bitset[107] = molecule->contains(chemkit::Atom::Terbium);
-    bitset[108] = molecule->contains(chemkit::Atom::Dysprosium);
-    bitset[109] = molecule->contains(chemkit::Atom::Holmium);
-    bitset[110] = molecule->contains(chemkit::Atom::Erbium);
-    bitset[111] = molecule->contains(chemkit::Atom::Thulium);
-    bitset[112] = molecule->contains(chemkit::Atom::Ytterbium);
-    bitset[113] = molecule->contains(chemkit::Atom::Technetium);
-    bitset[114] = molecule->contains(chemkit::Atom::Uranium);
+    fingerprint.set(49, molecule->contains(chemkit::Atom::Beryllium));
+    fingerprint.set(50, molecule->contains(chemkit::Atom::Magnesium));
+    fingerprint.set(51, molecule->contains(chemkit::Atom::Aluminum));
+    fingerprint.set(52, molecule->contains(chemkit::Atom::Calcium));
+    fingerprint.set(53, molecule->contains(chemkit::Atom::Scandium));
+    fingerprint.set(54, molecule->contains(chemkit::Atom::Titanium));
+    fingerprint.set(55, molecule->contains(chemkit::Atom::Vanadium));
+    fingerprint.set(56, molecule->contains(chemkit::Atom::Chromium));
+    fingerprint.set(57, molecule->contains(chemkit::Atom::Manganese));
+    fingerprint.set(58, molecule->contains(chemkit::Atom::Iron));
+    fingerprint.set(59, molecule->contains(chemkit::Atom::Cobalt));
+    fingerprint.set(60, molecule->contains(chemkit::Atom::Nickel));
+    fingerprint.set(61, molecule->contains(chemkit::Atom::Copper));
+    fingerprint.set(62, molecule->contains(chemkit::Atom::Zinc));
+    fingerprint.set(63, molecule->contains(chemkit::Atom::Gallium));
+    fingerprint.set(64, molecule->contains(chemkit::Atom::Germanium));
+    fingerprint.set(65, molecule->contains(chemkit::Atom::Arsenic));
+    fingerprint.set(66, molecule->contains(chemkit::Atom::Selenium));
+    fingerprint.set(67, molecule->contains(chemkit::Atom::Krypton));
+    fingerprint.set(68, molecule->contains(chemkit::Atom::Rubidium));
+    fingerprint.set(69, molecule->contains(chemkit::Atom::Strontium));
+    fingerprint.set(70, molecule->contains(chemkit::Atom::Yttrium));
+    fingerprint.set(71, molecule->contains(chemkit::Atom::Zirconium));
+    fingerprint.set(72, molecule->contains(chemkit::Atom::Niobium));
+    fingerprint.set(73, molecule->contains(chemkit::Atom::Molybdenum));
+    fingerprint.set(74, molecule->contains(chemkit::Atom::Ruthenium));
+    fingerprint.set(75, molecule->contains(chemkit::Atom::Rhodium));
+    fingerprint.set(76, molecule->contains(chemkit::Atom::Palladium));
+    fingerprint.set(77, molecule->contains(chemkit::Atom::Silver));
+    fingerprint.set(78, molecule->contains(chemkit::Atom::Cadmium));
+    fingerprint.set(79, molecule->contains(chemkit::Atom::Indium));
+    fingerprint.set(80, molecule->contains(chemkit::Atom::Tin));
+    fingerprint.set(81, molecule->contains(chemkit::Atom::Antimony));
+    fingerprint.set(82, molecule->contains(chemkit::Atom::Tellurium));
+    fingerprint.set(83, molecule->contains(chemkit::Atom::Xenon));
+    fingerprint.set(84, molecule->contains(chemkit::Atom::Cesium));
+    fingerprint.set(85, molecule->contains(chemkit::Atom::Barium));
+    fingerprint.set(86, molecule->contains(chemkit::Atom::Lutetium));
+    fingerprint.set(87, molecule->contains(chemkit::Atom::Hafnium));
+    fingerprint.set(88, molecule->contains(chemkit::Atom::Tantalum));
+    fingerprint.set(89, molecule->contains(chemkit::Atom::Tungsten));
+    fingerprint.set(90, molecule->contains(chemkit::Atom::Rhenium));
+    fingerprint.set(91, molecule->contains(chemkit::Atom::Osmium));
+    fingerprint.set(92, molecule->contains(chemkit::Atom::Iridium));
+    fingerprint.set(93, molecule->contains(chemkit::Atom::Platinum));
+    fingerprint.set(94, molecule->contains(chemkit::Atom::Gold));
+    fingerprint.set(95, molecule->contains(chemkit::Atom::Mercury));
+    fingerprint.set(96, molecule->contains(chemkit::Atom::Thallium));
+    fingerprint.set(97, molecule->contains(chemkit::Atom::Lead));
+    fingerprint.set(98, molecule->contains(chemkit::Atom::Bismuth));
+    fingerprint.set(99, molecule->contains(chemkit::Atom::Lanthanum));
+    fingerprint.set(100, molecule->contains(chemkit::Atom::Cerium));
+    fingerprint.set(101, molecule->contains(chemkit::Atom::Praseodymium));
+    fingerprint.set(102, molecule->contains(chemkit::Atom::Neodymium));
+    fingerprint.set(103, molecule->contains(chemkit::Atom::Promethium));
+    fingerprint.set(104, molecule->contains(chemkit::Atom::Samarium));
+    fingerprint.set(105, molecule->contains(chemkit::Atom::Europium));
+    fingerprint.set(106, molecule->contains(chemkit::Atom::Gadolinium));
+    fingerprint.set(107, molecule->contains(chemkit::Atom::Terbium));
+    fingerprint.set(108, molecule->contains(chemkit::Atom::Dysprosium));
+    fingerprint.set(109, molecule->contains(chemkit::Atom::Holmium));
+    fingerprint.set(110, molecule->contains(chemkit::Atom::Erbium));
+    fingerprint.set(111, molecule->contains(chemkit::Atom::Thulium));
+    fingerprint.set(112, molecule->contains(chemkit::Atom::Ytterbium));
+    fingerprint.set(113, molecule->contains(chemkit::Atom::Technetium));
+    fingerprint.set(114, molecule->contains(chemkit::Atom::Uranium));
 
     // section 2 - ring counts
     // TODO
@@ -209,196 +214,196 @@ chemkit::Bitset PubChemFingerprint::value(const chemkit::Molecule *molecule) con
     // section 3 - simple atom pairs
     foreach(const chemkit::Bond *bond, molecule->bonds()){
         if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Hydrogen)){
-            bitset[263] = 1;
+            fingerprint.set(263);
         }
         else if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Lithium)){
-            bitset[264] = 1;
+            fingerprint.set(264);
         }
         else if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Boron)){
-            bitset[265] = 1;
+            fingerprint.set(265);
         }
         else if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Carbon)){
-            bitset[266] = 1;
+            fingerprint.set(266);
         }
         else if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Oxygen)){
-            bitset[267] = 1;
+            fingerprint.set(267);
         }
         else if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Fluorine)){
-            bitset[268] = 1;
+            fingerprint.set(268);
         }
         else if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Phosphorus)){
-            bitset[269] = 1;
+            fingerprint.set(269);
         }
         else if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Sulfur)){
-            bitset[270] = 1;
+            fingerprint.set(270);
         }
         else if(bond->containsBoth(chemkit::Atom::Lithium, chemkit::Atom::Chlorine)){
-            bitset[271] = 1;
+            fingerprint.set(271);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Hydrogen)){
-            bitset[272] = 1;
+            fingerprint.set(272);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Boron)){
-            bitset[273] = 1;
+            fingerprint.set(273);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Carbon)){
-            bitset[274] = 1;
+            fingerprint.set(274);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Nitrogen)){
-            bitset[275] = 1;
+            fingerprint.set(275);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Oxygen)){
-            bitset[276] = 1;
+            fingerprint.set(276);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Fluorine)){
-            bitset[277] = 1;
+            fingerprint.set(277);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Silicon)){
-            bitset[278] = 1;
+            fingerprint.set(278);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Phosphorus)){
-            bitset[279] = 1;
+            fingerprint.set(279);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Sulfur)){
-            bitset[280] = 1;
+            fingerprint.set(280);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Chlorine)){
-            bitset[281] = 1;
+            fingerprint.set(281);
         }
         else if(bond->containsBoth(chemkit::Atom::Boron, chemkit::Atom::Bromine)){
-            bitset[282] = 1;
+            fingerprint.set(282);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Hydrogen)){
-            bitset[283] = 1;
+            fingerprint.set(283);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Carbon)){
-            bitset[284] = 1;
+            fingerprint.set(284);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Nitrogen)){
-            bitset[285] = 1;
+            fingerprint.set(285);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Oxygen)){
-            bitset[286] = 1;
+            fingerprint.set(286);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Fluorine)){
-            bitset[287] = 1;
+            fingerprint.set(287);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Sodium)){
-            bitset[288] = 1;
+            fingerprint.set(288);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Magnesium)){
-            bitset[289] = 1;
+            fingerprint.set(289);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Aluminum)){
-            bitset[290] = 1;
+            fingerprint.set(290);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Silicon)){
-            bitset[291] = 1;
+            fingerprint.set(291);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Phosphorus)){
-            bitset[292] = 1;
+            fingerprint.set(292);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Sulfur)){
-            bitset[293] = 1;
+            fingerprint.set(293);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Chlorine)){
-            bitset[294] = 1;
+            fingerprint.set(294);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Arsenic)){
-            bitset[295] = 1;
+            fingerprint.set(295);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Selenium)){
-            bitset[296] = 1;
+            fingerprint.set(296);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Bromine)){
-            bitset[297] = 1;
+            fingerprint.set(297);
         }
         else if(bond->containsBoth(chemkit::Atom::Carbon, chemkit::Atom::Iodine)){
-            bitset[298] = 1;
+            fingerprint.set(298);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Hydrogen)){
-            bitset[299] = 1;
+            fingerprint.set(299);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Nitrogen)){
-            bitset[300] = 1;
+            fingerprint.set(300);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Oxygen)){
-            bitset[301] = 1;
+            fingerprint.set(301);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Fluorine)){
-            bitset[302] = 1;
+            fingerprint.set(302);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Silicon)){
-            bitset[303] = 1;
+            fingerprint.set(303);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Phosphorus)){
-            bitset[304] = 1;
+            fingerprint.set(304);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Sulfur)){
-            bitset[305] = 1;
+            fingerprint.set(305);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Chlorine)){
-            bitset[306] = 1;
+            fingerprint.set(306);
         }
         else if(bond->containsBoth(chemkit::Atom::Nitrogen, chemkit::Atom::Bromine)){
-            bitset[307] = 1;
+            fingerprint.set(307);
         }
         else if(bond->containsBoth(chemkit::Atom::Oxygen, chemkit::Atom::Hydrogen)){
-            bitset[308] = 1;
+            fingerprint.set(308);
         }
         else if(bond->containsBoth(chemkit::Atom::Oxygen, chemkit::Atom::Oxygen)){
-            bitset[309] = 1;
+            fingerprint.set(309);
         }
         else if(bond->containsBoth(chemkit::Atom::Oxygen, chemkit::Atom::Magnesium)){
-            bitset[310] = 1;
+            fingerprint.set(310);
         }
         else if(bond->containsBoth(chemkit::Atom::Oxygen, chemkit::Atom::Sodium)){
-            bitset[311] = 1;
+            fingerprint.set(311);
         }
         else if(bond->containsBoth(chemkit::Atom::Oxygen, chemkit::Atom::Aluminum)){
-            bitset[312] = 1;
+            fingerprint.set(312);
         }
         else if(bond->containsBoth(chemkit::Atom::Oxygen, chemkit::Atom::Silicon)){
-            bitset[313] = 1;
+            fingerprint.set(313);
         }
         else if(bond->containsBoth(chemkit::Atom::Oxygen, chemkit::Atom::Phosphorus)){
-            bitset[314] = 1;
+            fingerprint.set(314);
         }
         else if(bond->containsBoth(chemkit::Atom::Oxygen, chemkit::Atom::Potassium)){
-            bitset[315] = 1;
+            fingerprint.set(315);
         }
         else if(bond->containsBoth(chemkit::Atom::Fluorine, chemkit::Atom::Phosphorus)){
-            bitset[316] = 1;
+            fingerprint.set(316);
         }
         else if(bond->containsBoth(chemkit::Atom::Fluorine, chemkit::Atom::Sulfur)){
-            bitset[317] = 1;
+            fingerprint.set(317);
         }
         else if(bond->containsBoth(chemkit::Atom::Aluminum, chemkit::Atom::Hydrogen)){
-            bitset[318] = 1;
+            fingerprint.set(318);
         }
         else if(bond->containsBoth(chemkit::Atom::Aluminum, chemkit::Atom::Chlorine)){
-            bitset[319] = 1;
+            fingerprint.set(319);
         }
         else if(bond->containsBoth(chemkit::Atom::Silicon, chemkit::Atom::Hydrogen)){
-            bitset[320] = 1;
+            fingerprint.set(320);
         }
         else if(bond->containsBoth(chemkit::Atom::Silicon, chemkit::Atom::Silicon)){
-            bitset[321] = 1;
+            fingerprint.set(321);
         }
         else if(bond->containsBoth(chemkit::Atom::Silicon, chemkit::Atom::Chlorine)){
-            bitset[322] = 1;
+            fingerprint.set(322);
         }
         else if(bond->containsBoth(chemkit::Atom::Phosphorus, chemkit::Atom::Hydrogen)){
-            bitset[323] = 1;
+            fingerprint.set(323);
         }
         else if(bond->containsBoth(chemkit::Atom::Phosphorus, chemkit::Atom::Phosphorus)){
-            bitset[324] = 1;
+            fingerprint.set(324);
         }
         else if(bond->containsBoth(chemkit::Atom::Arsenic, chemkit::Atom::Hydrogen)){
-            bitset[325] = 1;
+            fingerprint.set(325);
         }
         else if(bond->containsBoth(chemkit::Atom::Arsenic, chemkit::Atom::Arsenic)){
-            bitset[326] = 1;
+            fingerprint.set(326);
         }
     }
 
@@ -414,5 +419,5 @@ chemkit::Bitset PubChemFingerprint::value(const chemkit::Molecule *molecule) con
     // section 7 - complex SMARTS patterns
     // TODO
 
-    return bitset;
+    return fingerprint;
 }
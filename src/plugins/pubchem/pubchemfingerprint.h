@@ -45,6 +45,7 @@ public:
     ~PubChemFingerprint();
 
     chemkit::Bitset value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::PackedFingerprint packedValue(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
 };
 
 #endif // PUBCHEMFINGERPRINT_H
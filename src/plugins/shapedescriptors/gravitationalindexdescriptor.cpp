@@ -51,6 +51,7 @@ GravitationalIndexDescriptor::GravitationalIndexDescriptor()
 chemkit::Variant GravitationalIndexDescriptor::value(const chemkit::Molecule *molecule) const
 {
     chemkit::Real value = 0;
+    std::vector<chemkit::Real> masses = molecule->masses();
 
     for(size_t i = 0; i < molecule->atomCount(); i++){
         const chemkit::Atom *a = molecule->atom(i);
@@ -61,7 +62,7 @@ chemkit::Variant GravitationalIndexDescriptor::value(const chemkit::Molecule *mo
             chemkit::Real r2 = chemkit::geometry::distanceSquared(a->position(),
                                                                   b->position());
 
-            value += (a->mass() * b->mass()) / r2;
+            value += (masses[i] * masses[j]) / r2;
         }
     }
 
@@ -78,6 +79,7 @@ BondedGravitationalIndexDescriptor::BondedGravitationalIndexDescriptor()
 chemkit::Variant BondedGravitationalIndexDescriptor::value(const chemkit::Molecule *molecule) const
 {
     chemkit::Real value = 0;
+    std::vector<chemkit::Real> masses = molecule->masses();
 
     foreach(const chemkit::Bond *bond, molecule->bonds()){
         const chemkit::Atom *a = bond->atom1();
@@ -86,7 +88,7 @@ chemkit::Variant BondedGravitationalIndexDescriptor::value(const chemkit::Molecu
         chemkit::Real r2 = chemkit::geometry::distanceSquared(a->position(),
                                                               b->position());
 
-        value += (a->mass() * b->mass()) / r2;
+        value += (masses[a->index()] * masses[b->index()]) / r2;
     }
 
     return value;
@@ -53,12 +53,13 @@ chemkit::Variant RadiusOfGyrationDescriptor::value(const chemkit::Molecule *mole
 {
     chemkit::Real sum = 0;
     chemkit::Point3 centerOfMass = molecule->centerOfMass();
+    std::vector<chemkit::Real> masses = molecule->masses();
 
-    foreach(const chemkit::Atom *atom, molecule->atoms()){
-        chemkit::Real r2 = chemkit::geometry::distanceSquared(atom->position(),
+    for(size_t i = 0; i < molecule->atomCount(); i++){
+        chemkit::Real r2 = chemkit::geometry::distanceSquared(molecule->atom(i)->position(),
                                                               centerOfMass);
 
-        sum += atom->mass() * r2;
+        sum += masses[i] * r2;
     }
 
     return std::sqrt(sum / molecule->mass());
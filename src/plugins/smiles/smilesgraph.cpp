@@ -212,6 +212,69 @@ void SmilesGraphNode::write(std::stringstream &string, bool kekulize) const
     }
 }
 
+namespace {
+
+// Checks whether two bonded atoms stay connected when the bond between
+// them and all of the ring-closure bonds chosen so far are removed. The
+// visit marks and search stack are indexed by atom and reused between
+// checks.
+class RingClosureCheck
+{
+public:
+    RingClosureCheck(const chemkit::Molecule *molecule)
+        : m_ringBonds(molecule->bondCount(), false),
+          m_visitMarks(molecule->size(), 0),
+          m_visitMark(0)
+    {
+    }
+
+    void addRingBond(const chemkit::Bond *bond)
+    {
+        m_ringBonds[bond->index()] = true;
+    }
+
+    bool isConnectedWithoutBond(const chemkit::Atom *a, const chemkit::Atom *b)
+    {
+        const chemkit::Bond *excludedBond = a->bondTo(b);
+
+        m_visitMark++;
+        m_visitMarks[a->index()] = m_visitMark;
+
+        m_stack.clear();
+        m_stack.push_back(a);
+
+        while(!m_stack.empty()){
+            const chemkit::Atom *atom = m_stack.back();
+            m_stack.pop_back();
+
+            foreach(const chemkit::Bond *bond, atom->bonds()){
+                if(bond == excludedBond || m_ringBonds[bond->index()]){
+                    continue;
+                }
+
+                const chemkit::Atom *neighbor = bond->otherAtom(atom);
+                if(neighbor == b){
+                    return true;
+                }
+                else if(m_visitMarks[neighbor->index()] != m_visitMark){
+                    m_visitMarks[neighbor->index()] = m_visitMark;
+                    m_stack.push_back(neighbor);
+                }
+            }
+        }
+
+        return false;
+    }
+
+private:
+    std::vector<bool> m_ringBonds;
+    std::vector<size_t> m_visitMarks;
+    size_t m_visitMark;
+    std::vector<const chemkit::Atom *> m_stack;
+};
+
+} // end anonymous namespace
+
 // === SmilesGraph ========================================================= //
 SmilesGraph::SmilesGraph(const chemkit::Molecule *molecule)
 {
@@ -220,6 +283,7 @@ SmilesGraph::SmilesGraph(const chemkit::Molecule *molecule)
 
     std::multimap<const chemkit::Atom *, int> ringClosingAtoms;
     std::set<const chemkit::Bond *> ringBonds;
+    RingClosureCheck ringClosureCheck(molecule);
 
     // neighbor count for each atom without implicit hydrogens
     std::vector<int> neighborCounts(molecule->size());
@@ -284,6 +348,11 @@ SmilesGraph::SmilesGraph(const chemkit::Molecule *molecule)
                     else if(neighborCounts[neighbor->index()] <= 1){
                         continue;
                     }
+                    else if(!ringClosureCheck.isConnectedWithoutBond(atom, neighbor)){
+                        // opening a ring at this bond would split the
+                        // remaining atoms into two disconnected parts
+                        continue;
+                    }
 
                     ringClosingAtom = neighbor;
                 }
@@ -295,6 +364,7 @@ SmilesGraph::SmilesGraph(const chemkit::Molecule *molecule)
                 const chemkit::Bond *bond = atom->bondTo(ringClosingAtom);
                 ringClosingAtoms.insert(std::make_pair(ringClosingAtom, ringNumber));
                 ringBonds.insert(bond);
+                ringClosureCheck.addRingBond(bond);
                 parentNode->addRing(ringNumber, bond->order());
 
                 neighborCounts[bond->atom1()->index()]--;
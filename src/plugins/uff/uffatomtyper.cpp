@@ -35,6 +35,8 @@
 
 #include "uffatomtyper.h"
 
+#include "uffparameters.h"
+
 #include <chemkit/atom.h>
 #include <chemkit/bond.h>
 #include <chemkit/molecule.h>
@@ -43,6 +45,12 @@
 UffAtomTyper::UffAtomTyper(const chemkit::Molecule *molecule)
     : chemkit::AtomTyper("uff")
 {
+    // the type ids are the indices of the types in the parameters table
+    UffParameters parameters;
+    for(int i = 0; i < parameters.typeCount(); i++){
+        addType(parameters.parameters(i)->type);
+    }
+
     setMolecule(molecule);
 }
 
@@ -60,17 +68,22 @@ void UffAtomTyper::setMolecule(const chemkit::Molecule *molecule)
         return;
     }
 
-    m_types = std::vector<std::string>(molecule->atomCount());
+    m_types = std::vector<int>(molecule->atomCount());
 
     for(size_t index = 0; index < molecule->size(); index++){
         const chemkit::Atom *atom = molecule->atom(index);
 
-        m_types[index] = atomType(atom);
+        m_types[index] = addType(atomType(atom));
     }
 }
 
 // --- Types --------------------------------------------------------------- //
 std::string UffAtomTyper::type(const chemkit::Atom *atom) const
+{
+    return typeName(m_types[atom->index()]);
+}
+
+int UffAtomTyper::typeId(const chemkit::Atom *atom) const
 {
     return m_types[atom->index()];
 }
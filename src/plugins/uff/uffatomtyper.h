@@ -58,6 +58,7 @@ public:
 
     // types
     std::string type(const chemkit::Atom *atom) const CHEMKIT_OVERRIDE;
+    int typeId(const chemkit::Atom *atom) const CHEMKIT_OVERRIDE;
 
     // interaction types
     int bondedInteractionType(const chemkit::Atom *a, const chemkit::Atom *b) const CHEMKIT_OVERRIDE;
@@ -66,7 +67,7 @@ private:
     std::string atomType(const chemkit::Atom *atom) const;
 
 private:
-    std::vector<std::string> m_types;
+    std::vector<int> m_types;
 };
 
 #endif // UFFATOMTYPER_H
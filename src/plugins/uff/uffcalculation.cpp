@@ -51,20 +51,12 @@ UffCalculation::UffCalculation(int type, int atomCount, int parameterCount)
 {
 }
 
-// Returns the parameters for the given atom.
-const UffAtomParameters* UffCalculation::parameters(const std::string &type) const
-{
-    const UffForceField *forceField = static_cast<const UffForceField *>(this->forceField());
-
-    return forceField->parameters()->parameters(type);
-}
-
 // Returns the bond order of the bond between atom's a and b. If both
 // atoms have a resonant type the bond order returned is 1.5.
 // Otherwise the integer value of the bond order is returned.
-chemkit::Real UffCalculation::bondOrder(size_t a, size_t b) const
+chemkit::Real UffCalculation::bondOrder(const UffForceField *forceField, size_t a, size_t b)
 {
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
 
     int type = topology->bondedInteractionType(a, b);
 
@@ -77,7 +69,7 @@ chemkit::Real UffCalculation::bondOrder(size_t a, size_t b) const
 }
 
 // Returns the length of the bond between two atoms.
-chemkit::Real UffCalculation::bondLength(const UffAtomParameters *a, const UffAtomParameters *b, chemkit::Real bondOrder) const
+chemkit::Real UffCalculation::bondLength(const UffAtomParameters *a, const UffAtomParameters *b, chemkit::Real bondOrder)
 {
     // r_ij = r_i + r_j + r_bo - r_en
     chemkit::Real r_bo = -0.1332 * (a->r + b->r) * log(bondOrder);
@@ -96,17 +88,17 @@ UffBondStrechCalculation::UffBondStrechCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool UffBondStrechCalculation::setup()
+bool UffBondStrechCalculation::setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const UffAtomParameters *pa = parameters(atomType(0));
-    const UffAtomParameters *pb = parameters(atomType(1));
+    const UffAtomParameters *pa = forceField->atomParameters(atoms[0]);
+    const UffAtomParameters *pb = forceField->atomParameters(atoms[1]);
 
     if(!pa || !pb){
         return false;
     }
 
     // n = bondorder (1.5 for aromatic, 1.366 for amide)
-    chemkit::Real bondorder = bondOrder(atom(0), atom(1));
+    chemkit::Real bondorder = bondOrder(forceField, atoms[0], atoms[1]);
 
     chemkit::Real r0 = bondLength(pa, pb, bondorder);
 
@@ -115,8 +107,8 @@ bool UffBondStrechCalculation::setup()
     chemkit::Real zb = pb->Z;
     chemkit::Real kb = 664.12 * (za * zb) / pow(r0, 3);
 
-    setParameter(0, kb);
-    setParameter(1, r0);
+    parameters[0] = kb;
+    parameters[1] = r0;
 
     return true;
 }
@@ -162,11 +154,11 @@ UffAngleBendCalculation::UffAngleBendCalculation(size_t a, size_t b, size_t c)
     setAtom(2, c);
 }
 
-bool UffAngleBendCalculation::setup()
+bool UffAngleBendCalculation::setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const UffAtomParameters *pa = parameters(atomType(0));
-    const UffAtomParameters *pb = parameters(atomType(1));
-    const UffAtomParameters *pc = parameters(atomType(2));
+    const UffAtomParameters *pa = forceField->atomParameters(atoms[0]);
+    const UffAtomParameters *pb = forceField->atomParameters(atoms[1]);
+    const UffAtomParameters *pc = forceField->atomParameters(atoms[2]);
 
     if(!pa || !pb || !pc){
         return false;
@@ -174,8 +166,8 @@ bool UffAngleBendCalculation::setup()
 
     chemkit::Real theta0 = pb->theta * chemkit::constants::DegreesToRadians;
 
-    chemkit::Real bo_ij = bondOrder(atom(0), atom(1));
-    chemkit::Real bo_jk = bondOrder(atom(1), atom(2));
+    chemkit::Real bo_ij = bondOrder(forceField, atoms[0], atoms[1]);
+    chemkit::Real bo_jk = bondOrder(forceField, atoms[1], atoms[2]);
 
     chemkit::Real r_ab = bondLength(pa, pb, bo_ij);
     chemkit::Real r_bc = bondLength(pb, pc, bo_jk);
@@ -189,7 +181,7 @@ bool UffAngleBendCalculation::setup()
     // equation 13
     chemkit::Real ka = beta * ((z_a * z_c) / pow(r_ac, 5)) * r_ab * r_bc * (3.0 * r_ab * r_bc * (1.0 - pow(cos(theta0), 2.0)) - (pow(r_ac, 2.0) * cos(theta0)));
 
-    setParameter(0, ka);
+    parameters[0] = ka;
 
     chemkit::Real sinTheta0 = sin(theta0);
 
@@ -203,9 +195,9 @@ bool UffAngleBendCalculation::setup()
     chemkit::Real c1 = -4 * c2 * cos(theta0);
     chemkit::Real c0 = c2 * (2 * pow(cos(theta0), 2) + 1);
 
-    setParameter(1, c0);
-    setParameter(2, c1);
-    setParameter(3, c2);
+    parameters[1] = c0;
+    parameters[2] = c1;
+    parameters[3] = c2;
 
     return true;
 }
@@ -260,13 +252,12 @@ UffTorsionCalculation::UffTorsionCalculation(size_t a, size_t b, size_t c, size_
     setAtom(3, d);
 }
 
-bool UffTorsionCalculation::setup()
+bool UffTorsionCalculation::setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    UffForceField *forceField = static_cast<UffForceField *>(this->forceField());
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
 
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
     std::string typeB = topology->type(b);
     std::string typeC = topology->type(c);
@@ -275,8 +266,8 @@ bool UffTorsionCalculation::setup()
         return false;
     }
 
-    const UffAtomParameters *pb = parameters(typeB);
-    const UffAtomParameters *pc = parameters(typeC);
+    const UffAtomParameters *pb = forceField->atomParameters(b);
+    const UffAtomParameters *pc = forceField->atomParameters(c);
 
     chemkit::Real V = 0;
     chemkit::Real n = 0;
@@ -286,7 +277,7 @@ bool UffTorsionCalculation::setup()
     if(typeB[2] == '3' && typeC[2] == '3'){
 
         // exception for two group six atoms
-        if(forceField->isGroupSix(atom(1)) && forceField->isGroupSix(atom(2))){
+        if(forceField->isGroupSix(atoms[1]) && forceField->isGroupSix(atoms[2])){
             if(boost::starts_with(typeB, "O_") && boost::starts_with(typeC, "O_")){
                 V = 2; // sqrt(2*2)
             }
@@ -312,7 +303,7 @@ bool UffTorsionCalculation::setup()
     }
     // sp2-sp2
     else if((typeB[2] == '2' || typeB[2] == 'R') && (typeC[2] == '2' || typeC[2] == 'R')){
-        chemkit::Real bondorder = bondOrder(b, c);
+        chemkit::Real bondorder = bondOrder(forceField, b, c);
 
         // equation 17
         V = 5 * sqrt(pb->U * pc->U) * (1 + 4.18 * log(bondorder));
@@ -323,7 +314,7 @@ bool UffTorsionCalculation::setup()
     // group 6 sp3 - any sp2 or R
     else if((forceField->isGroupSix(b) && (typeC[2] == '2' || typeC[2] == 'R')) ||
             (forceField->isGroupSix(c) && (typeB[2] == '2' || typeB[2] == 'R'))){
-        chemkit::Real bondorder = bondOrder(b, c);
+        chemkit::Real bondorder = bondOrder(forceField, b, c);
 
         // equation 17
         V = 5 * sqrt(pb->U * pc->U) * (1 + 4.18 * log(bondorder));
@@ -342,9 +333,9 @@ bool UffTorsionCalculation::setup()
         return false;
     }
 
-    setParameter(0, V);
-    setParameter(1, n);
-    setParameter(2, phi0);
+    parameters[0] = V;
+    parameters[1] = n;
+    parameters[2] = phi0;
 
     return true;
 }
@@ -401,15 +392,15 @@ UffInversionCalculation::UffInversionCalculation(size_t a, size_t b, size_t c, s
     setAtom(3, d);
 }
 
-bool UffInversionCalculation::setup()
+bool UffInversionCalculation::setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const boost::shared_ptr<chemkit::Topology> &topology = this->topology();
+    const boost::shared_ptr<chemkit::Topology> &topology = forceField->topology();
 
     // b is the center atom
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
     std::string typeA = topology->type(a);
     std::string typeB = topology->type(b);
@@ -439,10 +430,10 @@ bool UffInversionCalculation::setup()
     // divide by 3
     k /= 3;
 
-    setParameter(0, k);
-    setParameter(1, c0);
-    setParameter(2, c1);
-    setParameter(3, c2);
+    parameters[0] = k;
+    parameters[1] = c0;
+    parameters[2] = c1;
+    parameters[3] = c2;
 
     return true;
 }
@@ -500,10 +491,10 @@ UffVanDerWaalsCalculation::UffVanDerWaalsCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool UffVanDerWaalsCalculation::setup()
+bool UffVanDerWaalsCalculation::setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
-    const UffAtomParameters *pa = parameters(atomType(0));
-    const UffAtomParameters *pb = parameters(atomType(1));
+    const UffAtomParameters *pa = forceField->atomParameters(atoms[0]);
+    const UffAtomParameters *pb = forceField->atomParameters(atoms[1]);
     if(!pa || !pb){
         return false;
     }
@@ -514,8 +505,8 @@ bool UffVanDerWaalsCalculation::setup()
     // equation 21b
     chemkit::Real x = sqrt(pa->x * pb->x);
 
-    setParameter(0, d);
-    setParameter(1, x);
+    parameters[0] = d;
+    parameters[1] = x;
 
     return true;
 }
@@ -560,8 +551,12 @@ UffElectrostaticCalculation::UffElectrostaticCalculation(size_t a, size_t b)
     setAtom(1, b);
 }
 
-bool UffElectrostaticCalculation::setup()
+bool UffElectrostaticCalculation::setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters)
 {
+    CHEMKIT_UNUSED(forceField);
+    CHEMKIT_UNUSED(atoms);
+    CHEMKIT_UNUSED(parameters);
+
     return false;
 }
 
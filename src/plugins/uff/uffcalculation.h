@@ -40,17 +40,16 @@
 
 #include "uffparameters.h"
 
+class UffForceField;
+
 class UffCalculation : public chemkit::ForceFieldCalculation
 {
 public:
     UffCalculation(int type, int atomCount, int parameterCount);
 
-    virtual bool setup() = 0;
-
 protected:
-    chemkit::Real bondOrder(size_t a,  size_t b) const;
-    chemkit::Real bondLength(const UffAtomParameters *a, const UffAtomParameters *b, chemkit::Real bondOrder) const;
-    const UffAtomParameters* parameters(const std::string &type) const;
+    static chemkit::Real bondOrder(const UffForceField *forceField, size_t a, size_t b);
+    static chemkit::Real bondLength(const UffAtomParameters *a, const UffAtomParameters *b, chemkit::Real bondOrder);
 };
 
 class UffBondStrechCalculation : public UffCalculation
@@ -58,7 +57,7 @@ class UffBondStrechCalculation : public UffCalculation
 public:
     UffBondStrechCalculation(size_t a, size_t b);
 
-    bool setup();
+    static bool setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -68,7 +67,7 @@ class UffAngleBendCalculation : public UffCalculation
 public:
     UffAngleBendCalculation(size_t a, size_t b, size_t c);
 
-    bool setup();
+    static bool setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -78,7 +77,7 @@ class UffTorsionCalculation : public UffCalculation
 public:
     UffTorsionCalculation(size_t a, size_t b, size_t c, size_t d);
 
-    bool setup();
+    static bool setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -88,7 +87,7 @@ class UffInversionCalculation : public UffCalculation
 public:
     UffInversionCalculation(size_t a, size_t b, size_t c, size_t d);
 
-    bool setup();
+    static bool setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -98,7 +97,7 @@ class UffVanDerWaalsCalculation : public UffCalculation
 public:
     UffVanDerWaalsCalculation(size_t a, size_t b);
 
-    bool setup();
+    static bool setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
@@ -108,7 +107,7 @@ class UffElectrostaticCalculation : public UffCalculation
 public:
     UffElectrostaticCalculation(size_t a, size_t b);
 
-    bool setup();
+    static bool setup(const UffForceField *forceField, const size_t *atoms, chemkit::Real *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
 };
 
@@ -43,12 +43,14 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include "uffkernel.h"
 #include "uffatomtyper.h"
 #include "uffparameters.h"
 #include "uffcalculation.h"
 
 #include <chemkit/foreach.h>
 #include <chemkit/topology.h>
+#include <chemkit/forcefieldcalculationbatch.h>
 
 // --- Construction and Destruction ---------------------------------------- //
 UffForceField::UffForceField()
@@ -78,82 +80,193 @@ bool UffForceField::setup()
         return false;
     }
 
+    // look up the parameters and properties for each type once. the
+    // topology may not use the same type ids as the uff atom typer so
+    // each of its types is mapped to the uff type id first
+    std::vector<const UffAtomParameters *> typeParameters(topology->typeCount());
+    std::vector<bool> inversionTypes(topology->typeCount());
+    m_groupSixTypes.assign(topology->typeCount(), false);
+
+    for(size_t type = 0; type < topology->typeCount(); type++){
+        std::string name = topology->typeName(type);
+
+        typeParameters[type] = m_parameters->parameters(m_parameters->typeId(name));
+
+        inversionTypes[type] = boost::starts_with(name, "C_") ||
+                               boost::starts_with(name, "N_") ||
+                               boost::starts_with(name, "P_") ||
+                               boost::starts_with(name, "As") ||
+                               boost::starts_with(name, "Sb") ||
+                               boost::starts_with(name, "Bi");
+
+        m_groupSixTypes[type] = boost::starts_with(name, "O_") ||
+                                boost::starts_with(name, "S_") ||
+                                boost::starts_with(name, "Se") ||
+                                boost::starts_with(name, "Te") ||
+                                boost::starts_with(name, "Po");
+    }
+
+    // atom parameters
+    m_atomParameters.assign(topology->size(), 0);
+
+    for(size_t i = 0; i < topology->size(); i++){
+        int type = topology->typeId(i);
+        if(type != -1){
+            m_atomParameters[i] = typeParameters[type];
+        }
+    }
+
+    bool ok = true;
+
     // bond strech
+    chemkit::ForceFieldKernelBatch<UffBondStrechKernel> *bondStrechBatch =
+        new chemkit::ForceFieldKernelBatch<UffBondStrechKernel>(chemkit::ForceFieldCalculation::BondStrech);
+    bondStrechBatch->reserve(topology->bondedInteractionCount());
+
     foreach(const chemkit::Topology::BondedInteraction &interaction, topology->bondedInteractions()){
-        addCalculation(new UffBondStrechCalculation(interaction[0],
-                                                    interaction[1]));
+        chemkit::Real parameters[UffBondStrechKernel::ParameterCount] = { 0 };
+        bool setup = UffBondStrechCalculation::setup(this, interaction.data(), parameters);
+        bondStrechBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(bondStrechBatch);
+
     // angle bend
+    chemkit::ForceFieldKernelBatch<UffAngleBendKernel> *angleBendBatch =
+        new chemkit::ForceFieldKernelBatch<UffAngleBendKernel>(chemkit::ForceFieldCalculation::AngleBend);
+    angleBendBatch->reserve(topology->angleInteractionCount());
+
     foreach(const chemkit::Topology::AngleInteraction &interaction, topology->angleInteractions()){
-        addCalculation(new UffAngleBendCalculation(interaction[0],
-                                                   interaction[1],
-                                                   interaction[2]));
+        chemkit::Real parameters[UffAngleBendKernel::ParameterCount] = { 0 };
+        bool setup = UffAngleBendCalculation::setup(this, interaction.data(), parameters);
+        angleBendBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(angleBendBatch);
+
     // torsion
+    chemkit::ForceFieldKernelBatch<UffTorsionKernel> *torsionBatch =
+        new chemkit::ForceFieldKernelBatch<UffTorsionKernel>(chemkit::ForceFieldCalculation::Torsion);
+    torsionBatch->reserve(topology->torsionInteractionCount());
+
     foreach(const chemkit::Topology::TorsionInteraction &interaction, topology->torsionInteractions()){
-        addCalculation(new UffTorsionCalculation(interaction[0],
-                                                 interaction[1],
-                                                 interaction[2],
-                                                 interaction[3]));
+        chemkit::Real parameters[UffTorsionKernel::ParameterCount] = { 0 };
+        bool setup = UffTorsionCalculation::setup(this, interaction.data(), parameters);
+        torsionBatch->addCalculation(interaction.data(), parameters, setup);
+        ok = ok && setup;
     }
 
+    addCalculationBatch(torsionBatch);
+
     // inversion
+    chemkit::ForceFieldKernelBatch<UffInversionKernel> *inversionBatch =
+        new chemkit::ForceFieldKernelBatch<UffInversionKernel>(chemkit::ForceFieldCalculation::Inversion);
+    inversionBatch->reserve(3 * topology->improperTorsionInteractionCount());
+
     foreach(const chemkit::Topology::ImproperTorsionInteraction &interaction, topology->improperTorsionInteractions()){
         // type for the center atom
-        std::string typeB = topology->type(interaction[1]);
-
-        if(boost::starts_with(typeB, "C_") ||
-           boost::starts_with(typeB, "N_") ||
-           boost::starts_with(typeB, "P_") ||
-           boost::starts_with(typeB, "As") ||
-           boost::starts_with(typeB, "Sb") ||
-           boost::starts_with(typeB, "Bi")){
-            addCalculation(new UffInversionCalculation(interaction[0],
-                                                       interaction[1],
-                                                       interaction[2],
-                                                       interaction[3]));
-            addCalculation(new UffInversionCalculation(interaction[0],
-                                                       interaction[1],
-                                                       interaction[3],
-                                                       interaction[2]));
-            addCalculation(new UffInversionCalculation(interaction[2],
-                                                       interaction[1],
-                                                       interaction[0],
-                                                       interaction[3]));
+        int typeB = topology->typeId(interaction[1]);
+
+        if(typeB != -1 && inversionTypes[typeB]){
+            const size_t inversions[3][4] = {
+                { interaction[0], interaction[1], interaction[2], interaction[3] },
+                { interaction[0], interaction[1], interaction[3], interaction[2] },
+                { interaction[2], interaction[1], interaction[0], interaction[3] }
+            };
+
+            for(int i = 0; i < 3; i++){
+                chemkit::Real parameters[UffInversionKernel::ParameterCount] = { 0 };
+                bool setup = UffInversionCalculation::setup(this, inversions[i], parameters);
+                inversionBatch->addCalculation(inversions[i], parameters, setup);
+                ok = ok && setup;
+            }
         }
     }
 
-    // van der waals
-    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
-        addCalculation(new UffVanDerWaalsCalculation(interaction[0],
-                                                     interaction[1]));
-    }
+    addCalculationBatch(inversionBatch);
 
-    bool ok = true;
+    // van der waals
+    if(nonbondedCutoff() > 0){
+        // atom parameters for the nonbonded calculations
+        for(size_t i = 0; i < topology->size(); i++){
+            if(!m_atomParameters[i]){
+                ok = false;
+            }
+        }
 
-    foreach(chemkit::ForceFieldCalculation *calculation, calculations()){
-        bool setup = static_cast<UffCalculation *>(calculation)->setup();
+        addNonbondedCalculationBatch(new chemkit::ForceFieldKernelBatch<UffVanDerWaalsKernel>(chemkit::ForceFieldCalculation::VanDerWaals));
+    }
+    else{
+        chemkit::ForceFieldKernelBatch<UffVanDerWaalsKernel> *vanDerWaalsBatch =
+            new chemkit::ForceFieldKernelBatch<UffVanDerWaalsKernel>(chemkit::ForceFieldCalculation::VanDerWaals);
+        vanDerWaalsBatch->reserve(topology->nonbondedInteractionCount());
 
-        if(!setup){
-            ok = false;
+        foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+            chemkit::Real parameters[UffVanDerWaalsKernel::ParameterCount] = { 0 };
+            bool setup = UffVanDerWaalsCalculation::setup(this, interaction.data(), parameters);
+            vanDerWaalsBatch->addCalculation(interaction.data(), parameters, setup);
+            ok = ok && setup;
         }
 
-        setCalculationSetup(calculation, setup);
+        addCalculationBatch(vanDerWaalsBatch);
     }
 
     return ok;
 }
 
+chemkit::ForceFieldCalculation* UffForceField::createCalculation(int type, const size_t *atoms) const
+{
+    switch(type){
+        case chemkit::ForceFieldCalculation::BondStrech:
+            return new UffBondStrechCalculation(atoms[0], atoms[1]);
+        case chemkit::ForceFieldCalculation::AngleBend:
+            return new UffAngleBendCalculation(atoms[0], atoms[1], atoms[2]);
+        case chemkit::ForceFieldCalculation::Torsion:
+            return new UffTorsionCalculation(atoms[0], atoms[1], atoms[2], atoms[3]);
+        case chemkit::ForceFieldCalculation::Inversion:
+            return new UffInversionCalculation(atoms[0], atoms[1], atoms[2], atoms[3]);
+        case chemkit::ForceFieldCalculation::VanDerWaals:
+            return new UffVanDerWaalsCalculation(atoms[0], atoms[1]);
+        default:
+            return 0;
+    }
+}
+
+bool UffForceField::nonbondedParameters(int type, size_t a, size_t b, bool oneFour, chemkit::Real *parameters) const
+{
+    CHEMKIT_UNUSED(oneFour);
+
+    if(type != chemkit::ForceFieldCalculation::VanDerWaals){
+        return false;
+    }
+
+    const UffAtomParameters *pa = m_atomParameters[a];
+    const UffAtomParameters *pb = m_atomParameters[b];
+    if(!pa || !pb){
+        return false;
+    }
+
+    // equation 22
+    parameters[0] = sqrt(pa->D * pb->D);
+
+    // equation 21b
+    parameters[1] = sqrt(pa->x * pb->x);
+
+    return true;
+}
+
+/// Returns the parameters for \p atom.
+const UffAtomParameters* UffForceField::atomParameters(size_t atom) const
+{
+    return m_atomParameters[atom];
+}
+
 /// Returns \c true if \p atom is in group six of the periodic table.
 bool UffForceField::isGroupSix(size_t atom) const
 {
-    std::string type = topology()->type(atom);
+    int type = topology()->typeId(atom);
 
-    return boost::starts_with(type, "O_") ||
-           boost::starts_with(type, "S_") ||
-           boost::starts_with(type, "Se") ||
-           boost::starts_with(type, "Te") ||
-           boost::starts_with(type, "Po");
+    return type != -1 && m_groupSixTypes[type];
 }
@@ -36,9 +36,12 @@
 #ifndef UFFFORCEFIELD_H
 #define UFFFORCEFIELD_H
 
+#include <vector>
+
 #include <chemkit/forcefield.h>
 
 class UffParameters;
+struct UffAtomParameters;
 
 class UffForceField : public chemkit::ForceField
 {
@@ -53,10 +56,17 @@ public:
     // setup
     virtual bool setup();
 
+    const UffAtomParameters* atomParameters(size_t atom) const;
     bool isGroupSix(size_t atom) const;
 
+protected:
+    virtual chemkit::ForceFieldCalculation* createCalculation(int type, const size_t *atoms) const;
+    virtual bool nonbondedParameters(int type, size_t a, size_t b, bool oneFour, chemkit::Real *parameters) const;
+
 private:
     UffParameters *m_parameters;
+    std::vector<const UffAtomParameters *> m_atomParameters;
+    std::vector<bool> m_groupSixTypes;
 };
 
 #endif // UFFFORCEFIELD_H
@@ -0,0 +1,226 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "uffkernel.h"
+
+#include <chemkit/geometry.h>
+#include <chemkit/constants.h>
+#include <chemkit/cartesiancoordinates.h>
+
+// === UffBondStrechKernel ================================================= //
+chemkit::Real UffBondStrechKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+
+    return 0.5 * kb * pow(r - r0, 2);
+}
+
+chemkit::Real UffBondStrechKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+
+    // dE/dr
+    chemkit::Real de_dr = kb * (r - r0);
+
+    boost::array<chemkit::Vector3, 2> dr = chemkit::geometry::distanceGradient(a, b);
+
+    gradient[atoms[0]] += dr[0] * de_dr;
+    gradient[atoms[1]] += dr[1] * de_dr;
+
+    return 0.5 * kb * pow(r - r0, 2);
+}
+
+// === UffAngleBendKernel ================================================== //
+chemkit::Real UffAngleBendKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real ka = parameters[0];
+    chemkit::Real c0 = parameters[1];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
+
+    chemkit::Real theta = chemkit::geometry::angleRadians((*coordinates)[atoms[0]],
+                                                          (*coordinates)[atoms[1]],
+                                                          (*coordinates)[atoms[2]]);
+
+    return ka * (c0 + (c1 * cos(theta)) + (c2 * cos(2*theta)));
+}
+
+chemkit::Real UffAngleBendKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+
+    chemkit::Real ka = parameters[0];
+    chemkit::Real c0 = parameters[1];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
+
+    chemkit::Real theta = chemkit::geometry::angleRadians(a, b, c);
+
+    // dE/dtheta
+    chemkit::Real de_dtheta = -ka * (c1 * sin(theta) + 2 * c2 * sin(2 * theta));
+
+    boost::array<chemkit::Vector3, 3> dtheta = chemkit::geometry::angleGradientRadians(a, b, c);
+
+    gradient[atoms[0]] += dtheta[0] * de_dtheta;
+    gradient[atoms[1]] += dtheta[1] * de_dtheta;
+    gradient[atoms[2]] += dtheta[2] * de_dtheta;
+
+    return ka * (c0 + (c1 * cos(theta)) + (c2 * cos(2*theta)));
+}
+
+// === UffTorsionKernel ==================================================== //
+chemkit::Real UffTorsionKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real V = parameters[0];
+    chemkit::Real n = parameters[1];
+    chemkit::Real phi0 = parameters[2];
+
+    chemkit::Real phi = chemkit::geometry::torsionAngleRadians((*coordinates)[atoms[0]],
+                                                               (*coordinates)[atoms[1]],
+                                                               (*coordinates)[atoms[2]],
+                                                               (*coordinates)[atoms[3]]);
+
+    return 0.5 * V * (1 - cos(n * phi0) * cos(n * phi));
+}
+
+chemkit::Real UffTorsionKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+    const chemkit::Point3 &d = (*coordinates)[atoms[3]];
+
+    chemkit::Real V = parameters[0];
+    chemkit::Real n = parameters[1];
+    chemkit::Real phi0 = parameters[2];
+
+    chemkit::Real phi = chemkit::geometry::torsionAngleRadians(a, b, c, d);
+
+    // dE/dphi
+    chemkit::Real de_dphi = 0.5 * V * n * cos(n * phi0) * sin(n * phi);
+
+    boost::array<chemkit::Vector3, 4> dphi = chemkit::geometry::torsionAngleGradientRadians(a, b, c, d);
+
+    gradient[atoms[0]] += dphi[0] * de_dphi;
+    gradient[atoms[1]] += dphi[1] * de_dphi;
+    gradient[atoms[2]] += dphi[2] * de_dphi;
+    gradient[atoms[3]] += dphi[3] * de_dphi;
+
+    return 0.5 * V * (1 - cos(n * phi0) * cos(n * phi));
+}
+
+// === UffInversionKernel ================================================== //
+chemkit::Real UffInversionKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real k = parameters[0];
+    chemkit::Real c0 = parameters[1];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
+
+    chemkit::Real w = chemkit::geometry::wilsonAngleRadians((*coordinates)[atoms[0]],
+                                                            (*coordinates)[atoms[1]],
+                                                            (*coordinates)[atoms[2]],
+                                                            (*coordinates)[atoms[3]]);
+    chemkit::Real y = w + (chemkit::constants::Pi / 2.0);
+
+    return k * (c0 + c1 * sin(y) + c2 * cos(2 * y));
+}
+
+chemkit::Real UffInversionKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+    const chemkit::Point3 &c = (*coordinates)[atoms[2]];
+    const chemkit::Point3 &d = (*coordinates)[atoms[3]];
+
+    chemkit::Real k = parameters[0];
+    chemkit::Real c0 = parameters[1];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
+
+    chemkit::Real w = chemkit::geometry::wilsonAngleRadians(a, b, c, d);
+    chemkit::Real y = w + (chemkit::constants::Pi / 2.0);
+
+    // dE/dw
+    chemkit::Real de_dw = k * (c1 * cos(y) - 2 * c2 * sin(2 * y));
+
+    boost::array<chemkit::Vector3, 4> dw = chemkit::geometry::wilsonAngleGradientRadians(a, b, c, d);
+
+    gradient[atoms[0]] += dw[0] * de_dw;
+    gradient[atoms[1]] += dw[1] * de_dw;
+    gradient[atoms[2]] += dw[2] * de_dw;
+    gradient[atoms[3]] += dw[3] * de_dw;
+
+    return k * (c0 + c1 * sin(y) + c2 * cos(2 * y));
+}
+
+// === UffVanDerWaalsKernel ================================================ //
+chemkit::Real UffVanDerWaalsKernel::energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters)
+{
+    chemkit::Real d = parameters[0];
+    chemkit::Real x = parameters[1];
+    chemkit::Real r = chemkit::geometry::distance((*coordinates)[atoms[0]], (*coordinates)[atoms[1]]);
+
+    return d * (-2 * pow(x/r, 6) + pow(x/r, 12));
+}
+
+chemkit::Real UffVanDerWaalsKernel::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, std::vector<chemkit::Vector3> &gradient)
+{
+    const chemkit::Point3 &a = (*coordinates)[atoms[0]];
+    const chemkit::Point3 &b = (*coordinates)[atoms[1]];
+
+    chemkit::Real d = parameters[0];
+    chemkit::Real x = parameters[1];
+    chemkit::Real r = chemkit::geometry::distance(a, b);
+
+    // dE/dr
+    chemkit::Real de_dr = -12 * d * x / pow(r, 2) * (pow(x/r, 11) - pow(x/r, 5));
+
+    boost::array<chemkit::Vector3, 2> dr = chemkit::geometry::distanceGradient(a, b);
+
+    gradient[atoms[0]] += dr[0] * de_dr;
+    gradient[atoms[1]] += dr[1] * de_dr;
+
+    return d * (-2 * pow(x/r, 6) + pow(x/r, 12));
+}
@@ -35,6 +35,8 @@
 
 #include "uffparameters.h"
 
+#include <boost/unordered_map.hpp>
+
 namespace {
 
 const UffAtomParameters AtomParameters[] = {
@@ -169,6 +171,33 @@ const UffAtomParameters AtomParameters[] = {
 
 int AtomParametersCount = sizeof(AtomParameters) / sizeof(*AtomParameters);
 
+// Maps each type name to its index in the parameters table.
+class TypeIndex
+{
+public:
+    TypeIndex()
+    {
+        for(int i = 0; i < AtomParametersCount; i++){
+            m_types[AtomParameters[i].type] = i;
+        }
+    }
+
+    int find(const std::string &type) const
+    {
+        boost::unordered_map<std::string, int>::const_iterator iter = m_types.find(type);
+        if(iter == m_types.end()){
+            return -1;
+        }
+
+        return iter->second;
+    }
+
+private:
+    boost::unordered_map<std::string, int> m_types;
+};
+
+const TypeIndex Types;
+
 } // end anonymous namespace
 
 // --- Construction and Destruction ---------------------------------------- //
@@ -181,13 +210,31 @@ UffParameters::~UffParameters()
 }
 
 // --- Parameters ---------------------------------------------------------- //
-const UffAtomParameters* UffParameters::parameters(const std::string &type) const
+// Returns the parameters at index type in the parameters table. The
+// uff atom typer uses the same indices for its type ids.
+const UffAtomParameters* UffParameters::parameters(int type) const
 {
-    for(int i = 0; i < AtomParametersCount; i++){
-        if(type == AtomParameters[i].type){
-            return &AtomParameters[i];
-        }
+    if(type < 0 || type >= AtomParametersCount){
+        return 0;
     }
 
-    return 0;
+    return &AtomParameters[type];
+}
+
+const UffAtomParameters* UffParameters::parameters(const std::string &type) const
+{
+    return parameters(typeId(type));
+}
+
+// Returns the index of the parameters for type in the parameters
+// table or -1 if there are no parameters for type.
+int UffParameters::typeId(const std::string &type) const
+{
+    return Types.find(type);
+}
+
+// Returns the number of types in the parameters table.
+int UffParameters::typeCount() const
+{
+    return AtomParametersCount;
 }
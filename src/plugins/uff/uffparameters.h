@@ -63,7 +63,10 @@ public:
     ~UffParameters();
 
     // parameters
+    const UffAtomParameters* parameters(int type) const;
     const UffAtomParameters* parameters(const std::string &type) const;
+    int typeId(const std::string &type) const;
+    int typeCount() const;
 };
 
 #endif // UFFPARAMETERS_H
@@ -36,6 +36,8 @@
 #include "atomtest.h"
 
 #include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/ring.h>
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
 
@@ -228,6 +230,28 @@ void AtomTest::rings()
             QVERIFY(atom->smallestRing() == benzeneRing);
         }
     }
+
+    // changing a bond order updates the aromaticity
+    chemkit::Atom *C1 = benzeneRing->atom(0);
+    chemkit::Bond *doubleBond = 0;
+    foreach(chemkit::Bond *bond, C1->bonds()){
+        if(bond->order() == chemkit::Bond::Double){
+            doubleBond = bond;
+        }
+    }
+    QVERIFY(doubleBond != 0);
+    doubleBond->setOrder(chemkit::Bond::Single);
+    QCOMPARE(C1->isAromatic(), false);
+    QCOMPARE(C1->isInRing(6), true);
+    doubleBond->setOrder(chemkit::Bond::Double);
+    QCOMPARE(C1->isAromatic(), true);
+
+    // removing a ring bond updates the ring membership
+    benzene.removeBond(doubleBond);
+    QCOMPARE(C1->ringCount(), size_t(0));
+    QCOMPARE(C1->isInRing(), false);
+    QCOMPARE(C1->isAromatic(), false);
+    QVERIFY(C1->smallestRing() == 0);
 }
 
 void AtomTest::position()
@@ -99,6 +99,37 @@ void AtomTyperTest::type()
     delete typer;
 }
 
+void AtomTyperTest::typeIds()
+{
+    chemkit::AtomTyper *typer = chemkit::AtomTyper::create("mock");
+    QVERIFY(typer != 0);
+    QCOMPARE(typer->typeCount(), size_t(0));
+
+    chemkit::Molecule molecule;
+    molecule.addAtom("C");
+    molecule.addAtom("O");
+    molecule.addAtom("C");
+
+    typer->setMolecule(&molecule);
+    int carbon = typer->typeId(molecule.atom(0));
+    int oxygen = typer->typeId(molecule.atom(1));
+    QVERIFY(carbon != oxygen);
+    QCOMPARE(typer->typeId(molecule.atom(2)), carbon);
+    QCOMPARE(typer->typeCount(), size_t(2));
+
+    QCOMPARE(typer->typeName(carbon), std::string("C"));
+    QCOMPARE(typer->typeName(oxygen), std::string("O"));
+    QCOMPARE(typer->typeName(-1), std::string());
+    QCOMPARE(typer->typeName(2), std::string());
+
+    std::vector<std::string> names = typer->typeNames();
+    QCOMPARE(names.size(), size_t(2));
+    QCOMPARE(names[carbon], std::string("C"));
+    QCOMPARE(names[oxygen], std::string("O"));
+
+    delete typer;
+}
+
 void AtomTyperTest::cleanupTestCase()
 {
     delete m_plugin;
@@ -50,6 +50,7 @@ class AtomTyperTest : public QObject
         void name();
         void molecule();
         void type();
+        void typeIds();
         void cleanupTestCase();
 
     private:
@@ -37,6 +37,7 @@
 
 #include <chemkit/atom.h>
 #include <chemkit/bond.h>
+#include <chemkit/ring.h>
 #include <chemkit/chemkit.h>
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
@@ -176,6 +177,20 @@ void BondTest::rings()
             QVERIFY(bond->smallestRing() == benzeneRing);
         }
     }
+
+    // changing an element updates the aromaticity
+    chemkit::Bond *C1C2 = benzeneRing->bond(0);
+    benzeneRing->atom(0)->setAtomicNumber(chemkit::Atom::Oxygen);
+    QCOMPARE(C1C2->isAromatic(), false);
+    QCOMPARE(C1C2->isInRing(), true);
+
+    // removing a ring atom updates the ring membership
+    chemkit::Bond *C4C5 = benzeneRing->bond(3);
+    benzene.removeAtom(benzeneRing->atom(0));
+    QCOMPARE(benzene.ringCount(), size_t(0));
+    QCOMPARE(C4C5->ringCount(), size_t(0));
+    QCOMPARE(C4C5->isInRing(), false);
+    QCOMPARE(C4C5->isAromatic(), false);
 }
 
 void BondTest::polarity()
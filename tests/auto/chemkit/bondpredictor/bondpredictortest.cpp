@@ -36,9 +36,61 @@
 #include "bondpredictortest.h"
 
 #include <chemkit/atom.h>
+#include <chemkit/polymer.h>
 #include <chemkit/molecule.h>
+#include <chemkit/polymerfile.h>
 #include <chemkit/bondpredictor.h>
 
+const std::string dataPath = "../../../data/";
+
+namespace {
+
+// returns the bonds predicted by comparing every pair of atoms
+std::vector<chemkit::BondPredictor::PredictedBond> predictBondsBruteForce(const chemkit::BondPredictor &predictor)
+{
+    std::vector<chemkit::BondPredictor::PredictedBond> bonds;
+
+    const chemkit::Molecule *molecule = predictor.molecule();
+
+    for(size_t i = 0; i < molecule->size(); i++){
+        chemkit::Atom *a = molecule->atom(i);
+
+        for(size_t j = i + 1; j < molecule->size(); j++){
+            chemkit::Atom *b = molecule->atom(j);
+            chemkit::Real distance = a->distance(b);
+
+            if(distance > predictor.minimumBondLength() &&
+               distance < predictor.maximumBondLength() &&
+               std::abs((a->covalentRadius() + b->covalentRadius()) - distance) < predictor.tolerance()){
+                bonds.push_back(boost::make_tuple(a, b, chemkit::Bond::Single));
+            }
+        }
+    }
+
+    return bonds;
+}
+
+// verifies that the predicted bonds match the brute force bonds
+bool compareBonds(const std::vector<chemkit::BondPredictor::PredictedBond> &actual,
+                  const std::vector<chemkit::BondPredictor::PredictedBond> &expected)
+{
+    if(actual.size() != expected.size()){
+        return false;
+    }
+
+    for(size_t i = 0; i < actual.size(); i++){
+        if(boost::get<0>(actual[i]) != boost::get<0>(expected[i]) ||
+           boost::get<1>(actual[i]) != boost::get<1>(expected[i]) ||
+           boost::get<2>(actual[i]) != boost::get<2>(expected[i])){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // end anonymous namespace
+
 void BondPredictorTest::predictBonds()
 {
     // create di-hydrogen molecule
@@ -65,4 +117,55 @@ void BondPredictorTest::predictBonds()
     QCOMPARE(h1->isBondedTo(h2), false);
 }
 
+void BondPredictorTest::hydrolase()
+{
+    chemkit::PolymerFile file(dataPath + "1THM.pdb");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    const boost::shared_ptr<chemkit::Polymer> &protein = file.polymer();
+    QVERIFY(protein);
+    QCOMPARE(protein->size(), size_t(2003));
+
+    chemkit::BondPredictor predictor(protein.get());
+    std::vector<chemkit::BondPredictor::PredictedBond> bonds = predictor.predictedBonds();
+    QCOMPARE(bonds.size(), size_t(2048));
+    QVERIFY(compareBonds(bonds, predictBondsBruteForce(predictor)));
+
+    // a larger tolerance finds more bonds
+    predictor.setTolerance(0.8);
+    bonds = predictor.predictedBonds();
+    QVERIFY(bonds.size() > 2048);
+    QVERIFY(compareBonds(bonds, predictBondsBruteForce(predictor)));
+}
+
+void BondPredictorTest::hemoglobin()
+{
+    chemkit::PolymerFile file(dataPath + "2DHB.pdb");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    const boost::shared_ptr<chemkit::Polymer> &protein = file.polymer();
+    QVERIFY(protein);
+    QCOMPARE(protein->size(), size_t(2201));
+
+    chemkit::BondPredictor predictor(protein.get());
+    std::vector<chemkit::BondPredictor::PredictedBond> bonds = predictor.predictedBonds();
+    QCOMPARE(bonds.size(), size_t(2256));
+    QVERIFY(compareBonds(bonds, predictBondsBruteForce(predictor)));
+
+    // a shorter maximum bond length limits the bonds found
+    predictor.setMaximumBondLength(1.2);
+    bonds = predictor.predictedBonds();
+    QVERIFY(bonds.size() < 2256);
+    QVERIFY(compareBonds(bonds, predictBondsBruteForce(predictor)));
+
+    chemkit::BondPredictor::predictBonds(protein.get());
+    QCOMPARE(protein->bondCount(), size_t(2256));
+}
+
 QTEST_APPLESS_MAIN(BondPredictorTest)
@@ -44,6 +44,8 @@ class BondPredictorTest : public QObject
 
     private slots:
         void predictBonds();
+        void hydrolase();
+        void hemoglobin();
 };
 
 #endif // BONDPREDICTORTEST_H
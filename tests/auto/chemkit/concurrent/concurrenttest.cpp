@@ -0,0 +1,310 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "concurrenttest.h"
+
+#include <chemkit/concurrent.h>
+#include <chemkit/threadpool.h>
+
+namespace {
+
+int square(int value)
+{
+    return value * value;
+}
+
+void increment(boost::mutex *mutex, int *counter)
+{
+    boost::lock_guard<boost::mutex> lock(*mutex);
+    (*counter)++;
+}
+
+void waitFor(boost::shared_future<void> future)
+{
+    future.wait();
+}
+
+void startAndWaitFor(boost::promise<void> *started, boost::shared_future<void> future)
+{
+    started->set_value();
+    future.wait();
+}
+
+bool isEven(int value)
+{
+    return value % 2 == 0;
+}
+
+int nestedSquare(int value)
+{
+    return chemkit::concurrent::run(boost::bind(square, value)).get();
+}
+
+class SetValue
+{
+public:
+    typedef void result_type;
+
+    SetValue(std::vector<int> &values)
+        : m_values(values)
+    {
+    }
+
+    void operator()(size_t index) const
+    {
+        m_values[index] = square(index);
+    }
+
+private:
+    std::vector<int> &m_values;
+};
+
+class NestedSum
+{
+public:
+    typedef void result_type;
+
+    NestedSum(std::vector<int> &sums)
+        : m_sums(sums)
+    {
+    }
+
+    void operator()(size_t index) const
+    {
+        std::vector<int> values(100);
+        chemkit::concurrent::parallel_for(0, values.size(), SetValue(values));
+
+        int sum = 0;
+        for(size_t i = 0; i < values.size(); i++){
+            sum += values[i];
+        }
+        m_sums[index] = sum;
+    }
+
+private:
+    std::vector<int> &m_sums;
+};
+
+class ThrowAt
+{
+public:
+    typedef void result_type;
+
+    void operator()(size_t index) const
+    {
+        if(index == 42){
+            throw std::runtime_error("error");
+        }
+    }
+};
+
+} // end anonymous namespace
+
+void ConcurrentTest::threadPool()
+{
+    chemkit::ThreadPool pool(3);
+    QCOMPARE(pool.threadCount(), size_t(3));
+    QVERIFY(!pool.isWorkerThread());
+
+    boost::mutex mutex;
+    int counter = 0;
+    for(int i = 0; i < 1000; i++){
+        pool.start(boost::bind(increment, &mutex, &counter));
+    }
+
+    pool.waitForDone();
+    QCOMPARE(counter, 1000);
+
+    QVERIFY(chemkit::ThreadPool::globalInstance() != 0);
+    QVERIFY(chemkit::ThreadPool::globalInstance()->threadCount() > 0);
+}
+
+void ConcurrentTest::run()
+{
+    std::vector<boost::shared_future<int> > futures;
+    for(int i = 0; i < 100; i++){
+        futures.push_back(chemkit::concurrent::run(boost::bind(square, i)));
+    }
+
+    for(int i = 0; i < 100; i++){
+        QCOMPARE(futures[i].get(), i * i);
+    }
+}
+
+void ConcurrentTest::cancel()
+{
+    chemkit::concurrent::CancellationToken token;
+    QVERIFY(!token.isCancelled());
+
+    // block each worker thread until the gate is opened
+    boost::promise<void> gate;
+    boost::shared_future<void> gateFuture(gate.get_future());
+    size_t threadCount = chemkit::ThreadPool::globalInstance()->threadCount();
+    for(size_t i = 0; i < threadCount; i++){
+        chemkit::concurrent::run(boost::bind(waitFor, gateFuture));
+    }
+
+    boost::shared_future<int> future =
+        chemkit::concurrent::run(boost::bind(square, 4), token);
+
+    token.cancel();
+    QVERIFY(token.isCancelled());
+    gate.set_value();
+
+    bool cancelled = false;
+    try {
+        future.get();
+    }
+    catch(chemkit::concurrent::CancelledError &){
+        cancelled = true;
+    }
+    QVERIFY(cancelled);
+
+    // cancelled parallel_for
+    std::vector<int> values(1000);
+    cancelled = false;
+    try {
+        chemkit::concurrent::parallel_for(0, values.size(), SetValue(values), token);
+    }
+    catch(chemkit::concurrent::CancelledError &){
+        cancelled = true;
+    }
+    QVERIFY(cancelled);
+}
+
+void ConcurrentTest::cancelRunning()
+{
+    chemkit::concurrent::CancellationToken token;
+
+    boost::promise<void> started;
+    boost::promise<void> gate;
+    boost::shared_future<void> gateFuture(gate.get_future());
+
+    boost::shared_future<void> future =
+        chemkit::concurrent::run(boost::bind(startAndWaitFor, &started, gateFuture), token);
+
+    // cancel the task after it has started
+    started.get_future().wait();
+    token.cancel();
+    gate.set_value();
+
+    bool cancelled = false;
+    try {
+        future.get();
+    }
+    catch(chemkit::concurrent::CancelledError &){
+        cancelled = true;
+    }
+    QVERIFY(cancelled);
+}
+
+void ConcurrentTest::parallel_for()
+{
+    std::vector<int> values(1000, -1);
+    chemkit::concurrent::parallel_for(0, values.size(), SetValue(values));
+
+    for(size_t i = 0; i < values.size(); i++){
+        QCOMPARE(values[i], int(i * i));
+    }
+
+    // empty range
+    chemkit::concurrent::parallel_for(5, 5, SetValue(values));
+}
+
+void ConcurrentTest::parallel_map()
+{
+    std::vector<int> input;
+    for(int i = 0; i < 500; i++){
+        input.push_back(i);
+    }
+
+    std::vector<int> output =
+        chemkit::concurrent::parallel_map(input, std::ptr_fun(square));
+    QCOMPARE(output.size(), input.size());
+
+    for(size_t i = 0; i < output.size(); i++){
+        QCOMPARE(output[i], input[i] * input[i]);
+    }
+
+    // bool results are not written to the packed std::vector<bool>
+    // from several threads
+    std::vector<bool> even =
+        chemkit::concurrent::parallel_map(input, std::ptr_fun(isEven));
+    QCOMPARE(even.size(), input.size());
+
+    for(size_t i = 0; i < even.size(); i++){
+        QCOMPARE(bool(even[i]), input[i] % 2 == 0);
+    }
+}
+
+void ConcurrentTest::nested()
+{
+    std::vector<int> sums(50);
+    chemkit::concurrent::parallel_for(0, sums.size(), NestedSum(sums));
+
+    for(size_t i = 0; i < sums.size(); i++){
+        QCOMPARE(sums[i], 328350);
+    }
+}
+
+void ConcurrentTest::nestedRun()
+{
+    // start more tasks than there are worker threads which each wait
+    // for the result of another task
+    size_t count = 4 * chemkit::ThreadPool::globalInstance()->threadCount();
+
+    std::vector<boost::shared_future<int> > futures;
+    for(size_t i = 0; i < count; i++){
+        futures.push_back(chemkit::concurrent::run(boost::bind(nestedSquare, int(i))));
+    }
+
+    for(size_t i = 0; i < count; i++){
+        QCOMPARE(futures[i].get(), int(i * i));
+    }
+}
+
+void ConcurrentTest::exception()
+{
+    bool thrown = false;
+    try {
+        chemkit::concurrent::parallel_for(0, 100, ThrowAt());
+    }
+    catch(std::runtime_error &){
+        thrown = true;
+    }
+    QVERIFY(thrown);
+}
+
+QTEST_APPLESS_MAIN(ConcurrentTest)
@@ -35,6 +35,8 @@
 
 #include "elementtest.h" 
 
+#include <algorithm>
+
 #include <chemkit/element.h>
 
 void ElementTest::symbol()
@@ -125,6 +127,31 @@ void ElementTest::fromName()
              chemkit::Element::AtomicNumberType(0));
     QCOMPARE(chemkit::Element::fromName("").atomicNumber(),
              chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromName("carbon").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromName("Carbo").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromName("Carbons").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+
+    for(int i = 1; chemkit::Element::isValidAtomicNumber(i); i++){
+        chemkit::Element element(i);
+        QVERIFY(chemkit::Element::fromName(element.name()) == element);
+    }
+}
+
+void ElementTest::fromNameCaseInsensitive()
+{
+    QCOMPARE(chemkit::Element::fromNameCaseInsensitive("carbon").atomicNumber(),
+             chemkit::Element::AtomicNumberType(6));
+    QCOMPARE(chemkit::Element::fromNameCaseInsensitive("OXYGEN").atomicNumber(),
+             chemkit::Element::AtomicNumberType(8));
+    QCOMPARE(chemkit::Element::fromNameCaseInsensitive("Oxygen").atomicNumber(),
+             chemkit::Element::AtomicNumberType(8));
+    QCOMPARE(chemkit::Element::fromNameCaseInsensitive("oxygen ").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromNameCaseInsensitive("").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
 }
 
 void ElementTest::fromSymbol()
@@ -143,6 +170,44 @@ void ElementTest::fromSymbol()
              chemkit::Element::AtomicNumberType(26));
     QCOMPARE(chemkit::Element::fromSymbol("S", 1).atomicNumber(),
              chemkit::Element::AtomicNumberType(16));
+    QCOMPARE(chemkit::Element::fromSymbol("Uuo").atomicNumber(),
+             chemkit::Element::AtomicNumberType(118));
+    QCOMPARE(chemkit::Element::fromSymbol("CL").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromSymbol("cl").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromSymbol("C1").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromSymbol("Xx").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+
+    for(int i = 1; chemkit::Element::isValidAtomicNumber(i); i++){
+        chemkit::Element element(i);
+        QVERIFY(chemkit::Element::fromSymbol(element.symbol()) == element);
+    }
+}
+
+void ElementTest::fromSymbolCaseInsensitive()
+{
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("CL").atomicNumber(),
+             chemkit::Element::AtomicNumberType(17));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("fe").atomicNumber(),
+             chemkit::Element::AtomicNumberType(26));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("c").atomicNumber(),
+             chemkit::Element::AtomicNumberType(6));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("ZNX", 2).atomicNumber(),
+             chemkit::Element::AtomicNumberType(30));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive(" C").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+
+    for(int i = 1; chemkit::Element::isValidAtomicNumber(i); i++){
+        chemkit::Element element(i);
+        std::string symbol = element.symbol();
+        std::transform(symbol.begin(), symbol.end(), symbol.begin(), ::toupper);
+        QVERIFY(chemkit::Element::fromSymbolCaseInsensitive(symbol) == element);
+    }
 }
 
 void ElementTest::isValidAtomicNumber()
@@ -53,7 +53,9 @@ class ElementTest : public QObject
         void expectedValence();
         void isMetal();
         void fromName();
+        void fromNameCaseInsensitive();
         void fromSymbol();
+        void fromSymbolCaseInsensitive();
         void isValidAtomicNumber();
         void isValidSymbol();
 };
@@ -0,0 +1,285 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "fingerprintdatabasetest.h"
+
+#include <algorithm>
+
+#include <boost/lexical_cast.hpp>
+
+#include <chemkit/molecule.h>
+#include <chemkit/fingerprint.h>
+#include <chemkit/fingerprintdatabase.h>
+
+namespace {
+
+typedef chemkit::FingerprintDatabase::Hit Hit;
+
+// Returns a random fingerprint with a random density of set bits.
+chemkit::PackedFingerprint randomFingerprint(size_t size, unsigned int &state)
+{
+    chemkit::PackedFingerprint fingerprint(size);
+
+    state = state * 1103515245 + 12345;
+    unsigned int density = 1 + (state >> 16) % 50;
+
+    for(size_t i = 0; i < size; i++){
+        state = state * 1103515245 + 12345;
+        if((state >> 16) % 100 < density){
+            fingerprint.set(i);
+        }
+    }
+
+    return fingerprint;
+}
+
+bool compareHits(const Hit &a, const Hit &b)
+{
+    if(a.second != b.second){
+        return a.second > b.second;
+    }
+
+    return a.first < b.first;
+}
+
+// Returns the similarity of each fingerprint in the database to the
+// query sorted by decreasing similarity.
+std::vector<Hit> bruteForce(const chemkit::FingerprintDatabase &database,
+                            const chemkit::PackedFingerprint &query)
+{
+    std::vector<Hit> hits;
+
+    for(size_t i = 0; i < database.size(); i++){
+        hits.push_back(Hit(i, chemkit::Fingerprint::tanimotoCoefficient(query, database.fingerprint(i))));
+    }
+
+    std::sort(hits.begin(), hits.end(), compareHits);
+
+    return hits;
+}
+
+} // end anonymous namespace
+
+void FingerprintDatabaseTest::basic()
+{
+    chemkit::FingerprintDatabase database;
+    QCOMPARE(database.size(), size_t(0));
+    QCOMPARE(database.isEmpty(), true);
+    QCOMPARE(database.fingerprint(), std::string());
+    QCOMPARE(database.fingerprintSize(), size_t(0));
+
+    QCOMPARE(database.setFingerprintSize(128), true);
+    QCOMPARE(database.fingerprintSize(), size_t(128));
+
+    chemkit::FingerprintDatabase fp2Database("fp2");
+    if(fp2Database.fingerprint().empty()){
+        QSKIP("fp2 fingerprint not available", SkipSingle);
+    }
+
+    QCOMPARE(fp2Database.fingerprint(), std::string("fp2"));
+    QCOMPARE(fp2Database.fingerprintSize(), size_t(1021));
+
+    chemkit::Molecule ethanol("CCO", "smiles");
+    ethanol.setName("ethanol");
+    QCOMPARE(fp2Database.addMolecule(&ethanol), true);
+    QCOMPARE(fp2Database.size(), size_t(1));
+    QCOMPARE(fp2Database.identifier(0), std::string("ethanol"));
+    QVERIFY(fp2Database.fingerprint(0).toBitset() == ethanol.fingerprint("fp2"));
+}
+
+void FingerprintDatabaseTest::fingerprints()
+{
+    chemkit::FingerprintDatabase database;
+
+    unsigned int state = 1;
+    std::vector<chemkit::PackedFingerprint> fingerprints;
+    for(size_t i = 0; i < 50; i++){
+        fingerprints.push_back(randomFingerprint(300, state));
+        QCOMPARE(database.addFingerprint(fingerprints.back(), boost::lexical_cast<std::string>(i)), true);
+    }
+
+    QCOMPARE(database.size(), size_t(50));
+    QCOMPARE(database.fingerprintSize(), size_t(300));
+    QCOMPARE(database.setFingerprintSize(100), false);
+
+    for(size_t i = 0; i < 50; i++){
+        QVERIFY(database.fingerprint(i) == fingerprints[i]);
+        QCOMPARE(database.identifier(i), boost::lexical_cast<std::string>(i));
+    }
+
+    // fingerprints with a different size are rejected
+    QCOMPARE(database.addFingerprint(chemkit::PackedFingerprint(200)), false);
+    QCOMPARE(database.size(), size_t(50));
+
+    database.clear();
+    QCOMPARE(database.size(), size_t(0));
+    QCOMPARE(database.fingerprintSize(), size_t(300));
+}
+
+void FingerprintDatabaseTest::search()
+{
+    chemkit::FingerprintDatabase database;
+
+    unsigned int state = 7;
+    for(size_t i = 0; i < 500; i++){
+        database.addFingerprint(randomFingerprint(881, state));
+    }
+
+    for(size_t q = 0; q < 5; q++){
+        chemkit::PackedFingerprint query = randomFingerprint(881, state);
+        std::vector<Hit> expected = bruteForce(database, query);
+
+        for(int t = 0; t <= 10; t++){
+            chemkit::Real threshold = t / 10.0;
+
+            std::vector<Hit> hits = database.search(query, threshold);
+
+            size_t count = 0;
+            while(count < expected.size() && expected[count].second >= threshold){
+                count++;
+            }
+
+            QCOMPARE(hits.size(), count);
+            QVERIFY(std::equal(hits.begin(), hits.end(), expected.begin()));
+        }
+    }
+
+    // a fingerprint in the database is its own best match
+    std::vector<Hit> hits = database.search(database.fingerprint(42), 1.0);
+    QVERIFY(!hits.empty());
+    QCOMPARE(hits[0].second, chemkit::Real(1));
+}
+
+void FingerprintDatabaseTest::nearestNeighbors()
+{
+    chemkit::FingerprintDatabase database;
+
+    unsigned int state = 3;
+    for(size_t i = 0; i < 500; i++){
+        database.addFingerprint(randomFingerprint(1021, state));
+    }
+
+    for(size_t q = 0; q < 5; q++){
+        chemkit::PackedFingerprint query = randomFingerprint(1021, state);
+        std::vector<Hit> expected = bruteForce(database, query);
+
+        for(size_t k = 0; k <= 20; k += 5){
+            std::vector<Hit> hits = database.nearestNeighbors(query, k);
+            QCOMPARE(hits.size(), k);
+            QVERIFY(std::equal(hits.begin(), hits.end(), expected.begin()));
+        }
+    }
+
+    // k larger than the database returns every fingerprint
+    QCOMPARE(database.nearestNeighbors(database.fingerprint(0), 1000).size(), size_t(500));
+}
+
+void FingerprintDatabaseTest::batch()
+{
+    chemkit::FingerprintDatabase database;
+
+    unsigned int state = 11;
+    for(size_t i = 0; i < 200; i++){
+        database.addFingerprint(randomFingerprint(512, state));
+    }
+
+    std::vector<chemkit::PackedFingerprint> queries;
+    for(size_t i = 0; i < 16; i++){
+        queries.push_back(randomFingerprint(512, state));
+    }
+
+    std::vector<std::vector<Hit> > results = database.search(queries, 0.3);
+    QCOMPARE(results.size(), queries.size());
+    for(size_t i = 0; i < queries.size(); i++){
+        QVERIFY(results[i] == database.search(queries[i], 0.3));
+    }
+
+    results = database.nearestNeighbors(queries, 5);
+    QCOMPARE(results.size(), queries.size());
+    for(size_t i = 0; i < queries.size(); i++){
+        QVERIFY(results[i] == database.nearestNeighbors(queries[i], 5));
+    }
+}
+
+void FingerprintDatabaseTest::empty()
+{
+    chemkit::FingerprintDatabase database;
+    chemkit::PackedFingerprint query(64);
+    QCOMPARE(database.search(query, 0.5).size(), size_t(0));
+    QCOMPARE(database.nearestNeighbors(query, 5).size(), size_t(0));
+
+    // empty fingerprints have a similarity of zero
+    database.addFingerprint(chemkit::PackedFingerprint(64));
+    database.addFingerprint(chemkit::PackedFingerprint(64));
+    QCOMPARE(database.search(query, 0.5).size(), size_t(0));
+    QCOMPARE(database.search(query, 0.0).size(), size_t(2));
+    QCOMPARE(database.nearestNeighbors(query, 1).size(), size_t(1));
+}
+
+void FingerprintDatabaseTest::querySize()
+{
+    chemkit::FingerprintDatabase database;
+
+    unsigned int state = 5;
+    for(size_t i = 0; i < 100; i++){
+        database.addFingerprint(randomFingerprint(256, state));
+    }
+
+    // queries with a different size than the database have no hits
+    std::vector<chemkit::PackedFingerprint> queries;
+    queries.push_back(randomFingerprint(64, state));
+    queries.push_back(randomFingerprint(1024, state));
+    queries.push_back(randomFingerprint(256, state));
+
+    for(size_t i = 0; i < 2; i++){
+        QCOMPARE(database.search(queries[i], 0.0).size(), size_t(0));
+        QCOMPARE(database.nearestNeighbors(queries[i], 5).size(), size_t(0));
+    }
+
+    std::vector<std::vector<Hit> > results = database.search(queries, 0.0);
+    QCOMPARE(results.size(), size_t(3));
+    QCOMPARE(results[0].size(), size_t(0));
+    QCOMPARE(results[1].size(), size_t(0));
+    QCOMPARE(results[2].size(), size_t(100));
+
+    results = database.nearestNeighbors(queries, 5);
+    QCOMPARE(results.size(), size_t(3));
+    QCOMPARE(results[0].size(), size_t(0));
+    QCOMPARE(results[1].size(), size_t(0));
+    QCOMPARE(results[2].size(), size_t(5));
+}
+
+QTEST_APPLESS_MAIN(FingerprintDatabaseTest)
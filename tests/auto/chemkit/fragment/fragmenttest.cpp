@@ -37,9 +37,83 @@
 
 #include <algorithm>
 
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/foreach.h>
 #include <chemkit/fragment.h>
 #include <chemkit/molecule.h>
 
+namespace {
+
+// returns the number of fragments in molecule found by a depth-first
+// search and checks that each fragment contains the right atoms
+size_t countFragments(const chemkit::Molecule &molecule)
+{
+    std::vector<size_t> components(molecule.atomCount(), size_t(-1));
+    size_t count = 0;
+
+    for(size_t i = 0; i < molecule.atomCount(); i++){
+        if(components[i] != size_t(-1)){
+            continue;
+        }
+
+        std::vector<const chemkit::Atom *> stack(1, molecule.atom(i));
+        components[i] = count;
+
+        while(!stack.empty()){
+            const chemkit::Atom *atom = stack.back();
+            stack.pop_back();
+
+            foreach(const chemkit::Atom *neighbor, atom->neighbors()){
+                if(components[neighbor->index()] == size_t(-1)){
+                    components[neighbor->index()] = count;
+                    stack.push_back(neighbor);
+                }
+            }
+        }
+
+        count++;
+    }
+
+    // fragments are ordered by their first atom and contain their
+    // atoms in order
+    size_t previous = 0;
+    foreach(const chemkit::Fragment *fragment, molecule.fragments()){
+        if(fragment->atom(0)->index() < previous){
+            return size_t(-1);
+        }
+        previous = fragment->atom(0)->index();
+
+        for(size_t i = 0; i < fragment->atomCount(); i++){
+            const chemkit::Atom *atom = fragment->atom(i);
+
+            if(atom->fragment() != fragment ||
+               components[atom->index()] != components[fragment->atom(0)->index()] ||
+               (i > 0 && atom->index() <= fragment->atom(i - 1)->index())){
+                return size_t(-1);
+            }
+        }
+    }
+
+    for(size_t i = 0; i < molecule.atomCount(); i++){
+        const chemkit::Atom *atom = molecule.atom(i);
+
+        for(size_t j = 0; j < molecule.atomCount(); j += 7){
+            const chemkit::Atom *other = molecule.atom(j);
+            bool connected = components[i] == components[j];
+
+            if(atom->isConnectedTo(other) != connected ||
+               atom->fragment()->contains(other) != connected){
+                return size_t(-1);
+            }
+        }
+    }
+
+    return count;
+}
+
+} // end anonymous namespace
+
 void FragmentTest::basic()
 {
     chemkit::Molecule waters;
@@ -133,4 +207,89 @@ void FragmentTest::bonds()
     QVERIFY(std::find(C2_bonds.begin(), C2_bonds.end(), C2_C3) != C2_bonds.end());
 }
 
+void FragmentTest::edits()
+{
+    chemkit::Molecule molecule;
+
+    // a chain of atoms with a ring at every fifth atom
+    for(size_t i = 0; i < 50; i++){
+        chemkit::Atom *atom = molecule.addAtom("C");
+
+        if(i > 0){
+            molecule.addBond(molecule.atom(i - 1), atom);
+        }
+        if(i >= 5 && i % 5 == 0){
+            molecule.addBond(molecule.atom(i - 3), atom);
+        }
+    }
+    QCOMPARE(molecule.fragmentCount(), size_t(1));
+    QCOMPARE(molecule.isFragmented(), false);
+    QCOMPARE(countFragments(molecule), size_t(1));
+
+    // removing a ring bond keeps the fragment connected
+    molecule.removeBond(molecule.atom(9), molecule.atom(10));
+    QCOMPARE(molecule.fragmentCount(), size_t(1));
+    QCOMPARE(countFragments(molecule), size_t(1));
+
+    // removing a chain bond splits the fragment
+    molecule.removeBond(molecule.atom(20), molecule.atom(21));
+    QCOMPARE(molecule.fragmentCount(), size_t(2));
+    QCOMPARE(molecule.isFragmented(), true);
+    QCOMPARE(countFragments(molecule), size_t(2));
+    QCOMPARE(molecule.atom(0)->fragment()->atomCount(), size_t(21));
+    QCOMPARE(molecule.atom(49)->fragment()->atomCount(), size_t(29));
+    QCOMPARE(molecule.atom(0)->fragment()->bondCount(), size_t(23));
+
+    // removing an atom removes its bonds and renumbers the others
+    molecule.removeAtom(molecule.atom(30));
+    QCOMPARE(molecule.fragmentCount(), size_t(3));
+    QCOMPARE(countFragments(molecule), size_t(3));
+
+    // bonds join fragments together again
+    molecule.addBond(molecule.atom(0), molecule.atom(48));
+    molecule.addBond(molecule.atom(20), molecule.atom(21));
+    QCOMPARE(molecule.fragmentCount(), size_t(1));
+    QCOMPARE(countFragments(molecule), size_t(1));
+
+    // interleave removals and additions with queries
+    unsigned int seed = 42;
+    for(size_t i = 0; i < 200; i++){
+        seed = seed * 1103515245 + 12345;
+        size_t a = (seed >> 8) % molecule.atomCount();
+        seed = seed * 1103515245 + 12345;
+        size_t b = (seed >> 8) % molecule.atomCount();
+
+        if(i % 3 == 0 && molecule.bondCount() > 0){
+            molecule.removeBond(molecule.bond((seed >> 4) % molecule.bondCount()));
+        }
+        else if(i % 17 == 0){
+            molecule.removeAtom(molecule.atom(a));
+            molecule.addAtom("N");
+        }
+        else{
+            molecule.addBond(molecule.atom(a), molecule.atom(b));
+        }
+
+        QCOMPARE(countFragments(molecule), molecule.fragmentCount());
+        QCOMPARE(molecule.fragments().size(), molecule.fragmentCount());
+    }
+
+    // atoms removed together in an edit
+    molecule.beginEdit();
+    for(size_t i = 0; i < molecule.atomCount(); i += 4){
+        molecule.removeAtom(molecule.atom(i));
+    }
+    molecule.endEdit();
+    QCOMPARE(countFragments(molecule), molecule.fragmentCount());
+
+    // fragments are copied with the molecule
+    chemkit::Molecule copy(molecule);
+    QCOMPARE(copy.fragmentCount(), molecule.fragmentCount());
+    QCOMPARE(countFragments(copy), copy.fragmentCount());
+
+    molecule.clear();
+    QCOMPARE(molecule.fragmentCount(), size_t(0));
+    QCOMPARE(molecule.isFragmented(), false);
+}
+
 QTEST_APPLESS_MAIN(FragmentTest)
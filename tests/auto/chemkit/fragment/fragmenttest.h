@@ -48,6 +48,7 @@ class FragmentTest : public QObject
         void atoms();
         void contains();
         void bonds();
+        void edits();
 };
 
 #endif // FRAGMENTTEST_H
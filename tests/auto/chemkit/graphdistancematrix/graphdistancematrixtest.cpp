@@ -0,0 +1,185 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "graphdistancematrixtest.h"
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/molecule.h>
+#include <chemkit/graphsnapshot.h>
+#include <chemkit/graphdistancematrix.h>
+
+void GraphDistanceMatrixTest::empty()
+{
+    chemkit::GraphDistanceMatrix matrix;
+    QCOMPARE(matrix.size(), size_t(0));
+    QCOMPARE(matrix.isEmpty(), true);
+    QCOMPARE(matrix.diameter(), 0);
+    QCOMPARE(matrix.radius(), 0);
+
+    chemkit::Molecule molecule;
+    QCOMPARE(molecule.graphDistanceMatrix()->size(), size_t(0));
+}
+
+void GraphDistanceMatrixTest::ethanol()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *O3 = molecule.addAtom("O");
+    chemkit::Atom *H4 = molecule.addAtom("H");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, O3);
+    molecule.addBond(O3, H4);
+
+    chemkit::GraphSnapshot graph(&molecule);
+    chemkit::GraphDistanceMatrix matrix(graph);
+    QCOMPARE(matrix.size(), size_t(4));
+    QCOMPARE(matrix.elementSize(), size_t(1));
+
+    QCOMPARE(matrix.distance(0, 0), 0);
+    QCOMPARE(matrix.distance(0, 1), 1);
+    QCOMPARE(matrix.distance(0, 2), 2);
+    QCOMPARE(matrix.distance(0, 3), 3);
+    QCOMPARE(matrix.distance(3, 0), 3);
+    QCOMPARE(matrix.distance(1, 3), 2);
+    QCOMPARE(matrix.isReachable(0, 3), true);
+
+    QCOMPARE(matrix.eccentricity(0), 3);
+    QCOMPARE(matrix.eccentricity(1), 2);
+    QCOMPARE(matrix.eccentricity(2), 2);
+    QCOMPARE(matrix.eccentricity(3), 3);
+    QCOMPARE(matrix.diameter(), 3);
+    QCOMPARE(matrix.radius(), 2);
+}
+
+void GraphDistanceMatrixTest::fragments()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *O1 = molecule.addAtom("O");
+    chemkit::Atom *H2 = molecule.addAtom("H");
+    chemkit::Atom *H3 = molecule.addAtom("H");
+    molecule.addAtom("Na");
+    molecule.addBond(O1, H2);
+    molecule.addBond(O1, H3);
+
+    boost::shared_ptr<const chemkit::GraphDistanceMatrix> matrix = molecule.graphDistanceMatrix();
+    QCOMPARE(matrix->distance(1, 2), 2);
+    QCOMPARE(matrix->distance(0, 3), -1);
+    QCOMPARE(matrix->distance(3, 1), -1);
+    QCOMPARE(matrix->isReachable(2, 3), false);
+    QCOMPARE(matrix->distance(3, 3), 0);
+
+    // eccentricities only include reachable atoms
+    QCOMPARE(matrix->eccentricity(0), 1);
+    QCOMPARE(matrix->eccentricity(3), 0);
+    QCOMPARE(matrix->diameter(), 2);
+    QCOMPARE(matrix->radius(), 0);
+}
+
+void GraphDistanceMatrixTest::chain()
+{
+    // distances longer than 254 bonds need two bytes each
+    chemkit::Molecule molecule;
+    chemkit::Atom *previous = molecule.addAtom("C");
+    for(int i = 1; i < 300; i++){
+        chemkit::Atom *atom = molecule.addAtom("C");
+        molecule.addBond(previous, atom);
+        previous = atom;
+    }
+
+    boost::shared_ptr<const chemkit::GraphDistanceMatrix> matrix = molecule.graphDistanceMatrix();
+    QCOMPARE(matrix->size(), size_t(300));
+    QCOMPARE(matrix->elementSize(), size_t(2));
+    QCOMPARE(matrix->distance(0, 299), 299);
+    QCOMPARE(matrix->distance(299, 0), 299);
+    QCOMPARE(matrix->distance(10, 265), 255);
+    QCOMPARE(matrix->distance(150, 150), 0);
+    QCOMPARE(matrix->eccentricity(0), 299);
+    QCOMPARE(matrix->eccentricity(150), 150);
+    QCOMPARE(matrix->diameter(), 299);
+    QCOMPARE(matrix->radius(), 150);
+}
+
+void GraphDistanceMatrixTest::star()
+{
+    // large graphs with short distances use one byte per distance
+    chemkit::Molecule molecule;
+    chemkit::Atom *center = molecule.addAtom("C");
+    for(int i = 0; i < 400; i++){
+        molecule.addBond(center, molecule.addAtom("H"));
+    }
+
+    boost::shared_ptr<const chemkit::GraphDistanceMatrix> matrix = molecule.graphDistanceMatrix();
+    QCOMPARE(matrix->size(), size_t(401));
+    QCOMPARE(matrix->elementSize(), size_t(1));
+    QCOMPARE(matrix->distance(0, 400), 1);
+    QCOMPARE(matrix->distance(1, 400), 2);
+    QCOMPARE(matrix->diameter(), 2);
+    QCOMPARE(matrix->radius(), 1);
+}
+
+void GraphDistanceMatrixTest::invalidation()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    chemkit::Bond *C1_C2 = molecule.addBond(C1, C2);
+    molecule.addBond(C2, C3);
+
+    boost::shared_ptr<const chemkit::GraphDistanceMatrix> matrix = molecule.graphDistanceMatrix();
+    QCOMPARE(matrix->distance(0, 2), 2);
+
+    // the matrix is shared until the graph changes
+    QVERIFY(molecule.graphDistanceMatrix() == matrix);
+
+    // changing a bond order does not change any distances
+    C1_C2->setOrder(2);
+    QVERIFY(molecule.graphDistanceMatrix() == matrix);
+
+    molecule.addBond(C1, C3);
+    QVERIFY(molecule.graphDistanceMatrix() != matrix);
+    QCOMPARE(molecule.graphDistanceMatrix()->distance(0, 2), 1);
+
+    // the old matrix is unchanged
+    QCOMPARE(matrix->distance(0, 2), 2);
+
+    molecule.removeAtom(C2);
+    QCOMPARE(molecule.graphDistanceMatrix()->size(), size_t(2));
+    QCOMPARE(molecule.graphDistanceMatrix()->distance(0, 1), 1);
+}
+
+QTEST_APPLESS_MAIN(GraphDistanceMatrixTest)
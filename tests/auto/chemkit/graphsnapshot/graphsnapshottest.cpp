@@ -0,0 +1,172 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "graphsnapshottest.h"
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/molecule.h>
+#include <chemkit/graphsnapshot.h>
+
+void GraphSnapshotTest::empty()
+{
+    chemkit::GraphSnapshot graph;
+    QCOMPARE(graph.size(), size_t(0));
+    QCOMPARE(graph.isEmpty(), true);
+    QCOMPARE(graph.edgeCount(), size_t(0));
+    QCOMPARE(graph.offsets().size(), size_t(1));
+
+    chemkit::Molecule molecule;
+    QCOMPARE(molecule.graphSnapshot()->size(), size_t(0));
+}
+
+void GraphSnapshotTest::ethanol()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *O3 = molecule.addAtom("O");
+    chemkit::Atom *H4 = molecule.addAtom("H");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, O3, chemkit::Bond::Double);
+    molecule.addBond(O3, H4);
+
+    chemkit::GraphSnapshot graph(&molecule);
+    QCOMPARE(graph.size(), size_t(4));
+    QCOMPARE(graph.vertexCount(), size_t(4));
+    QCOMPARE(graph.edgeCount(), size_t(3));
+    QCOMPARE(graph.offsets().size(), size_t(5));
+    QCOMPARE(graph.neighborIndices().size(), size_t(6));
+    QCOMPARE(graph.bondIndices().size(), size_t(6));
+    QCOMPARE(graph.bondOrders().size(), size_t(6));
+
+    QCOMPARE(graph.degree(0), size_t(1));
+    QCOMPARE(graph.degree(1), size_t(2));
+    QCOMPARE(graph.degree(2), size_t(2));
+    QCOMPARE(graph.degree(3), size_t(1));
+
+    // neighbors are in the same order as the atom's bonds
+    QCOMPARE(graph.neighbors(1).size(), size_t(2));
+    QCOMPARE(graph.neighbors(1)[0], size_t(0));
+    QCOMPARE(graph.neighbors(1)[1], size_t(2));
+    QCOMPARE(graph.bonds(1)[0], size_t(0));
+    QCOMPARE(graph.bonds(1)[1], size_t(1));
+
+    QCOMPARE(graph.isAdjacent(0, 1), true);
+    QCOMPARE(graph.isAdjacent(1, 0), true);
+    QCOMPARE(graph.isAdjacent(0, 2), false);
+    QCOMPARE(graph.bondIndex(2, 3), size_t(2));
+    QCOMPARE(graph.bondIndex(0, 3), size_t(chemkit::GraphSnapshot::NullIndex));
+    QCOMPARE(graph.bondOrder(1, 2), chemkit::Bond::BondOrderType(2));
+    QCOMPARE(graph.bondOrder(2, 1), chemkit::Bond::BondOrderType(2));
+    QCOMPARE(graph.bondOrder(0, 1), chemkit::Bond::BondOrderType(1));
+    QCOMPARE(graph.bondOrder(0, 3), chemkit::Bond::BondOrderType(0));
+}
+
+void GraphSnapshotTest::subgraph()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *O3 = molecule.addAtom("O");
+    chemkit::Atom *H4 = molecule.addAtom("H");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, O3);
+    molecule.addBond(O3, H4);
+
+    std::vector<chemkit::Atom *> atoms;
+    atoms.push_back(O3);
+    atoms.push_back(C2);
+    atoms.push_back(H4);
+
+    chemkit::GraphSnapshot graph(atoms);
+    QCOMPARE(graph.size(), size_t(3));
+    QCOMPARE(graph.edgeCount(), size_t(2));
+    QCOMPARE(graph.degree(0), size_t(2));
+    QCOMPARE(graph.degree(1), size_t(1));
+    QCOMPARE(graph.degree(2), size_t(1));
+    QCOMPARE(graph.isAdjacent(0, 1), true);
+    QCOMPARE(graph.isAdjacent(0, 2), true);
+    QCOMPARE(graph.isAdjacent(1, 2), false);
+
+    // bond indices refer to the bonds in the molecule
+    QCOMPARE(graph.bondIndex(0, 1), size_t(1));
+    QCOMPARE(graph.bondIndex(0, 2), size_t(2));
+}
+
+void GraphSnapshotTest::invalidation()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Bond *C1_C2 = molecule.addBond(C1, C2);
+
+    boost::shared_ptr<const chemkit::GraphSnapshot> graph = molecule.graphSnapshot();
+    QCOMPARE(graph->edgeCount(), size_t(1));
+
+    // the snapshot is shared until the molecule changes
+    QVERIFY(molecule.graphSnapshot() == graph);
+    C1->setPartialCharge(0.5);
+    QVERIFY(molecule.graphSnapshot() == graph);
+
+    // changing a bond order creates a new snapshot
+    C1_C2->setOrder(chemkit::Bond::Double);
+    QVERIFY(molecule.graphSnapshot() != graph);
+    QCOMPARE(molecule.graphSnapshot()->bondOrder(0, 1), chemkit::Bond::BondOrderType(2));
+
+    // the old snapshot is not modified
+    QCOMPARE(graph->bondOrder(0, 1), chemkit::Bond::BondOrderType(1));
+
+    // adding atoms and bonds creates a new snapshot
+    graph = molecule.graphSnapshot();
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    QVERIFY(molecule.graphSnapshot() != graph);
+    QCOMPARE(molecule.graphSnapshot()->size(), size_t(3));
+
+    graph = molecule.graphSnapshot();
+    molecule.addBond(C2, C3);
+    QVERIFY(molecule.graphSnapshot() != graph);
+    QCOMPARE(molecule.graphSnapshot()->edgeCount(), size_t(2));
+
+    // removing atoms creates a new snapshot
+    graph = molecule.graphSnapshot();
+    molecule.removeAtom(C1);
+    QVERIFY(molecule.graphSnapshot() != graph);
+    QCOMPARE(molecule.graphSnapshot()->size(), size_t(2));
+    QCOMPARE(molecule.graphSnapshot()->edgeCount(), size_t(1));
+    QCOMPARE(molecule.graphSnapshot()->isAdjacent(0, 1), true);
+}
+
+QTEST_APPLESS_MAIN(GraphSnapshotTest)
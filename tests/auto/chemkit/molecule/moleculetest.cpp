@@ -35,13 +35,21 @@
 
 #include "moleculetest.h"
 
+#include <sstream>
+#include <utility>
+
 #include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
 
 #include <chemkit/atom.h>
 #include <chemkit/bond.h>
+#include <chemkit/ring.h>
 #include <chemkit/chemkit.h>
+#include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
+#include <chemkit/threadpool.h>
+#include <chemkit/concurrent.h>
 #include <chemkit/cartesiancoordinates.h>
 
 void MoleculeTest::name()
@@ -98,6 +106,60 @@ void MoleculeTest::mass()
     QCOMPARE(molecule.mass(), chemkit::Real(0.0));
 }
 
+void MoleculeTest::atomProperties()
+{
+    chemkit::Molecule molecule;
+    QVERIFY(molecule.masses().empty());
+    QVERIFY(molecule.partialCharges().empty());
+
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *O2 = molecule.addAtom("O");
+    chemkit::Atom *H3 = molecule.addAtom("H");
+    O2->setPartialCharge(-0.5);
+    H3->setPartialCharge(0.5);
+    H3->setMassNumber(2);
+    C1->setChirality(chemkit::Stereochemistry::R);
+
+    std::vector<chemkit::Real> masses = molecule.masses();
+    QCOMPARE(masses.size(), size_t(3));
+    QCOMPARE(masses[0], C1->mass());
+    QCOMPARE(masses[1], O2->mass());
+    QCOMPARE(masses[2], H3->mass());
+
+    std::vector<chemkit::Real> charges = molecule.partialCharges();
+    QCOMPARE(charges.size(), size_t(3));
+    QCOMPARE(charges[0], chemkit::Real(0.0));
+    QCOMPARE(charges[1], chemkit::Real(-0.5));
+    QCOMPARE(charges[2], chemkit::Real(0.5));
+
+    std::vector<chemkit::Real> radii = molecule.covalentRadii();
+    QCOMPARE(radii.size(), size_t(3));
+    QCOMPARE(radii[1], O2->covalentRadius());
+    radii = molecule.vanDerWaalsRadii();
+    QCOMPARE(radii.size(), size_t(3));
+    QCOMPARE(radii[2], H3->vanDerWaalsRadius());
+
+    // properties follow their atoms when other atoms are removed
+    molecule.removeAtom(O2);
+    QCOMPARE(H3->massNumber(), chemkit::Atom::MassNumberType(2));
+    QCOMPARE(H3->partialCharge(), chemkit::Real(0.5));
+    QCOMPARE(C1->massNumber(), chemkit::Atom::MassNumberType(12));
+    QVERIFY(C1->chirality() == chemkit::Stereochemistry::R);
+    QVERIFY(H3->chirality() == chemkit::Stereochemistry::None);
+
+    // and are copied with the molecule
+    chemkit::Molecule copy(molecule);
+    QCOMPARE(copy.atom(1)->massNumber(), chemkit::Atom::MassNumberType(2));
+    QVERIFY(copy.atom(0)->chirality() == chemkit::Stereochemistry::R);
+    QCOMPARE(copy.partialCharges()[1], chemkit::Real(0.5));
+
+    // new atoms do not take the properties of removed atoms
+    molecule.removeAtom(C1);
+    chemkit::Atom *N4 = molecule.addAtom("N");
+    QVERIFY(N4->chirality() == chemkit::Stereochemistry::None);
+    QCOMPARE(N4->massNumber(), chemkit::Atom::MassNumberType(14));
+}
+
 void MoleculeTest::data()
 {
     chemkit::Molecule molecule;
@@ -152,6 +214,197 @@ void MoleculeTest::removeAtomIf()
     QCOMPARE(ethanol.formula(), std::string("O"));
 }
 
+void MoleculeTest::edit()
+{
+    chemkit::Molecule molecule;
+    for(int i = 0; i < 10; i++){
+        chemkit::Atom *atom = molecule.addAtom(i % 2 ? "O" : "C");
+        atom->setPosition(i, 0, 0);
+        atom->setPartialCharge(i);
+
+        if(i > 0){
+            molecule.addBond(molecule.atom(i - 1), atom, i % 3 + 1);
+        }
+    }
+    QCOMPARE(molecule.atomCount(), size_t(10));
+    QCOMPARE(molecule.bondCount(), size_t(9));
+
+    chemkit::Atom *C0 = molecule.atom(0);
+    chemkit::Atom *O3 = molecule.atom(3);
+    chemkit::Atom *C4 = molecule.atom(4);
+    chemkit::Atom *O9 = molecule.atom(9);
+
+    // atoms are only marked for removal during an edit
+    molecule.beginEdit();
+    molecule.removeAtom(molecule.atom(1));
+    molecule.removeAtom(molecule.atom(2));
+    molecule.removeAtom(molecule.atom(2));
+    molecule.removeBond(C4, molecule.atom(5));
+    QCOMPARE(molecule.atomCount(), size_t(10));
+    QCOMPARE(molecule.bondCount(), size_t(9));
+    QCOMPARE(O3->index(), size_t(3));
+
+    // nested edits are applied when the outermost edit ends
+    molecule.beginEdit();
+    molecule.removeAtom(molecule.atom(7));
+    molecule.endEdit();
+    QCOMPARE(molecule.atomCount(), size_t(10));
+
+    // bonds to removed atoms are removed
+    molecule.addBond(C0, molecule.atom(7));
+
+    // bonds added back are kept
+    molecule.removeBond(O3, C4);
+    molecule.addBond(O3, C4);
+
+    molecule.endEdit();
+    QCOMPARE(molecule.atomCount(), size_t(7));
+    QCOMPARE(molecule.bondCount(), size_t(3));
+
+    // atoms and bonds are renumbered
+    QVERIFY(molecule.atom(0) == C0);
+    QVERIFY(molecule.atom(1) == O3);
+    QVERIFY(molecule.atom(2) == C4);
+    QVERIFY(molecule.atom(6) == O9);
+    for(size_t i = 0; i < molecule.atomCount(); i++){
+        QCOMPARE(molecule.atom(i)->index(), i);
+    }
+    for(size_t i = 0; i < molecule.bondCount(); i++){
+        QCOMPARE(molecule.bond(i)->index(), i);
+    }
+
+    // atom properties are compacted
+    QCOMPARE(molecule.formula(), std::string("C4O3"));
+    QCOMPARE(O3->position().x(), chemkit::Real(3));
+    QCOMPARE(O9->position().x(), chemkit::Real(9));
+    QCOMPARE(C4->partialCharge(), chemkit::Real(4));
+    QCOMPARE(molecule.atom(5)->partialCharge(), chemkit::Real(8));
+    QCOMPARE(molecule.coordinates()->size(), size_t(7));
+
+    // bonds are compacted
+    QCOMPARE(C0->neighborCount(), size_t(0));
+    QCOMPARE(O3->neighborCount(), size_t(1));
+    QVERIFY(O3->isBondedTo(C4));
+    QCOMPARE(molecule.bond(O3, C4)->order(), chemkit::Bond::BondOrderType(2));
+    QVERIFY(molecule.atom(5)->isBondedTo(O9));
+    QCOMPARE(molecule.bond(molecule.atom(5), O9)->order(), chemkit::Bond::BondOrderType(1));
+    QCOMPARE(molecule.fragmentCount(), size_t(4));
+
+    // removing atoms in bulk
+    std::vector<chemkit::Atom *> atoms(molecule.atoms().begin(), molecule.atoms().begin() + 3);
+    molecule.removeAtoms(atoms);
+    QCOMPARE(molecule.atomCount(), size_t(4));
+    QCOMPARE(molecule.bondCount(), size_t(2));
+    QCOMPARE(molecule.formula(), std::string("C2O2"));
+}
+
+void MoleculeTest::copy()
+{
+    chemkit::Molecule molecule("c1ccccc1O", "smiles");
+    molecule.setName("phenol");
+    QCOMPARE(molecule.atomCount(), size_t(13));
+    QCOMPARE(molecule.ringCount(), size_t(1));
+
+    chemkit::Atom *O7 = molecule.atom(6);
+    O7->setMassNumber(18);
+    O7->setPartialCharge(-0.5);
+    O7->setPosition(1, 2, 3);
+    O7->setChirality(chemkit::Stereochemistry::R);
+    molecule.bond(0)->setStereochemistry(chemkit::Stereochemistry::E);
+
+    chemkit::Molecule copy(molecule);
+    QCOMPARE(copy.name(), std::string("phenol"));
+    QCOMPARE(copy.formula(), std::string("C6H6O"));
+    QCOMPARE(copy.bondCount(), size_t(13));
+    QCOMPARE(copy.ringCount(), size_t(1));
+    QVERIFY(copy.ring(0)->isAromatic());
+
+    for(size_t i = 0; i < copy.atomCount(); i++){
+        QVERIFY(copy.atom(i) != molecule.atom(i));
+        QVERIFY(copy.atom(i)->molecule() == &copy);
+        QCOMPARE(copy.atom(i)->index(), i);
+        QCOMPARE(copy.atom(i)->neighborCount(), molecule.atom(i)->neighborCount());
+    }
+    for(size_t i = 0; i < copy.bondCount(); i++){
+        chemkit::Bond *bond = copy.bond(i);
+        QVERIFY(bond->molecule() == &copy);
+        QCOMPARE(bond->atom1()->index(), molecule.bond(i)->atom1()->index());
+        QCOMPARE(bond->atom2()->index(), molecule.bond(i)->atom2()->index());
+        QCOMPARE(bond->order(), molecule.bond(i)->order());
+        QVERIFY(bond->atom1()->bonds().front()->molecule() == &copy);
+    }
+
+    chemkit::Atom *copyO7 = copy.atom(6);
+    QCOMPARE(copyO7->massNumber(), chemkit::Atom::MassNumberType(18));
+    QCOMPARE(copyO7->partialCharge(), chemkit::Real(-0.5));
+    QCOMPARE(copyO7->position(), chemkit::Point3(1, 2, 3));
+    QCOMPARE(copyO7->chirality(), chemkit::Stereochemistry::R);
+    QCOMPARE(copy.bond(0)->stereochemistry(), chemkit::Stereochemistry::E);
+    QCOMPARE(copy.atom(0)->massNumber(), molecule.atom(0)->massNumber());
+
+    // the copy is independent of the original
+    copy.removeAtom(copyO7);
+    QCOMPARE(copy.formula(), std::string("C6H6"));
+    QCOMPARE(molecule.formula(), std::string("C6H6O"));
+    QCOMPARE(O7->partialCharge(), chemkit::Real(-0.5));
+
+    // assignment replaces the previous contents
+    copy = molecule;
+    QCOMPARE(copy.formula(), std::string("C6H6O"));
+    QCOMPARE(copy.bondCount(), size_t(13));
+    QCOMPARE(copy.atom(6)->position(), chemkit::Point3(1, 2, 3));
+    QCOMPARE(copy.ringCount(), size_t(1));
+
+    // empty molecules
+    chemkit::Molecule empty;
+    copy = empty;
+    QVERIFY(copy.isEmpty());
+    QCOMPARE(copy.bondCount(), size_t(0));
+    QCOMPARE(copy.ringCount(), size_t(0));
+}
+
+void MoleculeTest::move()
+{
+#ifdef CHEMKIT_HAS_RVALUE_REFERENCES
+    chemkit::Molecule molecule("c1ccccc1O", "smiles");
+    molecule.setName("phenol");
+    molecule.atom(6)->setChirality(chemkit::Stereochemistry::S);
+    QCOMPARE(molecule.ringCount(), size_t(1));
+
+    chemkit::Atom *O7 = molecule.atom(6);
+    chemkit::Bond *bond = molecule.bond(0);
+
+    // atoms and bonds are moved rather than copied
+    chemkit::Molecule moved(std::move(molecule));
+    QVERIFY(molecule.isEmpty());
+    QCOMPARE(molecule.bondCount(), size_t(0));
+    QCOMPARE(molecule.ringCount(), size_t(0));
+    QCOMPARE(moved.name(), std::string("phenol"));
+    QCOMPARE(moved.formula(), std::string("C6H6O"));
+    QVERIFY(moved.atom(6) == O7);
+    QVERIFY(moved.bond(0) == bond);
+    QVERIFY(O7->molecule() == &moved);
+    QVERIFY(bond->molecule() == &moved);
+    QCOMPARE(O7->chirality(), chemkit::Stereochemistry::S);
+    QCOMPARE(moved.ringCount(), size_t(1));
+    QVERIFY(moved.ring(0)->isAromatic());
+
+    // the moved from molecule can be reused
+    molecule.addAtom("C");
+    QCOMPARE(molecule.formula(), std::string("C"));
+
+    // move assignment
+    molecule = std::move(moved);
+    QVERIFY(moved.isEmpty());
+    QCOMPARE(molecule.formula(), std::string("C6H6O"));
+    QVERIFY(molecule.atom(6) == O7);
+    QVERIFY(O7->molecule() == &molecule);
+    QCOMPARE(molecule.ringCount(), size_t(1));
+#else
+    QSKIP("rvalue references are not supported", SkipAll);
+#endif
+}
+
 void MoleculeTest::atom()
 {
     chemkit::Molecule molecule;
@@ -451,4 +704,110 @@ void MoleculeTest::rotate()
     QVERIFY(C3->position().isApprox(chemkit::Vector3(0, 1, 0)));
 }
 
+namespace {
+
+// returns a summary of the lazily perceived properties of molecule
+std::string perceive(const chemkit::Molecule *molecule)
+{
+    std::stringstream summary;
+
+    summary << molecule->ringCount() << " "
+            << molecule->fragmentCount() << " "
+            << molecule->center() << " ";
+
+    foreach(const chemkit::Atom *atom, molecule->atoms()){
+        summary << atom->isInRing() << atom->isAromatic();
+    }
+    foreach(const chemkit::Bond *bond, molecule->bonds()){
+        summary << bond->isInRing() << bond->isAromatic();
+    }
+
+    summary << " " << molecule->descriptor("randic-index").toDouble()
+            << " " << molecule->descriptor("wiener-index").toInt()
+            << " " << molecule->descriptor("graph-diameter").toInt()
+            << " " << molecule->descriptor("tpsa").toDouble()
+            << " " << molecule->fingerprint("fp2");
+
+    return summary.str();
+}
+
+void perceiveShared(const chemkit::Molecule *molecule, std::string *summary)
+{
+    *summary = perceive(molecule);
+}
+
+} // end anonymous namespace
+
+void MoleculeTest::concurrentPerception()
+{
+    const char *formulas[] = {
+        "c1ccccc1O",
+        "C1CCCCC1.CCO",
+        "c1ccc2c(c1)cccc2C(=O)O",
+        "O=C1NC(=O)C=CN1C1OC(CO)C(O)C1O",
+        "C1CC2CCC1C2.c1ccncc1.O"
+    };
+    const size_t formulaCount = sizeof(formulas) / sizeof(*formulas);
+
+    // expected results from molecules only used by a single thread
+    std::vector<std::string> expected;
+    for(size_t i = 0; i < formulaCount; i++){
+        chemkit::Molecule molecule(formulas[i], "smiles");
+        QVERIFY(!molecule.isEmpty());
+        expected.push_back(perceive(&molecule));
+    }
+
+    chemkit::ThreadPool pool(8);
+
+    // run perception on many threads at once for each new set of
+    // shared molecules
+    for(size_t round = 0; round < 20; round++){
+        std::vector<boost::shared_ptr<chemkit::Molecule> > molecules;
+        for(size_t i = 0; i < formulaCount; i++){
+            molecules.push_back(boost::make_shared<chemkit::Molecule>(formulas[i], "smiles"));
+        }
+
+        std::vector<std::string> summaries(formulaCount * 16);
+        for(size_t i = 0; i < summaries.size(); i++){
+            pool.start(boost::bind(perceiveShared, molecules[i % formulaCount].get(), &summaries[i]));
+        }
+        pool.waitForDone();
+
+        for(size_t i = 0; i < summaries.size(); i++){
+            QCOMPARE(summaries[i], expected[i % formulaCount]);
+        }
+    }
+}
+
+// The rings and graph distances of large molecules are found with
+// tasks on the global thread pool. Perception started from other tasks
+// on the same pool must not be re-entered or deadlock while a thread
+// waits for those tasks.
+void MoleculeTest::concurrentParallelPerception()
+{
+    // polyphenylene with 64 rings
+    std::string formula;
+    for(size_t i = 0; i < 64; i++){
+        formula += "c1ccc(cc1)";
+    }
+
+    chemkit::Molecule molecule(formula, "smiles");
+    QCOMPARE(molecule.ringCount(), size_t(64));
+    std::string expected = perceive(&molecule);
+
+    for(size_t round = 0; round < 4; round++){
+        boost::shared_ptr<chemkit::Molecule> shared =
+            boost::make_shared<chemkit::Molecule>(formula, "smiles");
+
+        std::vector<boost::shared_future<std::string> > summaries;
+        for(size_t i = 0; i < 16; i++){
+            summaries.push_back(chemkit::concurrent::run(boost::bind(perceive, shared.get())));
+        }
+
+        for(size_t i = 0; i < summaries.size(); i++){
+            QCOMPARE(summaries[i].get(), expected);
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(MoleculeTest)
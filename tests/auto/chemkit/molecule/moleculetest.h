@@ -46,10 +46,14 @@ class MoleculeTest : public QObject
         void name();
         void formula();
         void mass();
+        void atomProperties();
         void data();
         void addAtom();
         void addAtomCopy();
         void removeAtomIf();
+        void edit();
+        void copy();
+        void move();
         void atom();
         void addBond();
         void bond();
@@ -65,6 +69,8 @@ class MoleculeTest : public QObject
         void isFragmented();
         void removeFragment();
         void rotate();
+        void concurrentPerception();
+        void concurrentParallelPerception();
 };
 
 #endif // MOLECULETEST_H
@@ -0,0 +1,190 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculearenatest.h"
+
+#include <boost/make_shared.hpp>
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/molecule.h>
+#include <chemkit/moleculearena.h>
+
+void MoleculeArenaTest::basic()
+{
+    chemkit::MoleculeArena arena;
+    QCOMPARE(arena.blockSize(), size_t(65536));
+    QCOMPARE(arena.blockCount(), size_t(0));
+    QCOMPARE(arena.size(), size_t(0));
+    QCOMPARE(arena.capacity(), size_t(0));
+
+    chemkit::MoleculeArena smallArena(128);
+    QCOMPARE(smallArena.blockSize(), size_t(128));
+}
+
+void MoleculeArenaTest::allocate()
+{
+    chemkit::MoleculeArena arena(128);
+
+    char *a = static_cast<char *>(arena.allocate(16));
+    char *b = static_cast<char *>(arena.allocate(16));
+    QVERIFY(a != 0);
+    QVERIFY(b == a + 16);
+    QCOMPARE(arena.blockCount(), size_t(1));
+    QCOMPARE(arena.size(), size_t(32));
+    QCOMPARE(arena.capacity(), size_t(128));
+
+    // allocations are rounded up to keep them aligned
+    char *c = static_cast<char *>(arena.allocate(5));
+    char *d = static_cast<char *>(arena.allocate(8));
+    QVERIFY(c == b + 16);
+    QVERIFY(d == c + 16);
+    QCOMPARE(arena.size(), size_t(64));
+
+    // allocations which do not fit in the current block start a new one
+    arena.allocate(96);
+    QCOMPARE(arena.blockCount(), size_t(2));
+    QCOMPARE(arena.capacity(), size_t(256));
+
+    // allocations larger than the block size get their own block
+    arena.allocate(1024);
+    QCOMPARE(arena.blockCount(), size_t(3));
+    QCOMPARE(arena.capacity(), size_t(1280));
+}
+
+void MoleculeArenaTest::release()
+{
+    chemkit::MoleculeArena arena(64);
+    arena.allocate(32);
+    arena.allocate(64);
+    QCOMPARE(arena.blockCount(), size_t(2));
+
+    arena.release();
+    QCOMPARE(arena.blockCount(), size_t(0));
+    QCOMPARE(arena.size(), size_t(0));
+    QCOMPARE(arena.capacity(), size_t(0));
+
+    arena.allocate(32);
+    QCOMPARE(arena.blockCount(), size_t(1));
+}
+
+void MoleculeArenaTest::molecule()
+{
+    QVERIFY(chemkit::MoleculeArena::currentArena() == 0);
+
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    chemkit::Bond *C1_C2 = molecule.addBond(C1, C2);
+    chemkit::Bond *C2_C3 = molecule.addBond(C2, C3);
+    QCOMPARE(molecule.atomCount(), size_t(3));
+    QCOMPARE(molecule.bondCount(), size_t(2));
+
+    // atoms and bonds are stored next to each other
+    QVERIFY(reinterpret_cast<char *>(C2) > reinterpret_cast<char *>(C1));
+    QVERIFY(reinterpret_cast<char *>(C2) - reinterpret_cast<char *>(C1) ==
+            reinterpret_cast<char *>(C3) - reinterpret_cast<char *>(C2));
+    QVERIFY(C1_C2->atom1() == C1);
+    QVERIFY(C2_C3->atom2() == C3);
+
+    // storage for removed atoms is reused
+    molecule.removeAtom(C3);
+    QCOMPARE(molecule.bondCount(), size_t(1));
+    chemkit::Atom *N3 = molecule.addAtom("N");
+    chemkit::Bond *C2_N3 = molecule.addBond(C2, N3);
+    QVERIFY(N3 == C3);
+    QVERIFY(C2_N3 == C2_C3);
+    QCOMPARE(N3->index(), size_t(2));
+    QCOMPARE(N3->symbol(), std::string("N"));
+    QVERIFY(C2->isBondedTo(N3));
+
+    // add enough atoms to require several slabs
+    for(int i = 0; i < 100; i++){
+        molecule.addBond(molecule.atom(i + 2), molecule.addAtom("C"));
+    }
+    QCOMPARE(molecule.atomCount(), size_t(103));
+    QCOMPARE(molecule.bondCount(), size_t(102));
+    QCOMPARE(molecule.atom(0), C1);
+    QCOMPARE(molecule.atom(102)->neighborCount(), size_t(1));
+
+    molecule.clear();
+    QCOMPARE(molecule.atomCount(), size_t(0));
+    QCOMPARE(molecule.bondCount(), size_t(0));
+
+    chemkit::Atom *O1 = molecule.addAtom("O");
+    QCOMPARE(O1->index(), size_t(0));
+    QCOMPARE(O1->symbol(), std::string("O"));
+}
+
+void MoleculeArenaTest::sharedArena()
+{
+    boost::shared_ptr<chemkit::MoleculeArena> arena =
+        boost::make_shared<chemkit::MoleculeArena>();
+
+    chemkit::MoleculeArena::setCurrentArena(arena);
+    QVERIFY(chemkit::MoleculeArena::currentArena() == arena);
+
+    chemkit::Molecule *water = new chemkit::Molecule("InChI=1/H2O/h1H2", "inchi");
+    chemkit::Molecule *ethanol = new chemkit::Molecule("InChI=1/C2H6O/c1-2-3/h3H,2H2,1H3", "inchi");
+
+    chemkit::MoleculeArena::setCurrentArena(boost::shared_ptr<chemkit::MoleculeArena>());
+    QVERIFY(chemkit::MoleculeArena::currentArena() == 0);
+
+    QCOMPARE(water->formula(), std::string("H2O"));
+    QCOMPARE(ethanol->formula(), std::string("C2H6O"));
+
+    // both molecules are stored in a single block of the shared arena
+    QCOMPARE(arena->blockCount(), size_t(1));
+    QVERIFY(arena->size() > 0);
+
+    // molecules created without a current arena do not use it
+    size_t size = arena->size();
+    chemkit::Molecule methane("InChI=1/CH4/h1H4", "inchi");
+    QCOMPARE(methane.atomCount(), size_t(5));
+    QCOMPARE(arena->size(), size);
+
+    // the arena is kept alive by the molecules using it
+    arena.reset();
+    delete water;
+    QCOMPARE(ethanol->atomCount(), size_t(9));
+    QCOMPARE(ethanol->bondCount(), size_t(8));
+    ethanol->clear();
+    ethanol->addAtom("C");
+    QCOMPARE(ethanol->formula(), std::string("C"));
+    delete ethanol;
+}
+
+QTEST_APPLESS_MAIN(MoleculeArenaTest)
@@ -35,9 +35,21 @@
 
 #include "moleculewatchertest.h"
 
+#include <boost/bind.hpp>
+
+#include <chemkit/atom.h>
 #include <chemkit/molecule.h>
 #include <chemkit/moleculewatcher.h>
 
+namespace {
+
+void increment(int *count)
+{
+    (*count)++;
+}
+
+} // end anonymous namespace
+
 void MoleculeWatcherTest::molecule()
 {
     chemkit::Molecule molecule;
@@ -51,4 +63,48 @@ void MoleculeWatcherTest::molecule()
     QVERIFY(watcher.molecule() == 0);
 }
 
+void MoleculeWatcherTest::structureChanged()
+{
+    chemkit::Molecule molecule("CCO", "smiles");
+    chemkit::MoleculeWatcher watcher(&molecule);
+
+    int atomRemovedCount = 0;
+    int bondRemovedCount = 0;
+    int structureChangedCount = 0;
+    watcher.atomRemoved.connect(boost::bind(increment, &atomRemovedCount));
+    watcher.bondRemoved.connect(boost::bind(increment, &bondRemovedCount));
+    watcher.structureChanged.connect(boost::bind(increment, &structureChangedCount));
+
+    // removing a single atom emits a signal for it and each of its bonds
+    molecule.removeAtom(molecule.atom(0));
+    QCOMPARE(atomRemovedCount, 1);
+    QCOMPARE(bondRemovedCount, 4);
+    QCOMPARE(structureChangedCount, 0);
+
+    // an edit emits a single signal
+    molecule.beginEdit();
+    molecule.removeAtom(molecule.atom(1));
+    molecule.atom(0)->setPartialCharge(0.5);
+    molecule.addAtom("N");
+    QCOMPARE(structureChangedCount, 0);
+    molecule.endEdit();
+    QCOMPARE(atomRemovedCount, 1);
+    QCOMPARE(bondRemovedCount, 4);
+    QCOMPARE(structureChangedCount, 1);
+
+    // removing many atoms emits a single signal
+    molecule.removeAtomIf(boost::bind(&chemkit::Atom::isTerminalHydrogen, _1));
+    QCOMPARE(structureChangedCount, 2);
+
+    // an edit without changes emits no signals
+    molecule.beginEdit();
+    molecule.endEdit();
+    QCOMPARE(structureChangedCount, 2);
+
+    molecule.clear();
+    QCOMPARE(molecule.isEmpty(), true);
+    QCOMPARE(atomRemovedCount, 1);
+    QCOMPARE(structureChangedCount, 3);
+}
+
 QTEST_APPLESS_MAIN(MoleculeWatcherTest)
@@ -0,0 +1,251 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "packedfingerprinttest.h"
+
+#include <cmath>
+
+#include <chemkit/fingerprint.h>
+#include <chemkit/packedfingerprint.h>
+
+void PackedFingerprintTest::basic()
+{
+    chemkit::PackedFingerprint empty;
+    QCOMPARE(empty.size(), size_t(0));
+    QCOMPARE(empty.isEmpty(), true);
+    QCOMPARE(empty.wordCount(), size_t(0));
+    QCOMPARE(empty.count(), size_t(0));
+
+    chemkit::PackedFingerprint fingerprint(100);
+    QCOMPARE(fingerprint.size(), size_t(100));
+    QCOMPARE(fingerprint.isEmpty(), false);
+    QCOMPARE(fingerprint.count(), size_t(0));
+
+    fingerprint.set(0);
+    fingerprint.set(63);
+    fingerprint.set(64);
+    fingerprint.set(99);
+    QCOMPARE(fingerprint.test(0), true);
+    QCOMPARE(fingerprint.test(1), false);
+    QCOMPARE(fingerprint[63], true);
+    QCOMPARE(fingerprint[64], true);
+    QCOMPARE(fingerprint[99], true);
+    QCOMPARE(fingerprint.count(), size_t(4));
+
+    fingerprint.set(63, false);
+    fingerprint.reset(0);
+    QCOMPARE(fingerprint.test(0), false);
+    QCOMPARE(fingerprint.test(63), false);
+    QCOMPARE(fingerprint.count(), size_t(2));
+
+    fingerprint.clear();
+    QCOMPARE(fingerprint.count(), size_t(0));
+    QCOMPARE(fingerprint.size(), size_t(100));
+}
+
+void PackedFingerprintTest::words()
+{
+    // fingerprints are padded to whole 512-bit cache lines
+    QCOMPARE(chemkit::PackedFingerprint::wordCount(0), size_t(0));
+    QCOMPARE(chemkit::PackedFingerprint::wordCount(1), size_t(8));
+    QCOMPARE(chemkit::PackedFingerprint::wordCount(512), size_t(8));
+    QCOMPARE(chemkit::PackedFingerprint::wordCount(513), size_t(16));
+    QCOMPARE(chemkit::PackedFingerprint::wordCount(881), size_t(16));
+    QCOMPARE(chemkit::PackedFingerprint::wordCount(1021), size_t(16));
+
+    chemkit::PackedFingerprint fingerprint(1021);
+    QCOMPARE(fingerprint.wordCount(), size_t(16));
+    QCOMPARE(reinterpret_cast<size_t>(fingerprint.words()) % 64, size_t(0));
+
+    fingerprint.set(1);
+    fingerprint.set(65);
+    fingerprint.set(1020);
+    QCOMPARE(fingerprint.words()[0], chemkit::PackedFingerprint::Word(2));
+    QCOMPARE(fingerprint.words()[1], chemkit::PackedFingerprint::Word(2));
+    QCOMPARE(fingerprint.words()[15], chemkit::PackedFingerprint::Word(1) << 60);
+}
+
+void PackedFingerprintTest::bitset()
+{
+    chemkit::Bitset bitset(881);
+    bitset.set(0);
+    bitset.set(7);
+    bitset.set(300);
+    bitset.set(880);
+
+    chemkit::PackedFingerprint fingerprint(bitset);
+    QCOMPARE(fingerprint.size(), size_t(881));
+    QCOMPARE(fingerprint.count(), size_t(4));
+    QCOMPARE(fingerprint.test(0), true);
+    QCOMPARE(fingerprint.test(7), true);
+    QCOMPARE(fingerprint.test(300), true);
+    QCOMPARE(fingerprint.test(880), true);
+    QCOMPARE(fingerprint.test(301), false);
+
+    QVERIFY(fingerprint.toBitset() == bitset);
+}
+
+void PackedFingerprintTest::count()
+{
+    chemkit::PackedFingerprint a(1024);
+    chemkit::PackedFingerprint b(1024);
+
+    for(size_t i = 0; i < 1024; i += 2){
+        a.set(i);
+    }
+    for(size_t i = 0; i < 1024; i += 3){
+        b.set(i);
+    }
+
+    QCOMPARE(a.count(), size_t(512));
+    QCOMPARE(b.count(), size_t(342));
+    QCOMPARE(chemkit::PackedFingerprint::intersectionCount(a.words(), b.words(), a.wordCount()), size_t(171));
+
+    // counts of partial vectors
+    QCOMPARE(chemkit::PackedFingerprint::count(a.words(), 3), size_t(96));
+    QCOMPARE(chemkit::PackedFingerprint::count(a.words(), 7), size_t(224));
+    QCOMPARE(chemkit::PackedFingerprint::intersectionCount(a.words(), b.words(), 1), size_t(11));
+}
+
+void PackedFingerprintTest::contains()
+{
+    chemkit::PackedFingerprint a(1024);
+    chemkit::PackedFingerprint b(1024);
+    QVERIFY(a.contains(b));
+
+    for(size_t i = 0; i < 1024; i += 2){
+        a.set(i);
+    }
+    for(size_t i = 0; i < 1024; i += 4){
+        b.set(i);
+    }
+
+    QVERIFY(a.contains(a));
+    QVERIFY(a.contains(b));
+    QVERIFY(!b.contains(a));
+
+    b.set(1023);
+    QVERIFY(!a.contains(b));
+}
+
+void PackedFingerprintTest::copy()
+{
+    chemkit::PackedFingerprint a(200);
+    a.set(5);
+    a.set(150);
+
+    chemkit::PackedFingerprint b = a;
+    QVERIFY(b == a);
+    QVERIFY(b.words() != a.words());
+
+    b.set(6);
+    QVERIFY(b != a);
+    QCOMPARE(a.test(6), false);
+
+    chemkit::PackedFingerprint c(2000);
+    c = a;
+    QVERIFY(c == a);
+    QCOMPARE(c.size(), size_t(200));
+    QCOMPARE(c.wordCount(), size_t(8));
+
+    c = chemkit::PackedFingerprint();
+    QCOMPARE(c.isEmpty(), true);
+    QCOMPARE(c.count(), size_t(0));
+}
+
+void PackedFingerprintTest::similarity()
+{
+    chemkit::Bitset bitsetA(881);
+    chemkit::Bitset bitsetB(881);
+    for(size_t i = 0; i < 881; i++){
+        if(i % 3 == 0){
+            bitsetA.set(i);
+        }
+        if(i % 5 == 0 || i % 7 == 0){
+            bitsetB.set(i);
+        }
+    }
+
+    chemkit::PackedFingerprint a(bitsetA);
+    chemkit::PackedFingerprint b(bitsetB);
+
+    size_t countA = bitsetA.count();
+    size_t countB = bitsetB.count();
+    size_t intersection = (bitsetA & bitsetB).count();
+
+    QCOMPARE(chemkit::Fingerprint::tanimotoCoefficient(a, b),
+             chemkit::Fingerprint::tanimotoCoefficient(bitsetA, bitsetB));
+    QCOMPARE(chemkit::Fingerprint::diceCoefficient(a, b),
+             chemkit::Real(2 * intersection) / chemkit::Real(countA + countB));
+    QCOMPARE(chemkit::Fingerprint::cosineCoefficient(a, b),
+             chemkit::Real(intersection) / std::sqrt(chemkit::Real(countA * countB)));
+    QCOMPARE(chemkit::Fingerprint::tverskyIndex(a, b, 1, 1),
+             chemkit::Fingerprint::tanimotoCoefficient(a, b));
+    QCOMPARE(chemkit::Fingerprint::tverskyIndex(a, b, 0.5, 0.5),
+             chemkit::Fingerprint::diceCoefficient(a, b));
+
+    QCOMPARE(chemkit::Fingerprint::tanimotoCoefficient(a, a), chemkit::Real(1));
+    QCOMPARE(chemkit::Fingerprint::cosineCoefficient(b, b), chemkit::Real(1));
+
+    // similarity of empty fingerprints is zero
+    chemkit::PackedFingerprint empty(881);
+    QCOMPARE(chemkit::Fingerprint::tanimotoCoefficient(empty, empty), chemkit::Real(0));
+    QCOMPARE(chemkit::Fingerprint::diceCoefficient(empty, empty), chemkit::Real(0));
+    QCOMPARE(chemkit::Fingerprint::cosineCoefficient(a, empty), chemkit::Real(0));
+    QCOMPARE(chemkit::Fingerprint::tverskyIndex(empty, empty, 1, 1), chemkit::Real(0));
+}
+
+void PackedFingerprintTest::longFingerprint()
+{
+    // the vectorized kernels must agree with the bitset
+    chemkit::Bitset bitsetA(4099);
+    chemkit::Bitset bitsetB(4099);
+    unsigned int state = 12345;
+    for(size_t i = 0; i < 4099; i++){
+        state = state * 1103515245 + 12345;
+        bitsetA[i] = (state >> 16) & 1;
+        bitsetB[i] = (state >> 17) & 1;
+    }
+
+    chemkit::PackedFingerprint a(bitsetA);
+    chemkit::PackedFingerprint b(bitsetB);
+    QCOMPARE(a.count(), bitsetA.count());
+    QCOMPARE(b.count(), bitsetB.count());
+    QCOMPARE(chemkit::PackedFingerprint::intersectionCount(a.words(), b.words(), a.wordCount()),
+             (bitsetA & bitsetB).count());
+}
+
+QTEST_APPLESS_MAIN(PackedFingerprintTest)
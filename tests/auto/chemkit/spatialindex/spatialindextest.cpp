@@ -0,0 +1,318 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "spatialindextest.h"
+
+#include <cstdlib>
+#include <algorithm>
+
+#include <chemkit/atom.h>
+#include <chemkit/molecule.h>
+#include <chemkit/unitcell.h>
+#include <chemkit/concurrent.h>
+#include <chemkit/spatialindex.h>
+
+using chemkit::Real;
+using chemkit::Point3;
+using chemkit::Vector3;
+using chemkit::UnitCell;
+using chemkit::SpatialIndex;
+
+namespace {
+
+// returns count points randomly distributed in a box of size
+std::vector<Point3> randomPoints(size_t count, Real size)
+{
+    srand(42);
+
+    std::vector<Point3> points;
+    for(size_t i = 0; i < count; i++){
+        points.push_back(Point3(size * rand() / RAND_MAX,
+                                size * rand() / RAND_MAX,
+                                size * rand() / RAND_MAX));
+    }
+
+    return points;
+}
+
+// returns every pair of points within cutoff found by brute force
+std::vector<SpatialIndex::Pair> bruteForcePairs(const SpatialIndex &index, Real cutoff)
+{
+    std::vector<SpatialIndex::Pair> pairs;
+
+    for(size_t i = 0; i < index.size(); i++){
+        for(size_t j = i + 1; j < index.size(); j++){
+            if(index.distance(i, j) <= cutoff){
+                pairs.push_back(std::make_pair(i, j));
+            }
+        }
+    }
+
+    return pairs;
+}
+
+// finds the nearest points to a query point in an index
+struct NearestFunction
+{
+    typedef std::vector<size_t> result_type;
+
+    NearestFunction(const SpatialIndex &index, size_t k)
+        : index(index),
+          k(k)
+    {
+    }
+
+    std::vector<size_t> operator()(const Point3 &point) const
+    {
+        return index.nearest(point, k);
+    }
+
+    const SpatialIndex &index;
+    size_t k;
+};
+
+} // end anonymous namespace
+
+void SpatialIndexTest::basic()
+{
+    SpatialIndex index;
+    QCOMPARE(index.size(), size_t(0));
+    QCOMPARE(index.isEmpty(), true);
+    QCOMPARE(index.isPeriodic(), false);
+    QCOMPARE(index.within(Point3(0, 0, 0), 5.0).size(), size_t(0));
+    QCOMPARE(index.nearest(Point3(0, 0, 0), 3).size(), size_t(0));
+    QCOMPARE(index.pairs(5.0).size(), size_t(0));
+
+    std::vector<Point3> points;
+    points.push_back(Point3(0, 0, 0));
+    points.push_back(Point3(1, 0, 0));
+    points.push_back(Point3(0, 3, 0));
+    index.setPositions(points);
+    QCOMPARE(index.size(), size_t(3));
+    QCOMPARE(index.isEmpty(), false);
+    QCOMPARE(index.position(2), Point3(0, 3, 0));
+    QCOMPARE(qRound(index.distance(1, 2) * 1000), 3162);
+
+    index.setCellSize(0.5);
+    QCOMPARE(index.cellSize(), Real(0.5));
+    QCOMPARE(index.pairs(1.5).size(), size_t(1));
+}
+
+void SpatialIndexTest::within()
+{
+    std::vector<Point3> points = randomPoints(500, 20);
+
+    SpatialIndex index;
+    index.setPositions(points);
+
+    std::vector<Point3> queries = randomPoints(20, 24);
+    foreach(Point3 query, queries){
+        query -= Vector3(2, 2, 2);
+
+        const Real radii[] = { 0.5, 2.0, 5.0, 40.0 };
+
+        for(size_t i = 0; i < sizeof(radii) / sizeof(Real); i++){
+            Real radius = radii[i];
+
+            std::vector<size_t> expected;
+            for(size_t j = 0; j < points.size(); j++){
+                if((points[j] - query).norm() <= radius){
+                    expected.push_back(j);
+                }
+            }
+
+            QVERIFY(index.within(query, radius) == expected);
+        }
+    }
+}
+
+void SpatialIndexTest::nearest()
+{
+    std::vector<Point3> points = randomPoints(500, 20);
+
+    SpatialIndex index;
+    index.setPositions(points);
+
+    std::vector<Point3> queries = randomPoints(20, 30);
+    foreach(const Point3 &query, queries){
+        std::vector<std::pair<Real, size_t> > distances;
+        for(size_t i = 0; i < points.size(); i++){
+            distances.push_back(std::make_pair((points[i] - query).squaredNorm(), i));
+        }
+        std::sort(distances.begin(), distances.end());
+
+        std::vector<size_t> nearest = index.nearest(query, 10);
+        QCOMPARE(nearest.size(), size_t(10));
+        for(size_t i = 0; i < nearest.size(); i++){
+            QCOMPARE(nearest[i], distances[i].second);
+        }
+    }
+
+    QCOMPARE(index.nearest(points[7], 1).front(), size_t(7));
+    QCOMPARE(index.nearest(points[7], 1000).size(), points.size());
+}
+
+void SpatialIndexTest::nearestConcurrent()
+{
+    // verify that querying an index from several threads before
+    // its k-d tree has been built gives the same results
+    std::vector<Point3> points = randomPoints(2000, 20);
+    std::vector<Point3> queries = randomPoints(200, 30);
+
+    SpatialIndex index;
+    index.setPositions(points);
+
+    for(int iteration = 0; iteration < 5; iteration++){
+        // move a point to invalidate the k-d tree
+        index.setPosition(iteration, points[iteration] + Vector3(0.1, 0, 0));
+
+        std::vector<std::vector<size_t> > nearest =
+            chemkit::concurrent::parallel_map(queries, NearestFunction(index, 5));
+
+        QCOMPARE(nearest.size(), queries.size());
+        for(size_t i = 0; i < queries.size(); i++){
+            QVERIFY(nearest[i] == index.nearest(queries[i], 5));
+        }
+    }
+}
+
+void SpatialIndexTest::pairs()
+{
+    SpatialIndex index;
+    index.setPositions(randomPoints(1000, 25));
+
+    const Real cutoffs[] = { 1.0, 3.0, 6.0 };
+
+    for(size_t i = 0; i < sizeof(cutoffs) / sizeof(Real); i++){
+        Real cutoff = cutoffs[i];
+
+        std::vector<SpatialIndex::Pair> pairs = index.pairs(cutoff);
+        std::sort(pairs.begin(), pairs.end());
+        QVERIFY(pairs == bruteForcePairs(index, cutoff));
+    }
+}
+
+void SpatialIndexTest::periodic()
+{
+    UnitCell unitCell(Vector3(20, 0, 0), Vector3(3, 18, 0), Vector3(-2, 1, 22));
+
+    SpatialIndex index;
+    index.setUnitCell(&unitCell);
+    index.setPositions(randomPoints(800, 20));
+    QCOMPARE(index.isPeriodic(), true);
+
+    // points on opposite sides of the cell are close
+    QCOMPARE(qRound(index.displacement(Point3(0.5, 0, 0), Point3(19.5, 0, 0)).norm() * 1000), 1000);
+
+    const Real cutoffs[] = { 1.5, 4.0, 7.0 };
+
+    for(size_t i = 0; i < sizeof(cutoffs) / sizeof(Real); i++){
+        Real cutoff = cutoffs[i];
+
+        std::vector<SpatialIndex::Pair> pairs = index.pairs(cutoff);
+        std::sort(pairs.begin(), pairs.end());
+        QVERIFY(pairs == bruteForcePairs(index, cutoff));
+    }
+
+    Point3 query(19.8, 17.9, 0.1);
+    std::vector<std::pair<Real, size_t> > distances;
+    for(size_t i = 0; i < index.size(); i++){
+        distances.push_back(std::make_pair(index.displacement(query, index.position(i)).squaredNorm(), i));
+    }
+    std::sort(distances.begin(), distances.end());
+
+    std::vector<size_t> nearest = index.nearest(query, 5);
+    QCOMPARE(nearest.size(), size_t(5));
+    for(size_t i = 0; i < nearest.size(); i++){
+        QCOMPARE(nearest[i], distances[i].second);
+    }
+
+    index.setUnitCell(0);
+    QCOMPARE(index.isPeriodic(), false);
+    QCOMPARE(qRound(index.displacement(Point3(0.5, 0, 0), Point3(19.5, 0, 0)).norm() * 1000), 19000);
+}
+
+void SpatialIndexTest::setPosition()
+{
+    std::vector<Point3> points = randomPoints(300, 15);
+
+    SpatialIndex index;
+    index.setPositions(points);
+
+    // move points including outside of the original bounds
+    std::vector<Point3> moved = randomPoints(100, 25);
+    for(size_t i = 0; i < moved.size(); i++){
+        index.setPosition(i * 3, moved[i] - Vector3(5, 5, 5));
+    }
+
+    SpatialIndex rebuilt;
+    std::vector<Point3> positions;
+    for(size_t i = 0; i < index.size(); i++){
+        positions.push_back(index.position(i));
+    }
+    rebuilt.setPositions(positions);
+
+    std::vector<SpatialIndex::Pair> pairs = index.pairs(2.5);
+    std::sort(pairs.begin(), pairs.end());
+    QVERIFY(pairs == bruteForcePairs(rebuilt, 2.5));
+
+    Point3 query(-4, 7, 19);
+    QVERIFY(index.within(query, 6.0) == rebuilt.within(query, 6.0));
+    QVERIFY(index.nearest(query, 8) == rebuilt.nearest(query, 8));
+}
+
+void SpatialIndexTest::molecule()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *O3 = molecule.addAtom("O");
+    C1->setPosition(0, 0, 0);
+    C2->setPosition(1.5, 0, 0);
+    O3->setPosition(2.2, 1.2, 0);
+
+    SpatialIndex index(&molecule);
+    QCOMPARE(index.size(), size_t(3));
+
+    std::vector<SpatialIndex::Pair> pairs = index.pairs(1.6);
+    std::sort(pairs.begin(), pairs.end());
+    QCOMPARE(pairs.size(), size_t(2));
+    QVERIFY(pairs[0] == SpatialIndex::Pair(0, 1));
+    QVERIFY(pairs[1] == SpatialIndex::Pair(1, 2));
+
+    QCOMPARE(index.nearest(Point3(2, 1, 0), 1).front(), size_t(2));
+}
+
+QTEST_APPLESS_MAIN(SpatialIndexTest)
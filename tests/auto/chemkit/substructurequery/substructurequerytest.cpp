@@ -42,6 +42,30 @@
 #include <chemkit/molecule.h>
 #include <chemkit/substructurequery.h>
 
+namespace {
+
+// Verifies that the query gives the expected result for the molecule
+// and that screening does not change the result or the mapping.
+void verifyMatches(chemkit::SubstructureQuery &query,
+                   const boost::shared_ptr<chemkit::Molecule> &molecule,
+                   bool expected)
+{
+    int flags = query.flags() & ~chemkit::SubstructureQuery::UseScreening;
+
+    query.setFlags(flags);
+    QCOMPARE(query.matches(molecule.get()), expected);
+    std::map<chemkit::Atom *, chemkit::Atom *> mapping = query.mapping(molecule.get());
+    QCOMPARE(mapping.empty(), !expected);
+
+    query.setFlags(flags | chemkit::SubstructureQuery::UseScreening);
+    QCOMPARE(query.matches(molecule.get()), expected);
+    QVERIFY(query.mapping(molecule.get()) == mapping);
+
+    query.setFlags(flags);
+}
+
+} // end anonymous namespace
+
 void SubstructureQueryTest::molecule()
 {
     chemkit::SubstructureQuery query;
@@ -252,6 +276,26 @@ void SubstructureQueryTest::matches()
     QCOMPARE(query.matches(propane.get()), false);
     QCOMPARE(query.matches(benzene.get()), false);
     QCOMPARE(query.matches(phenol.get()), true);
+
+    // chains are found in rings containing extra bonds between their atoms
+    boost::shared_ptr<chemkit::Molecule> butane = boost::make_shared<chemkit::Molecule>("CCCC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> cyclopropane = boost::make_shared<chemkit::Molecule>("C1CC1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> cyclobutane = boost::make_shared<chemkit::Molecule>("C1CCC1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> methylcyclopropane = boost::make_shared<chemkit::Molecule>("CC1CC1", "smiles");
+
+    query.setMolecule(propane);
+    QCOMPARE(query.matches(cyclopropane.get()), true);
+    QCOMPARE(query.matches(cyclobutane.get()), true);
+
+    query.setMolecule(butane);
+    QCOMPARE(query.matches(cyclopropane.get()), false);
+    QCOMPARE(query.matches(cyclobutane.get()), true);
+    QCOMPARE(query.matches(methylcyclopropane.get()), true);
+
+    query.setMolecule(cyclopropane);
+    QCOMPARE(query.matches(propane.get()), false);
+    QCOMPARE(query.matches(butane.get()), false);
+    QCOMPARE(query.matches(methylcyclopropane.get()), true);
 }
 
 void SubstructureQueryTest::find()
@@ -301,4 +345,171 @@ void SubstructureQueryTest::find()
     QCOMPARE(carboxylMoiety.isEmpty(), true);
 }
 
+void SubstructureQueryTest::compareAromaticity()
+{
+    boost::shared_ptr<chemkit::Molecule> benzene = boost::make_shared<chemkit::Molecule>("c1ccccc1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> toluene = boost::make_shared<chemkit::Molecule>("Cc1ccccc1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> pyridine = boost::make_shared<chemkit::Molecule>("c1ccncc1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> naphthalene = boost::make_shared<chemkit::Molecule>("c1ccc2ccccc2c1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> anthracene = boost::make_shared<chemkit::Molecule>("c1ccc2cc3ccccc3cc2c1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> cyclohexane = boost::make_shared<chemkit::Molecule>("C1CCCCC1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> butadiene = boost::make_shared<chemkit::Molecule>("C=CC=C", "smiles");
+    boost::shared_ptr<chemkit::Molecule> hexatriene = boost::make_shared<chemkit::Molecule>("C=CC=CC=C", "smiles");
+
+    chemkit::SubstructureQuery query;
+    query.setFlags(chemkit::SubstructureQuery::CompareAromaticity);
+
+    query.setMolecule(benzene);
+    verifyMatches(query, benzene, true);
+    verifyMatches(query, toluene, true);
+    verifyMatches(query, pyridine, false);
+    verifyMatches(query, naphthalene, true);
+    verifyMatches(query, cyclohexane, false);
+    verifyMatches(query, hexatriene, false);
+
+    // aromatic bonds match regardless of the kekule structure
+    query.setMolecule(naphthalene);
+    verifyMatches(query, benzene, false);
+    verifyMatches(query, naphthalene, true);
+    verifyMatches(query, anthracene, true);
+
+    // aromatic bonds in the molecule still match the kekule bond
+    // orders in the query
+    query.setMolecule(butadiene);
+    verifyMatches(query, hexatriene, true);
+    verifyMatches(query, benzene, true);
+    verifyMatches(query, cyclohexane, false);
+
+    query.setMolecule(cyclohexane);
+    verifyMatches(query, cyclohexane, true);
+    verifyMatches(query, benzene, false);
+}
+
+void SubstructureQueryTest::compareHydrogens()
+{
+    boost::shared_ptr<chemkit::Molecule> methane = boost::make_shared<chemkit::Molecule>("C", "smiles");
+    boost::shared_ptr<chemkit::Molecule> ethane = boost::make_shared<chemkit::Molecule>("CC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> propane = boost::make_shared<chemkit::Molecule>("CCC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> methanol = boost::make_shared<chemkit::Molecule>("CO", "smiles");
+    boost::shared_ptr<chemkit::Molecule> ethanol = boost::make_shared<chemkit::Molecule>("CCO", "smiles");
+    boost::shared_ptr<chemkit::Molecule> benzene = boost::make_shared<chemkit::Molecule>("c1ccccc1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> toluene = boost::make_shared<chemkit::Molecule>("Cc1ccccc1", "smiles");
+
+    chemkit::SubstructureQuery query;
+
+    // without hydrogens only the heavy atoms are compared
+    query.setMolecule(methanol);
+    verifyMatches(query, ethanol, true);
+    query.setMolecule(ethane);
+    verifyMatches(query, propane, true);
+    query.setMolecule(benzene);
+    verifyMatches(query, toluene, true);
+
+    // with hydrogens each heavy atom must have the same hydrogens
+    query.setFlags(chemkit::SubstructureQuery::CompareHydrogens);
+
+    query.setMolecule(methane);
+    verifyMatches(query, methane, true);
+    verifyMatches(query, ethane, false);
+
+    query.setMolecule(methanol);
+    verifyMatches(query, methanol, true);
+    verifyMatches(query, ethanol, false);
+
+    query.setMolecule(ethane);
+    verifyMatches(query, ethane, true);
+    verifyMatches(query, propane, false);
+
+    query.setMolecule(benzene);
+    verifyMatches(query, benzene, true);
+    verifyMatches(query, toluene, false);
+
+    query.setFlags(chemkit::SubstructureQuery::CompareHydrogens |
+                   chemkit::SubstructureQuery::CompareAromaticity);
+    verifyMatches(query, benzene, true);
+    verifyMatches(query, toluene, false);
+}
+
+void SubstructureQueryTest::ringQueries()
+{
+    boost::shared_ptr<chemkit::Molecule> butane = boost::make_shared<chemkit::Molecule>("CCCC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> cyclopentane = boost::make_shared<chemkit::Molecule>("C1CCCC1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> cyclohexane = boost::make_shared<chemkit::Molecule>("C1CCCCC1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> hexane = boost::make_shared<chemkit::Molecule>("CCCCCC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> decalin = boost::make_shared<chemkit::Molecule>("C1CCC2CCCCC2C1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> spiro = boost::make_shared<chemkit::Molecule>("C1CCC2(C1)CCCC2", "smiles");
+    boost::shared_ptr<chemkit::Molecule> piperidine = boost::make_shared<chemkit::Molecule>("C1CCNCC1", "smiles");
+
+    chemkit::SubstructureQuery query;
+
+    query.setMolecule(cyclohexane);
+    verifyMatches(query, cyclohexane, true);
+    verifyMatches(query, decalin, true);
+    verifyMatches(query, hexane, false);
+    verifyMatches(query, cyclopentane, false);
+    verifyMatches(query, spiro, false);
+    verifyMatches(query, piperidine, false);
+
+    query.setMolecule(cyclopentane);
+    verifyMatches(query, cyclohexane, false);
+    verifyMatches(query, spiro, true);
+
+    // fused ring systems require both rings
+    query.setMolecule(decalin);
+    verifyMatches(query, decalin, true);
+    verifyMatches(query, cyclohexane, false);
+    verifyMatches(query, spiro, false);
+
+    query.setMolecule(butane);
+    verifyMatches(query, cyclohexane, true);
+    verifyMatches(query, piperidine, true);
+
+    query.setFlags(chemkit::SubstructureQuery::CompareHydrogens);
+    query.setMolecule(cyclohexane);
+    verifyMatches(query, cyclohexane, true);
+    verifyMatches(query, decalin, false);
+}
+
+void SubstructureQueryTest::fragmentQueries()
+{
+    boost::shared_ptr<chemkit::Molecule> ethane = boost::make_shared<chemkit::Molecule>("CC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> propane = boost::make_shared<chemkit::Molecule>("CCC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> butane = boost::make_shared<chemkit::Molecule>("CCCC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> ethanol = boost::make_shared<chemkit::Molecule>("CCO", "smiles");
+    boost::shared_ptr<chemkit::Molecule> phenol = boost::make_shared<chemkit::Molecule>("c1ccccc1O", "smiles");
+    boost::shared_ptr<chemkit::Molecule> ethanolWater = boost::make_shared<chemkit::Molecule>("CCO.O", "smiles");
+
+    boost::shared_ptr<chemkit::Molecule> methaneWater = boost::make_shared<chemkit::Molecule>("C.O", "smiles");
+    boost::shared_ptr<chemkit::Molecule> ethaneEthane = boost::make_shared<chemkit::Molecule>("CC.CC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> benzeneWater = boost::make_shared<chemkit::Molecule>("c1ccccc1.O", "smiles");
+    boost::shared_ptr<chemkit::Molecule> benzeneAmmonia = boost::make_shared<chemkit::Molecule>("c1ccccc1.N", "smiles");
+
+    chemkit::SubstructureQuery query;
+
+    // each fragment of the query is matched to different atoms
+    query.setMolecule(methaneWater);
+    verifyMatches(query, ethanol, true);
+    verifyMatches(query, ethanolWater, true);
+    verifyMatches(query, ethane, false);
+
+    query.setMolecule(ethaneEthane);
+    verifyMatches(query, butane, true);
+    verifyMatches(query, propane, false);
+    verifyMatches(query, ethane, false);
+
+    query.setMolecule(benzeneWater);
+    verifyMatches(query, phenol, true);
+    query.setMolecule(benzeneAmmonia);
+    verifyMatches(query, phenol, false);
+
+    // with hydrogens the water must be a separate fragment
+    query.setFlags(chemkit::SubstructureQuery::CompareHydrogens);
+    query.setMolecule(methaneWater);
+    verifyMatches(query, ethanol, false);
+    verifyMatches(query, ethanolWater, false);
+
+    query.setMolecule(ethanol);
+    verifyMatches(query, ethanolWater, true);
+}
+
 QTEST_APPLESS_MAIN(SubstructureQueryTest)
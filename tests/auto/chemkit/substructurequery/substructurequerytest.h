@@ -48,6 +48,10 @@ class SubstructureQueryTest : public QObject
         void maximumMapping();
         void matches();
         void find();
+        void compareAromaticity();
+        void compareHydrogens();
+        void ringQueries();
+        void fragmentQueries();
 };
 
 #endif // SUBSTRUCTUREQUERYTEST_H
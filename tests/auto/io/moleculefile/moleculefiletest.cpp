@@ -35,10 +35,17 @@
 
 #include "moleculefiletest.h"
 
+#include <sstream>
+#include <stdexcept>
+
 #include <boost/make_shared.hpp>
 
 #include <chemkit/molecule.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/moleculefileformat.h>
+#include <chemkit/moleculearena.h>
+
+const std::string dataPath = "../../../data/";
 
 void MoleculeFileTest::fileName()
 {
@@ -118,6 +125,83 @@ void MoleculeFileTest::molecule()
     QVERIFY(file.molecule("invalid-name") == 0);
 }
 
+void MoleculeFileTest::arena()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    QVERIFY(file.arena() == 0);
+
+    boost::shared_ptr<chemkit::MoleculeArena> arena =
+        boost::make_shared<chemkit::MoleculeArena>();
+    file.setArena(arena);
+    QVERIFY(file.arena() == arena);
+
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+    QCOMPARE(file.moleculeCount(), size_t(416));
+
+    // the molecules are packed into the arena
+    QVERIFY(arena->size() > 0);
+    QVERIFY(arena->blockCount() < file.moleculeCount());
+
+    // the arena is only current while reading
+    QVERIFY(chemkit::MoleculeArena::currentArena() == 0);
+
+    // the molecules remain valid after the file and arena are gone
+    boost::shared_ptr<chemkit::Molecule> molecule = file.molecule(0);
+    size_t atomCount = molecule->atomCount();
+    std::string formula = molecule->formula();
+    arena.reset();
+    file.clear();
+    file.setArena(arena);
+    QCOMPARE(molecule->atomCount(), atomCount);
+    QCOMPARE(molecule->formula(), formula);
+}
+
+namespace {
+
+// file format which fails by throwing an exception
+class ThrowingFileFormat : public chemkit::MoleculeFileFormat
+{
+public:
+    ThrowingFileFormat()
+        : chemkit::MoleculeFileFormat("throwing")
+    {
+    }
+
+    bool read(std::istream &input, chemkit::MoleculeFile *file)
+    {
+        CHEMKIT_UNUSED(input);
+        CHEMKIT_UNUSED(file);
+
+        throw std::runtime_error("read failed");
+    }
+};
+
+} // end anonymous namespace
+
+void MoleculeFileTest::arenaWithException()
+{
+    chemkit::MoleculeFile file;
+    file.setArena(boost::make_shared<chemkit::MoleculeArena>());
+
+    file.setFormat(new ThrowingFileFormat);
+
+    std::istringstream input("");
+    bool thrown = false;
+    try {
+        file.read(input);
+    }
+    catch(const std::runtime_error &){
+        thrown = true;
+    }
+    QVERIFY(thrown);
+
+    // the arena is no longer current after the read fails
+    QVERIFY(chemkit::MoleculeArena::currentArena() == 0);
+}
+
 void MoleculeFileTest::fileFormatDetection()
 {
     // create empty file object
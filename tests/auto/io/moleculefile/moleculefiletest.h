@@ -48,6 +48,8 @@ class MoleculeFileTest : public QObject
         void contains();
         void data();
         void molecule();
+        void arena();
+        void arenaWithException();
         void fileFormatDetection();
         void fileFormatDetectionWithCompression();
 };
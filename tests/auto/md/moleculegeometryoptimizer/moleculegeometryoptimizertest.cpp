@@ -35,9 +35,12 @@
 
 #include "moleculegeometryoptimizertest.h"
 
+#include <cmath>
+
 #include <chemkit/atom.h>
 #include <chemkit/bond.h>
 #include <chemkit/molecule.h>
+#include <chemkit/minimizer.h>
 #include <chemkit/moleculegeometryoptimizer.h>
 
 void MoleculeGeometryOptimizerTest::molecule()
@@ -79,7 +82,61 @@ void MoleculeGeometryOptimizerTest::water()
         qDebug() << optimizer.errorString().c_str();
     QVERIFY(ok);
 
-    QCOMPARE(qRound(molecule.bondAngle(H2, O1, H3)), 104);
+    QCOMPARE(qRound(molecule.bondAngle(H2, O1, H3) * 10), 1045);
+}
+
+void MoleculeGeometryOptimizerTest::minimizers()
+{
+    chemkit::MoleculeGeometryOptimizer optimizer;
+    QCOMPARE(optimizer.minimizer(), std::string("lbfgs"));
+    QVERIFY(!optimizer.setMinimizer("invalid"));
+    QCOMPARE(optimizer.minimizer(), std::string("lbfgs"));
+
+    foreach(const std::string &name, chemkit::Minimizer::minimizers()){
+        chemkit::Molecule molecule;
+        chemkit::Atom *O1 = molecule.addAtom("O");
+        chemkit::Atom *H2 = molecule.addAtom("H");
+        chemkit::Atom *H3 = molecule.addAtom("H");
+        molecule.addBond(O1, H2);
+        molecule.addBond(O1, H3);
+        O1->setPosition(0, 0, 0);
+        H2->setPosition(0, 1, 0);
+        H3->setPosition(1, 0, 0);
+
+        optimizer.setMolecule(&molecule);
+        QVERIFY(optimizer.setMinimizer(name));
+        QCOMPARE(optimizer.minimizer(), name);
+
+        bool ok = optimizer.optimize();
+        if(!ok)
+            qDebug() << name.c_str() << optimizer.errorString().c_str();
+        QVERIFY(ok);
+        QVERIFY(optimizer.converged());
+        QVERIFY(optimizer.evaluationCount() >= optimizer.iterationCount());
+        QCOMPARE(qRound(molecule.bondAngle(H2, O1, H3) * 10), 1045);
+    }
+}
+
+void MoleculeGeometryOptimizerTest::maximumIterations()
+{
+    chemkit::Molecule molecule("CCO", "smiles");
+    QCOMPARE(molecule.formula(), std::string("C2H6O"));
+    for(size_t i = 0; i < molecule.size(); i++){
+        molecule.atom(i)->setPosition(std::cos(double(i)), std::sin(double(i)), 0.5 * i);
+    }
+
+    chemkit::MoleculeGeometryOptimizer optimizer(&molecule);
+    optimizer.setMaximumIterations(2);
+    QCOMPARE(optimizer.maximumIterations(), size_t(2));
+
+    // optimize() must return once the iteration limit is reached
+    QVERIFY(!optimizer.optimize());
+    QCOMPARE(optimizer.iterationCount(), size_t(2));
+
+    // with the default limit the optimization converges
+    optimizer.setMaximumIterations(1000);
+    QVERIFY(optimizer.optimize());
+    QVERIFY(optimizer.iterationCount() < size_t(1000));
 }
 
 QTEST_APPLESS_MAIN(MoleculeGeometryOptimizerTest)
@@ -45,6 +45,8 @@ class MoleculeGeometryOptimizerTest : public QObject
     private slots:
         void molecule();
         void water();
+        void minimizers();
+        void maximumIterations();
 };
 
 #endif // MOLECULEGEOMTRYOPTIMIZERTEST_H
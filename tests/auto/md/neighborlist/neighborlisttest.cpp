@@ -0,0 +1,130 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "neighborlisttest.h"
+
+#include <set>
+
+#include <chemkit/topology.h>
+#include <chemkit/neighborlist.h>
+#include <chemkit/cartesiancoordinates.h>
+
+void NeighborListTest::basic()
+{
+    chemkit::NeighborList neighborList(8, 1);
+    QCOMPARE(neighborList.cutoff(), chemkit::Real(8));
+    QCOMPARE(neighborList.skin(), chemkit::Real(1));
+    QCOMPARE(neighborList.size(), size_t(0));
+    QVERIFY(neighborList.isEmpty());
+}
+
+void NeighborListTest::pairs()
+{
+    // a 6x6x6 lattice with 1.5 angstrom spacing
+    chemkit::CartesianCoordinates coordinates;
+    for(int x = 0; x < 6; x++){
+        for(int y = 0; y < 6; y++){
+            for(int z = 0; z < 6; z++){
+                coordinates.append(1.5 * x, 1.5 * y, 1.5 * z);
+            }
+        }
+    }
+
+    chemkit::NeighborList neighborList(3, 0.5);
+    neighborList.rebuild(&coordinates);
+
+    // every pair within the cutoff must be listed exactly once
+    std::set<std::pair<size_t, size_t> > listed;
+    foreach(const chemkit::NeighborList::Pair &pair, neighborList.pairs()){
+        QVERIFY(pair[0] < pair[1]);
+        QVERIFY(listed.insert(std::make_pair(pair[0], pair[1])).second);
+    }
+
+    for(size_t i = 0; i < coordinates.size(); i++){
+        for(size_t j = i + 1; j < coordinates.size(); j++){
+            if(coordinates.distance(i, j) <= 3){
+                QVERIFY(listed.count(std::make_pair(i, j)) == 1);
+            }
+        }
+    }
+}
+
+void NeighborListTest::exclusions()
+{
+    chemkit::Topology topology(3);
+    topology.addExclusion(0, 1);
+    topology.addExclusion(2, 1);
+    QVERIFY(topology.isExcluded(1, 2));
+    QVERIFY(!topology.isExcluded(0, 2));
+
+    chemkit::CartesianCoordinates coordinates;
+    coordinates.append(0, 0, 0);
+    coordinates.append(1, 0, 0);
+    coordinates.append(2, 0, 0);
+
+    chemkit::NeighborList neighborList(5, 1);
+    neighborList.addExclusions(&topology);
+    QVERIFY(neighborList.isExcluded(1, 0));
+    neighborList.rebuild(&coordinates);
+    QCOMPARE(neighborList.size(), size_t(1));
+    QCOMPARE(neighborList.pairs().front()[0], size_t(0));
+    QCOMPARE(neighborList.pairs().front()[1], size_t(2));
+
+    neighborList.clearExclusions();
+    neighborList.rebuild(&coordinates);
+    QCOMPARE(neighborList.size(), size_t(3));
+}
+
+void NeighborListTest::update()
+{
+    chemkit::CartesianCoordinates coordinates;
+    coordinates.append(0, 0, 0);
+    coordinates.append(4, 0, 0);
+
+    chemkit::NeighborList neighborList(3, 2);
+    QVERIFY(neighborList.update(&coordinates));
+    QCOMPARE(neighborList.size(), size_t(1));
+
+    // moving less than half the skin keeps the list
+    coordinates.setPosition(1, chemkit::Point3(3.5, 0, 0));
+    QVERIFY(!neighborList.update(&coordinates));
+
+    // moving further forces a rebuild
+    coordinates.setPosition(1, chemkit::Point3(10, 0, 0));
+    QVERIFY(neighborList.update(&coordinates));
+    QCOMPARE(neighborList.size(), size_t(0));
+}
+
+QTEST_APPLESS_MAIN(NeighborListTest)
@@ -46,4 +46,34 @@ void TopologyTest::size()
     QCOMPARE(topology.size(), size_t(100));
 }
 
+void TopologyTest::types()
+{
+    chemkit::Topology topology(4);
+    QCOMPARE(topology.typeCount(), size_t(0));
+    QCOMPARE(topology.typeId(0), -1);
+    QCOMPARE(topology.type(0), std::string());
+
+    topology.setType(0, "C_3");
+    topology.setType(1, "H_");
+    topology.setType(2, "C_3");
+    QCOMPARE(topology.typeCount(), size_t(2));
+    QCOMPARE(topology.type(0), std::string("C_3"));
+    QCOMPARE(topology.type(1), std::string("H_"));
+    QCOMPARE(topology.type(2), std::string("C_3"));
+    QCOMPARE(topology.typeId(0), topology.typeId(2));
+    QVERIFY(topology.typeId(0) != topology.typeId(1));
+    QCOMPARE(topology.typeName(topology.typeId(1)), std::string("H_"));
+
+    int type = topology.addType("O_2");
+    QCOMPARE(topology.typeCount(), size_t(3));
+    QCOMPARE(topology.addType("O_2"), type);
+    QCOMPARE(topology.addType("H_"), topology.typeId(1));
+
+    topology.setTypeId(3, type);
+    QCOMPARE(topology.type(3), std::string("O_2"));
+
+    topology.setTypeId(3, -1);
+    QCOMPARE(topology.type(3), std::string());
+}
+
 QTEST_APPLESS_MAIN(TopologyTest)
@@ -46,6 +46,7 @@ class TopologyTest : public QObject
 
     private slots:
         void size();
+        void types();
 };
 
 #endif // TOPOLOGYTEST_H
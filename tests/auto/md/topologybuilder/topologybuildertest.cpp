@@ -55,6 +55,9 @@ void TopologyBuilderTest::phenol()
     QCOMPARE(topology->size(), size_t(13));
     QCOMPARE(topology->bondedInteractionCount(), size_t(13));
 
+    // each type name is only stored once
+    QCOMPARE(topology->typeCount(), size_t(3));
+
     for(size_t i = 0; i < phenol.size(); i++){
         const chemkit::Atom *atom = phenol.atom(i);
 
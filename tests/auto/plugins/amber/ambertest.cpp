@@ -44,6 +44,7 @@
 #include <chemkit/forcefield.h>
 #include <chemkit/moleculefile.h>
 #include <chemkit/moleculardescriptor.h>
+#include <chemkit/cartesiancoordinates.h>
 
 #ifdef CHEMKIT_WITH_MD_IO
 #include <chemkit/trajectoryfileformat.h>
@@ -204,4 +205,55 @@ void AmberTest::water()
     delete forceField;
 }
 
+void AmberTest::batches_data()
+{
+    QTest::addColumn<QString>("fileNameString");
+
+    QTest::newRow("adenosine") << "adenosine.mol";
+    QTest::newRow("serine") << "serine.mol";
+}
+
+void AmberTest::batches()
+{
+    // verify that the batched energy and gradient are identical
+    // to those calculated from each of the calculations
+    QFETCH(QString, fileNameString);
+    QByteArray fileName = fileNameString.toAscii();
+
+    boost::shared_ptr<chemkit::Molecule> molecule =
+        chemkit::MoleculeFile::quickRead(dataPath + fileName.constData());
+    QVERIFY(molecule != 0);
+
+    chemkit::ForceField *forceField = chemkit::ForceField::create("amber");
+    QVERIFY(forceField != 0);
+
+    forceField->setTopologyFromMolecule(molecule.get());
+    QVERIFY(forceField->setup());
+    QVERIFY(!forceField->calculationBatches().empty());
+
+    const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+    chemkit::Real energy = 0;
+    std::vector<chemkit::Vector3> gradient(molecule->atomCount(), chemkit::Vector3(0, 0, 0));
+
+    foreach(const chemkit::ForceFieldCalculation *calculation, forceField->calculations()){
+        energy += calculation->energy(coordinates);
+
+        std::vector<chemkit::Vector3> atomGradients = calculation->gradient(coordinates);
+        for(size_t i = 0; i < atomGradients.size(); i++){
+            gradient[calculation->atom(i)] += atomGradients[i];
+        }
+    }
+
+    QCOMPARE(forceField->energy(coordinates), energy);
+
+    std::vector<chemkit::Vector3> batchGradient = forceField->gradient(coordinates);
+    QCOMPARE(batchGradient.size(), gradient.size());
+    for(size_t i = 0; i < gradient.size(); i++){
+        QVERIFY((batchGradient[i] - gradient[i]).norm() < 1e-8);
+    }
+
+    delete forceField;
+}
+
 QTEST_APPLESS_MAIN(AmberTest)
@@ -47,6 +47,8 @@ class AmberTest : public QObject
         void adenosine();
         void serine();
         void water();
+        void batches_data();
+        void batches();
 };
 
 #endif // AMBERTEST_H
@@ -35,17 +35,27 @@
 
 #include "fpstest.h"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <boost/cstdint.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/range/algorithm.hpp>
 
 #include <chemkit/molecule.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/fingerprintfile.h>
 #include <chemkit/moleculefileformat.h>
+#include <chemkit/fingerprintdatabase.h>
+#include <chemkit/fingerprintfileformat.h>
 
 void FpsTest::initTestCase()
 {
     // verify that the fps plugin registered itself correctly
     QVERIFY(boost::count(chemkit::MoleculeFileFormat::formats(), "fps") == 1);
+    QVERIFY(boost::count(chemkit::FingerprintFileFormat::formats(), "fps") == 1);
+    QVERIFY(boost::count(chemkit::FingerprintFileFormat::formats(), "fpsb") == 1);
 }
 
 void FpsTest::write()
@@ -96,4 +106,295 @@ void FpsTest::write()
     QCOMPARE(identifier.c_str(), "C2H6O");
 }
 
+void FpsTest::writeDatabase()
+{
+    boost::shared_ptr<chemkit::FingerprintDatabase> database =
+        boost::make_shared<chemkit::FingerprintDatabase>("fp2");
+
+    chemkit::Molecule ethanol("CCO", "smiles");
+    ethanol.setName("ethanol");
+    QVERIFY(database->addMolecule(&ethanol));
+
+    chemkit::PackedFingerprint fingerprint(1021);
+    fingerprint.set(0);
+    fingerprint.set(9);
+    fingerprint.set(1020);
+    QVERIFY(database->addFingerprint(fingerprint, "bits"));
+
+    chemkit::FingerprintFile file;
+    file.setDatabase(database);
+
+    std::ostringstream output;
+    bool ok = file.write(output, "fps");
+    QVERIFY(ok);
+
+    std::string outputData = output.str();
+
+    std::vector<std::string> lines;
+    boost::split(lines,
+                 outputData,
+                 boost::is_any_of("\n"),
+                 boost::token_compress_on);
+    QCOMPARE(lines.size(), size_t(8));
+    QCOMPARE(lines[0].c_str(), "#FPS1");
+    QCOMPARE(lines[1].c_str(), "#num_bits=1021");
+    QCOMPARE(lines[2].c_str(), "#type=chemkit-FP2/1");
+    QVERIFY(boost::starts_with(lines[3], "#software=chemkit/"));
+    QVERIFY(boost::starts_with(lines[4], "#date="));
+
+    // the fingerprints match those written for molecule files
+    QCOMPARE(lines[5].c_str(), "0000000000000000000000000000000000000000000"
+                               "0000000000000000000000000000000000000000000"
+                               "0000000000000000000000000000000000000000000"
+                               "8000800000000000000000000000000000000400000"
+                               "0000000000000000000000000000000000000000000"
+                               "00000000000000000000000000000000000000000\tethanol");
+    QCOMPARE(lines[6].c_str(), "0102000000000000000000000000000000000000000"
+                               "0000000000000000000000000000000000000000000"
+                               "0000000000000000000000000000000000000000000"
+                               "0000000000000000000000000000000000000000000"
+                               "0000000000000000000000000000000000000000000"
+                               "00000000000000000000000000000000000000010\tbits");
+}
+
+void FpsTest::readDatabase()
+{
+    std::istringstream input("#FPS1\n"
+                             "#num_bits=16\n"
+                             "#type=chemkit-FP2/1\n"
+                             "#software=chemkit/0.1\n"
+                             "0100\tfirst\n"
+                             "ff0f\tsecond\textra\n"
+                             "\n"
+                             "0380\n");
+
+    chemkit::FingerprintFile file;
+    bool ok = file.read(input, "fps");
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    boost::shared_ptr<chemkit::FingerprintDatabase> database = file.database();
+    QVERIFY(database != 0);
+    QCOMPARE(database->size(), size_t(3));
+    QCOMPARE(database->fingerprint(), std::string("fp2"));
+    QCOMPARE(database->fingerprintSize(), size_t(16));
+
+    // bytes are stored least significant first
+    chemkit::PackedFingerprint fingerprint = database->fingerprint(0);
+    QCOMPARE(fingerprint.count(), size_t(1));
+    QVERIFY(fingerprint.test(0));
+
+    fingerprint = database->fingerprint(1);
+    QCOMPARE(fingerprint.count(), size_t(12));
+    QVERIFY(fingerprint.test(7));
+    QVERIFY(fingerprint.test(11));
+    QVERIFY(!fingerprint.test(12));
+
+    fingerprint = database->fingerprint(2);
+    QCOMPARE(fingerprint.count(), size_t(3));
+    QVERIFY(fingerprint.test(15));
+
+    QCOMPARE(database->identifier(0), std::string("first"));
+    QCOMPARE(database->identifier(1), std::string("second"));
+    QCOMPARE(database->identifier(2), std::string());
+
+    // read back the file written for a database
+    boost::shared_ptr<chemkit::FingerprintDatabase> written =
+        boost::make_shared<chemkit::FingerprintDatabase>("fp2");
+    chemkit::Molecule ethanol("CCO", "smiles");
+    ethanol.setName("ethanol");
+    QVERIFY(written->addMolecule(&ethanol));
+
+    file.setDatabase(written);
+    std::stringstream buffer;
+    QVERIFY(file.write(buffer, "fps"));
+
+    chemkit::FingerprintFile readFile;
+    QVERIFY(readFile.read(buffer, "fps"));
+    QCOMPARE(readFile.size(), size_t(1));
+    QCOMPARE(readFile.database()->fingerprintSize(), size_t(1021));
+    QVERIFY(readFile.database()->fingerprint(0) == written->fingerprint(0));
+    QCOMPARE(readFile.database()->identifier(0), std::string("ethanol"));
+}
+
+void FpsTest::readInvalid()
+{
+    chemkit::FingerprintFile file;
+
+    // fingerprint with the wrong length
+    std::istringstream input("#FPS1\n"
+                             "#num_bits=16\n"
+                             "010\tfirst\n");
+    QVERIFY(!file.read(input, "fps"));
+
+    // fingerprint with an invalid character
+    std::istringstream invalidInput("#FPS1\n"
+                                    "01x0\tfirst\n");
+    QVERIFY(!file.read(invalidInput, "fps"));
+}
+
+namespace {
+
+// Returns a database containing a small set of fingerprints.
+boost::shared_ptr<chemkit::FingerprintDatabase> createDatabase()
+{
+    boost::shared_ptr<chemkit::FingerprintDatabase> database =
+        boost::make_shared<chemkit::FingerprintDatabase>("fp2");
+
+    const char *smiles[] = { "CCO", "c1ccccc1", "c1ccccc1O", "CC(=O)O", "CCN" };
+    for(size_t i = 0; i < 5; i++){
+        chemkit::Molecule molecule(smiles[i], "smiles");
+        molecule.setName(smiles[i]);
+        database->addMolecule(&molecule);
+    }
+
+    return database;
+}
+
+// Verifies that the database read from a binary file matches the
+// database it was written from.
+void compareDatabases(const chemkit::FingerprintDatabase *database,
+                      const chemkit::FingerprintDatabase *expected)
+{
+    QVERIFY(database->hasExternalStorage());
+    QCOMPARE(database->size(), expected->size());
+    QCOMPARE(database->fingerprint(), expected->fingerprint());
+    QCOMPARE(database->fingerprintSize(), expected->fingerprintSize());
+
+    for(size_t i = 0; i < expected->size(); i++){
+        QVERIFY(database->fingerprint(i) == expected->fingerprint(i));
+        QCOMPARE(database->identifier(i), expected->identifier(i));
+
+        std::vector<chemkit::FingerprintDatabase::Hit> hits =
+            database->search(expected->fingerprint(i), 0.5);
+        QVERIFY(hits == expected->search(expected->fingerprint(i), 0.5));
+
+        hits = database->nearestNeighbors(expected->fingerprint(i), 3);
+        QVERIFY(hits == expected->nearestNeighbors(expected->fingerprint(i), 3));
+    }
+}
+
+// Overwrites the value at position index of the table whose offset
+// is stored at headerOffset in the header of the binary file.
+void setTableValue(std::string &data, size_t headerOffset, size_t index, boost::uint64_t value)
+{
+    boost::uint64_t tableOffset;
+    std::memcpy(&tableOffset, data.data() + headerOffset, sizeof(tableOffset));
+    std::memcpy(&data[tableOffset + index * sizeof(value)], &value, sizeof(value));
+}
+
+} // end anonymous namespace
+
+void FpsTest::readBinary()
+{
+    boost::shared_ptr<chemkit::FingerprintDatabase> database = createDatabase();
+
+    chemkit::FingerprintFile file;
+    file.setDatabase(database);
+
+    std::stringstream buffer;
+    bool ok = file.write(buffer, "fpsb");
+    QVERIFY(ok);
+
+    chemkit::FingerprintFile readFile;
+    ok = readFile.read(buffer, "fpsb");
+    if(!ok)
+        qDebug() << readFile.errorString().c_str();
+    QVERIFY(ok);
+    compareDatabases(readFile.database().get(), database.get());
+
+    // adding a fingerprint copies the fingerprints into memory
+    boost::shared_ptr<chemkit::FingerprintDatabase> readDatabase = readFile.database();
+    chemkit::Molecule molecule("CCCC", "smiles");
+    QVERIFY(readDatabase->addMolecule(&molecule));
+    QVERIFY(!readDatabase->hasExternalStorage());
+    QCOMPARE(readDatabase->size(), size_t(6));
+    QVERIFY(database->addMolecule(&molecule));
+    for(size_t i = 0; i < database->size(); i++){
+        QVERIFY(readDatabase->fingerprint(i) == database->fingerprint(i));
+        QCOMPARE(readDatabase->identifier(i), database->identifier(i));
+    }
+}
+
+void FpsTest::readMappedBinary()
+{
+    boost::shared_ptr<chemkit::FingerprintDatabase> database = createDatabase();
+
+    chemkit::FingerprintFile file;
+    file.setDatabase(database);
+    QVERIFY(file.write("fpstest.fpsb"));
+
+    chemkit::FingerprintFile readFile;
+    {
+        boost::iostreams::mapped_file_source input("fpstest.fpsb");
+        bool ok = readFile.read(input, "fpsb");
+        if(!ok)
+            qDebug() << readFile.errorString().c_str();
+        QVERIFY(ok);
+    }
+
+    // the database keeps the file mapped after the source is closed
+    compareDatabases(readFile.database().get(), database.get());
+
+    readFile.clear();
+    std::remove("fpstest.fpsb");
+}
+
+void FpsTest::readInvalidBinary()
+{
+    boost::shared_ptr<chemkit::FingerprintDatabase> database = createDatabase();
+
+    chemkit::FingerprintFile file;
+    file.setDatabase(database);
+
+    std::ostringstream output;
+    QVERIFY(file.write(output, "fpsb"));
+    std::string data = output.str();
+
+    // truncated file
+    std::istringstream truncated(data.substr(0, data.size() / 2));
+    QVERIFY(!file.read(truncated, "fpsb"));
+
+    // invalid magic string
+    std::string invalidMagic = data;
+    invalidMagic[0] = 'X';
+    std::istringstream invalidMagicInput(invalidMagic);
+    QVERIFY(!file.read(invalidMagicInput, "fpsb"));
+
+    // fingerprint index out of range
+    std::string invalidIndex = data;
+    setTableValue(invalidIndex, 48, 0, 1000);
+    std::istringstream invalidIndexInput(invalidIndex);
+    QVERIFY(!file.read(invalidIndexInput, "fpsb"));
+
+    // duplicate fingerprint position
+    std::string invalidPosition = data;
+    setTableValue(invalidPosition, 56, 1, 0);
+    std::istringstream invalidPositionInput(invalidPosition);
+    QVERIFY(!file.read(invalidPositionInput, "fpsb"));
+
+    // decreasing identifier offset
+    std::string invalidIdentifier = data;
+    setTableValue(invalidIdentifier, 64, 2, 1000);
+    std::istringstream invalidIdentifierInput(invalidIdentifier);
+    QVERIFY(!file.read(invalidIdentifierInput, "fpsb"));
+
+    // fingerprint in the bucket for a different number of set bits
+    std::string invalidBucket = data;
+    boost::uint64_t wordsOffset;
+    std::memcpy(&wordsOffset, data.data() + 32, sizeof(wordsOffset));
+    invalidBucket[wordsOffset] ^= 1;
+    std::istringstream invalidBucketInput(invalidBucket);
+    QVERIFY(!file.read(invalidBucketInput, "fpsb"));
+
+    // unmodified file
+    std::istringstream validInput(data);
+    QVERIFY(file.read(validInput, "fpsb"));
+
+    // text fps file
+    std::istringstream textInput("#FPS1\n0100\tfirst\n");
+    QVERIFY(!file.read(textInput, "fpsb"));
+}
+
 QTEST_APPLESS_MAIN(FpsTest)
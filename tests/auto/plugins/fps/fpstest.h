@@ -45,6 +45,12 @@ class FpsTest : public QObject
     private slots:
         void initTestCase();
         void write();
+        void writeDatabase();
+        void readDatabase();
+        void readInvalid();
+        void readBinary();
+        void readMappedBinary();
+        void readInvalidBinary();
 };
 
 #endif // FPSTEST_H
@@ -47,6 +47,7 @@
 #include <chemkit/aromaticitymodel.h>
 #include <chemkit/partialchargemodel.h>
 #include <chemkit/moleculardescriptor.h>
+#include <chemkit/cartesiancoordinates.h>
 
 const std::string dataPath = "../../../data/";
 
@@ -192,4 +193,56 @@ void MmffTest::validate()
     QCOMPARE(failedMolecules.size(), 0);
 }
 
+void MmffTest::batches_data()
+{
+    QTest::addColumn<QString>("fileNameString");
+
+    QTest::newRow("ethanol") << "ethanol.cml";
+    QTest::newRow("uridine") << "uridine.mol2";
+    QTest::newRow("adenosine") << "adenosine.mol";
+}
+
+void MmffTest::batches()
+{
+    // verify that the batched energy and gradient are identical
+    // to those calculated from each of the calculations
+    QFETCH(QString, fileNameString);
+    QByteArray fileName = fileNameString.toAscii();
+
+    boost::shared_ptr<chemkit::Molecule> molecule =
+        chemkit::MoleculeFile::quickRead(dataPath + fileName.constData());
+    QVERIFY(molecule != 0);
+
+    chemkit::ForceField *mmff = chemkit::ForceField::create("mmff");
+    QVERIFY(mmff != 0);
+
+    mmff->setTopologyFromMolecule(molecule.get());
+    QVERIFY(mmff->setup());
+    QVERIFY(!mmff->calculationBatches().empty());
+
+    const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+    chemkit::Real energy = 0;
+    std::vector<chemkit::Vector3> gradient(molecule->atomCount(), chemkit::Vector3(0, 0, 0));
+
+    foreach(const chemkit::ForceFieldCalculation *calculation, mmff->calculations()){
+        energy += calculation->energy(coordinates);
+
+        std::vector<chemkit::Vector3> atomGradients = calculation->gradient(coordinates);
+        for(size_t i = 0; i < atomGradients.size(); i++){
+            gradient[calculation->atom(i)] += atomGradients[i];
+        }
+    }
+
+    QCOMPARE(mmff->energy(coordinates), energy);
+
+    std::vector<chemkit::Vector3> batchGradient = mmff->gradient(coordinates);
+    QCOMPARE(batchGradient.size(), gradient.size());
+    for(size_t i = 0; i < gradient.size(); i++){
+        QVERIFY((batchGradient[i] - gradient[i]).norm() < 1e-8);
+    }
+
+    delete mmff;
+}
+
 QTEST_APPLESS_MAIN(MmffTest)
@@ -45,6 +45,8 @@ class MmffTest : public QObject
     private slots:
         void initTestCase();
         void validate();
+        void batches_data();
+        void batches();
 };
 
 #endif // MMFFTEST_H
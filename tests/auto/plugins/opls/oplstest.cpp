@@ -47,6 +47,7 @@
 #include <chemkit/forcefield.h>
 #include <chemkit/moleculefile.h>
 #include <chemkit/moleculardescriptor.h>
+#include <chemkit/cartesiancoordinates.h>
 
 const std::string dataPath = "../../../data/";
 
@@ -98,4 +99,56 @@ void OplsTest::energy()
     delete opls;
 }
 
+void OplsTest::batches_data()
+{
+    QTest::addColumn<QString>("fileNameString");
+
+    QTest::newRow("water") << "water.mol";
+    QTest::newRow("methanol") << "methanol.sdf";
+    QTest::newRow("ethanol") << "ethanol.cml";
+}
+
+void OplsTest::batches()
+{
+    // verify that the batched energy and gradient are identical
+    // to those calculated from each of the calculations
+    QFETCH(QString, fileNameString);
+    QByteArray fileName = fileNameString.toAscii();
+
+    boost::shared_ptr<chemkit::Molecule> molecule =
+        chemkit::MoleculeFile::quickRead(dataPath + fileName.constData());
+    QVERIFY(molecule != 0);
+
+    chemkit::ForceField *opls = chemkit::ForceField::create("opls");
+    QVERIFY(opls != 0);
+
+    opls->setTopologyFromMolecule(molecule.get());
+    QVERIFY(opls->setup());
+    QVERIFY(!opls->calculationBatches().empty());
+
+    const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+    chemkit::Real energy = 0;
+    std::vector<chemkit::Vector3> gradient(molecule->atomCount(), chemkit::Vector3(0, 0, 0));
+
+    foreach(const chemkit::ForceFieldCalculation *calculation, opls->calculations()){
+        energy += calculation->energy(coordinates);
+
+        std::vector<chemkit::Vector3> atomGradients = calculation->gradient(coordinates);
+        for(size_t i = 0; i < atomGradients.size(); i++){
+            gradient[calculation->atom(i)] += atomGradients[i];
+        }
+    }
+
+    QCOMPARE(opls->energy(coordinates), energy);
+
+    std::vector<chemkit::Vector3> batchGradient = opls->gradient(coordinates);
+    QCOMPARE(batchGradient.size(), gradient.size());
+    for(size_t i = 0; i < gradient.size(); i++){
+        QVERIFY((batchGradient[i] - gradient[i]).norm() < 1e-8);
+    }
+
+    delete opls;
+}
+
 QTEST_APPLESS_MAIN(OplsTest)
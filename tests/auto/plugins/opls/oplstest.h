@@ -46,6 +46,8 @@ class OplsTest : public QObject
         void initTestCase();
         void energy_data();
         void energy();
+        void batches_data();
+        void batches();
 };
 
 #endif // OPLSTEST_H
@@ -37,6 +37,7 @@
 
 #include <boost/range/algorithm.hpp>
 
+#include <chemkit/atom.h>
 #include <chemkit/polymer.h>
 #include <chemkit/polymerfile.h>
 #include <chemkit/polymerchain.h>
@@ -205,6 +206,7 @@ void PdbTest::read_2DHB_pdbml()
     // protein
     const boost::shared_ptr<chemkit::Polymer> &protein = file.polymer();
     QCOMPARE(protein->chainCount(), size_t(2));
+    QCOMPARE(protein->atomCount(chemkit::Atom::Iron), size_t(2));
 
     // chain A
     chemkit::PolymerChain *chainA = protein->chain(0);
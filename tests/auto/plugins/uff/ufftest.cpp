@@ -42,6 +42,9 @@
 #include <chemkit/forcefield.h>
 #include <chemkit/moleculefile.h>
 #include <chemkit/moleculardescriptor.h>
+#include <chemkit/cartesiancoordinates.h>
+
+const std::string dataPath = "../../../data/";
 
 void UffTest::initTestCase()
 {
@@ -51,4 +54,134 @@ void UffTest::initTestCase()
     QVERIFY(boost::count(chemkit::MolecularDescriptor::descriptors(), "uff-energy") == 1);
 }
 
+void UffTest::batches_data()
+{
+    QTest::addColumn<QString>("fileNameString");
+
+    QTest::newRow("ethanol") << "ethanol.cml";
+    QTest::newRow("uridine") << "uridine.mol2";
+    QTest::newRow("adenosine") << "adenosine.mol";
+}
+
+void UffTest::batches()
+{
+    // verify that the batched energy and gradient are identical
+    // to those calculated from each of the calculations
+    QFETCH(QString, fileNameString);
+    QByteArray fileName = fileNameString.toAscii();
+
+    boost::shared_ptr<chemkit::Molecule> molecule =
+        chemkit::MoleculeFile::quickRead(dataPath + fileName.constData());
+    QVERIFY(molecule != 0);
+
+    chemkit::ForceField *uff = chemkit::ForceField::create("uff");
+    QVERIFY(uff != 0);
+
+    uff->setTopologyFromMolecule(molecule.get());
+    QVERIFY(uff->setup());
+    QVERIFY(!uff->calculationBatches().empty());
+
+    const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+    chemkit::Real energy = 0;
+    std::vector<chemkit::Vector3> gradient(molecule->atomCount(), chemkit::Vector3(0, 0, 0));
+
+    foreach(const chemkit::ForceFieldCalculation *calculation, uff->calculations()){
+        energy += calculation->energy(coordinates);
+
+        std::vector<chemkit::Vector3> atomGradients = calculation->gradient(coordinates);
+        for(size_t i = 0; i < atomGradients.size(); i++){
+            gradient[calculation->atom(i)] += atomGradients[i];
+        }
+    }
+
+    QCOMPARE(uff->energy(coordinates), energy);
+
+    std::vector<chemkit::Vector3> batchGradient = uff->gradient(coordinates);
+    QCOMPARE(batchGradient.size(), gradient.size());
+    for(size_t i = 0; i < gradient.size(); i++){
+        QVERIFY((batchGradient[i] - gradient[i]).norm() < 1e-8);
+    }
+
+    delete uff;
+}
+
+void UffTest::setParameter()
+{
+    // verify that changing the parameters of a calculation after
+    // setup also changes the energy calculated from its batch
+    boost::shared_ptr<chemkit::Molecule> molecule =
+        chemkit::MoleculeFile::quickRead(dataPath + "ethanol.cml");
+    QVERIFY(molecule != 0);
+
+    chemkit::ForceField *uff = chemkit::ForceField::create("uff");
+    QVERIFY(uff != 0);
+
+    uff->setTopologyFromMolecule(molecule.get());
+    QVERIFY(uff->setup());
+
+    const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+    foreach(chemkit::ForceFieldCalculation *calculation, uff->calculations()){
+        for(int i = 0; i < calculation->parameterCount(); i++){
+            calculation->setParameter(i, calculation->parameter(i) * 1.5);
+        }
+    }
+
+    chemkit::Real energy = 0;
+    foreach(const chemkit::ForceFieldCalculation *calculation, uff->calculations()){
+        energy += calculation->energy(coordinates);
+    }
+
+    QCOMPARE(uff->energy(coordinates), energy);
+
+    delete uff;
+}
+
+void UffTest::nonbondedSwitch()
+{
+    // verify that the gradient with a switched nonbonded cutoff
+    // matches the gradient calculated from the energy
+    boost::shared_ptr<chemkit::Molecule> molecule =
+        chemkit::MoleculeFile::quickRead(dataPath + "uridine.mol2");
+    QVERIFY(molecule != 0);
+
+    chemkit::ForceField *uff = chemkit::ForceField::create("uff");
+    QVERIFY(uff != 0);
+
+    uff->setNonbondedCutoff(5.0);
+    QCOMPARE(uff->nonbondedSwitchDistance(), chemkit::Real(3.0));
+
+    uff->setTopologyFromMolecule(molecule.get());
+    QVERIFY(uff->setup());
+
+    chemkit::CartesianCoordinates coordinates = *molecule->coordinates();
+
+    std::vector<chemkit::Vector3> gradient;
+    uff->energyAndGradient(&coordinates, gradient);
+    QCOMPARE(gradient.size(), molecule->atomCount());
+
+    const chemkit::Real step = 1e-5;
+
+    for(size_t i = 0; i < coordinates.size(); i++){
+        chemkit::Point3 position = coordinates.position(i);
+
+        for(int j = 0; j < 3; j++){
+            chemkit::Vector3 offset(0, 0, 0);
+            offset[j] = step;
+
+            coordinates.setPosition(i, position + offset);
+            chemkit::Real forward = uff->energy(&coordinates);
+            coordinates.setPosition(i, position - offset);
+            chemkit::Real backward = uff->energy(&coordinates);
+            coordinates.setPosition(i, position);
+
+            chemkit::Real derivative = (forward - backward) / (2 * step);
+            QVERIFY(std::abs(derivative - gradient[i][j]) < 1e-4 * std::max(chemkit::Real(1), std::abs(derivative)));
+        }
+    }
+
+    delete uff;
+}
+
 QTEST_APPLESS_MAIN(UffTest)
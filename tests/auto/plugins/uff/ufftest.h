@@ -44,6 +44,10 @@ class UffTest : public QObject
 
     private slots:
         void initTestCase();
+        void batches_data();
+        void batches();
+        void setParameter();
+        void nonbondedSwitch();
 };
 
 #endif // UFFTEST_H
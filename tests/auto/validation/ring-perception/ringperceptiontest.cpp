@@ -36,7 +36,9 @@
 // The ring-perception test verifies the ring perception and aromaticity
 // perception algorithms against a large number of molecules. Each molecule
 // is constructed and then each atom and bond it contains is checked for ring
-// membership and aromaticity.
+// membership and aromaticity. The ring systems test verifies that
+// perceiving the rings in each ring system separately gives the same set of
+// rings as the RP-Path algorithm run on the whole fragment.
 
 #include "ringperceptiontest.h"
 
@@ -44,7 +46,13 @@
 #include <chemkit/bond.h>
 #include <chemkit/ring.h>
 #include <chemkit/chemkit.h>
+#include <chemkit/fragment.h>
 #include <chemkit/molecule.h>
+#include <chemkit/moleculefile.h>
+
+#include "../../../../src/chemkit/rppath.h"
+
+const std::string dataPath = "../../../data/";
 
 void RingPerceptionTest::addHydrogens(chemkit::Molecule *molecule)
 {
@@ -3489,4 +3497,57 @@ void RingPerceptionTest::vigtua()
     QCOMPARE(C11_C12->isAromatic(), true);
 }
 
+// Returns the rings found by running the RP-Path algorithm on all of
+// the non-terminal atoms in the fragment at once.
+// returns the rings as sorted lists of their bonds so that ring sets can be
+// compared independently of the order the rings were found in
+static std::vector<std::vector<chemkit::Bond *> > ringBondSets(const std::vector<std::vector<chemkit::Atom *> > &rings)
+{
+    std::vector<std::vector<chemkit::Bond *> > bondSets;
+
+    foreach(const std::vector<chemkit::Atom *> &ring, rings){
+        std::vector<chemkit::Bond *> bonds;
+
+        for(size_t i = 0; i < ring.size(); i++){
+            bonds.push_back(ring[i]->bondTo(ring[(i + 1) % ring.size()]));
+        }
+
+        std::sort(bonds.begin(), bonds.end());
+        bondSets.push_back(bonds);
+    }
+
+    std::sort(bondSets.begin(), bondSets.end());
+
+    return bondSets;
+}
+
+void RingPerceptionTest::ringSystems()
+{
+    // these files contain cage compounds (e.g. bicyclo[2.2.2]octane) whose
+    // smallest rings are not unique along with other ring systems
+    const char *fileNames[] = { "MMFF94_hypervalent.mol2",
+                                "pubchem_416_benzenes.sdf" };
+
+    for(size_t i = 0; i < sizeof(fileNames) / sizeof(*fileNames); i++){
+        chemkit::MoleculeFile file(dataPath + fileNames[i]);
+        bool ok = file.read();
+        if(!ok)
+            qDebug() << file.errorString().c_str();
+        QVERIFY(ok);
+
+        foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file.molecules()){
+            foreach(const chemkit::Fragment *fragment, molecule->fragments()){
+                std::vector<std::vector<chemkit::Bond *> > expected =
+                    ringBondSets(chemkit::algorithm::detail::fragmentRings(fragment->atoms()));
+                std::vector<std::vector<chemkit::Bond *> > actual =
+                    ringBondSets(chemkit::algorithm::detail::perceiveRings(fragment->atoms()));
+
+                if(actual != expected)
+                    qDebug() << fileNames[i] << molecule->name().c_str();
+                QVERIFY(actual == expected);
+            }
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(RingPerceptionTest)
@@ -89,6 +89,7 @@ class RingPerceptionTest : public QObject
         void tricyclooctane();
         void uracil();
         void vigtua();
+        void ringSystems();
 };
 
 #endif // RINGPERCEPTIONTEST_H
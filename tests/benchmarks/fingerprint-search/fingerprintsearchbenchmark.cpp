@@ -0,0 +1,116 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+// This benchmark measures the throughput of similarity searches in a
+// database of one million random 1021-bit fingerprints. The density
+// of set bits varies between fingerprints so that, as with real
+// fingerprints, the popcount buckets allow part of the database to
+// be skipped.
+
+#include "fingerprintsearchbenchmark.h"
+
+const size_t DatabaseSize = 1000000;
+const size_t FingerprintSize = 1021;
+const size_t QueryCount = 16;
+
+namespace {
+
+// Returns a random fingerprint with between one and forty percent
+// of its bits set.
+chemkit::PackedFingerprint randomFingerprint(unsigned int &state)
+{
+    chemkit::PackedFingerprint fingerprint(FingerprintSize);
+
+    state = state * 1103515245 + 12345;
+    unsigned int density = 1 + (state >> 16) % 40;
+
+    for(size_t i = 0; i < FingerprintSize; i++){
+        state = state * 1103515245 + 12345;
+        if((state >> 16) % 100 < density){
+            fingerprint.set(i);
+        }
+    }
+
+    return fingerprint;
+}
+
+} // end anonymous namespace
+
+void FingerprintSearchBenchmark::initTestCase()
+{
+    unsigned int state = 1;
+
+    database.reserve(DatabaseSize);
+    for(size_t i = 0; i < DatabaseSize; i++){
+        database.addFingerprint(randomFingerprint(state));
+    }
+
+    for(size_t i = 0; i < QueryCount; i++){
+        queries.push_back(randomFingerprint(state));
+    }
+
+    QCOMPARE(database.size(), DatabaseSize);
+}
+
+void FingerprintSearchBenchmark::search()
+{
+    QBENCHMARK {
+        foreach(const chemkit::PackedFingerprint &query, queries){
+            database.search(query, 0.8);
+        }
+    }
+}
+
+void FingerprintSearchBenchmark::nearestNeighbors()
+{
+    QBENCHMARK {
+        foreach(const chemkit::PackedFingerprint &query, queries){
+            database.nearestNeighbors(query, 10);
+        }
+    }
+}
+
+void FingerprintSearchBenchmark::batch()
+{
+    QBENCHMARK {
+        std::vector<std::vector<chemkit::FingerprintDatabase::Hit> > results =
+            database.nearestNeighbors(queries, 10);
+
+        QCOMPARE(results.size(), QueryCount);
+    }
+}
+
+QTEST_APPLESS_MAIN(FingerprintSearchBenchmark)
@@ -0,0 +1,99 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+// This benchmark measures the time it takes to set up the MMFF
+// force field for the protein hemoglobin (PDB ID: 2DHB) and the
+// time it takes to evaluate the energy once it has been set up.
+// The protein contains 146 residues and 2201 atoms.
+
+#include "mmffsetupbenchmark.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <chemkit/polymer.h>
+#include <chemkit/forcefield.h>
+#include <chemkit/polymerfile.h>
+#include <chemkit/bondpredictor.h>
+
+const std::string dataPath = "../../data/";
+
+void MmffSetupBenchmark::setup()
+{
+    chemkit::PolymerFile file(dataPath + "2DHB.pdb");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    const boost::shared_ptr<chemkit::Polymer> &protein = file.polymer();
+    QVERIFY(protein);
+    QCOMPARE(protein->size(), size_t(2201));
+
+    // the pdb file does not contain the bonds between residue atoms
+    chemkit::BondPredictor::predictBonds(protein.get());
+
+    QBENCHMARK {
+        boost::scoped_ptr<chemkit::ForceField> forceField(chemkit::ForceField::create("mmff"));
+        QVERIFY(forceField);
+
+        forceField->setTopologyFromMolecule(protein.get());
+        forceField->setup();
+        QVERIFY(forceField->calculationCount() > 0);
+    }
+}
+
+void MmffSetupBenchmark::energy()
+{
+    chemkit::PolymerFile file(dataPath + "2DHB.pdb");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    const boost::shared_ptr<chemkit::Polymer> &protein = file.polymer();
+    QVERIFY(protein);
+    chemkit::BondPredictor::predictBonds(protein.get());
+
+    boost::scoped_ptr<chemkit::ForceField> forceField(chemkit::ForceField::create("mmff"));
+    QVERIFY(forceField);
+    forceField->setTopologyFromMolecule(protein.get());
+    forceField->setup();
+
+    QBENCHMARK {
+        forceField->energy(protein->coordinates());
+    }
+}
+
+QTEST_APPLESS_MAIN(MmffSetupBenchmark)
@@ -0,0 +1,99 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+// This benchmark measures the performance of reading the protein
+// hemoglobin (PDB ID: 2DHB) from a PDB file. The atoms() benchmark
+// isolates the cost of creating the atoms from their element symbols
+// and the file() benchmark measures reading the whole file.
+
+#include "parsepdbbenchmark.h"
+
+#include <fstream>
+
+#include <boost/algorithm/string.hpp>
+
+#include <chemkit/atom.h>
+#include <chemkit/polymer.h>
+#include <chemkit/element.h>
+#include <chemkit/molecule.h>
+#include <chemkit/polymerfile.h>
+
+const std::string dataPath = "../../data/";
+
+void ParsePdbBenchmark::initTestCase()
+{
+    std::ifstream input((dataPath + "2DHB.pdb").c_str());
+    QVERIFY(input.is_open());
+
+    // read the element symbol of each atom
+    std::string line;
+    while(std::getline(input, line)){
+        if(boost::starts_with(line, "ATOM") || boost::starts_with(line, "HETATM")){
+            symbols.push_back(boost::trim_copy(line.substr(76, 2)));
+        }
+    }
+
+    QCOMPARE(symbols.size(), size_t(2289));
+}
+
+void ParsePdbBenchmark::atoms()
+{
+    QBENCHMARK {
+        chemkit::Molecule molecule;
+
+        foreach(const std::string &symbol, symbols){
+            molecule.addAtom(chemkit::Element::fromSymbolCaseInsensitive(symbol));
+        }
+
+        QCOMPARE(molecule.atomCount(chemkit::Atom::Carbon), size_t(1478));
+        QCOMPARE(molecule.atomCount(chemkit::Atom::Iron), size_t(2));
+    }
+}
+
+void ParsePdbBenchmark::file()
+{
+    QBENCHMARK {
+        chemkit::PolymerFile file(dataPath + "2DHB.pdb");
+        bool ok = file.read();
+        if(!ok)
+            qDebug() << file.errorString().c_str();
+        QVERIFY(ok);
+
+        QCOMPARE(file.polymer()->size(), size_t(2201));
+    }
+}
+
+QTEST_APPLESS_MAIN(ParsePdbBenchmark)
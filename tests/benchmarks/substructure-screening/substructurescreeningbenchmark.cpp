@@ -0,0 +1,118 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+// This benchmark measures the effect of screening molecules before
+// running the substructure isomorphism algorithm. The molecules from
+// the 'pubchem_416_benzenes.sdf' file are repeated to form a library
+// of about ten thousand molecules which is then filtered with a set
+// of common functional groups and ring systems, both with and without
+// the SubstructureQuery::UseScreening flag.
+
+#include "substructurescreeningbenchmark.h"
+
+#include <chemkit/molecule.h>
+#include <chemkit/substructurequery.h>
+
+const std::string dataPath = "../../data/";
+
+const size_t LibraryCopies = 24;
+
+const char *Queries[] = {
+    "c1ccccc1",
+    "c1ccc2ccccc2c1",
+    "c1ccncc1",
+    "c1ccsc1",
+    "C1CCCCC1",
+    "C1CCNCC1",
+    "CC(=O)O",
+    "CC(=O)N",
+    "NS(=O)=O",
+    "Clc1ccccc1",
+    "FC(F)F",
+    "O=C(N)c1ccccc1",
+    "OC(=O)c1ccccc1N",
+    "CCCCCCCC"
+};
+
+const size_t QueryCount = sizeof(Queries) / sizeof(Queries[0]);
+
+void SubstructureScreeningBenchmark::initTestCase()
+{
+    file.setFileName(dataPath + "pubchem_416_benzenes.sdf");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+    QCOMPARE(file.moleculeCount(), size_t(416));
+
+    for(size_t i = 0; i < LibraryCopies; i++){
+        foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file.molecules()){
+            library.push_back(molecule.get());
+        }
+    }
+}
+
+void SubstructureScreeningBenchmark::filter()
+{
+    matchCounts.clear();
+
+    QBENCHMARK_ONCE {
+        for(size_t i = 0; i < QueryCount; i++){
+            chemkit::SubstructureQuery query(Queries[i], "smiles");
+
+            matchCounts.push_back(query.filter(library).size());
+        }
+    }
+}
+
+void SubstructureScreeningBenchmark::filterScreened()
+{
+    std::vector<size_t> screenedMatchCounts;
+
+    QBENCHMARK_ONCE {
+        for(size_t i = 0; i < QueryCount; i++){
+            chemkit::SubstructureQuery query(Queries[i], "smiles");
+            query.setFlags(chemkit::SubstructureQuery::UseScreening);
+
+            screenedMatchCounts.push_back(query.filter(library).size());
+        }
+    }
+
+    // screening must not change the molecules that match
+    QVERIFY(screenedMatchCounts == matchCounts);
+}
+
+QTEST_APPLESS_MAIN(SubstructureScreeningBenchmark)
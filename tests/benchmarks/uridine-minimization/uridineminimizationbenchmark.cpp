@@ -41,20 +41,32 @@
 
 const std::string dataPath = "../../data/";
 
+void UridineMinimizationBenchmark::benchmark_data()
+{
+    QTest::addColumn<QString>("minimizer");
+
+    QTest::newRow("steepest-descent") << QString("steepest-descent");
+    QTest::newRow("conjugate-gradient") << QString("conjugate-gradient");
+    QTest::newRow("lbfgs") << QString("lbfgs");
+}
+
 void UridineMinimizationBenchmark::benchmark()
 {
+    QFETCH(QString, minimizer);
+
     boost::shared_ptr<chemkit::Molecule> molecule = chemkit::MoleculeFile::quickRead(dataPath + "uridine.mol2");
     QVERIFY(molecule != 0);
 
     chemkit::MoleculeGeometryOptimizer optimizer;
     optimizer.setForceField("uff");
     optimizer.setMolecule(molecule.get());
+    QVERIFY(optimizer.setMinimizer(minimizer.toStdString()));
 
     bool ok = optimizer.setup();
     QVERIFY(ok);
 
     QBENCHMARK {
-        for(;;){
+        while(optimizer.iterationCount() < optimizer.maximumIterations()){
             optimizer.step();
 
             // converge when rmsg = 0.1
@@ -63,6 +75,10 @@ void UridineMinimizationBenchmark::benchmark()
             }
         }
     }
+
+    qDebug() << minimizer
+             << "iterations:" << optimizer.iterationCount()
+             << "evaluations:" << optimizer.evaluationCount();
 }
 
 QTEST_APPLESS_MAIN(UridineMinimizationBenchmark)
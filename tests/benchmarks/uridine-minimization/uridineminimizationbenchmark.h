@@ -43,6 +43,7 @@ class UridineMinimizationBenchmark : public QObject
     Q_OBJECT
 
     private slots:
+        void benchmark_data();
         void benchmark();
 };
 